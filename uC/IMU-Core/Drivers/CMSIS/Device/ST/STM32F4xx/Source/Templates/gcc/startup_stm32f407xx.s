@@ -62,6 +62,13 @@ defined in linker script */
 .word  _sbss
 /* end address for the .bss section. defined in linker script */
 .word  _ebss
+/* start address for the initialization values of the .ccmram section,
+its start and end, and the .ccmbss section. defined in linker script */
+.word  _siccmram
+.word  _sccmram
+.word  _eccmram
+.word  _sccmbss
+.word  _eccmbss
 /* stack used for SystemInit_ExtMemCtl; always internal RAM used */
 
 /**
@@ -107,6 +114,34 @@ LoopFillZerobss:
   cmp  r2, r3
   bcc  FillZerobss
 
+/* Copy the CCM RAM data initializers from flash */
+  movs  r1, #0
+  b  LoopCopyCcmInit
+
+CopyCcmInit:
+  ldr  r3, =_siccmram
+  ldr  r3, [r3, r1]
+  str  r3, [r0, r1]
+  adds  r1, r1, #4
+
+LoopCopyCcmInit:
+  ldr  r0, =_sccmram
+  ldr  r3, =_eccmram
+  adds  r2, r0, r1
+  cmp  r2, r3
+  bcc  CopyCcmInit
+  ldr  r2, =_sccmbss
+  b  LoopFillZeroCcm
+/* Zero fill the CCM RAM bss */
+FillZeroCcm:
+  movs  r3, #0
+  str  r3, [r2], #4
+
+LoopFillZeroCcm:
+  ldr  r3, = _eccmbss
+  cmp  r2, r3
+  bcc  FillZeroCcm
+
 /* Call the clock system intitialization function.*/
   bl  SystemInit   
 /* Call static constructors */
@@ -0,0 +1,577 @@
+/*
+ * allan.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Overlapping Allan deviation of a long static capture, per gyro and
+ *  accel axis, and the noise parameters read off it in the form
+ *  eskf_noise_t and pdr_config_t take them.
+ *
+ *  ./allan [-f rate Hz] [-j threads] [-S hours] [-q] [log file]
+ *
+ *  Input is the print_motion7() format (see eskf_replay.c), from stdin
+ *  without a file argument; the rate is taken from the time stamps
+ *  unless -f is given. -S generates a synthetic capture instead, white
+ *  noise and a rate random walk at the ESKF defaults, to check the
+ *  extraction. -q leaves the deviation table out.
+ *
+ *  The data is streamed: a reader parses blocks of samples into a small
+ *  ring and one worker per axis, or per group of axes with -j, consumes
+ *  every block. Cluster sizes are spaced ALLAN_PER_OCTAVE per octave.
+ *  Sizes below 2 KMIN are evaluated on the samples themselves; above,
+ *  level j keeps means of 2^j samples and evaluates k in [KMIN, 2 KMIN)
+ *  of those, i.e. m = k 2^j with overlap steps of 2^j samples. Each
+ *  level holds the last 4 KMIN cumulative sums, so memory is fixed and
+ *  the work is O(log n) cluster sizes per sample, nearly all at level 0.
+ *
+ *  Parameters, IEEE Std 952 style: ARW N where the slope is closest to
+ *  -1/2 (N = adev at tau = 1 s on that line), bias instability B from the
+ *  minimum (adev / 0.664), RRW K where the slope is closest to +1/2
+ *  (adev at tau = 3 s on that line). Points with a relative error of
+ *  more than 25 % are not used.
+ */
+
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CHANNELS 6				/* gx gy gz ax ay az */
+#define BLOCK 8192				/* samples per block */
+#define BLOCKS 8				/* ring of blocks between reader and workers */
+#define KMIN 64
+#define RING (4 * KMIN)			/* cumulative sums kept per level, power of two */
+#define LEVELS 40
+#define ALLAN_PER_OCTAVE 8
+#define MAX_K 64				/* cluster sizes per level */
+#define MAX_POINTS (LEVELS * ALLAN_PER_OCTAVE + 64)
+#define MAX_ERROR 0.25
+
+typedef struct
+{
+	double theta;
+	double ring[RING];
+	uint64_t n;
+	double pending;
+	uint8_t havePending;
+	double sum[MAX_K];
+	uint64_t count[MAX_K];
+} level_t;
+
+typedef struct
+{
+	level_t level[LEVELS];
+	double offset;
+	uint8_t haveOffset;
+	uint64_t samples;
+} channel_t;
+
+typedef struct
+{
+	float v[BLOCK][CHANNELS];
+	uint32_t n;
+	uint32_t users;
+} block_t;
+
+/* cluster sizes, in samples of their level */
+static uint32_t kBase[MAX_K], kBaseN;	/* level 0 */
+static uint32_t kHigh[MAX_K], kHighN;	/* levels 1.. */
+
+static channel_t channels[CHANNELS];
+static block_t blocks[BLOCKS];
+static uint64_t produced;				/* blocks filled */
+static uint8_t done;
+static uint32_t workers = CHANNELS;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t filled = PTHREAD_COND_INITIALIZER, freed = PTHREAD_COND_INITIALIZER;
+
+static const char *names[CHANNELS] = { "gx", "gy", "gz", "ax", "ay", "az" };
+
+static void sizes(void)
+{
+	uint32_t i, k, last = 0;
+
+	for (i = 0;; i++)
+	{
+		k = (uint32_t)lround(pow(2.0, (double)i / ALLAN_PER_OCTAVE));
+		if (k >= 2 * KMIN)
+		{
+			break;
+		}
+		if (k != last)
+		{
+			kBase[kBaseN++] = k;
+			if (k >= KMIN)
+			{
+				kHigh[kHighN++] = k;
+			}
+			last = k;
+		}
+	}
+}
+
+static void push(channel_t *c, uint32_t j, double y)
+{
+	level_t *l = &c->level[j];
+	const uint32_t *k = j ? kHigh : kBase;
+	uint32_t nk = j ? kHighN : kBaseN, i;
+	double now;
+
+	l->theta += y;
+	l->ring[l->n & (RING - 1)] = l->theta;
+	now = l->theta;
+	l->n++;
+
+	for (i = 0; i < nk; i++)
+	{
+		if (l->n > 2 * k[i])
+		{
+			double d = now - 2.0 * l->ring[(l->n - 1 - k[i]) & (RING - 1)] + l->ring[(l->n - 1 - 2 * k[i]) & (RING - 1)];
+
+			l->sum[i] += d * d;
+			l->count[i]++;
+		}
+	}
+
+	if (j + 1 < LEVELS)
+	{
+		if (l->havePending)
+		{
+			push(c, j + 1, 0.5 * (l->pending + y));
+			l->havePending = 0;
+		}
+		else
+		{
+			l->pending = y;
+			l->havePending = 1;
+		}
+	}
+}
+
+static void* worker(void *arg)
+{
+	uint32_t id = (uint32_t)(uintptr_t)arg, c, i;
+	uint64_t seq = 0;
+
+	for (;;)
+	{
+		block_t *b = &blocks[seq % BLOCKS];
+
+		pthread_mutex_lock(&lock);
+		while (produced <= seq && !done)
+		{
+			pthread_cond_wait(&filled, &lock);
+		}
+		if (produced <= seq)
+		{
+			pthread_mutex_unlock(&lock);
+			return NULL;
+		}
+		pthread_mutex_unlock(&lock);
+
+		for (c = id; c < CHANNELS; c += workers)
+		{
+			channel_t *ch = &channels[c];
+
+			if (!ch->haveOffset && b->n)
+			{
+				/* a constant does not change the variance, but keeps theta small */
+				ch->offset = b->v[0][c];
+				ch->haveOffset = 1;
+			}
+			for (i = 0; i < b->n; i++)
+			{
+				push(ch, 0, b->v[i][c] - ch->offset);
+			}
+			ch->samples += b->n;
+		}
+
+		pthread_mutex_lock(&lock);
+		if (--b->users == 0)
+		{
+			pthread_cond_broadcast(&freed);
+		}
+		pthread_mutex_unlock(&lock);
+		seq++;
+	}
+}
+
+/* next free block, NULL never */
+static block_t* take_block(void)
+{
+	block_t *b = &blocks[produced % BLOCKS];
+
+	pthread_mutex_lock(&lock);
+	while (b->users)
+	{
+		pthread_cond_wait(&freed, &lock);
+	}
+	pthread_mutex_unlock(&lock);
+	b->n = 0;
+
+	return b;
+}
+
+static void give_block(block_t *b)
+{
+	pthread_mutex_lock(&lock);
+	b->users = workers;
+	produced++;
+	pthread_cond_broadcast(&filled);
+	pthread_mutex_unlock(&lock);
+}
+
+/* print_motion7() line: t;ax;ay;az;gx;gy;gz;temp */
+static int parse(const char *line, double *t, float v[CHANNELS])
+{
+	float f[7];
+	char *end;
+	int i;
+
+	*t = strtod(line, &end);
+	for (i = 0; i < 7; i++)
+	{
+		if (*end != ';')
+		{
+			return 0;
+		}
+		f[i] = strtof(end + 1, &end);
+	}
+	v[0] = f[3];
+	v[1] = f[4];
+	v[2] = f[5];
+	v[3] = f[0];
+	v[4] = f[1];
+	v[5] = f[2];
+
+	return 1;
+}
+
+static uint64_t rng = 12345;
+
+static double gauss(void)
+{
+	double u1, u2;
+
+	rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+	u1 = ((rng >> 11) + 1.0) / 9007199254740993.0;
+	rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+	u2 = (rng >> 11) / 9007199254740992.0;
+
+	return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+/* ESKF defaults in main.c */
+static const double synthN[CHANNELS] = { 1.75e-4, 1.75e-4, 1.75e-4, 2.94e-3, 2.94e-3, 2.94e-3 };
+static const double synthK[CHANNELS] = { 1e-5, 1e-5, 1e-5, 1e-4, 1e-4, 1e-4 };
+
+static uint64_t read_input(FILE *in, double hours, double *rate)
+{
+	char line[256];
+	uint64_t n = 0, total = (uint64_t)(hours * 3600.0 * *rate);
+	double t, t0 = 0.0, t1 = 0.0, bias[CHANNELS] = { 0.0 };
+	block_t *b = take_block();
+	uint32_t c;
+
+	for (;;)
+	{
+		if (in)
+		{
+			if (!fgets(line, sizeof(line), in))
+			{
+				break;
+			}
+			if (!parse(line, &t, b->v[b->n]))
+			{
+				continue;
+			}
+			if (n == 0)
+			{
+				t0 = t;
+			}
+			t1 = t;
+		}
+		else
+		{
+			if (n == total)
+			{
+				break;
+			}
+			for (c = 0; c < CHANNELS; c++)
+			{
+				bias[c] += synthK[c] / sqrt(*rate) * gauss();
+				b->v[b->n][c] = (float)(bias[c] + synthN[c] * sqrt(*rate) * gauss());
+			}
+		}
+		n++;
+		if (++b->n == BLOCK)
+		{
+			give_block(b);
+			b = take_block();
+		}
+	}
+	if (b->n)
+	{
+		give_block(b);
+	}
+
+	pthread_mutex_lock(&lock);
+	done = 1;
+	pthread_cond_broadcast(&filled);
+	pthread_mutex_unlock(&lock);
+
+	if (in && *rate <= 0.0 && n > 1 && t1 > t0)
+	{
+		*rate = (n - 1) / (t1 - t0);
+	}
+	return n;
+}
+
+typedef struct
+{
+	double tau, adev, err;
+} point_t;
+
+/* deviation curve of one channel, sorted by tau */
+static uint32_t curve(const channel_t *c, double rate, point_t *p)
+{
+	uint32_t j, i, n = 0;
+
+	for (j = 0; j < LEVELS; j++)
+	{
+		const level_t *l = &c->level[j];
+		const uint32_t *k = j ? kHigh : kBase;
+		uint32_t nk = j ? kHighN : kBaseN;
+
+		for (i = 0; i < nk; i++)
+		{
+			double m = ldexp(k[i], j), clusters = c->samples / m;
+
+			if (l->count[i] == 0 || clusters < 3.0)
+			{
+				continue;
+			}
+			p[n].tau = m / rate;
+			p[n].adev = sqrt(l->sum[i] / (2.0 * (double)k[i] * k[i] * l->count[i]));
+			p[n].err = 1.0 / sqrt(2.0 * (clusters - 1.0));
+			n++;
+		}
+	}
+
+	return n;
+}
+
+typedef struct
+{
+	double N, B, K;
+	double tauN, tauB, tauK;
+} params_t;
+
+/* point whose local log-log slope is closest to s, -1 if none is usable */
+static int32_t slope_point(const point_t *p, uint32_t n, double s)
+{
+	double best = 1e9;
+	int32_t at = -1;
+	uint32_t i;
+
+	for (i = 1; i + 1 < n; i++)
+	{
+		double d;
+
+		if (p[i + 1].err > MAX_ERROR)
+		{
+			break;
+		}
+		d = fabs(log(p[i + 1].adev / p[i - 1].adev) / log(p[i + 1].tau / p[i - 1].tau) - s);
+		if (d < best)
+		{
+			best = d;
+			at = i;
+		}
+	}
+	return at;
+}
+
+static params_t extract(const point_t *p, uint32_t n)
+{
+	params_t r = { NAN, NAN, NAN, NAN, NAN, NAN };
+	int32_t i;
+	uint32_t k;
+
+	i = slope_point(p, n, -0.5);
+	if (i >= 0)
+	{
+		r.N = p[i].adev * sqrt(p[i].tau);
+		r.tauN = p[i].tau;
+	}
+
+	for (k = 0; k < n && p[k].err <= MAX_ERROR; k++)
+	{
+		if (isnan(r.B) || p[k].adev / 0.664 < r.B)
+		{
+			r.B = p[k].adev / 0.664;
+			r.tauB = p[k].tau;
+		}
+	}
+
+	i = slope_point(p, n, 0.5);
+	if (i >= 0 && log(p[i + 1].adev / p[i - 1].adev) > 0.0)
+	{
+		r.K = p[i].adev * sqrt(3.0 / p[i].tau);
+		r.tauK = p[i].tau;
+	}
+
+	return r;
+}
+
+static double mean3(const params_t *p, int which)
+{
+	double s = 0.0;
+	int i, n = 0;
+
+	for (i = 0; i < 3; i++)
+	{
+		double v = which == 0 ? p[i].N : p[i].K;
+
+		if (!isnan(v))
+		{
+			s += v;
+			n++;
+		}
+	}
+	return n ? s / n : NAN;
+}
+
+/* C float literal, 0 with a note when the term was not observed */
+static const char* literal(double v, char *buf)
+{
+	if (isnan(v))
+	{
+		return "0.0f /* not observed */";
+	}
+	sprintf(buf, "%.3ef", v);
+	return buf;
+}
+
+int main(int argc, char **argv)
+{
+	static point_t points[CHANNELS][MAX_POINTS];
+	uint32_t np[CHANNELS], i, c;
+	params_t par[CHANNELS];
+	pthread_t threads[CHANNELS];
+	double rate = 0.0, hours = 0.0, seconds;
+	struct timespec t0, t1;
+	uint64_t n;
+	FILE *in = stdin;
+	char buf[4][16];
+	int opt, quiet = 0;
+
+	while ((opt = getopt(argc, argv, "f:j:S:q")) != -1)
+	{
+		switch (opt)
+		{
+		case 'f':
+			rate = strtod(optarg, NULL);
+			break;
+		case 'j':
+			workers = strtoul(optarg, NULL, 10);
+			workers = workers < 1 ? 1 : (workers > CHANNELS ? CHANNELS : workers);
+			break;
+		case 'S':
+			hours = strtod(optarg, NULL);
+			break;
+		case 'q':
+			quiet = 1;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-f rate Hz] [-j threads] [-S hours] [-q] [log file]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (hours > 0.0)
+	{
+		in = NULL;
+		if (rate <= 0.0)
+		{
+			rate = 100.0;
+		}
+	}
+	else if (optind < argc && !(in = fopen(argv[optind], "r")))
+	{
+		perror(argv[optind]);
+		return 1;
+	}
+
+	sizes();
+	for (i = 0; i < workers; i++)
+	{
+		pthread_create(&threads[i], NULL, worker, (void*)(uintptr_t)i);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	n = read_input(in, hours, &rate);
+	for (i = 0; i < workers; i++)
+	{
+		pthread_join(threads[i], NULL);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	seconds = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+
+	if (n < 8 * KMIN || rate <= 0.0)
+	{
+		fprintf(stderr, "too few samples (%llu)\n", (unsigned long long)n);
+		return 1;
+	}
+
+	for (c = 0; c < CHANNELS; c++)
+	{
+		np[c] = curve(&channels[c], rate, points[c]);
+		par[c] = extract(points[c], np[c]);
+	}
+
+	printf("# %llu samples at %.3f Hz (%.2f h), %u threads, %.1f s, %.1f M samples/s\n", (unsigned long long)n, rate,
+			n / rate / 3600.0, workers, seconds, n / seconds * 1e-6);
+
+	if (!quiet)
+	{
+		printf("# tau s;adev gx;gy;gz rad/s;ax;ay;az m/s^2;rel error\n");
+		for (i = 0; i < np[0]; i++)
+		{
+			printf("%.6g", points[0][i].tau);
+			for (c = 0; c < CHANNELS; c++)
+			{
+				printf(";%.4e", points[c][i].adev);
+			}
+			printf(";%.3f\n", points[0][i].err);
+		}
+	}
+
+	printf("# axis: N /sqrt(Hz) at tau; B at tau; K /s/sqrt(Hz) at tau%s\n", hours > 0.0 ? "; synthetic N, K" : "");
+	for (c = 0; c < CHANNELS; c++)
+	{
+		printf("# %s: N %.3e (%.3g s)  B %.3e (%.3g s)  K %.3e (%.3g s)", names[c], par[c].N, par[c].tauN, par[c].B,
+				par[c].tauB, par[c].K, par[c].tauK);
+		if (hours > 0.0)
+		{
+			printf("  %.3e %.3e", synthN[c], synthK[c]);
+		}
+		printf("\n");
+	}
+
+	/* ready to paste into main.c */
+	printf("eskf_noise_t eskfNoise = { %s, %s, %s, %s };\n", literal(mean3(&par[0], 0), buf[0]),
+			literal(mean3(&par[3], 0), buf[1]), literal(mean3(&par[0], 1), buf[2]), literal(mean3(&par[3], 1), buf[3]));
+	printf("/* pdr_config_t sigmaAccel %.3ef, sigmaGyro %.3ef at %.0f Hz */\n", mean3(&par[3], 0) * sqrt(rate),
+			mean3(&par[0], 0) * sqrt(rate), rate);
+
+	if (in && in != stdin)
+	{
+		fclose(in);
+	}
+	return 0;
+}
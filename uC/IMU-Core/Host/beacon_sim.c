@@ -0,0 +1,223 @@
+/*
+ * beacon_sim.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Closed loop simulation of RSSI beacon ranging: beacons broadcast
+ *  through the simulated Si4463 (rf4463_sim.c), the unmodified driver
+ *  (rf4463.c) fetches packets and RSSI over the emulated SPI, beacon.c
+ *  turns them into ranges and fuses them into the ESKF that integrates
+ *  a synthetic IMU.
+ *
+ *  ./beacon_sim [-b x,y,z]... [-n path loss exp] [-s shadow dB]
+ *               [-P rssi at 1 m] [-r packets/s per beacon] [-c crc error rate]
+ *               [-t seconds] [-R radius] [-v speed] [-e initial error m]
+ *               [-B accel bias] [-S seed] [-x] [-q]
+ *
+ *  Without -b four beacons sit at the corners of a 20 x 20 m square,
+ *  2.5 m up. The receiver starts at rest and speeds up to -v m/s on a
+ *  circle of -R m around the centre, 1 m up, body level. The filter
+ *  starts -e m off in x and y. -x leaves the ranges out of the filter
+ *  to show the free inertial drift.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "eskf.h"
+#include "beacon.h"
+#include "rf4463.h"
+#include "rf4463_sim.h"
+#include "host_port.h"
+
+#define IMU_HZ 100.0
+#define RAMP_S 5.0
+
+static uint64_t rng = 12345;
+
+static double gauss(void)
+{
+	double u1, u2;
+
+	rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+	u1 = ((rng >> 11) + 1.0) / 9007199254740993.0;
+	rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+	u2 = (rng >> 11) / 9007199254740992.0;
+
+	return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static double uniform(void)
+{
+	rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+	return (rng >> 11) / 9007199254740992.0;
+}
+
+/* circle with speed ramping up as 1 - exp(-t / RAMP_S), from rest */
+static void truth(double t, double R, double V, const double c[3], double p[3], double a[3])
+{
+	double e = exp(-t / RAMP_S);
+	double th = V / R * (t - RAMP_S * (1.0 - e));
+	double th_d = V / R * (1.0 - e), th_dd = V / (R * RAMP_S) * e;
+	double ct = cos(th), st = sin(th);
+
+	/* start on the x axis of the circle, moving towards +y */
+	p[0] = c[0] + R * ct;
+	p[1] = c[1] + R * st;
+	p[2] = c[2];
+	a[0] = R * (-th_dd * st - th_d * th_d * ct);
+	a[1] = R * (th_dd * ct - th_d * th_d * st);
+	a[2] = 0.0;
+}
+
+int main(int argc, char **argv)
+{
+	eskf_noise_t noise = { 1.75e-4f, 2.94e-3f, 1e-5f, 1e-4f };
+	beacon_config_t cfg = { 2.5f, 4.0f, 0.5f, 200.0f, 9.0f };
+	float pos[BEACON_MAX][3];
+	uint32_t nb = 0, k, n, fuse = 1, quiet = 0, id;
+	double shadow = 4.0, rssi1m = -40.0, rate = 2.0, crcRate = 0.0, seconds = 120.0;
+	double R = 6.0, V = 1.0, err0 = 3.0, bias = 0.02, c[3] = { 0.0, 0.0, 1.0 };
+	double p[3], a[3], sum2 = 0.0, e2, last = 0.0, maxErr = 0.0;
+	uint32_t sumN = 0;
+	const eskf_state_t *x = ESKF_State();
+	const beacon_stats_t *bs = BEACON_Stats();
+	const rf_stats_t *rs = RF4463_Stats();
+	const rfsim_stats_t *ss = RFSIM_Stats();
+	int opt, ret;
+
+	while ((opt = getopt(argc, argv, "b:n:s:P:r:c:t:R:v:e:B:S:xq")) != -1)
+	{
+		switch (opt)
+		{
+			case 'b':
+				if (nb < BEACON_MAX && sscanf(optarg, "%f,%f,%f", &pos[nb][0], &pos[nb][1], &pos[nb][2]) == 3)
+				{
+					nb++;
+				}
+				break;
+			case 'n': cfg.pathLossExp = strtof(optarg, NULL); break;
+			case 's': shadow = atof(optarg); cfg.shadowDb = (float)shadow; break;
+			case 'P': rssi1m = atof(optarg); break;
+			case 'r': rate = atof(optarg); break;
+			case 'c': crcRate = atof(optarg); break;
+			case 't': seconds = atof(optarg); break;
+			case 'R': R = atof(optarg); break;
+			case 'v': V = atof(optarg); break;
+			case 'e': err0 = atof(optarg); break;
+			case 'B': bias = atof(optarg); break;
+			case 'S': rng = strtoull(optarg, NULL, 0); break;
+			case 'x': fuse = 0; break;
+			case 'q': quiet = 1; break;
+			default:
+				fprintf(stderr, "see the header of beacon_sim.c for options\n");
+				return 2;
+		}
+	}
+
+	if (nb == 0)
+	{
+		static const float corners[4][3] = { { 0, 0, 2.5f }, { 20, 0, 2.5f }, { 20, 20, 2.5f }, { 0, 20, 2.5f } };
+
+		memcpy(pos, corners, sizeof(corners));
+		nb = 4;
+	}
+	for (id = 0; id < nb; id++)
+	{
+		c[0] += pos[id][0] / nb;
+		c[1] += pos[id][1] / nb;
+	}
+
+	BEACON_Init(&cfg);
+	for (id = 0; id < nb; id++)
+	{
+		BEACON_Set(id, pos[id][0], pos[id][1], pos[id][2], 0.0f);
+	}
+
+	RFSIM_Reset();
+	RF4463_SetRxCallback(BEACON_OnPacket);
+	ret = RF4463_Init();
+	if (ret != 0)
+	{
+		fprintf(stderr, "RF4463_Init failed: %d\n", ret);
+		return 1;
+	}
+
+	ESKF_SetInitialSigma(0.01f, 0.1f, (float)(err0 > 0.1 ? err0 : 0.1), 0.01f, 0.1f);
+	ESKF_Init(&noise);
+	truth(0.0, R, V, c, p, a);
+	{
+		float p0[3] = { (float)(p[0] + err0), (float)(p[1] - err0), (float)p[2] };
+
+		ESKF_SetPosition(p0);
+	}
+
+	n = (uint32_t)(seconds * IMU_HZ);
+	for (k = 0; k < n; k++)
+	{
+		double t = k / IMU_HZ, tNext = (k + 1) / IMU_HZ;
+		float dt = (float)(1.0 / IMU_HZ);
+
+		/* IMU interrupt: level body, yaw 0, so f = a - g in nav axes */
+		truth(t, R, V, c, p, a);
+		ESKF_Predict((float)(0.0012 * gauss()), (float)(0.0012 * gauss()), (float)(0.0012 * gauss()),
+				(float)(a[0] + bias + 0.02 * gauss()), (float)(a[1] + 0.02 * gauss()),
+				(float)(a[2] + ESKF_GRAVITY + 0.02 * gauss()), dt);
+		if (fuse)
+		{
+			BEACON_Fuse();
+		}
+		HOST_AdvanceUs((uint32_t)(1e6 / IMU_HZ));
+
+		/* beacons due before the next sample, staggered evenly */
+		for (id = 0; id < nb; id++)
+		{
+			double phase = id / (rate * nb);
+
+			if (floor((tNext - phase) * rate) > floor((t - phase) * rate) && tNext > phase)
+			{
+				uint8_t pkt[RF4463_PACKET_LEN] = { 'B', 'N', (uint8_t)id, (uint8_t)k, (uint8_t)(int8_t)rssi1m };
+				double d[3] = { p[0] - pos[id][0], p[1] - pos[id][1], p[2] - pos[id][2] };
+				double dist = sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+				double rssi = rssi1m - 10.0 * cfg.pathLossExp * log10(dist > 0.1 ? dist : 0.1) + shadow * gauss();
+
+				/* 0.5 dB register steps */
+				RFSIM_Deliver(pkt, sizeof(pkt), (float)(floor(rssi * 2.0 + 0.5) * 0.5), uniform() >= crcRate);
+
+				/* main loop */
+				RF4463_Poll();
+			}
+		}
+
+		e2 = (x->p[0] - p[0]) * (x->p[0] - p[0]) + (x->p[1] - p[1]) * (x->p[1] - p[1]);
+		last = sqrt(e2);
+		if (t >= seconds / 2)
+		{
+			sum2 += e2;
+			sumN++;
+			if (last > maxErr)
+			{
+				maxErr = last;
+			}
+		}
+		if (!quiet && k % (uint32_t)(10 * IMU_HZ) == 0)
+		{
+			printf("%6.1f s truth %7.2f %7.2f est %7.2f %7.2f err %6.2f m\n", t, p[0], p[1], x->p[0], x->p[1], last);
+		}
+	}
+
+	printf("%s: horizontal error second half rms %.2f m max %.2f m, end %.2f m\n", fuse ? "ranging" : "inertial only",
+			sumN ? sqrt(sum2 / sumN) : 0.0, maxErr, last);
+	printf("beacon rx=%lu fused=%lu rejected=%lu stale=%lu dropped=%lu unknown=%lu\n",
+			(unsigned long)bs->packets, (unsigned long)bs->fused, (unsigned long)bs->rejected,
+			(unsigned long)bs->stale, (unsigned long)bs->dropped, (unsigned long)bs->unknown);
+	printf("rf irq=%lu rx=%lu crc=%lu cts=%lu missed=%lu, sim commands=%lu delivered=%lu not listening=%lu\n",
+			(unsigned long)rs->irqs, (unsigned long)rs->packets, (unsigned long)rs->crcErrors,
+			(unsigned long)rs->ctsTimeouts, (unsigned long)rs->missedIrqs, (unsigned long)ss->commands,
+			(unsigned long)ss->delivered, (unsigned long)ss->missed);
+
+	return 0;
+}
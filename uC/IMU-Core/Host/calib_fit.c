@@ -0,0 +1,520 @@
+/*
+ * calib_fit.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Host side of the calibration (calib.c): finds the six static accel
+ *  positions and the gyro bias in a motion log, fits the magnetometer
+ *  ellipsoid from a capture, prints the "calib set" commands for the
+ *  command channel and writes the record into a flash sector image the
+ *  same way the firmware does.
+ *
+ *  ./calib_fit [-f rate Hz] [-r accel range g] [-w gyro range dps]
+ *              [-m mag capture] [-i sector image] [-S] [motion log]
+ *
+ *  The motion log is in print_motion7() format and is turned back into
+ *  counts with the nominal scales of -r and -w (2 g, 250 dps). Still
+ *  stretches of at least 2 s are the positions; the longest one per
+ *  position is used. The mag capture has one "hx;hy;hz" line of counts
+ *  per sample. -i loads the sector image if it exists and saves it back.
+ *  -S runs on synthetic data with known errors and reports how well they
+ *  are recovered.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "calib.h"
+
+#define G_SI 9.807
+#define SECTOR (128 * 1024)
+#define MAX_MAG 20000
+
+static uint32_t sector[SECTOR / 4];
+static uint64_t rng = 12345;
+
+/* flash port on a RAM copy of the sector */
+uint32_t CALIB_PortSize(void)
+{
+	return SECTOR;
+}
+
+const void* CALIB_PortBase(void)
+{
+	return sector;
+}
+
+int32_t CALIB_PortErase(void)
+{
+	memset(sector, 0xFF, sizeof(sector));
+	return 0;
+}
+
+int32_t CALIB_PortWrite(uint32_t offset, const uint32_t *data, uint32_t words)
+{
+	uint32_t i;
+
+	for (i = 0; i < words; i++)
+	{
+		/* flash only clears bits */
+		sector[offset / 4 + i] &= data[i];
+	}
+	return 0;
+}
+
+/* the STM32 CRC unit: CRC-32 polynomial, init all ones, word wise MSB first, no reflection or final xor */
+uint32_t CALIB_PortCrc(const uint32_t *data, uint32_t words)
+{
+	uint32_t crc = 0xFFFFFFFFu, i;
+	int b;
+
+	for (i = 0; i < words; i++)
+	{
+		crc ^= data[i];
+		for (b = 0; b < 32; b++)
+		{
+			crc = (crc & 0x80000000u) ? (crc << 1) ^ 0x04C11DB7u : crc << 1;
+		}
+	}
+	return crc;
+}
+
+static double gauss(void)
+{
+	double u1, u2;
+
+	rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+	u1 = ((rng >> 11) + 1.0) / 9007199254740993.0;
+	rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+	u2 = (rng >> 11) / 9007199254740992.0;
+
+	return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+typedef struct
+{
+	double perG, perRad;	/* counts */
+	double rate;
+	/* still detection over 1 s windows */
+	uint32_t win, n;
+	double s[6], ss[6];
+	/* current still stretch */
+	uint32_t runWin;
+	double runSum[6];
+	/* results */
+	uint32_t best[6];
+	float pos[6][3];
+	double gyroSum[3];
+	uint32_t gyroN;
+} finder_t;
+
+static void finder_close_run(finder_t *f)
+{
+	float mean[3];
+	double best = 0.0;
+	int i, axis = 0, p;
+
+	if (f->runWin >= 2)
+	{
+		for (i = 0; i < 3; i++)
+		{
+			mean[i] = (float)(f->runSum[i] / (f->runWin * f->win));
+			if (fabs(mean[i]) > best)
+			{
+				best = fabs(mean[i]);
+				axis = i;
+			}
+			f->gyroSum[i] += f->runSum[3 + i];
+		}
+		f->gyroN += f->runWin * f->win;
+
+		p = 2 * axis + (mean[axis] < 0.0f);
+		if (best > 0.8 * f->perG && f->runWin > f->best[p])
+		{
+			f->best[p] = f->runWin;
+			memcpy(f->pos[p], mean, sizeof(mean));
+		}
+	}
+	f->runWin = 0;
+	memset(f->runSum, 0, sizeof(f->runSum));
+}
+
+/* one sample in counts: accel 0..2, gyro 3..5 */
+static void finder_add(finder_t *f, const double c[6])
+{
+	double sdA = 0.0, sdG = 0.0, m;
+	int i;
+
+	for (i = 0; i < 6; i++)
+	{
+		f->s[i] += c[i];
+		f->ss[i] += c[i] * c[i];
+	}
+	if (++f->n < f->win)
+	{
+		return;
+	}
+
+	for (i = 0; i < 6; i++)
+	{
+		m = f->s[i] / f->n;
+		m = sqrt(fmax(f->ss[i] / f->n - m * m, 0.0));
+		if (i < 3)
+		{
+			sdA = fmax(sdA, m);
+		}
+		else
+		{
+			sdG = fmax(sdG, m);
+		}
+	}
+
+	/* still: accel scatter under CALIB_STILL_COUNTS, gyro under 0.02 rad/s */
+	if (sdA < CALIB_STILL_COUNTS && sdG < 0.02 * f->perRad)
+	{
+		f->runWin++;
+		for (i = 0; i < 6; i++)
+		{
+			f->runSum[i] += f->s[i];
+		}
+	}
+	else
+	{
+		finder_close_run(f);
+	}
+
+	f->n = 0;
+	memset(f->s, 0, sizeof(f->s));
+	memset(f->ss, 0, sizeof(f->ss));
+}
+
+/* synthetic sensor errors */
+static const double trueK[3][3] = { { 1.02, 0.004, -0.006 }, { -0.003, 0.985, 0.008 }, { 0.005, -0.002, 1.011 } };
+static const double trueB[3] = { 180.0, -95.0, 310.0 };
+static const double trueGyroB[3] = { 35.0, -22.0, 12.0 };
+static const double trueSoft[3][3] = { { 1.10, 0.05, -0.02 }, { 0.05, 0.92, 0.03 }, { -0.02, 0.03, 1.04 } };
+static const double trueHard[3] = { 85.0, -140.0, 40.0 };
+
+static void synth_log(finder_t *f)
+{
+	static const int up[6][3] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+	double c[6], a[3];
+	uint32_t p, k;
+	int i, j;
+
+	for (p = 0; p < 6; p++)
+	{
+		/* 4 s still, placed within 0.5 deg, then 2 s of handling */
+		double tilt = 0.0087 * gauss();
+
+		for (k = 0; k < (uint32_t)(6.0 * f->rate); k++)
+		{
+			int moving = k >= (uint32_t)(4.0 * f->rate);
+
+			for (i = 0; i < 3; i++)
+			{
+				a[i] = up[p][i] + (i == (p / 2 + 1) % 3 ? tilt : 0.0);
+			}
+			for (i = 0; i < 3; i++)
+			{
+				c[i] = trueB[i] + 8.0 * gauss();
+				for (j = 0; j < 3; j++)
+				{
+					c[i] += trueK[i][j] * a[j] * f->perG;
+				}
+				c[3 + i] = trueGyroB[i] + 5.0 * gauss() + (moving ? 0.5 * f->perRad * sin(k * 0.05 + i) : 0.0);
+				if (moving)
+				{
+					c[i] += 0.2 * f->perG * sin(k * 0.07 + i);
+				}
+			}
+			finder_add(f, c);
+		}
+	}
+}
+
+static uint32_t synth_mag(float sums[], double radius)
+{
+	uint32_t k, n = 3000;
+	int16_t raw[3];
+	double u[3], l;
+	int i;
+
+	for (k = 0; k < n; k++)
+	{
+		do
+		{
+			for (i = 0; i < 3; i++)
+			{
+				u[i] = gauss();
+			}
+			l = sqrt(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+		} while (l < 1e-6);
+
+		for (i = 0; i < 3; i++)
+		{
+			double v = trueHard[i] + 1.5 * gauss();
+
+			v += radius * (trueSoft[i][0] * u[0] + trueSoft[i][1] * u[1] + trueSoft[i][2] * u[2]) / l;
+			raw[i] = (int16_t)lround(v);
+		}
+		CALIB_EllipsoidAdd(sums, raw);
+	}
+
+	return n;
+}
+
+static void print_set(const char *name, const calib_axis3_t *c)
+{
+	printf("calib set %s %.6f %.6f %.6f %.6f %.6f %.6f %.6f %.6f %.6f %.3f %.3f %.3f\n", name,
+			c->M[0][0], c->M[0][1], c->M[0][2], c->M[1][0], c->M[1][1], c->M[1][2],
+			c->M[2][0], c->M[2][1], c->M[2][2], c->b[0], c->b[1], c->b[2]);
+}
+
+/* largest difference between the fixed point correction and the float model, Q4 counts */
+static double fixed_error(uint32_t s, const calib_axis3_t *c)
+{
+	double worst = 0.0, ref;
+	int16_t raw[3];
+	int32_t out[3];
+	uint32_t k;
+	int i;
+
+	for (k = 0; k < 10000; k++)
+	{
+		for (i = 0; i < 3; i++)
+		{
+			raw[i] = (int16_t)(20000.0 * (2.0 * (k * 2654435761u % 65536) / 65536.0 - 1.0) * (i + 1) / 3.0);
+		}
+		CALIB_Correct(s, raw, out);
+		for (i = 0; i < 3; i++)
+		{
+			ref = 16.0 * (c->M[i][0] * (raw[0] - c->b[0]) + c->M[i][1] * (raw[1] - c->b[1]) + c->M[i][2] * (raw[2] - c->b[2]));
+			worst = fmax(worst, fabs(out[i] - ref));
+		}
+	}
+
+	return worst;
+}
+
+int main(int argc, char **argv)
+{
+	finder_t f;
+	double range = 2.0, dps = 250.0, c[6];
+	float sums[CALIB_ELLIPSOID_SUMS] = { 0 }, t, a[3], g[3], temp, res;
+	const char *magName = NULL, *image = NULL;
+	calib_axis3_t acc, gyr, mag;
+	uint32_t magN = 0, p;
+	int synthetic = 0, opt, i, j;
+	char line[256];
+	FILE *in;
+
+	memset(&f, 0, sizeof(f));
+	f.rate = 100.0;
+
+	while ((opt = getopt(argc, argv, "f:r:w:m:i:S")) != -1)
+	{
+		switch (opt)
+		{
+			case 'f': f.rate = atof(optarg); break;
+			case 'r': range = atof(optarg); break;
+			case 'w': dps = atof(optarg); break;
+			case 'm': magName = optarg; break;
+			case 'i': image = optarg; break;
+			case 'S': synthetic = 1; break;
+			default:
+				fprintf(stderr, "see the header of calib_fit.c for options\n");
+				return 2;
+		}
+	}
+
+	f.perG = 32767.5 / range;
+	f.perRad = 32767.5 / (dps * M_PI / 180.0);
+	f.win = (uint32_t)f.rate;
+
+	CALIB_PortErase();
+	if (image && (in = fopen(image, "rb")) != NULL)
+	{
+		if (fread(sector, 1, sizeof(sector), in) != sizeof(sector))
+		{
+			fprintf(stderr, "%s: short image, starting erased\n", image);
+			CALIB_PortErase();
+		}
+		fclose(in);
+	}
+	printf("flash: %s\n", CALIB_Init((float)f.perG, (float)f.perRad) == 0 ? "record loaded" : "no record");
+
+	/* accel positions and gyro bias */
+	if (synthetic)
+	{
+		synth_log(&f);
+	}
+	else if (optind < argc)
+	{
+		in = fopen(argv[optind], "r");
+		if (!in)
+		{
+			perror(argv[optind]);
+			return 1;
+		}
+		while (fgets(line, sizeof(line), in))
+		{
+			if (sscanf(line, "%f;%f;%f;%f;%f;%f;%f;%f", &t, &a[0], &a[1], &a[2], &g[0], &g[1], &g[2], &temp) == 8)
+			{
+				for (i = 0; i < 3; i++)
+				{
+					c[i] = a[i] / G_SI * f.perG;
+					c[3 + i] = g[i] * f.perRad;
+				}
+				finder_add(&f, c);
+			}
+		}
+		fclose(in);
+	}
+	finder_close_run(&f);
+
+	for (p = 0; p < 6; p++)
+	{
+		printf("position %c%c: %s\n", "+-"[p & 1], "xyz"[p / 2], f.best[p] ? "found" : "missing");
+	}
+	if (f.gyroN)
+	{
+		gyr = (calib_axis3_t){ { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } }, { 0, 0, 0 } };
+		for (i = 0; i < 3; i++)
+		{
+			gyr.b[i] = (float)(f.gyroSum[i] / f.gyroN);
+		}
+		CALIB_Set(CALIB_GYRO, &gyr);
+		print_set("gyro", &gyr);
+		printf("  fixed point error %.2f/16 counts\n", fixed_error(CALIB_GYRO, &gyr));
+	}
+	if (f.best[0] && f.best[1] && f.best[2] && f.best[3] && f.best[4] && f.best[5])
+	{
+		if (CALIB_FitAccel(f.pos, (float)f.perG, &acc, &res) == 0)
+		{
+			CALIB_Set(CALIB_ACCEL, &acc);
+			print_set("accel", &acc);
+			printf("  residual %.1f counts, fixed point error %.2f/16 counts\n", res, fixed_error(CALIB_ACCEL, &acc));
+		}
+	}
+
+	/* magnetometer */
+	if (synthetic)
+	{
+		magN = synth_mag(sums, 300.0);
+	}
+	else if (magName)
+	{
+		int hx, hy, hz;
+		int16_t raw[3];
+
+		in = fopen(magName, "r");
+		if (!in)
+		{
+			perror(magName);
+			return 1;
+		}
+		while (fgets(line, sizeof(line), in) && magN < MAX_MAG)
+		{
+			if (sscanf(line, "%d;%d;%d", &hx, &hy, &hz) == 3)
+			{
+				raw[0] = (int16_t)hx;
+				raw[1] = (int16_t)hy;
+				raw[2] = (int16_t)hz;
+				CALIB_EllipsoidAdd(sums, raw);
+				magN++;
+			}
+		}
+		fclose(in);
+	}
+	if (magN)
+	{
+		int32_t ret = CALIB_FitEllipsoid(sums, magN, &mag);
+
+		printf("mag fit %d from %u samples\n", (int)ret, (unsigned)magN);
+		if (ret == 0)
+		{
+			CALIB_Set(CALIB_MAG, &mag);
+			print_set("mag", &mag);
+		}
+	}
+
+	if (synthetic)
+	{
+		/* accel: M K should be the identity; mag: M S should be a scaled rotation, M S (M S)' = r^2 I */
+		double e = 0.0, ms[3][3], r2 = 0.0, dev = 0.0;
+		int k;
+
+		for (i = 0; i < 3; i++)
+		{
+			for (j = 0; j < 3; j++)
+			{
+				double v = 0.0;
+
+				for (k = 0; k < 3; k++)
+				{
+					v += acc.M[i][k] * trueK[k][j];
+				}
+				e = fmax(e, fabs(v - (i == j)));
+				ms[i][j] = 0.0;
+			}
+		}
+		printf("truth: accel |M K - I| max %.2e, offset error %.1f %.1f %.1f counts, gyro bias error %.1f %.1f %.1f counts\n",
+				e, acc.b[0] - trueB[0], acc.b[1] - trueB[1], acc.b[2] - trueB[2],
+				gyr.b[0] - trueGyroB[0], gyr.b[1] - trueGyroB[1], gyr.b[2] - trueGyroB[2]);
+
+		for (i = 0; i < 3; i++)
+		{
+			for (j = 0; j < 3; j++)
+			{
+				for (k = 0; k < 3; k++)
+				{
+					ms[i][j] += mag.M[i][k] * trueSoft[k][j];
+				}
+			}
+		}
+		for (i = 0; i < 3; i++)
+		{
+			for (j = 0; j < 3; j++)
+			{
+				double v = 0.0;
+
+				for (k = 0; k < 3; k++)
+				{
+					v += ms[i][k] * ms[j][k];
+				}
+				if (i == 0 && j == 0)
+				{
+					r2 = v;
+				}
+				dev = fmax(dev, fabs(v / r2 - (i == j)));
+			}
+		}
+		printf("truth: mag hard iron error %.1f %.1f %.1f counts, soft iron non-orthogonality %.2e\n",
+				mag.b[0] - trueHard[0], mag.b[1] - trueHard[1], mag.b[2] - trueHard[2], dev);
+	}
+
+	/* store, reload, compare */
+	if (CALIB_Save() != 0)
+	{
+		fprintf(stderr, "save failed\n");
+		return 1;
+	}
+	{
+		calib_coeffs_t saved = *CALIB_Coeffs();
+
+		CALIB_Init((float)f.perG, (float)f.perRad);
+		printf("flash: record %lu saved, reload %s\n", (unsigned long)CALIB_Stats()->loadSeq,
+				memcmp(&saved, CALIB_Coeffs(), sizeof(saved)) == 0 ? "matches" : "DIFFERS");
+	}
+	if (image && (in = fopen(image, "wb")) != NULL)
+	{
+		fwrite(sector, 1, sizeof(sector), in);
+		fclose(in);
+	}
+
+	return 0;
+}
@@ -0,0 +1,210 @@
+/*
+ * decim_design.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Designs the decimation filters of decim.c and writes them as
+ *  Inc/decim_coeffs.h. Kaiser windowed sinc, odd length (integer group
+ *  delay), taps sized from the Kaiser formula for the attenuation and
+ *  transition of each design. The stopband of every design starts at
+ *  the output rate minus its passband edge, so what folds back lands
+ *  above the passband instead of in it.
+ *
+ *  ./decim_design [-o header]
+ *
+ *  Stage 1 (8 kHz to 1 kHz) is quantised to Q15. Stage 2 stays in float,
+ *  two designs per output rate: "flat" passes 0.4 of the output rate,
+ *  "fast" passes 0.2 with a much shorter filter and delay. The measured
+ *  passband ripple and stopband attenuation of each design go to stdout.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define FS1 8000.0
+#define FS2 1000.0
+
+typedef struct
+{
+	const char *name;
+	double outHz;
+	double pass;		/* fraction of the output rate */
+	double atten;		/* dB */
+} design_t;
+
+static const design_t stage2[] = {
+	{ "flat", 500.0, 0.4, 60.0 }, { "fast", 500.0, 0.2, 50.0 },
+	{ "flat", 250.0, 0.4, 60.0 }, { "fast", 250.0, 0.2, 50.0 },
+	{ "flat", 200.0, 0.4, 60.0 }, { "fast", 200.0, 0.2, 50.0 },
+	{ "flat", 100.0, 0.4, 60.0 }, { "fast", 100.0, 0.2, 50.0 },
+	{ "flat", 50.0, 0.4, 50.0 }, { "fast", 50.0, 0.2, 50.0 },
+};
+
+static double bessel_i0(double x)
+{
+	double s = 1.0, t = 1.0;
+	int k;
+
+	for (k = 1; k < 50; k++)
+	{
+		t *= (x / (2.0 * k)) * (x / (2.0 * k));
+		s += t;
+	}
+	return s;
+}
+
+/* fills h (DC gain 1), returns the number of taps */
+static int kaiser(double fs, double pass, double stop, double atten, double *h, int max)
+{
+	double dw = 2.0 * M_PI * (stop - pass) / fs, fc = 0.5 * (pass + stop) / fs, beta, sum = 0.0;
+	int n = (int)ceil((atten - 8.0) / (2.285 * dw)) + 1, k;
+
+	n |= 1;
+	if (n > max)
+	{
+		fprintf(stderr, "%d taps needed, %d max\n", n, max);
+		exit(1);
+	}
+
+	beta = atten > 50.0 ? 0.1102 * (atten - 8.7) : 0.5842 * pow(atten - 21.0, 0.4) + 0.07886 * (atten - 21.0);
+	for (k = 0; k < n; k++)
+	{
+		double x = k - 0.5 * (n - 1), r = 2.0 * x / (n - 1);
+
+		h[k] = (x == 0.0 ? 2.0 * fc : sin(2.0 * M_PI * fc * x) / (M_PI * x)) * bessel_i0(beta * sqrt(1.0 - r * r)) / bessel_i0(beta);
+		sum += h[k];
+	}
+	for (k = 0; k < n; k++)
+	{
+		/* the zeros of the sinc, not rounding noise */
+		h[k] = fabs(h[k] / sum) < 1e-12 ? 0.0 : h[k] / sum;
+	}
+	return n;
+}
+
+static double gain(const double *h, int n, double f, double fs)
+{
+	double re = 0.0, im = 0.0;
+	int k;
+
+	for (k = 0; k < n; k++)
+	{
+		re += h[k] * cos(2.0 * M_PI * f * k / fs);
+		im -= h[k] * sin(2.0 * M_PI * f * k / fs);
+	}
+	return sqrt(re * re + im * im);
+}
+
+/* largest passband deviation and smallest stopband attenuation, dB */
+static void measure(const double *h, int n, double fs, double pass, double stop, double *ripple, double *atten)
+{
+	double f, g, lo = 1.0, hi = 1.0, sb = 0.0;
+
+	for (f = 0.0; f <= pass; f += pass / 200.0)
+	{
+		g = gain(h, n, f, fs);
+		lo = fmin(lo, g);
+		hi = fmax(hi, g);
+	}
+	for (f = stop; f <= 0.5 * fs; f += (0.5 * fs - stop) / 2000.0)
+	{
+		sb = fmax(sb, gain(h, n, f, fs));
+	}
+	*ripple = 20.0 * log10(hi / lo);
+	*atten = -20.0 * log10(sb);
+}
+
+int main(int argc, char **argv)
+{
+	static double h[1024];
+	const char *path = "../Inc/decim_coeffs.h";
+	double pass1 = 0.0, ripple, atten;
+	FILE *out;
+	int n, k, opt;
+	size_t d;
+
+	while ((opt = getopt(argc, argv, "o:")) != -1)
+	{
+		if (opt == 'o')
+		{
+			path = optarg;
+		}
+		else
+		{
+			fprintf(stderr, "usage: %s [-o header]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	out = fopen(path, "w");
+	if (!out)
+	{
+		perror(path);
+		return 1;
+	}
+
+	fprintf(out, "/*\n * decim_coeffs.h\n *\n *  Created on: 18 Oct 2026\n *\n"
+			" *  Generated by Host/decim_design, do not edit. Symmetric, so the\n"
+			" *  time reversed order CMSIS expects is the same as the natural one.\n */\n\n"
+			"#ifndef DECIM_COEFFS_H_\n#define DECIM_COEFFS_H_\n\n#include \"decim.h\"\n\n");
+
+	/* stage 1 must keep the widest stage 2 passband */
+	for (d = 0; d < sizeof(stage2) / sizeof(stage2[0]); d++)
+	{
+		pass1 = fmax(pass1, stage2[d].pass * stage2[d].outHz);
+	}
+	n = kaiser(FS1, pass1, FS2 - pass1, 70.0, h, 1024);
+	for (k = 0; k < n; k++)
+	{
+		/* measured as quantised */
+		h[k] = lrint(h[k] * 32768.0) / 32768.0;
+	}
+	measure(h, n, FS1, pass1, FS2 - pass1, &ripple, &atten);
+	printf("stage 1: %d taps, pass %.0f Hz ripple %.3f dB, stop %.0f Hz atten %.1f dB\n", n, pass1, ripple,
+			FS2 - pass1, atten);
+
+	fprintf(out, "/* %.0f Hz to %.0f Hz, pass %.0f Hz, stop %.0f Hz, %.1f dB */\n", FS1, FS2, pass1, FS2 - pass1, atten);
+	fprintf(out, "#define DECIM_STAGE1_TAPS %d\n\nstatic const q15_t decimStage1[DECIM_STAGE1_TAPS] = {", n);
+	for (k = 0; k < n; k++)
+	{
+		fprintf(out, "%s%ld,", k % 12 ? " " : "\n\t", lrint(h[k] * 32768.0));
+	}
+	fprintf(out, "\n};\n\n");
+
+	for (d = 0; d < sizeof(stage2) / sizeof(stage2[0]); d++)
+	{
+		const design_t *s = &stage2[d];
+		double pass = s->pass * s->outHz, stop = s->outHz - pass;
+
+		n = kaiser(FS2, pass, stop, s->atten, h, 1024);
+		measure(h, n, FS2, pass, stop, &ripple, &atten);
+		printf("%s %3.0f Hz: %3d taps, delay %5.1f ms, pass %5.1f Hz ripple %.3f dB, stop %5.1f Hz atten %.1f dB\n",
+				s->name, s->outHz, n, 0.5 * (n - 1) / FS2 * 1e3, pass, ripple, stop, atten);
+
+		fprintf(out, "/* %s, %.0f Hz out, pass %.0f Hz, stop %.0f Hz, %.1f dB */\n", s->name, s->outHz, pass, stop, atten);
+		fprintf(out, "static const float32_t decim%s%.0f[%d] = {", s->name, s->outHz, n);
+		for (k = 0; k < n; k++)
+		{
+			fprintf(out, "%s%.8ef,", k % 6 ? " " : "\n\t", h[k]);
+		}
+		fprintf(out, "\n};\n\n");
+	}
+
+	fprintf(out, "static const decim_design_t decimDesigns[] = {\n");
+	for (d = 0; d < sizeof(stage2) / sizeof(stage2[0]); d++)
+	{
+		const design_t *s = &stage2[d];
+		double pass = s->pass * s->outHz;
+
+		n = kaiser(FS2, pass, s->outHz - pass, s->atten, h, 1024);
+		fprintf(out, "\t{ \"%s\", %.0f, %d, %d, %.1ff, decim%s%.0f },\n", s->name, s->outHz, (int)(FS2 / s->outHz), n,
+				pass, s->name, s->outHz);
+	}
+	fprintf(out, "};\n\n#endif /* DECIM_COEFFS_H_ */\n");
+
+	fclose(out);
+	return 0;
+}
@@ -0,0 +1,145 @@
+/*
+ * eskf_replay.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Replays a recorded motion log through the firmware ESKF (eskf.c,
+ *  dsp_port.c) and prints the navigation solution.
+ *
+ *  ./eskf_replay [-a align samples] [-f rate Hz] [-z zupt variance]
+ *                [-o output every n samples] [log file]
+ *
+ *  Input is the print_motion7() format, one sample per line:
+ *  time s;ax;ay;az m/s^2;gx;gy;gz rad/s;temp. The log is read from stdin
+ *  without a file argument. The first -a samples must be at rest: they
+ *  level the filter and seed the gyro bias. With -z, a zero velocity
+ *  measurement is applied to every sample that looks static, which keeps
+ *  a bench log bounded and lets the biases converge.
+ *  Output: time;px;py;pz;vx;vy;vz;roll;pitch;yaw (deg).
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "eskf.h"
+
+#define STATIC_ACCEL_TOL 0.3f	/* m/s^2 off gravity */
+#define STATIC_GYRO_TOL 0.05f	/* rad/s */
+
+static int read_sample(FILE *in, float *t, float a[3], float g[3])
+{
+	char line[256];
+	float temp;
+
+	while (fgets(line, sizeof(line), in))
+	{
+		if (sscanf(line, "%f;%f;%f;%f;%f;%f;%f;%f", t, &a[0], &a[1], &a[2], &g[0], &g[1], &g[2], &temp) == 8)
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	eskf_noise_t noise = { 0.005f, 0.05f, 1e-5f, 1e-3f };
+	uint32_t alignN = 100, every = 10, rate = 100, n = 0, zupts = 0;
+	float zuptVar = 0.0f, t, tPrev = 0.0f, a[3], g[3], aSum[3] = { 0 }, gSum[3] = { 0 };
+	const eskf_state_t *x;
+	FILE *in = stdin;
+	int opt, i;
+
+	while ((opt = getopt(argc, argv, "a:f:z:o:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'a': alignN = strtoul(optarg, NULL, 0); break;
+			case 'f': rate = strtoul(optarg, NULL, 0); break;
+			case 'z': zuptVar = strtof(optarg, NULL); break;
+			case 'o': every = strtoul(optarg, NULL, 0); break;
+			default:
+				fprintf(stderr, "see the header of eskf_replay.c for options\n");
+				return 2;
+		}
+	}
+	if (optind < argc && !(in = fopen(argv[optind], "r")))
+	{
+		perror(argv[optind]);
+		return 1;
+	}
+
+	ESKF_Init(&noise);
+
+	/* coarse alignment */
+	for (n = 0; n < alignN && read_sample(in, &t, a, g); n++)
+	{
+		for (i = 0; i < 3; i++)
+		{
+			aSum[i] += a[i];
+			gSum[i] += g[i];
+		}
+		tPrev = t;
+	}
+	if (n == 0)
+	{
+		fprintf(stderr, "no samples\n");
+		return 1;
+	}
+	ESKF_AlignFromAccel(aSum[0] / n, aSum[1] / n, aSum[2] / n);
+	for (i = 0; i < 3; i++)
+	{
+		gSum[i] /= n;
+	}
+	ESKF_SetGyroBias(gSum);
+
+	x = ESKF_State();
+	n = 0;
+
+	while (read_sample(in, &t, a, g))
+	{
+		float dt = t - tPrev;
+		float an = sqrtf(a[0] * a[0] + a[1] * a[1] + a[2] * a[2]);
+		float gn = sqrtf(g[0] * g[0] + g[1] * g[1] + g[2] * g[2]);
+
+		/* the log time has 1 ms resolution, fall back to the nominal rate on gaps */
+		if (dt <= 0.0f || dt > 1.0f)
+		{
+			dt = 1.0f / rate;
+		}
+		tPrev = t;
+
+		ESKF_Predict(g[0], g[1], g[2], a[0], a[1], a[2], dt);
+
+		if (zuptVar > 0.0f && fabsf(an - ESKF_GRAVITY) < STATIC_ACCEL_TOL && gn < STATIC_GYRO_TOL)
+		{
+			static const uint8_t idx[3] = { ESKF_VEL, ESKF_VEL + 1, ESKF_VEL + 2 };
+			float y[3] = { -x->v[0], -x->v[1], -x->v[2] };
+			float r[3] = { zuptVar, zuptVar, zuptVar };
+
+			ESKF_UpdateSelect(idx, y, r, 3);
+			zupts++;
+		}
+
+		if (every && (n++ % every) == 0)
+		{
+			const float *q = x->q;
+			float roll = atan2f(2.0f * (q[0] * q[1] + q[2] * q[3]), 1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2]));
+			float pitch = asinf(fmaxf(-1.0f, fminf(1.0f, 2.0f * (q[0] * q[2] - q[3] * q[1]))));
+			float yaw = atan2f(2.0f * (q[0] * q[3] + q[1] * q[2]), 1.0f - 2.0f * (q[2] * q[2] + q[3] * q[3]));
+
+			printf("%.3f;%.4f;%.4f;%.4f;%.4f;%.4f;%.4f;%.2f;%.2f;%.2f\n", t,
+					x->p[0], x->p[1], x->p[2], x->v[0], x->v[1], x->v[2],
+					roll * 57.29578f, pitch * 57.29578f, yaw * 57.29578f);
+		}
+	}
+
+	fprintf(stderr, "%lu samples, %lu zero velocity updates\n", (unsigned long)n, (unsigned long)zupts);
+	fprintf(stderr, "bg=%.5f %.5f %.5f ba=%.4f %.4f %.4f\n",
+			x->bg[0], x->bg[1], x->bg[2], x->ba[0], x->ba[1], x->ba[2]);
+
+	return 0;
+}
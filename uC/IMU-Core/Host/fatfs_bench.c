@@ -0,0 +1,144 @@
+/*
+ * fatfs_bench.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Runs the firmware logging stack (FatFs + log_session + disk_stats) on a
+ *  RAM disk or a disk image with a card latency profile and reports how
+ *  long the sample path can be blocked, i.e. how much buffering the
+ *  acquisition side needs for a given part size, cluster size and sync
+ *  policy. All latencies are in virtual time, see host_port.h.
+ *
+ *  ./fatfs_bench [-d ram|<image file>] [-P none|fast|sd] [-s sectors]
+ *                [-c cluster bytes] [-r record bytes] [-f rate Hz]
+ *                [-t seconds] [-p part bytes] [-m part ms] [-y sync ms]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ff_gen_drv.h"
+#include "ram_diskio.h"
+#include "image_diskio.h"
+#include "disk_stats.h"
+#include "log_session.h"
+#include "host_port.h"
+
+int main(int argc, char **argv)
+{
+	const char *disk = "ram", *profileName = "sd";
+	uint32_t sectors = 131072, cluster = 0, recordBytes = 32, rate = 1000, seconds = 60;
+	log_config_t cfg = { 0, 4 * 1024 * 1024, 0, 1000 };
+	const image_profile_t *profile;
+	uint8_t *ram = NULL, record[256];
+	uint64_t t0, t1, start, maxWriteUs = 0, maxPollUs = 0, totalUs;
+	uint32_t i, n, period;
+	char path[4];
+	FATFS fs;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "d:P:s:c:r:f:t:p:m:y:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'd': disk = optarg; break;
+			case 'P': profileName = optarg; break;
+			case 's': sectors = strtoul(optarg, NULL, 0); break;
+			case 'c': cluster = strtoul(optarg, NULL, 0); break;
+			case 'r': recordBytes = strtoul(optarg, NULL, 0); break;
+			case 'f': rate = strtoul(optarg, NULL, 0); break;
+			case 't': seconds = strtoul(optarg, NULL, 0); break;
+			case 'p': cfg.maxBytes = strtoul(optarg, NULL, 0); break;
+			case 'm': cfg.maxMs = strtoul(optarg, NULL, 0); break;
+			case 'y': cfg.syncMs = strtoul(optarg, NULL, 0); break;
+			default:
+				fprintf(stderr, "see the header of fatfs_bench.c for options\n");
+				return 2;
+		}
+	}
+
+	if (recordBytes < 8 || recordBytes > sizeof(record) || rate == 0)
+	{
+		fprintf(stderr, "record size must be 8..%u bytes, rate > 0\n", (unsigned)sizeof(record));
+		return 2;
+	}
+
+	if (strcmp(disk, "ram") == 0)
+	{
+		ram = calloc(sectors, RAMDISK_SECTOR_SIZE);
+		RAMDISK_Setup(ram, sectors);
+		FATFS_LinkDriver(&RAMDISK_Driver, path);
+	}
+	else
+	{
+		profile = IMAGE_Profile(profileName);
+		if (!profile || IMAGE_Open(disk, sectors, profile) != 0)
+		{
+			fprintf(stderr, "cannot open %s with profile %s\n", disk, profileName);
+			return 1;
+		}
+		FATFS_LinkDriver(&IMAGE_Driver, path);
+	}
+
+	/* f_mkfs needs the work area registered, the actual mount follows */
+	if (f_mount(&fs, path, 0) != FR_OK || f_mkfs(path, 1, cluster) != FR_OK || f_mount(&fs, path, 1) != FR_OK)
+	{
+		fprintf(stderr, "cannot format the volume\n");
+		return 1;
+	}
+	DISKSTAT_Reset();
+
+	if (LOG_Open(&cfg) != 0)
+	{
+		fprintf(stderr, "cannot open a log session\n");
+		return 1;
+	}
+
+	period = 1000000 / rate;
+	n = seconds * rate;
+	start = HOST_NowUs();
+
+	for (i = 0; i < n; i++)
+	{
+		/* tick + sequence + filler, roughly a sample frame */
+		memset(record, (uint8_t)i, recordBytes);
+		memcpy(&record[0], &i, sizeof(i));
+
+		t0 = HOST_NowUs();
+		LOG_Write(record, recordBytes);
+		t1 = HOST_NowUs();
+		if (t1 - t0 > maxWriteUs)
+		{
+			maxWriteUs = t1 - t0;
+		}
+
+		LOG_Poll();
+		t0 = HOST_NowUs();
+		if (t0 - t1 > maxPollUs)
+		{
+			maxPollUs = t0 - t1;
+		}
+
+		HOST_AdvanceUs(period);
+	}
+
+	LOG_Close();
+	totalUs = HOST_NowUs() - start;
+
+	printf("session %04lX: %lu parts, %lu bytes, %lu inline rotations, %lu errors\n",
+			(unsigned long)LOG_SessionId(), (unsigned long)LOG_Stats()->parts, (unsigned long)LOG_Stats()->bytes,
+			(unsigned long)LOG_Stats()->syncRotations, (unsigned long)LOG_Stats()->errors);
+	printf("worst LOG_Write %lu us, worst LOG_Poll %lu us\n", (unsigned long)maxWriteUs, (unsigned long)maxPollUs);
+	printf("sample buffer needed: %lu records (%lu bytes) at %lu Hz\n",
+			(unsigned long)((maxWriteUs > maxPollUs ? maxWriteUs : maxPollUs) / period + 1),
+			(unsigned long)(((maxWriteUs > maxPollUs ? maxWriteUs : maxPollUs) / period + 1) * recordBytes),
+			(unsigned long)rate);
+	printf("virtual run time %lu ms for %lu s of data\n", (unsigned long)(totalUs / 1000), (unsigned long)seconds);
+
+	IMAGE_Close();
+	free(ram);
+
+	return 0;
+}
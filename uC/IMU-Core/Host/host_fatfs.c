@@ -0,0 +1,26 @@
+/*
+ * host_fatfs.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Stands in for Src/fatfs.c, which links the card driver: the host
+ *  tools link their own disk backend and mount the default drive.
+ */
+
+#include "fatfs.h"
+
+static FATFS fs;
+static uint8_t mounted = 0;
+
+FRESULT FATFS_Mount(void)
+{
+	FRESULT res = FR_OK;
+
+	if (!mounted)
+	{
+		res = f_mount(&fs, "", 1);
+		mounted = (res == FR_OK);
+	}
+
+	return res;
+}
@@ -0,0 +1,59 @@
+/*
+ * host_port.c
+ *
+ *  Created on: 18 Oct 2026
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include "stm32f4xx_hal.h"
+#include "dwt_delay.h"
+#include "print.h"
+#include "host_port.h"
+
+uint32_t SystemCoreClock = 168000000;
+
+static uint64_t virtualNs = 0;
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec + virtualNs;
+}
+
+void HOST_AdvanceUs(uint32_t us)
+{
+	virtualNs += (uint64_t)us * 1000;
+}
+
+uint64_t HOST_NowUs(void)
+{
+	return now_ns() / 1000;
+}
+
+void DWT_Init(void)
+{
+}
+
+uint32_t DWT_Get(void)
+{
+	return (uint32_t)(now_ns() * (SystemCoreClock / 1000000) / 1000);
+}
+
+void DWT_Delay(uint32_t us)
+{
+	HOST_AdvanceUs(us);
+}
+
+uint32_t HAL_GetTick(void)
+{
+	return (uint32_t)(now_ns() / 1000000);
+}
+
+void print_str(const char *str)
+{
+	fputs(str, stdout);
+}
@@ -0,0 +1,21 @@
+/*
+ * host_port.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Host replacements for the DWT cycle counter, the HAL tick and the
+ *  UART print path. Time is the monotonic clock plus a virtual offset
+ *  that simulated devices advance instead of sleeping, so latency
+ *  profiles cost no wall time while every DWT based statistic still
+ *  sees them.
+ */
+
+#ifndef HOST_PORT_H_
+#define HOST_PORT_H_
+
+#include <stdint.h>
+
+void HOST_AdvanceUs(uint32_t us);
+uint64_t HOST_NowUs(void);
+
+#endif /* HOST_PORT_H_ */
@@ -0,0 +1,197 @@
+/*
+ * image_diskio.c
+ *
+ *  Created on: 18 Oct 2026
+ */
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "image_diskio.h"
+#include "disk_stats.h"
+#include "host_port.h"
+
+#define IMAGE_SECTOR_SIZE 512
+
+extern uint32_t SystemCoreClock;
+
+static const struct
+{
+	const char *name;
+	image_profile_t profile;
+} profiles[] =
+{
+	/* name    read  write sector jitter every  busy    sync   retry */
+	{ "none", {    0,    0,    0,     0,    0,       0,     0, 0 } },
+	{ "fast", {  150,  250,   15,    50,  256,   20000,  1500, 0 } },	// UHS-I class card
+	{ "sd",   {  400,  700,   60,   300,   64,  120000, 10000, 2 } },	// class 4 card, 100+ ms stalls
+};
+
+static int imageFd = -1;
+static uint32_t imageSectors = 0;
+static image_profile_t model;
+static uint32_t writtenSectors = 0;
+static volatile DSTATUS Stat = STA_NOINIT;
+
+DSTATUS IMAGE_initialize (BYTE pdrv);
+DSTATUS IMAGE_status (BYTE pdrv);
+DRESULT IMAGE_read (BYTE pdrv, BYTE *buff, DWORD sector, UINT count);
+DRESULT IMAGE_write (BYTE pdrv, const BYTE *buff, DWORD sector, UINT count);
+DRESULT IMAGE_ioctl (BYTE pdrv, BYTE cmd, void *buff);
+
+Diskio_drvTypeDef IMAGE_Driver =
+{
+	IMAGE_initialize,
+	IMAGE_status,
+	IMAGE_read,
+	IMAGE_write,
+	IMAGE_ioctl,
+};
+
+const image_profile_t* IMAGE_Profile(const char *name)
+{
+	size_t i;
+
+	for (i = 0; i < sizeof(profiles)/sizeof(profiles[0]); i++)
+	{
+		if (strcmp(profiles[i].name, name) == 0)
+		{
+			return &profiles[i].profile;
+		}
+	}
+
+	return NULL;
+}
+
+int IMAGE_Open(const char *path, uint32_t sectors, const image_profile_t *profile)
+{
+	imageFd = open(path, O_RDWR | O_CREAT, 0644);
+	if (imageFd < 0 || ftruncate(imageFd, (off_t)sectors * IMAGE_SECTOR_SIZE) != 0)
+	{
+		return -1;
+	}
+
+	imageSectors = sectors;
+	model = *profile;
+	writtenSectors = 0;
+	srand(1);
+
+	return 0;
+}
+
+void IMAGE_Close(void)
+{
+	if (imageFd >= 0)
+	{
+		close(imageFd);
+	}
+	imageFd = -1;
+	Stat = STA_NOINIT;
+}
+
+/* spends the modelled command time, retried commands pay the fixed cost again */
+static void command_delay(uint32_t fixedUs, UINT count)
+{
+	uint32_t us = fixedUs + count * model.sectorUs;
+
+	if (model.jitterUs)
+	{
+		us += (uint32_t)rand() % model.jitterUs;
+	}
+	while (model.retryPermille && (uint32_t)(rand() % 1000) < model.retryPermille)
+	{
+		DISKSTAT_Retry();
+		us += fixedUs;
+	}
+
+	HOST_AdvanceUs(us);
+}
+
+DSTATUS IMAGE_initialize (BYTE pdrv)
+{
+	Stat = (imageFd >= 0) ? 0 : STA_NOINIT;
+	return Stat;
+}
+
+DSTATUS IMAGE_status (BYTE pdrv)
+{
+	return Stat;
+}
+
+DRESULT IMAGE_read (BYTE pdrv, BYTE *buff, DWORD sector, UINT count)
+{
+	size_t len = (size_t)count * IMAGE_SECTOR_SIZE;
+
+	if (Stat & STA_NOINIT)
+	{
+		return RES_NOTRDY;
+	}
+	if (sector + count > imageSectors)
+	{
+		return RES_PARERR;
+	}
+
+	command_delay(model.readUs, count);
+
+	return (pread(imageFd, buff, len, (off_t)sector * IMAGE_SECTOR_SIZE) == (ssize_t)len) ? RES_OK : RES_ERROR;
+}
+
+DRESULT IMAGE_write (BYTE pdrv, const BYTE *buff, DWORD sector, UINT count)
+{
+	size_t len = (size_t)count * IMAGE_SECTOR_SIZE;
+	uint32_t before = writtenSectors;
+
+	if (Stat & STA_NOINIT)
+	{
+		return RES_NOTRDY;
+	}
+	if (sector + count > imageSectors)
+	{
+		return RES_PARERR;
+	}
+
+	command_delay(model.writeUs, count);
+
+	/* the card goes busy once per busyEvery sectors written */
+	writtenSectors += count;
+	if (model.busyEvery && writtenSectors / model.busyEvery != before / model.busyEvery)
+	{
+		HOST_AdvanceUs(model.busyUs);
+		DISKSTAT_Busy(model.busyUs * (SystemCoreClock / 1000000));
+	}
+
+	return (pwrite(imageFd, buff, len, (off_t)sector * IMAGE_SECTOR_SIZE) == (ssize_t)len) ? RES_OK : RES_ERROR;
+}
+
+DRESULT IMAGE_ioctl (BYTE pdrv, BYTE cmd, void *buff)
+{
+	if (Stat & STA_NOINIT)
+	{
+		return RES_NOTRDY;
+	}
+
+	switch (cmd)
+	{
+		case CTRL_SYNC:
+			HOST_AdvanceUs(model.syncUs);
+			DISKSTAT_Busy(model.syncUs * (SystemCoreClock / 1000000));
+			return RES_OK;
+
+		case GET_SECTOR_COUNT:
+			*(DWORD*)buff = imageSectors;
+			return RES_OK;
+
+		case GET_SECTOR_SIZE:
+			*(WORD*)buff = IMAGE_SECTOR_SIZE;
+			return RES_OK;
+
+		case GET_BLOCK_SIZE:
+			*(DWORD*)buff = 1;
+			return RES_OK;
+
+		default:
+			return RES_PARERR;
+	}
+}
@@ -0,0 +1,35 @@
+/*
+ * image_diskio.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  FatFs diskio driver on a Linux disk image file with an artificial
+ *  latency model. Latencies advance the host virtual clock (host_port.h)
+ *  and busy stalls / retries are reported to disk_stats like a real card
+ *  driver would.
+ */
+
+#ifndef IMAGE_DISKIO_H_
+#define IMAGE_DISKIO_H_
+
+#include "ff_gen_drv.h"
+
+typedef struct
+{
+	uint32_t readUs;		/* fixed cost of a read command */
+	uint32_t writeUs;		/* fixed cost of a write command */
+	uint32_t sectorUs;		/* transfer cost per sector */
+	uint32_t jitterUs;		/* uniform random extra per command */
+	uint32_t busyEvery;		/* every n-th written sector triggers a stall, 0 = never */
+	uint32_t busyUs;		/* stall length (erase / wear levelling) */
+	uint32_t syncUs;		/* CTRL_SYNC cost */
+	uint32_t retryPermille;	/* chance a command has to be repeated */
+} image_profile_t;
+
+extern Diskio_drvTypeDef IMAGE_Driver;
+
+int IMAGE_Open(const char *path, uint32_t sectors, const image_profile_t *profile);
+void IMAGE_Close(void);
+const image_profile_t* IMAGE_Profile(const char *name); // "none", "fast", "sd"
+
+#endif /* IMAGE_DISKIO_H_ */
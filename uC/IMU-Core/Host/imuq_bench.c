@@ -0,0 +1,244 @@
+/*
+ * imuq_bench.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Checks the fixed point read path (imu_q15.c) against its float
+ *  reference and against the CALIB_Correct() chain of mpu9250.c, and
+ *  times both paths.
+ *
+ *  ./imuq_bench [-n samples] [-c cutoff] [-u]
+ *
+ *  Bursts are synthetic: a slowly tumbling gravity vector and a gyro
+ *  sine with noise, through a non-trivial calibration (-u leaves the
+ *  calibration at identity). With -c 0 the FIR passes through and the
+ *  outputs are also compared with CALIB_Correct() on the remapped
+ *  counts, which is what getMotion7() returns. Host times use the plain
+ *  C intrinsics of dsp_port.h and say nothing about the Cortex-M4; the
+ *  cycle counts there come from "imuq bench".
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "imu_q15.h"
+#include "calib.h"
+
+#define SECTOR 4096
+#define ACCEL_SCALE (9.807f * 2.0f / 32767.5f)
+#define GYRO_SCALE (250.0f / 32767.5f * 0.017453293f)
+
+static uint32_t sector[SECTOR / 4];
+static uint64_t rng = 12345;
+
+/* empty flash: CALIB_Init() finds no record */
+uint32_t CALIB_PortSize(void)
+{
+	return SECTOR;
+}
+
+const void* CALIB_PortBase(void)
+{
+	return sector;
+}
+
+int32_t CALIB_PortErase(void)
+{
+	memset(sector, 0xFF, sizeof(sector));
+	return 0;
+}
+
+int32_t CALIB_PortWrite(uint32_t offset, const uint32_t *data, uint32_t words)
+{
+	(void)offset;
+	(void)data;
+	(void)words;
+	return 0;
+}
+
+uint32_t CALIB_PortCrc(const uint32_t *data, uint32_t words)
+{
+	(void)data;
+	(void)words;
+	return 0;
+}
+
+static double gauss(void)
+{
+	double s = 0.0;
+	int i;
+
+	for (i = 0; i < 12; i++)
+	{
+		rng ^= rng << 13;
+		rng ^= rng >> 7;
+		rng ^= rng << 17;
+		s += (rng >> 11) * (1.0 / 9007199254740992.0);
+	}
+	return s - 6.0;
+}
+
+static int16_t sat16(double v)
+{
+	v = floor(v + 0.5);
+	return v > 32767 ? 32767 : (v < -32768 ? -32768 : (int16_t)v);
+}
+
+static void put16(uint8_t *p, int16_t v)
+{
+	p[0] = (uint8_t)((uint16_t)v >> 8);
+	p[1] = (uint8_t)v;
+}
+
+static void burst(uint32_t k, uint8_t raw[IMUQ_RAW_LEN])
+{
+	double t = k * 0.01, g = 16384.0;
+	double roll = 0.7 * sin(0.31 * t), pitch = 0.5 * sin(0.17 * t + 1.0);
+
+	put16(&raw[0], sat16(-g * sin(pitch) + 8.0 * gauss()));
+	put16(&raw[2], sat16(g * cos(pitch) * sin(roll) + 8.0 * gauss()));
+	put16(&raw[4], sat16(g * cos(pitch) * cos(roll) + 8.0 * gauss()));
+	put16(&raw[6], sat16(2000.0 + 30.0 * sin(0.001 * t)));
+	put16(&raw[8], sat16(3000.0 * sin(2.0 * t) + 40.0 + 4.0 * gauss()));
+	put16(&raw[10], sat16(1500.0 * cos(1.3 * t) - 25.0 + 4.0 * gauss()));
+	put16(&raw[12], sat16(800.0 * sin(0.7 * t) + 12.5 + 4.0 * gauss()));
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv)
+{
+	static const int16_t remap[3][3] = { { 0, 1, 0 }, { 1, 0, 0 }, { 0, 0, -1 } };
+	imuq_config_t cfg = { ACCEL_SCALE, GYRO_SCALE, 333.87f, 21.0f, { { 0 } }, 0.15f };
+	uint32_t n = 1000000, k, i;
+	int identity = 0, opt;
+	uint8_t *raw;
+	imuq_filter_t fq, ff;
+	imuq_sample_t q, f;
+	double diff = 0.0, ss = 0.0, chain = 0.0, tq, tf, t0;
+	volatile float sink = 0.0f;	/* keeps the timed outputs alive */
+
+	while ((opt = getopt(argc, argv, "n:c:u")) != -1)
+	{
+		switch (opt)
+		{
+		case 'n':
+			n = strtoul(optarg, NULL, 10);
+			break;
+		case 'c':
+			cfg.cutoff = strtof(optarg, NULL);
+			break;
+		case 'u':
+			identity = 1;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-n samples] [-c cutoff] [-u]\n", argv[0]);
+			return 1;
+		}
+	}
+	memcpy(cfg.remap, remap, sizeof(remap));
+
+	CALIB_PortErase();
+	CALIB_Init(9.807f / ACCEL_SCALE, 1.0f / GYRO_SCALE);
+	if (!identity)
+	{
+		calib_axis3_t a = { { { 1.012f, 0.004f, -0.007f }, { 0.003f, 0.991f, 0.009f }, { -0.006f, 0.002f, 1.004f } },
+				{ 123.4f, -87.6f, 310.25f } };
+		calib_axis3_t g = { { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+				{ -12.5f, 40.3f, 25.8f } };
+
+		CALIB_Set(CALIB_ACCEL, &a);
+		CALIB_Set(CALIB_GYRO, &g);
+	}
+	IMUQ_Init(&cfg);
+
+	raw = malloc((size_t)n * IMUQ_RAW_LEN);
+	if (!raw)
+	{
+		return 1;
+	}
+	for (k = 0; k < n; k++)
+	{
+		burst(k, &raw[(size_t)k * IMUQ_RAW_LEN]);
+	}
+
+	/* accuracy */
+	IMUQ_ResetFilter(&fq);
+	IMUQ_ResetFilter(&ff);
+	for (k = 0; k < n; k++)
+	{
+		const uint8_t *r = &raw[(size_t)k * IMUQ_RAW_LEN];
+
+		IMUQ_Process(&fq, r, &q);
+		IMUQ_ProcessFloat(&ff, r, &f);
+		for (i = 0; i < 3; i++)
+		{
+			double da = (q.a[i] - f.a[i]) / ACCEL_SCALE, dg = (q.g[i] - f.g[i]) / GYRO_SCALE;
+
+			diff = fmax(diff, fmax(fabs(da), fabs(dg)));
+			ss += da * da + dg * dg;
+		}
+
+		if (cfg.cutoff <= 0.0f)
+		{
+			int16_t s[6], body[6];
+			int32_t c[6];
+
+			for (i = 0; i < 6; i++)
+			{
+				s[i] = (int16_t)((r[2 * i + (i < 3 ? 0 : 2)] << 8) | r[2 * i + (i < 3 ? 1 : 3)]);
+			}
+			for (i = 0; i < 3; i++)
+			{
+				body[i] = remap[i][0] * s[0] + remap[i][1] * s[1] + remap[i][2] * s[2];
+				body[3 + i] = remap[i][0] * s[3] + remap[i][1] * s[4] + remap[i][2] * s[5];
+			}
+			CALIB_Correct(CALIB_ACCEL, &body[0], &c[0]);
+			CALIB_Correct(CALIB_GYRO, &body[3], &c[3]);
+			for (i = 0; i < 3; i++)
+			{
+				chain = fmax(chain, fabs(q.a[i] / ACCEL_SCALE - c[i] / 16.0));
+				chain = fmax(chain, fabs(q.g[i] / GYRO_SCALE - c[3 + i] / 16.0));
+			}
+		}
+	}
+
+	/* timing, each path on its own pass */
+	t0 = now();
+	for (k = 0; k < n; k++)
+	{
+		IMUQ_Process(&fq, &raw[(size_t)k * IMUQ_RAW_LEN], &q);
+		sink += q.a[0];
+	}
+	tq = now() - t0;
+
+	t0 = now();
+	for (k = 0; k < n; k++)
+	{
+		IMUQ_ProcessFloat(&ff, &raw[(size_t)k * IMUQ_RAW_LEN], &f);
+		sink += f.a[0];
+	}
+	tf = now() - t0;
+
+	printf("samples %u cutoff %.3f calibration %s saturated %u\n", n, cfg.cutoff, identity ? "identity" : "set",
+			IMUQ_Stats()->saturated);
+	printf("q15 - float: max %.3f rms %.3f counts\n", diff, sqrt(ss / (6.0 * n)));
+	if (cfg.cutoff <= 0.0f)
+	{
+		printf("q15 - CALIB_Correct chain: max %.3f counts\n", chain);
+	}
+	printf("host ns/sample: q15 %.1f float %.1f\n", tq * 1e9 / n, tf * 1e9 / n);
+
+	free(raw);
+	return 0;
+}
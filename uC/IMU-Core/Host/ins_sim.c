@@ -0,0 +1,202 @@
+/*
+ * ins_sim.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Runs the firmware strapdown INS (ins.c) on a deterministic analytic
+ *  trajectory and reports the navigation error with and without the
+ *  coning/sculling terms.
+ *
+ *  ./ins_sim [-f sample Hz] [-d nav divider] [-t seconds]
+ *            [-a coning half angle deg] [-c coning Hz] [-A motion amplitude m]
+ *            [-w motion Hz] [-V vibration m/s^2] [-v]
+ *
+ *  Attitude is classic coning, a body axis tilted by the half angle
+ *  precessing at the coning frequency, the worst case for a rotation
+ *  vector update. Position follows a slow orbit-like path plus a circular
+ *  vibration in phase with the coning, which exercises sculling. Gyro and accel increments are integrated
+ *  from the exact rates in double precision, so the numbers are identical
+ *  on every run and any error is the algorithm's.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ins.h"
+
+#define SUBSTEPS 16
+
+typedef struct
+{
+	double cone, coneW, amp, moveW, vib;
+} trajectory_t;
+
+static void truth(const trajectory_t *tr, double t, double q[4], double w[3], double p[3], double f[3])
+{
+	double c = cos(0.5 * tr->cone), s = sin(0.5 * tr->cone);
+	double ct = cos(tr->coneW * t), st = sin(tr->coneW * t);
+	double qd[4], a[3], R[3][3];
+	double W = tr->moveW, A = tr->amp;
+	int i;
+
+	q[0] = c;
+	q[1] = s * ct;
+	q[2] = s * st;
+	q[3] = 0.0;
+	qd[0] = 0.0;
+	qd[1] = -s * st * tr->coneW;
+	qd[2] = s * ct * tr->coneW;
+	qd[3] = 0.0;
+
+	/* body rate = 2 q* (x) dq/dt */
+	w[0] = 2.0 * (q[0] * qd[1] - q[1] * qd[0] - q[2] * qd[3] + q[3] * qd[2]);
+	w[1] = 2.0 * (q[0] * qd[2] + q[1] * qd[3] - q[2] * qd[0] - q[3] * qd[1]);
+	w[2] = 2.0 * (q[0] * qd[3] - q[1] * qd[2] + q[2] * qd[1] - q[3] * qd[0]);
+
+	p[0] = A * (1.0 - cos(W * t));
+	p[1] = A * sin(W * t) * sin(W * t);
+	p[2] = 0.5 * A * (1.0 - cos(2.0 * W * t));
+	a[0] = A * W * W * cos(W * t);
+	a[1] = 2.0 * A * W * W * cos(2.0 * W * t);
+	a[2] = 2.0 * A * W * W * cos(2.0 * W * t);
+	a[2] += INS_GRAVITY;
+
+	/* circular vibration in phase with the coning, the sculling case */
+	p[0] += tr->vib / (tr->coneW * tr->coneW) * (1.0 - cos(tr->coneW * t));
+	p[1] += tr->vib / tr->coneW * t - tr->vib / (tr->coneW * tr->coneW) * sin(tr->coneW * t);
+	a[0] += tr->vib * cos(tr->coneW * t);
+	a[1] += tr->vib * sin(tr->coneW * t);
+
+	R[0][0] = q[0] * q[0] + q[1] * q[1] - q[2] * q[2] - q[3] * q[3];
+	R[0][1] = 2.0 * (q[1] * q[2] - q[0] * q[3]);
+	R[0][2] = 2.0 * (q[1] * q[3] + q[0] * q[2]);
+	R[1][0] = 2.0 * (q[1] * q[2] + q[0] * q[3]);
+	R[1][1] = q[0] * q[0] - q[1] * q[1] + q[2] * q[2] - q[3] * q[3];
+	R[1][2] = 2.0 * (q[2] * q[3] - q[0] * q[1]);
+	R[2][0] = 2.0 * (q[1] * q[3] - q[0] * q[2]);
+	R[2][1] = 2.0 * (q[2] * q[3] + q[0] * q[1]);
+	R[2][2] = q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3];
+
+	/* specific force in body = R' (a - g) */
+	for (i = 0; i < 3; i++)
+	{
+		f[i] = R[0][i] * a[0] + R[1][i] * a[1] + R[2][i] * a[2];
+	}
+}
+
+/* Simpson integral of the body rates and specific force over one sample */
+static void increments(const trajectory_t *tr, double t0, double dt, float dth[3], float dv[3])
+{
+	double q[4], w[3], p[3], f[3], sw[3] = { 0 }, sf[3] = { 0 }, h = dt / SUBSTEPS;
+	int k, i;
+
+	for (k = 0; k <= SUBSTEPS; k++)
+	{
+		double wgt = (k == 0 || k == SUBSTEPS) ? 1.0 : ((k & 1) ? 4.0 : 2.0);
+
+		truth(tr, t0 + k * h, q, w, p, f);
+		for (i = 0; i < 3; i++)
+		{
+			sw[i] += wgt * w[i];
+			sf[i] += wgt * f[i];
+		}
+	}
+	for (i = 0; i < 3; i++)
+	{
+		dth[i] = (float)(sw[i] * h / 3.0);
+		dv[i] = (float)(sf[i] * h / 3.0);
+	}
+}
+
+static double run(const trajectory_t *tr, uint32_t rate, uint32_t div, double seconds, uint8_t comp, int verbose,
+		double *posErr)
+{
+	double q[4], w[3], p[3], f[3], e[3], angle = 0.0;
+	float q0[4], dth[3], dv[3];
+	const ins_state_t *s = INS_State();
+	uint32_t k, n = (uint32_t)(seconds * rate);
+	int i;
+
+	INS_Init((float)rate, div);
+	INS_SetCompensation(comp);
+	truth(tr, 0.0, q, w, p, f);
+	for (i = 0; i < 4; i++)
+	{
+		q0[i] = (float)q[i];
+	}
+	INS_SetAttitude(q0);
+
+	for (k = 0; k < n; k++)
+	{
+		increments(tr, (double)k / rate, 1.0 / rate, dth, dv);
+		INS_AddIncrement(dth, dv);
+		if (!INS_Poll())
+		{
+			continue;
+		}
+
+		truth(tr, (double)(k + 1) / rate, q, w, p, f);
+
+		/* angle of q_true* (x) q_ins from its vector part, acos of the scalar part has no resolution */
+		e[0] = q[0] * s->q[1] - q[1] * s->q[0] - q[2] * s->q[3] + q[3] * s->q[2];
+		e[1] = q[0] * s->q[2] + q[1] * s->q[3] - q[2] * s->q[0] - q[3] * s->q[1];
+		e[2] = q[0] * s->q[3] - q[1] * s->q[2] + q[2] * s->q[1] - q[3] * s->q[0];
+		angle = 2.0 * asin(fmin(1.0, sqrt(e[0] * e[0] + e[1] * e[1] + e[2] * e[2])));
+		*posErr = sqrt((p[0] - s->p[0]) * (p[0] - s->p[0]) + (p[1] - s->p[1]) * (p[1] - s->p[1]) +
+				(p[2] - s->p[2]) * (p[2] - s->p[2]));
+
+		if (verbose && ((k + 1) % rate) == 0)
+		{
+			printf("%d %.0f s: att %.5f deg pos %.4f m\n", comp, s->time, angle * 180.0 / M_PI, *posErr);
+		}
+	}
+
+	return angle * 180.0 / M_PI;
+}
+
+int main(int argc, char **argv)
+{
+	trajectory_t tr = { 1.0, 10.0, 1.0, 0.5, 2.0 };
+	uint32_t rate = 1000, div = 10;
+	double seconds = 60.0, att, pos = 0.0;
+	int opt, verbose = 0;
+	uint8_t comp;
+
+	while ((opt = getopt(argc, argv, "f:d:t:a:c:A:w:V:v")) != -1)
+	{
+		switch (opt)
+		{
+			case 'f': rate = strtoul(optarg, NULL, 0); break;
+			case 'd': div = strtoul(optarg, NULL, 0); break;
+			case 't': seconds = atof(optarg); break;
+			case 'a': tr.cone = atof(optarg); break;
+			case 'c': tr.coneW = atof(optarg); break;
+			case 'A': tr.amp = atof(optarg); break;
+			case 'w': tr.moveW = atof(optarg); break;
+			case 'V': tr.vib = atof(optarg); break;
+			case 'v': verbose = 1; break;
+			default:
+				fprintf(stderr, "see the header of ins_sim.c for options\n");
+				return 2;
+		}
+	}
+
+	printf("%lu Hz in, %lu Hz nav, %.0f s, coning %.2f deg at %.1f Hz, motion %.2f m at %.2f Hz, vibration %.1f m/s^2\n",
+			(unsigned long)rate, (unsigned long)(rate / div), seconds, tr.cone, tr.coneW, tr.amp, tr.moveW, tr.vib);
+
+	tr.cone *= 2.0 * M_PI / 360.0;
+	tr.coneW *= 2.0 * M_PI;
+	tr.moveW *= 2.0 * M_PI;
+
+	for (comp = 0; comp < 2; comp++)
+	{
+		att = run(&tr, rate, div, seconds, comp, verbose, &pos);
+		printf("%s: attitude error %.5f deg, position error %.4f m\n",
+				comp ? "coning/sculling on " : "coning/sculling off", att, pos);
+	}
+
+	return 0;
+}
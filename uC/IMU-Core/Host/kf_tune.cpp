@@ -0,0 +1,625 @@
+/*
+ * kf_tune.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Genetic algorithm tuning of the ESKF process noise (eskf_noise_t) and
+ *  the zero velocity measurement variance (pdr_config_t.zuptVar) over
+ *  recorded foot-mounted walks. Every candidate is replayed through the
+ *  firmware eskf.c and pdr.c, built for the host as kfnav.so, exactly as
+ *  pdr_replay does; its fitness is the RMS over the logs of the distance
+ *  between the estimated and the true end point.
+ *
+ *  ./kf_tune [-p population] [-g generations] [-j threads] [-s seed]
+ *            [-f rate Hz] [-c checkpoint] [-r] [-n library] log[@x,y,z] ...
+ *
+ *  Logs are in print_motion7() format (see eskf_replay.c) and start at
+ *  rest. The true end point is given after @, relative to the start; a
+ *  log without one is a closed loop. pdr_replay -S ... -o writes such
+ *  logs. The logs are decoded once and kept in memory for all
+ *  generations.
+ *
+ *  The firmware modules keep their state in statics, so each worker of
+ *  the thread pool loads its own copy of kfnav.so with dlmopen() into a
+ *  new link map namespace (glibc allows 15 besides the main one).
+ *
+ *  Genes are log10 of the five variances / densities, bounded to two
+ *  decades either side of the firmware defaults. Each generation keeps
+ *  the two best, fills the rest by tournament selection of three, BLX
+ *  crossover and Gaussian mutation, and is written to the checkpoint
+ *  file (-c); -r resumes from it.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dlfcn.h>
+#include <unistd.h>
+
+extern "C"
+{
+#include "eskf.h"
+#include "pdr.h"
+}
+
+#define GENES 5
+#define ELITE 2
+#define TOURNAMENT 3
+#define BLX_ALPHA 0.3
+#define MUTATE_P 0.2
+#define MUTATE_SIGMA 0.25		/* decades */
+#define ALIGN_S 0.3				/* levelling at the start, inside the first stance */
+#define MAX_WORKERS 15
+
+static const char *geneNames[GENES] = { "gyroNoise", "accelNoise", "gyroBiasRw", "accelBiasRw", "zuptVar" };
+/* firmware defaults, main.c */
+static const double defaults[GENES] = { 1.75e-4, 2.94e-3, 1e-5, 1e-4, 1e-4 };
+
+struct Sample
+{
+	float a[3];
+	float g[3];
+};
+
+struct Log
+{
+	std::string name;
+	std::vector<Sample> samples;
+	double end[3];
+};
+
+typedef std::vector<double> Genome;
+
+/* one kfnav.so instance */
+class Nav
+{
+public:
+	explicit Nav(const std::string &path)
+	{
+		handle = dlmopen(LM_ID_NEWLM, path.c_str(), RTLD_NOW | RTLD_LOCAL);
+		if (!handle)
+		{
+			return;
+		}
+		init = (void (*)(const eskf_noise_t*))dlsym(handle, "ESKF_Init");
+		align = (void (*)(float, float, float))dlsym(handle, "ESKF_AlignFromAccel");
+		predict = (void (*)(float, float, float, float, float, float, float))dlsym(handle, "ESKF_Predict");
+		state = (const eskf_state_t* (*)(void))dlsym(handle, "ESKF_State");
+		pdrInit = (void (*)(const pdr_config_t*))dlsym(handle, "PDR_Init");
+		pdrUpdate = (uint8_t (*)(float, float, float, float, float, float))dlsym(handle, "PDR_Update");
+		pdrPop = (int32_t (*)(pdr_step_t*))dlsym(handle, "PDR_PopStep");
+	}
+
+	~Nav()
+	{
+		if (handle)
+		{
+			dlclose(handle);
+		}
+	}
+
+	bool ok() const
+	{
+		return handle && init && align && predict && state && pdrInit && pdrUpdate && pdrPop;
+	}
+
+	/* end point error of one log, m */
+	double run(const Log &log, const Genome &x, float rate)
+	{
+		eskf_noise_t noise = { (float)std::pow(10.0, x[0]), (float)std::pow(10.0, x[1]), (float)std::pow(10.0, x[2]),
+				(float)std::pow(10.0, x[3]) };
+		pdr_config_t cfg = { rate, 5, 5, 0.02f, 0.002f, 3e4f, (float)std::pow(10.0, x[4]) };
+		float aSum[3] = { 0.0f, 0.0f, 0.0f };
+		size_t alignN = (size_t)(ALIGN_S * rate);
+		pdr_step_t step;
+		size_t n;
+
+		init(&noise);
+		pdrInit(&cfg);
+
+		for (n = 0; n < log.samples.size(); n++)
+		{
+			const Sample &s = log.samples[n];
+
+			if (n < alignN)
+			{
+				for (int i = 0; i < 3; i++)
+				{
+					aSum[i] += s.a[i];
+				}
+				if (n == alignN - 1)
+				{
+					align(aSum[0], aSum[1], aSum[2]);
+				}
+			}
+			predict(s.g[0], s.g[1], s.g[2], s.a[0], s.a[1], s.a[2], 1.0f / rate);
+			pdrUpdate(s.g[0], s.g[1], s.g[2], s.a[0], s.a[1], s.a[2]);
+			while (pdrPop(&step) == 0)
+			{
+			}
+		}
+
+		const eskf_state_t *e = state();
+		double d = 0.0;
+
+		for (int i = 0; i < 3; i++)
+		{
+			d += (e->p[i] - log.end[i]) * (e->p[i] - log.end[i]);
+		}
+		/* a diverged filter gives NaN, rank it last */
+		return std::isfinite(d) ? std::sqrt(d) : 1e9;
+	}
+
+private:
+	void *handle = nullptr;
+	void (*init)(const eskf_noise_t*) = nullptr;
+	void (*align)(float, float, float) = nullptr;
+	void (*predict)(float, float, float, float, float, float, float) = nullptr;
+	const eskf_state_t* (*state)(void) = nullptr;
+	void (*pdrInit)(const pdr_config_t*) = nullptr;
+	uint8_t (*pdrUpdate)(float, float, float, float, float, float) = nullptr;
+	int32_t (*pdrPop)(pdr_step_t*) = nullptr;
+};
+
+/*
+ * Fixed workers, each with its own Nav. run() hands out the indices
+ * 0..count-1 through an atomic counter and returns when all are done.
+ */
+class Pool
+{
+public:
+	Pool(const std::string &library, unsigned threads)
+	{
+		for (unsigned i = 0; i < threads; i++)
+		{
+			std::unique_ptr<Nav> nav(new Nav(library));
+
+			if (!nav->ok())
+			{
+				fprintf(stderr, "worker %u: %s\n", i, dlerror());
+				break;
+			}
+			navs.push_back(std::move(nav));
+		}
+		for (size_t i = 0; i < navs.size(); i++)
+		{
+			workers.emplace_back(&Pool::loop, this, i);
+		}
+	}
+
+	~Pool()
+	{
+		{
+			std::lock_guard<std::mutex> g(lock);
+			stop = true;
+		}
+		wake.notify_all();
+		for (auto &w : workers)
+		{
+			w.join();
+		}
+	}
+
+	size_t size() const
+	{
+		return navs.size();
+	}
+
+	void run(size_t count, std::function<void(Nav&, size_t)> job)
+	{
+		std::unique_lock<std::mutex> g(lock);
+
+		task = job;
+		total = count;
+		next = 0;
+		finished = 0;
+		generation++;
+		wake.notify_all();
+		done.wait(g, [this] { return finished == total; });
+	}
+
+private:
+	void loop(size_t id)
+	{
+		unsigned long seen = 0;
+
+		for (;;)
+		{
+			std::function<void(Nav&, size_t)> job;
+			{
+				std::unique_lock<std::mutex> g(lock);
+
+				wake.wait(g, [&] { return stop || generation != seen; });
+				if (stop)
+				{
+					return;
+				}
+				seen = generation;
+				job = task;
+			}
+
+			size_t i, n = 0;
+
+			while ((i = next.fetch_add(1)) < total)
+			{
+				job(*navs[id], i);
+				n++;
+			}
+
+			std::lock_guard<std::mutex> g(lock);
+			finished += n;
+			if (finished == total)
+			{
+				done.notify_one();
+			}
+		}
+	}
+
+	std::vector<std::unique_ptr<Nav>> navs;
+	std::vector<std::thread> workers;
+	std::mutex lock;
+	std::condition_variable wake, done;
+	std::function<void(Nav&, size_t)> task;
+	std::atomic<size_t> next { 0 };
+	size_t total = 0, finished = 0;
+	unsigned long generation = 0;
+	bool stop = false;
+};
+
+/* print_motion7() lines: t;ax;ay;az;gx;gy;gz;temp */
+static bool load(const std::string &arg, Log &log, float rate)
+{
+	std::string path = arg;
+	size_t at = arg.rfind('@');
+	char line[256];
+	Sample s;
+	float t, temp;
+
+	log.end[0] = log.end[1] = log.end[2] = 0.0;
+	if (at != std::string::npos)
+	{
+		path = arg.substr(0, at);
+		sscanf(arg.c_str() + at + 1, "%lf,%lf,%lf", &log.end[0], &log.end[1], &log.end[2]);
+	}
+	log.name = path;
+
+	FILE *in = fopen(path.c_str(), "r");
+
+	if (!in)
+	{
+		perror(path.c_str());
+		return false;
+	}
+	while (fgets(line, sizeof(line), in))
+	{
+		if (sscanf(line, "%f;%f;%f;%f;%f;%f;%f;%f", &t, &s.a[0], &s.a[1], &s.a[2], &s.g[0], &s.g[1], &s.g[2], &temp) == 8)
+		{
+			log.samples.push_back(s);
+		}
+	}
+	fclose(in);
+
+	return log.samples.size() > ALIGN_S * rate;
+}
+
+struct Population
+{
+	unsigned generation = 0;
+	std::vector<Genome> genomes;
+	std::vector<double> fitness;
+	std::mt19937_64 rng;
+};
+
+static bool save(const std::string &path, const Population &p)
+{
+	std::string tmp = path + ".tmp";
+	std::ofstream out(tmp);
+
+	out << "kf_tune 1\n" << p.generation << " " << p.genomes.size() << "\n" << p.rng << "\n";
+	out.precision(17);
+	for (size_t i = 0; i < p.genomes.size(); i++)
+	{
+		for (double g : p.genomes[i])
+		{
+			out << g << " ";
+		}
+		out << p.fitness[i] << "\n";
+	}
+	out.close();
+
+	/* a crash while writing leaves the previous checkpoint */
+	return out && rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+static bool restore(const std::string &path, Population &p)
+{
+	std::ifstream in(path);
+	std::string magic;
+	size_t n;
+	int version;
+
+	if (!(in >> magic >> version) || magic != "kf_tune" || version != 1 || !(in >> p.generation >> n >> p.rng))
+	{
+		return false;
+	}
+	p.genomes.assign(n, Genome(GENES));
+	p.fitness.assign(n, 0.0);
+	for (size_t i = 0; i < n; i++)
+	{
+		for (double &g : p.genomes[i])
+		{
+			in >> g;
+		}
+		in >> p.fitness[i];
+	}
+	return bool(in);
+}
+
+static double lo(int g)
+{
+	return std::log10(defaults[g]) - 2.0;
+}
+
+static double hi(int g)
+{
+	return std::log10(defaults[g]) + 2.0;
+}
+
+static double clamp(int g, double v)
+{
+	return v < lo(g) ? lo(g) : (v > hi(g) ? hi(g) : v);
+}
+
+static size_t tournament(const Population &p)
+{
+	std::uniform_int_distribution<size_t> pick(0, p.genomes.size() - 1);
+	size_t best = pick(const_cast<std::mt19937_64&>(p.rng));
+
+	for (int i = 1; i < TOURNAMENT; i++)
+	{
+		size_t c = pick(const_cast<std::mt19937_64&>(p.rng));
+
+		if (p.fitness[c] < p.fitness[best])
+		{
+			best = c;
+		}
+	}
+	return best;
+}
+
+static void breed(Population &p)
+{
+	std::vector<size_t> order(p.genomes.size());
+	std::vector<Genome> next;
+	std::uniform_real_distribution<double> u(0.0, 1.0);
+	std::normal_distribution<double> n(0.0, MUTATE_SIGMA);
+
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		order[i] = i;
+	}
+	std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return p.fitness[a] < p.fitness[b]; });
+	for (size_t i = 0; i < ELITE && i < order.size(); i++)
+	{
+		next.push_back(p.genomes[order[i]]);
+	}
+
+	while (next.size() < p.genomes.size())
+	{
+		const Genome &a = p.genomes[tournament(p)], &b = p.genomes[tournament(p)];
+		Genome c(GENES);
+
+		for (int g = 0; g < GENES; g++)
+		{
+			double l = std::min(a[g], b[g]), h = std::max(a[g], b[g]), d = h - l;
+
+			c[g] = l - BLX_ALPHA * d + u(p.rng) * (1.0 + 2.0 * BLX_ALPHA) * d;
+			if (u(p.rng) < MUTATE_P)
+			{
+				c[g] += n(p.rng);
+			}
+			c[g] = clamp(g, c[g]);
+		}
+		next.push_back(c);
+	}
+
+	p.genomes = next;
+	p.generation++;
+}
+
+static std::string library_path(void)
+{
+	char exe[4096];
+	ssize_t n = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+	std::string dir = ".";
+
+	if (n > 0)
+	{
+		exe[n] = 0;
+		dir = exe;
+		dir = dir.substr(0, dir.rfind('/'));
+	}
+	return dir + "/kfnav.so";
+}
+
+static void print_best(const Population &p, size_t best)
+{
+	const Genome &g = p.genomes[best];
+
+	printf("eskf_noise_t eskfNoise = { %.3ef, %.3ef, %.3ef, %.3ef };\n", std::pow(10.0, g[0]), std::pow(10.0, g[1]),
+			std::pow(10.0, g[2]), std::pow(10.0, g[3]));
+	printf("/* pdr_config_t zuptVar %.3ef */\n", std::pow(10.0, g[4]));
+}
+
+int main(int argc, char **argv)
+{
+	unsigned popSize = 48, generations = 30, threads = std::thread::hardware_concurrency(), seed = 1;
+	std::string checkpoint, library = library_path();
+	std::vector<Log> logs;
+	bool resume = false;
+	float rate = 100.0f;
+	Population p;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "p:g:j:s:f:c:rn:")) != -1)
+	{
+		switch (opt)
+		{
+		case 'p':
+			popSize = strtoul(optarg, NULL, 10);
+			break;
+		case 'g':
+			generations = strtoul(optarg, NULL, 10);
+			break;
+		case 'j':
+			threads = strtoul(optarg, NULL, 10);
+			break;
+		case 's':
+			seed = strtoul(optarg, NULL, 10);
+			break;
+		case 'f':
+			rate = strtof(optarg, NULL);
+			break;
+		case 'c':
+			checkpoint = optarg;
+			break;
+		case 'r':
+			resume = true;
+			break;
+		case 'n':
+			library = optarg;
+			break;
+		default:
+			fprintf(stderr, "see the header of kf_tune.cpp for options\n");
+			return 2;
+		}
+	}
+	if (optind >= argc || popSize < ELITE + 2)
+	{
+		fprintf(stderr, "see the header of kf_tune.cpp for options\n");
+		return 2;
+	}
+
+	for (int i = optind; i < argc; i++)
+	{
+		Log log;
+
+		if (!load(argv[i], log, rate))
+		{
+			return 1;
+		}
+		printf("# %s: %zu samples, end %.2f %.2f %.2f m\n", log.name.c_str(), log.samples.size(), log.end[0], log.end[1],
+				log.end[2]);
+		logs.push_back(std::move(log));
+	}
+
+	threads = threads < 1 ? 1 : (threads > MAX_WORKERS ? MAX_WORKERS : threads);
+	Pool pool(library, threads);
+
+	if (pool.size() == 0)
+	{
+		fprintf(stderr, "no worker could load %s\n", library.c_str());
+		return 1;
+	}
+
+	if (resume && !checkpoint.empty() && restore(checkpoint, p))
+	{
+		printf("# resumed %s after generation %u\n", checkpoint.c_str(), p.generation);
+		/* the saved generation has its fitness already */
+		breed(p);
+	}
+	else
+	{
+		std::uniform_real_distribution<double> u(0.0, 1.0);
+
+		p.rng.seed(seed);
+		p.genomes.assign(popSize, Genome(GENES));
+		p.fitness.assign(popSize, 0.0);
+		for (int g = 0; g < GENES; g++)
+		{
+			/* the defaults are one of the candidates */
+			p.genomes[0][g] = std::log10(defaults[g]);
+		}
+		for (size_t i = 1; i < popSize; i++)
+		{
+			for (int g = 0; g < GENES; g++)
+			{
+				p.genomes[i][g] = lo(g) + u(p.rng) * (hi(g) - lo(g));
+			}
+		}
+	}
+
+	printf("# %zu logs, population %zu, %zu workers\n# gen;best m;median m;ms per log run", logs.size(), p.genomes.size(),
+			pool.size());
+	for (int g = 0; g < GENES; g++)
+	{
+		printf(";%s", geneNames[g]);
+	}
+	printf("\n");
+
+	size_t best = 0;
+
+	for (;;)
+	{
+		size_t runs = p.genomes.size() * logs.size();
+		std::vector<double> err(runs);
+		auto t0 = std::chrono::steady_clock::now();
+
+		/* one job per candidate and log, so a few long logs still spread over the workers */
+		pool.run(runs, [&](Nav &nav, size_t i) { err[i] = nav.run(logs[i % logs.size()], p.genomes[i / logs.size()], rate); });
+
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+		for (size_t i = 0; i < p.genomes.size(); i++)
+		{
+			double s = 0.0;
+
+			for (size_t k = 0; k < logs.size(); k++)
+			{
+				s += err[i * logs.size() + k] * err[i * logs.size() + k];
+			}
+			p.fitness[i] = std::sqrt(s / logs.size());
+		}
+
+		std::vector<double> sorted = p.fitness;
+
+		std::sort(sorted.begin(), sorted.end());
+		best = std::min_element(p.fitness.begin(), p.fitness.end()) - p.fitness.begin();
+		printf("%u;%.4f;%.4f;%.2f", p.generation, p.fitness[best], sorted[sorted.size() / 2], ms * pool.size() / runs);
+		for (int g = 0; g < GENES; g++)
+		{
+			printf(";%.3e", std::pow(10.0, p.genomes[best][g]));
+		}
+		printf("\n");
+		fflush(stdout);
+
+		if (!checkpoint.empty() && !save(checkpoint, p))
+		{
+			fprintf(stderr, "cannot write %s\n", checkpoint.c_str());
+		}
+		if (p.generation + 1 >= generations)
+		{
+			break;
+		}
+		breed(p);
+	}
+
+	print_best(p, best);
+
+	return 0;
+}
@@ -0,0 +1,127 @@
+/*
+ * log_stitch.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Joins the part files of one logger session back into a single
+ *  continuous stream.
+ *
+ *  make log_stitch (part names from log_session.c)
+ *  ./log_stitch <log dir> <session id, hex> <output file>
+ *
+ *  Parts are read in part index order until the first missing one. The
+ *  header of every part is checked against the session id, its index and
+ *  the payload offset. Only the payload length in the header is copied:
+ *  after an unclean shutdown a part still has its preallocated size, and
+ *  what follows the last synced payload is stale card content.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log_session.h"
+
+#define COPY_CHUNK (64 * 1024)
+
+static int read_header(FILE *f, log_part_header_t *hdr)
+{
+	if (fread(hdr, sizeof(*hdr), 1, f) != 1)
+	{
+		return -1;
+	}
+	if (hdr->magic != LOG_MAGIC || hdr->version != LOG_VERSION || hdr->headerSize < sizeof(*hdr))
+	{
+		return -1;
+	}
+
+	return fseek(f, hdr->headerSize, SEEK_SET);
+}
+
+static FILE* open_part(const char *dir, uint32_t sessionId, uint32_t partIndex)
+{
+	char name[13], path[1024];
+
+	LOG_PartName(name, sessionId, partIndex);
+	snprintf(path, sizeof(path), "%s/%s", dir, name);
+
+	return fopen(path, "rb");
+}
+
+int main(int argc, char **argv)
+{
+	static unsigned char chunk[COPY_CHUNK];
+	log_part_header_t hdr;
+	uint32_t sessionId, part, offset = 0, firstTick = 0, limit, got;
+	FILE *in, *out;
+
+	if (argc != 4)
+	{
+		fprintf(stderr, "usage: %s <log dir> <session id, hex> <output file>\n", argv[0]);
+		return 2;
+	}
+
+	sessionId = (uint32_t)strtoul(argv[2], NULL, 16);
+
+	in = open_part(argv[1], sessionId, 0);
+	if (!in)
+	{
+		fprintf(stderr, "session %04lX: part 0 not found\n", (unsigned long)sessionId);
+		return 1;
+	}
+
+	out = fopen(argv[3], "wb");
+	if (!out)
+	{
+		perror(argv[3]);
+		return 1;
+	}
+
+	for (part = 0; in; part++)
+	{
+		size_t n;
+
+		if (read_header(in, &hdr) != 0 || hdr.sessionId != sessionId || hdr.partIndex != part)
+		{
+			fprintf(stderr, "part %lu: bad header, stopping\n", (unsigned long)part);
+			fclose(in);
+			break;
+		}
+		if (part == 0)
+		{
+			firstTick = hdr.startTick;
+		}
+		if (hdr.sessionOffset != offset)
+		{
+			fprintf(stderr, "part %lu: payload offset %lu, expected %lu (%ld bytes missing)\n",
+					(unsigned long)part, (unsigned long)hdr.sessionOffset, (unsigned long)offset,
+					(long)hdr.sessionOffset - (long)offset);
+			offset = hdr.sessionOffset;
+		}
+
+		limit = hdr.payloadBytes;
+		got = 0;
+		while (got < limit && (n = fread(chunk, 1, limit - got < COPY_CHUNK ? limit - got : COPY_CHUNK, in)) > 0)
+		{
+			fwrite(chunk, 1, n, out);
+			got += n;
+		}
+		offset += got;
+		if (got < limit)
+		{
+			fprintf(stderr, "part %lu: %lu payload bytes, header says %lu\n", (unsigned long)part,
+					(unsigned long)got, (unsigned long)limit);
+		}
+
+		printf("part %lu: start %lu ms, payload up to %lu bytes\n",
+				(unsigned long)part, (unsigned long)(hdr.startTick - firstTick), (unsigned long)offset);
+
+		fclose(in);
+		in = open_part(argv[1], sessionId, part + 1);
+	}
+
+	fclose(out);
+	printf("session %04lX: %lu parts, %lu bytes\n", (unsigned long)sessionId, (unsigned long)part, (unsigned long)offset);
+
+	return 0;
+}
@@ -0,0 +1,295 @@
+/*
+ * map_report.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  What ended up where, from the GNU ld map of the firmware (-Wl,-Map):
+ *  use of each memory region, its output sections and the largest input
+ *  sections by object file.
+ *
+ *  gcc -O2 -o map_report map_report.c
+ *  ./map_report [-r region] [-n top] [-x member] <IMU-Core.map>
+ *
+ *  Input sections are placed by their run address, so .data counts in
+ *  RAM and not in the flash that holds its initial values. Static
+ *  variables have no symbol in the map; with -fdata-sections each is its
+ *  own input section (.bss.name), otherwise the object file is as fine
+ *  as it gets. Check CCMRAM for anything that is a DMA buffer.
+ *
+ *  -x fails (exit status 1) when a library member whose name contains
+ *  the pattern is linked, and names the file and symbol that pulled it
+ *  in: -x mallocr is the check that newlib's allocator stays out
+ *  (mempool.h).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define MAX_REGIONS 16
+#define MAX_NAME 128
+
+typedef struct
+{
+	char name[32];
+	unsigned long long origin, length, used;
+} region_t;
+
+typedef struct
+{
+	char name[MAX_NAME];
+	char file[MAX_NAME];
+	unsigned long long addr, size;
+	int region;
+	int output;				/* output section, otherwise an input section */
+} entry_t;
+
+static region_t regions[MAX_REGIONS];
+static int regionsNum;
+static entry_t *entries;
+static size_t entriesNum, entriesMax;
+static const char *forbidden;
+static int forbiddenFound;
+
+static int is_hex(const char *s)
+{
+	return s[0] == '0' && s[1] == 'x';
+}
+
+static int region_of(unsigned long long addr, unsigned long long size)
+{
+	int i;
+
+	for (i = 0; i < regionsNum; i++)
+	{
+		if (addr >= regions[i].origin && addr + size <= regions[i].origin + regions[i].length && size)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+static void add(const char *name, const char *file, unsigned long long addr, unsigned long long size, int output)
+{
+	entry_t *e;
+	const char *base;
+
+	if (entriesNum == entriesMax)
+	{
+		entriesMax = entriesMax ? entriesMax * 2 : 1024;
+		entries = realloc(entries, entriesMax * sizeof(*entries));
+		if (!entries)
+		{
+			fprintf(stderr, "out of memory\n");
+			exit(1);
+		}
+	}
+
+	e = &entries[entriesNum];
+	e->region = region_of(addr, size);
+	if (e->region < 0)
+	{
+		/* debug sections, discarded input, empty sections */
+		return;
+	}
+	base = strrchr(file, '/');
+	snprintf(e->name, sizeof(e->name), "%s", name);
+	snprintf(e->file, sizeof(e->file), "%s", base ? base + 1 : file);
+	e->addr = addr;
+	e->size = size;
+	e->output = output;
+	entriesNum++;
+}
+
+static int by_size(const void *a, const void *b)
+{
+	const entry_t *x = a, *y = b;
+
+	return x->size < y->size ? 1 : x->size > y->size ? -1 : 0;
+}
+
+static void parse(FILE *f)
+{
+	char line[1024], pending[MAX_NAME] = "", name[MAX_NAME], addr[32], size[32], file[MAX_NAME];
+	char member[sizeof(line)] = "";
+	int state = 0, n, pendingOutput = 0;
+
+	while (fgets(line, sizeof(line), f))
+	{
+		line[strcspn(line, "\r\n")] = 0;
+
+		if (state == 0)
+		{
+			if (strncmp(line, "Memory Configuration", 20) == 0)
+			{
+				state = 1;
+			}
+			else if (line[0] && line[0] != ' ' && strchr(line, '('))
+			{
+				/* library member, the reference that pulled it in follows indented */
+				snprintf(member, sizeof(member), "%s", line);
+			}
+			else if (line[0] == ' ' && member[0])
+			{
+				if (forbidden && strstr(member, forbidden))
+				{
+					fprintf(stderr, "%s\n  pulled in by %s\n", member, line + strspn(line, " "));
+					forbiddenFound = 1;
+				}
+				member[0] = 0;
+			}
+			continue;
+		}
+		if (state == 1)
+		{
+			region_t *r = &regions[regionsNum];
+			char origin[32], length[32];
+
+			if (strncmp(line, "Linker script and memory map", 28) == 0)
+			{
+				state = 2;
+				continue;
+			}
+			if (regionsNum < MAX_REGIONS && sscanf(line, "%31s %31s %31s", r->name, origin, length) == 3
+					&& is_hex(origin) && strcmp(r->name, "*default*") != 0)
+			{
+				r->origin = strtoull(origin, NULL, 16);
+				r->length = strtoull(length, NULL, 16);
+				r->used = 0;
+				regionsNum++;
+			}
+			continue;
+		}
+
+		/* a name too long for its column continues on the next line */
+		if (pending[0])
+		{
+			n = sscanf(line, "%31s %31s %127s", addr, size, file);
+			if (n >= 2 && is_hex(addr) && is_hex(size))
+			{
+				add(pending, n == 3 ? file : "", strtoull(addr, NULL, 16), strtoull(size, NULL, 16),
+						pendingOutput);
+			}
+			pending[0] = 0;
+			continue;
+		}
+
+		/* output sections start in column 0, input sections in column 1 */
+		if (line[0] == '.' || (line[0] == ' ' && line[1] == '.'))
+		{
+			int output = line[0] == '.';
+
+			n = sscanf(line, "%127s %31s %31s %127s", name, addr, size, file);
+			if (n == 1)
+			{
+				snprintf(pending, sizeof(pending), "%s", name);
+				pendingOutput = output;
+			}
+			else if (n >= 3 && is_hex(addr) && is_hex(size))
+			{
+				add(name, n == 4 && !output ? file : "", strtoull(addr, NULL, 16), strtoull(size, NULL, 16),
+						output);
+			}
+		}
+		else if (strncmp(line, " *fill*", 7) == 0)
+		{
+			n = sscanf(line, "%127s %31s %31s", name, addr, size);
+			if (n == 3 && is_hex(addr) && is_hex(size))
+			{
+				add(name, "", strtoull(addr, NULL, 16), strtoull(size, NULL, 16), 0);
+			}
+		}
+	}
+}
+
+int main(int argc, char **argv)
+{
+	const char *only = NULL;
+	unsigned long top = 20, shown;
+	size_t i;
+	int opt, r;
+	FILE *f;
+
+	while ((opt = getopt(argc, argv, "r:n:x:")) != -1)
+	{
+		switch (opt)
+		{
+		case 'r':
+			only = optarg;
+			break;
+		case 'n':
+			top = strtoul(optarg, NULL, 0);
+			break;
+		case 'x':
+			forbidden = optarg;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-r region] [-n top] [-x member] <map file>\n", argv[0]);
+			return 2;
+		}
+	}
+	if (optind != argc - 1)
+	{
+		fprintf(stderr, "usage: %s [-r region] [-n top] [-x member] <map file>\n", argv[0]);
+		return 2;
+	}
+
+	f = fopen(argv[optind], "r");
+	if (!f)
+	{
+		perror(argv[optind]);
+		return 1;
+	}
+	parse(f);
+	fclose(f);
+	if (!regionsNum)
+	{
+		fprintf(stderr, "%s: no memory configuration, not a GNU ld map?\n", argv[optind]);
+		return 1;
+	}
+
+	qsort(entries, entriesNum, sizeof(*entries), by_size);
+	for (i = 0; i < entriesNum; i++)
+	{
+		if (entries[i].output)
+		{
+			regions[entries[i].region].used += entries[i].size;
+		}
+	}
+
+	for (r = 0; r < regionsNum; r++)
+	{
+		const region_t *g = &regions[r];
+
+		if (only && strcmp(only, g->name) != 0)
+		{
+			continue;
+		}
+		printf("%-10s 0x%08llx %8llu / %8llu bytes %5.1f%%\n", g->name, g->origin, g->used, g->length,
+				g->length ? 100.0 * g->used / g->length : 0.0);
+
+		for (i = 0; i < entriesNum; i++)
+		{
+			if (entries[i].region == r && entries[i].output)
+			{
+				printf("  %-24s 0x%08llx %8llu\n", entries[i].name, entries[i].addr, entries[i].size);
+			}
+		}
+		shown = 0;
+		for (i = 0; i < entriesNum && shown < top; i++)
+		{
+			if (entries[i].region == r && !entries[i].output)
+			{
+				printf("    %8llu  %-32s %s\n", entries[i].size, entries[i].name, entries[i].file);
+				shown++;
+			}
+		}
+	}
+
+	free(entries);
+
+	return forbiddenFound ? 1 : 0;
+}
@@ -0,0 +1,297 @@
+/*
+ * pdr_replay.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Replays a foot-mounted walk through the firmware ESKF + ZUPT PDR
+ *  (eskf.c, pdr.c) and prints the detected steps.
+ *
+ *  ./pdr_replay [-f rate Hz] [-w window] [-g threshold] [-m min stance]
+ *               [-a align samples] [-S steps per side] [-L step m]
+ *               [-R seed] [-o write synthetic log] [-q]
+ *               [-s steps] [-e x,y] [-r end error m] [log file]
+ *
+ *  The log is in print_motion7() format (see eskf_replay.c) and starts
+ *  at rest: the first -a samples, 0.3 s by default, level the filter. With -S
+ *  a deterministic walk around a square is synthesised instead: -S steps
+ *  of -L m per side, stance 0.4 s and swing 0.6 s with foot pitch, lift
+ *  and the 90 deg turn done during the first swing of each side, plus
+ *  seeded sensor noise. The true path length and end point are printed
+ *  next to the estimate, and -o saves the samples in print_motion7()
+ *  format for the other replay tools.
+ *
+ *  As a regression test, -s is the expected step count and -r the
+ *  largest allowed distance of the estimated end point from -e (from
+ *  the truth with -S). The exit status is 1 when either is missed.
+ *  "make check-pdr" replays the walks in walks/ against their bounds.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "eskf.h"
+#include "pdr.h"
+
+#define STANCE_S 0.4
+#define SWING_S 0.6
+#define LIFT_M 0.1
+#define PITCH_RAD 0.6
+
+typedef struct
+{
+	uint32_t steps;			/* per side */
+	double length;
+	double rate;
+	uint32_t k, n;
+	double t, p[3], v[3];	/* truth, integrated */
+	uint64_t rng;
+} walk_t;
+
+static double gauss(walk_t *w)
+{
+	double u1, u2;
+
+	w->rng = w->rng * 6364136223846793005ULL + 1442695040888963407ULL;
+	u1 = ((w->rng >> 11) + 1.0) / 9007199254740993.0;
+	w->rng = w->rng * 6364136223846793005ULL + 1442695040888963407ULL;
+	u2 = (w->rng >> 11) / 9007199254740992.0;
+
+	return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+/* one sample of the synthetic walk, returns 0 at the end */
+static int walk_sample(walk_t *w, float a[3], float g[3])
+{
+	double period = STANCE_S + SWING_S, tau, ph, s_d = 0, s_dd = 0, z_dd = 0;
+	double psi, psi_d = 0, th = 0, th_d = 0, an[3], cps, sps, cth, sth, fb[3];
+	uint32_t step, side;
+	int i;
+
+	if (w->k >= w->n)
+	{
+		return 0;
+	}
+
+	w->t = w->k / w->rate;
+	step = (uint32_t)(w->t / period);
+	side = step / w->steps;
+	ph = w->t - step * period;
+	psi = side * M_PI / 2.0;
+
+	/* one extra stance at the end */
+	if (ph > STANCE_S && step < 4 * w->steps)
+	{
+		double W = 2.0 * M_PI / SWING_S, turn = (step % w->steps == 0 && side > 0) ? M_PI / 2.0 : 0.0;
+
+		tau = (ph - STANCE_S) / SWING_S;
+		s_d = w->length / SWING_S * (1.0 - cos(2.0 * M_PI * tau));
+		s_dd = w->length / SWING_S * W * sin(2.0 * M_PI * tau);
+		z_dd = 0.5 * LIFT_M * W * W * cos(2.0 * M_PI * tau);
+		th = PITCH_RAD * sin(2.0 * M_PI * tau);
+		th_d = PITCH_RAD * W * cos(2.0 * M_PI * tau);
+		psi = psi - turn + turn * (tau - sin(2.0 * M_PI * tau) / (2.0 * M_PI));
+		psi_d = turn / SWING_S * (1.0 - cos(2.0 * M_PI * tau));
+	}
+
+	cps = cos(psi); sps = sin(psi);
+	cth = cos(th); sth = sin(th);
+
+	an[0] = s_dd * cps - s_d * psi_d * sps;
+	an[1] = s_dd * sps + s_d * psi_d * cps;
+	an[2] = z_dd + ESKF_GRAVITY;
+
+	/* body = yaw(psi) * pitch(th), f_body = R' (a - g) */
+	{
+		double r0 = cps * an[0] + sps * an[1], r1 = -sps * an[0] + cps * an[1];
+
+		fb[0] = cth * r0 - sth * an[2];
+		fb[1] = r1;
+		fb[2] = sth * r0 + cth * an[2];
+	}
+
+	g[0] = (float)(-sth * psi_d + 0.0012 * gauss(w));
+	g[1] = (float)(th_d + 0.0012 * gauss(w));
+	g[2] = (float)(cth * psi_d + 0.0012 * gauss(w));
+	for (i = 0; i < 3; i++)
+	{
+		a[i] = (float)(fb[i] + 0.02 * gauss(w));
+	}
+
+	/* truth position, horizontal only matters */
+	w->v[0] = s_d * cps;
+	w->v[1] = s_d * sps;
+	w->p[0] += w->v[0] / w->rate;
+	w->p[1] += w->v[1] / w->rate;
+
+	w->k++;
+
+	return 1;
+}
+
+static int read_sample(FILE *in, float *t, float a[3], float g[3])
+{
+	char line[256];
+	float temp;
+
+	while (fgets(line, sizeof(line), in))
+	{
+		if (sscanf(line, "%f;%f;%f;%f;%f;%f;%f;%f", t, &a[0], &a[1], &a[2], &g[0], &g[1], &g[2], &temp) == 8)
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	eskf_noise_t noise = { 1.75e-4f, 2.94e-3f, 1e-5f, 1e-4f };
+	pdr_config_t cfg = { 100.0f, 5, 5, 0.02f, 0.002f, 3e4f, 1e-4f };
+	walk_t walk = { 0, 0.7, 100.0, 0, 0, 0, { 0 }, { 0 }, 12345 };
+	uint32_t alignN = 0, n, quiet = 0, fail = 0;
+	long expSteps = -1;
+	double endX = 0.0, endY = 0.0, endTol = 0.0, err;
+	int haveEnd = 0;
+	float t = 0.0f, a[3], g[3], aSum[3] = { 0 }, gSum[3] = { 0 };
+	const eskf_state_t *x = ESKF_State();
+	const pdr_stats_t *st = PDR_Stats();
+	FILE *in = NULL, *out = NULL;
+	pdr_step_t step;
+	int opt, i, more;
+
+	while ((opt = getopt(argc, argv, "f:w:g:m:a:S:L:R:o:qs:e:r:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'f': cfg.sampleHz = strtof(optarg, NULL); break;
+			case 'w': cfg.window = strtoul(optarg, NULL, 0); break;
+			case 'g': cfg.threshold = strtof(optarg, NULL); break;
+			case 'm': cfg.minStance = strtoul(optarg, NULL, 0); break;
+			case 'a': alignN = strtoul(optarg, NULL, 0); break;
+			case 'S': walk.steps = strtoul(optarg, NULL, 0); break;
+			case 'L': walk.length = atof(optarg); break;
+			case 'R': walk.rng = strtoull(optarg, NULL, 0); break;
+			case 'o': out = fopen(optarg, "w"); break;
+			case 'q': quiet = 1; break;
+			case 's': expSteps = strtol(optarg, NULL, 0); break;
+			case 'e': haveEnd = sscanf(optarg, "%lf,%lf", &endX, &endY) == 2; break;
+			case 'r': endTol = atof(optarg); break;
+			default:
+				fprintf(stderr, "see the header of pdr_replay.c for options\n");
+				return 2;
+		}
+	}
+
+	/* inside the first stance, which is 0.4 s in the synthetic walk */
+	if (alignN == 0)
+	{
+		alignN = (uint32_t)(0.3f * cfg.sampleHz);
+	}
+
+	if (walk.steps)
+	{
+		walk.rate = cfg.sampleHz;
+		walk.n = (uint32_t)((4 * walk.steps * (STANCE_S + SWING_S) + STANCE_S) * walk.rate);
+	}
+	else
+	{
+		in = (optind < argc) ? fopen(argv[optind], "r") : stdin;
+		if (!in)
+		{
+			perror(argv[optind]);
+			return 1;
+		}
+	}
+
+	ESKF_Init(&noise);
+	PDR_Init(&cfg);
+
+	for (n = 0;; n++)
+	{
+		more = walk.steps ? walk_sample(&walk, a, g) : read_sample(in, &t, a, g);
+		if (!more)
+		{
+			break;
+		}
+		if (walk.steps)
+		{
+			t = (float)walk.t;
+		}
+		if (out)
+		{
+			fprintf(out, "%8.4f;%8.4f;%8.4f;%8.4f;%8.4f;%8.4f;%8.4f;%8.4f\n", t, a[0], a[1], a[2], g[0], g[1], g[2], 25.0);
+		}
+
+		/* level from the first samples of the initial stance */
+		if (n < alignN)
+		{
+			for (i = 0; i < 3; i++)
+			{
+				aSum[i] += a[i];
+				gSum[i] += g[i];
+			}
+			if (n == alignN - 1)
+			{
+				ESKF_AlignFromAccel(aSum[0], aSum[1], aSum[2]);
+			}
+		}
+
+		ESKF_Predict(g[0], g[1], g[2], a[0], a[1], a[2], 1.0f / cfg.sampleHz);
+		PDR_Update(g[0], g[1], g[2], a[0], a[1], a[2]);
+
+		while (PDR_PopStep(&step) == 0)
+		{
+			if (!quiet)
+			{
+				printf("%.2f step %lu: %.3f m heading %.1f deg dz %.3f m %.2f s\n", t, (unsigned long)step.index,
+						step.length, step.heading * 57.29578f, step.dp[2], step.duration);
+			}
+		}
+	}
+
+	printf("%lu samples, %lu stance, %lu steps, %.2f m, end %.3f %.3f %.3f m\n",
+			(unsigned long)st->samples, (unsigned long)st->stanceSamples, (unsigned long)st->steps,
+			st->distance, x->p[0], x->p[1], x->p[2]);
+	if (walk.steps)
+	{
+		printf("truth: %lu steps, %.2f m, end %.3f %.3f m\n", (unsigned long)(4 * walk.steps),
+				4 * walk.steps * walk.length, walk.p[0], walk.p[1]);
+	}
+	if (out)
+	{
+		fclose(out);
+	}
+
+	if (walk.steps)
+	{
+		if (expSteps < 0)
+		{
+			expSteps = 4 * walk.steps;
+		}
+		if (!haveEnd)
+		{
+			endX = walk.p[0];
+			endY = walk.p[1];
+			haveEnd = 1;
+		}
+	}
+	if (expSteps >= 0 && st->steps != (uint32_t)expSteps)
+	{
+		printf("FAIL: %lu steps, expected %ld\n", (unsigned long)st->steps, expSteps);
+		fail = 1;
+	}
+	if (endTol > 0.0 && haveEnd)
+	{
+		err = hypot(x->p[0] - endX, x->p[1] - endY);
+		if (err > endTol)
+		{
+			printf("FAIL: end point %.3f m from %.3f %.3f, allowed %.3f m\n", err, endX, endY, endTol);
+			fail = 1;
+		}
+	}
+
+	return fail;
+}
@@ -0,0 +1,308 @@
+/*
+ * pf_bench.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Runs the firmware particle filter (pf.c) on a synthetic office floor
+ *  and reports tracking error and throughput in particles per ms for the
+ *  step, range and resampling passes.
+ *
+ *  ./pf_bench [-n particles] [-d heading drift deg/step] [-r] [-m]
+ *             [-L laps] [-S seed] [-o map file] [-q]
+ *
+ *  The floor is 40 x 20 m at 0.2 m cells: a corridor along the middle,
+ *  rooms on both sides with 1 m doors. The walker goes down the corridor,
+ *  in and out of two rooms and back, 0.7 m steps. The PDR heading drifts
+ *  by -d deg per step (0.3 by default) with 2 deg noise, the step length
+ *  has 5 % noise. -r adds a beacon range every 4 steps from beacons in
+ *  the four corners, -m leaves the map out. With -n 0 the throughput is
+ *  measured for 256..PF_MAX_PARTICLES. -o writes the floor as a map file
+ *  (pf.h) and checks that PF_ParseMap() reads it back.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "pf.h"
+
+#define W_M 40.0f
+#define H_M 20.0f
+#define CELL 0.2f
+#define COLS 200
+#define ROWS 100
+#define STRIDE ((COLS + 7) / 8)
+
+static uint8_t bits[ROWS * STRIDE];
+static uint64_t rng = 12345;
+
+static double gauss(void)
+{
+	double u1, u2;
+
+	rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+	u1 = ((rng >> 11) + 1.0) / 9007199254740993.0;
+	rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+	u2 = (rng >> 11) / 9007199254740992.0;
+
+	return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static double now_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e3 + ts.tv_nsec * 1e-6;
+}
+
+static void set_wall(float x0, float y0, float x1, float y1)
+{
+	int cx, cy;
+
+	for (cy = (int)(y0 / CELL); cy <= (int)(y1 / CELL) && cy < ROWS; cy++)
+	{
+		for (cx = (int)(x0 / CELL); cx <= (int)(x1 / CELL) && cx < COLS; cx++)
+		{
+			bits[cy * STRIDE + (cx >> 3)] |= 0x80 >> (cx & 7);
+		}
+	}
+}
+
+static void clear_wall(float x0, float y0, float x1, float y1)
+{
+	int cx, cy;
+
+	for (cy = (int)(y0 / CELL); cy <= (int)(y1 / CELL) && cy < ROWS; cy++)
+	{
+		for (cx = (int)(x0 / CELL); cx <= (int)(x1 / CELL) && cx < COLS; cx++)
+		{
+			bits[cy * STRIDE + (cx >> 3)] &= ~(0x80 >> (cx & 7));
+		}
+	}
+}
+
+static void build_floor(void)
+{
+	float x;
+
+	memset(bits, 0, sizeof(bits));
+	set_wall(0, 0, W_M, 0);
+	set_wall(0, H_M - CELL, W_M, H_M);
+	set_wall(0, 0, 0, H_M);
+	set_wall(W_M - CELL, 0, W_M, H_M);
+
+	/* corridor 9..11 m, rooms every 10 m */
+	set_wall(0, 8.8f, W_M, 9.0f);
+	set_wall(0, 11.0f, W_M, 11.2f);
+	for (x = 10.0f; x < W_M; x += 10.0f)
+	{
+		set_wall(x, 0, x + CELL, 8.8f);
+		set_wall(x, 11.2f, x + CELL, H_M);
+	}
+	for (x = 5.0f; x < W_M; x += 10.0f)
+	{
+		clear_wall(x, 8.8f, x + 1.0f, 9.0f);
+		clear_wall(x, 11.0f, x + 1.0f, 11.2f);
+	}
+}
+
+/* the floor in the format PF_LoadMap() reads, then back through PF_ParseMap() */
+static int write_map(const char *path)
+{
+	static uint8_t file[PF_MAP_BYTES];
+	pf_map_t m;
+	FILE *out = fopen(path, "wb");
+	long n;
+
+	if (!out)
+	{
+		perror(path);
+		return 1;
+	}
+	fprintf(out, "P4\n# pf %.2f 0 0\n%d %d\n", CELL, COLS, ROWS);
+	fwrite(bits, 1, sizeof(bits), out);
+	n = ftell(out);
+	fclose(out);
+
+	out = fopen(path, "rb");
+	if (n > (long)sizeof(file) || fread(file, 1, n, out) != (size_t)n || PF_ParseMap(file, n, &m) != 0
+			|| m.width != COLS || m.height != ROWS || fabsf(m.cell - CELL) > 1e-6f
+			|| memcmp(m.bits, bits, sizeof(bits)) != 0)
+	{
+		fprintf(stderr, "%s: %ld bytes, not read back (at most %d)\n", path, n, PF_MAP_BYTES);
+		fclose(out);
+		return 1;
+	}
+	fclose(out);
+	printf("%s: %ld bytes, %d x %d cells of %.2f m\n", path, n, COLS, ROWS, CELL);
+
+	return 0;
+}
+
+typedef struct
+{
+	float x, y;
+} point_t;
+
+/* corridor, into the room above the second door, out, into the one below the fourth, back */
+static const point_t route[] = {
+	{ 2.0f, 10.0f }, { 15.5f, 10.0f }, { 15.5f, 16.0f }, { 18.0f, 16.0f }, { 18.0f, 14.0f },
+	{ 15.5f, 14.0f }, { 15.5f, 10.0f }, { 35.5f, 10.0f }, { 35.5f, 4.0f }, { 38.0f, 4.0f },
+	{ 38.0f, 6.0f }, { 35.5f, 6.0f }, { 35.5f, 10.0f }, { 2.0f, 10.0f }
+};
+
+static void track(uint16_t particles, float drift, int ranges, int useMap, uint32_t laps, int quiet)
+{
+	static const float beacons[4][3] = { { 0.5f, 0.5f, 2.5f }, { 39.5f, 0.5f, 2.5f }, { 39.5f, 19.5f, 2.5f }, { 0.5f, 19.5f, 2.5f } };
+	pf_map_t map = { COLS, ROWS, CELL, 0.0f, 0.0f, bits };
+	pf_config_t cfg = { particles, 0.1f, 0.01f, 0.05f, 0.5f, 1.0f, 1 };
+	const pf_estimate_t *e = PF_Estimate();
+	const pf_stats_t *st = PF_Stats();
+	float x = route[0].x, y = route[0].y, bias = 0.0f, err = 0.0f, sum2 = 0.0f, maxErr = 0.0f;
+	uint32_t seg, steps = 0, lap;
+
+	PF_Init(&cfg);
+	PF_SetMap(useMap ? &map : NULL);
+	PF_Reset(x, y, 0.3f);
+
+	for (lap = 0; lap < laps; lap++)
+	{
+		for (seg = 1; seg < sizeof(route) / sizeof(route[0]); seg++)
+		{
+			float dx = route[seg].x - x, dy = route[seg].y - y;
+			float len = sqrtf(dx * dx + dy * dy), hdg = atan2f(dy, dx);
+			uint32_t k, n = (uint32_t)(len / 0.7f + 0.5f);
+
+			for (k = 0; k < n; k++)
+			{
+				float L = len / n;
+
+				x += L * cosf(hdg);
+				y += L * sinf(hdg);
+				bias -= drift;
+				PF_Step(L * (float)(1.0 + 0.05 * gauss()), hdg + bias + (float)(0.035 * gauss()));
+				steps++;
+
+				if (ranges && steps % 4 == 0)
+				{
+					const float *b = beacons[(steps / 4) % 4];
+					float d = sqrtf((x - b[0]) * (x - b[0]) + (y - b[1]) * (y - b[1]) + 1.5f * 1.5f);
+					float r = d * powf(10.0f, (float)(4.0 * gauss()) / 25.0f), sd = r * 2.302585f * 4.0f / 25.0f;
+
+					PF_Range(b, r, sd * sd);
+				}
+
+				err = sqrtf((e->x - x) * (e->x - x) + (e->y - y) * (e->y - y));
+				sum2 += err * err;
+				if (err > maxErr)
+				{
+					maxErr = err;
+				}
+				if (!quiet && steps % 10 == 0)
+				{
+					printf("step %4lu truth %6.2f %6.2f est %6.2f %6.2f err %5.2f sd %4.2f %4.2f hdg %6.1f (drift %6.1f) neff %.0f\n",
+							(unsigned long)steps, x, y, e->x, e->y, err, e->sx, e->sy, e->heading * 57.29578f,
+							bias * 57.29578f, e->neff);
+				}
+			}
+		}
+	}
+
+	printf("%u particles, %s%s: %lu steps, error rms %.2f m max %.2f m end %.2f m, heading offset %.1f deg (true %.1f)\n",
+			particles, useMap ? "map" : "no map", ranges ? " + ranges" : "", (unsigned long)steps,
+			sqrtf(sum2 / steps), maxErr, err, e->heading * 57.29578f, -bias * 57.29578f);
+	printf("resamples %lu depletions %lu\n", (unsigned long)st->resamples, (unsigned long)st->depletions);
+}
+
+static void throughput(uint16_t particles)
+{
+	static const float b[3] = { 0.5f, 0.5f, 2.5f };
+	pf_map_t map = { COLS, ROWS, CELL, 0.0f, 0.0f, bits };
+	pf_config_t cfg = { particles, 0.1f, 0.01f, 0.05f, 0.0f, 1.0f, 1 };
+	double t0, tStep, tRange;
+	uint32_t k, n = 2000;
+
+	/* step and range alone first, then steps that resample every time */
+	cfg.resampleRatio = 0.0f;
+	PF_Init(&cfg);
+	PF_SetMap(&map);
+	PF_Reset(20.0f, 10.0f, 0.3f);
+	t0 = now_ms();
+	for (k = 0; k < n; k++)
+	{
+		/* back and forth along the corridor */
+		PF_Step(0.7f, (k & 1) ? (float)M_PI : 0.0f);
+	}
+	tStep = now_ms() - t0;
+
+	t0 = now_ms();
+	for (k = 0; k < n; k++)
+	{
+		PF_Range(b, 21.0f, 4.0f);
+	}
+	tRange = now_ms() - t0;
+
+	cfg.resampleRatio = 2.0f;
+	PF_Init(&cfg);
+	PF_SetMap(&map);
+	PF_Reset(20.0f, 10.0f, 0.3f);
+	t0 = now_ms();
+	for (k = 0; k < n; k++)
+	{
+		PF_Step(0.7f, (k & 1) ? (float)M_PI : 0.0f);
+	}
+
+	printf("%5u particles: step %8.0f  range %8.0f  resample %8.0f particles/ms\n", particles,
+			particles * n / tStep, particles * n / tRange, particles * n / fmax(now_ms() - t0 - tStep, 1e-3));
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t laps = 1;
+	int particles = 2048, ranges = 0, useMap = 1, quiet = 0, opt;
+	float drift = 0.3f;
+	const char *mapPath = NULL;
+
+	while ((opt = getopt(argc, argv, "n:d:rmL:S:o:q")) != -1)
+	{
+		switch (opt)
+		{
+			case 'n': particles = atoi(optarg); break;
+			case 'd': drift = strtof(optarg, NULL); break;
+			case 'r': ranges = 1; break;
+			case 'm': useMap = 0; break;
+			case 'L': laps = strtoul(optarg, NULL, 0); break;
+			case 'S': rng = strtoull(optarg, NULL, 0); break;
+			case 'o': mapPath = optarg; break;
+			case 'q': quiet = 1; break;
+			default:
+				fprintf(stderr, "see the header of pf_bench.c for options\n");
+				return 2;
+		}
+	}
+
+	build_floor();
+
+	if (mapPath)
+	{
+		return write_map(mapPath);
+	}
+
+	if (particles == 0)
+	{
+		for (particles = 256; particles <= PF_MAX_PARTICLES; particles *= 2)
+		{
+			throughput(particles);
+		}
+		return 0;
+	}
+
+	track(particles > PF_MAX_PARTICLES ? PF_MAX_PARTICLES : particles, drift * 0.01745329f, ranges, useMap, laps, quiet);
+	throughput(particles > PF_MAX_PARTICLES ? PF_MAX_PARTICLES : particles);
+
+	return 0;
+}
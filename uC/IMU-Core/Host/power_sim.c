@@ -0,0 +1,319 @@
+/*
+ * power_sim.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Runs power.c against a simulated day: the POWER_Port* functions are
+ *  a sample timer, an MPU9250 whose wake on motion compares successive
+ *  low power accel samples against WOM_THR, and an MCU that sleeps until
+ *  the next INT pulse, with its wake up and clock restore times. Time is
+ *  simulated, so hours take milliseconds.
+ *
+ *  ./power_sim [-c scenario] [-t still s] [-m wom mg] [-o lp odr] [-W]
+ *
+ *  The scenario is a comma separated list of w<seconds> (walking),
+ *  s<seconds> (standing) and b<seconds> (a knock while standing), by
+ *  default w60,s120,w30,s10,w30,s20,b0.3,s300. -W sleeps with WFI
+ *  instead of Stop. The state times are printed against the times the
+ *  scenario allows, standing minus the still time before each entry.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "power.h"
+
+#define SIM_SAMPLE_HZ 100.0
+#define SIM_TICK_US 62.5
+#define SIM_STOP_EXIT_US 20.0		/* low power regulator */
+#define SIM_CLOCK_US 1800.0			/* HSE start up and PLL lock after Stop */
+#define SIM_SENSOR_US 250.0			/* register writes with read back */
+#define SIM_MAX_SEGMENTS 64
+
+typedef struct
+{
+	char kind;
+	double start, end;
+} segment_t;
+
+static segment_t scenario[SIM_MAX_SEGMENTS];
+static int segments;
+static double now, end;
+
+static uint8_t sampling, womOn, stopMode;
+static double lpPeriod, womG;
+static double nextSample;
+static uint32_t sensorLow, sensorFull;
+
+static uint64_t rng = 7;
+
+static double gauss(void)
+{
+	double s = 0.0;
+	int i;
+
+	for (i = 0; i < 12; i++)
+	{
+		rng ^= rng << 13;
+		rng ^= rng >> 7;
+		rng ^= rng << 17;
+		s += (rng >> 11) * (1.0 / 9007199254740992.0);
+	}
+	return s - 6.0;
+}
+
+static char kind_at(double t)
+{
+	int i;
+
+	for (i = 0; i < segments; i++)
+	{
+		if (t >= scenario[i].start && t < scenario[i].end)
+		{
+			return scenario[i].kind;
+		}
+	}
+	return 's';
+}
+
+/* body rates in rad/s and accel in m/s^2 at time t, us */
+static void motion(double t, double *g, double *a)
+{
+	double s = t * 1e-6;
+	char k = kind_at(t);
+	int i;
+
+	for (i = 0; i < 3; i++)
+	{
+		g[i] = 0.003 * gauss();
+		a[i] = 0.02 * gauss();
+	}
+	a[2] += 9.807;
+
+	if (k == 'w')
+	{
+		/* foot at 1.8 steps per second */
+		g[1] += 4.0 * sin(2.0 * M_PI * 0.9 * s);
+		a[0] += 6.0 * sin(2.0 * M_PI * 0.9 * s + 0.5);
+		a[2] += 4.0 * sin(2.0 * M_PI * 1.8 * s);
+	}
+	else if (k == 'b')
+	{
+		a[0] += 2.0 * sin(2.0 * M_PI * 6.0 * s);
+		g[2] += 0.2 * sin(2.0 * M_PI * 6.0 * s);
+	}
+}
+
+void POWER_PortInit(void)
+{
+}
+
+uint32_t POWER_PortTicks(void)
+{
+	return (uint32_t)(uint64_t)(now / SIM_TICK_US);
+}
+
+float POWER_PortTickUs(void)
+{
+	return (float)SIM_TICK_US;
+}
+
+void POWER_PortSampling(uint8_t on)
+{
+	sampling = on;
+	nextSample = now;
+}
+
+int32_t POWER_PortSensor(uint8_t lowPower, const power_config_t *cfg)
+{
+	now += SIM_SENSOR_US;
+	womOn = lowPower;
+	if (lowPower)
+	{
+		sensorLow++;
+		lpPeriod = 1e6 / (0.244140625 * (1 << cfg->lpOdr));
+		womG = cfg->womMg / 4 * 4 * 1e-3 * 9.807;
+	}
+	else
+	{
+		sensorFull++;
+	}
+	return 0;
+}
+
+void POWER_PortWakeIrq(uint8_t on)
+{
+	(void)on;
+}
+
+/* the first low power sample after now that moved more than WOM_THR on any axis */
+static double wom_edge(void)
+{
+	double g[3], a[3], last[3], t = now;
+	int i;
+
+	motion(t, g, last);
+	while ((t += lpPeriod) < end)
+	{
+		motion(t, g, a);
+		for (i = 0; i < 3; i++)
+		{
+			if (fabs(a[i] - last[i]) > womG)
+			{
+				return t;
+			}
+		}
+		memcpy(last, a, sizeof(last));
+	}
+	return -1.0;
+}
+
+uint32_t POWER_PortSleep(uint8_t stop, volatile const uint8_t *wake)
+{
+	double edge;
+	uint32_t woke;
+
+	stopMode = stop;
+	if (*wake)
+	{
+		return POWER_PortTicks();
+	}
+	edge = womOn ? wom_edge() : -1.0;
+	if (edge < 0.0)
+	{
+		now = end;
+		return POWER_PortTicks();
+	}
+
+	now = edge + (stop ? SIM_STOP_EXIT_US : 0.5);
+	woke = POWER_PortTicks();
+	if (stop)
+	{
+		now += SIM_CLOCK_US;
+	}
+	/* interrupts back on, the INT handler runs */
+	POWER_MotionIrq();
+
+	return woke;
+}
+
+static int parse(const char *s)
+{
+	double t = 0.0;
+
+	segments = 0;
+	while (*s && segments < SIM_MAX_SEGMENTS)
+	{
+		char *next;
+		double d;
+
+		if (*s != 'w' && *s != 's' && *s != 'b')
+		{
+			return -1;
+		}
+		d = strtod(s + 1, &next);
+		if (next == s + 1 || d <= 0.0)
+		{
+			return -1;
+		}
+		scenario[segments].kind = *s;
+		scenario[segments].start = t * 1e6;
+		t += d;
+		scenario[segments].end = t * 1e6;
+		segments++;
+		s = *next == ',' ? next + 1 : next;
+	}
+	end = t * 1e6;
+
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	power_config_t cfg = { SIM_SAMPLE_HZ, 5.0f, 0.05f, 0.3f, 80, 5, 1, 1 };
+	const char *text = "w60,s120,w30,s10,w30,s20,b0.3,s300";
+	const power_stats_t *st;
+	double standing = 0.0, allowed = 0.0;
+	uint32_t samples = 0;
+	int opt, i;
+
+	while ((opt = getopt(argc, argv, "c:t:m:o:W")) != -1)
+	{
+		switch (opt)
+		{
+		case 'c':
+			text = optarg;
+			break;
+		case 't':
+			cfg.stillSeconds = strtof(optarg, NULL);
+			break;
+		case 'm':
+			cfg.womMg = (uint16_t)strtoul(optarg, NULL, 10);
+			break;
+		case 'o':
+			cfg.lpOdr = (uint8_t)strtoul(optarg, NULL, 10);
+			break;
+		case 'W':
+			cfg.stop = 0;
+			break;
+		default:
+			fprintf(stderr, "see the header of power_sim.c for options\n");
+			return 2;
+		}
+	}
+	if (parse(text) != 0)
+	{
+		fprintf(stderr, "bad scenario %s\n", text);
+		return 2;
+	}
+
+	POWER_Init(&cfg);
+	sampling = 1;
+	nextSample = 0.0;
+
+	while (now < end)
+	{
+		if (POWER_State() == POWER_ACTIVE)
+		{
+			double g[3], a[3];
+
+			if (!sampling)
+			{
+				/* the timer is stopped only on the way into wake on motion */
+				POWER_Poll();
+				continue;
+			}
+			now = nextSample;
+			nextSample += 1e6 / SIM_SAMPLE_HZ;
+			motion(now, g, a);
+			POWER_AddSample((float)g[0], (float)g[1], (float)g[2], (float)a[0], (float)a[1], (float)a[2]);
+			samples++;
+		}
+		POWER_Poll();
+	}
+
+	/* standing time a perfect detector sleeps through: a knock ends the still run */
+	for (i = 0; i < segments; i++)
+	{
+		double d = (scenario[i].end - scenario[i].start) * 1e-6;
+
+		if (scenario[i].kind == 's')
+		{
+			standing += d;
+			allowed += d > cfg.stillSeconds ? d - cfg.stillSeconds : 0.0;
+		}
+	}
+
+	st = POWER_Stats();
+	printf("scenario %s, %.0f s, %s, still %.1f s, wom %u mg at %.2f Hz\n", text, end * 1e-6, cfg.stop ? "Stop" : "WFI",
+			cfg.stillSeconds, cfg.womMg, 0.244140625 * (1 << cfg.lpOdr));
+	printf("standing %.1f s, of which after the still time %.1f s\n", standing, allowed);
+	printf("active %.1f s, low %.3f s, asleep %.1f s; %u samples, sensor low %u full %u\n", st->us[POWER_ACTIVE] * 1e-6,
+			st->us[POWER_LOW] * 1e-6, st->us[POWER_ASLEEP] * 1e-6, samples, sensorLow, sensorFull);
+	POWER_Command("");
+
+	return 0;
+}
@@ -0,0 +1,250 @@
+/*
+ * rf4463_sim.c
+ *
+ *  Created on: 18 Oct 2026
+ */
+
+#include <string.h>
+
+#include "rf4463.h"
+#include "rf4463_sim.h"
+#include "host_port.h"
+
+#define FIFO_SIZE 64
+
+typedef enum
+{
+	SIM_OFF,
+	SIM_BOOT,		/* out of shutdown, waiting for POWER_UP */
+	SIM_READY,
+	SIM_RX,
+	SIM_TX
+} sim_state;
+
+static sim_state state = SIM_OFF;
+static uint8_t selected;
+static uint8_t frame[80];
+static uint32_t frameLen;
+
+static uint8_t resp[16];
+static uint32_t respLen;
+
+static uint8_t rxFifo[FIFO_SIZE], txFifo[FIFO_SIZE];
+static uint32_t rxCount, rxPos, txCount;
+static uint8_t pktLen = RF4463_PACKET_LEN;
+static uint8_t phPend, latchRssi, txNext;
+
+static rfsim_stats_t stats;
+
+void RFSIM_Reset(void)
+{
+	state = SIM_OFF;
+	selected = 0;
+	frameLen = 0;
+	respLen = 0;
+	rxCount = rxPos = txCount = 0;
+	phPend = 0;
+	memset(&stats, 0, sizeof(stats));
+}
+
+const rfsim_stats_t* RFSIM_Stats(void)
+{
+	return &stats;
+}
+
+static void irq(uint8_t bits)
+{
+	phPend |= bits;
+	RF4463_IrqHandler();
+}
+
+static void execute(void)
+{
+	memset(resp, 0, sizeof(resp));
+	respLen = sizeof(resp);
+	stats.commands++;
+
+	if (state == SIM_BOOT && frame[0] == RF4463_CMD_POWER_UP)
+	{
+		state = SIM_READY;
+		return;
+	}
+	if (state < SIM_READY)
+	{
+		respLen = 0;	/* no CTS */
+		return;
+	}
+
+	switch (frame[0])
+	{
+		case RF4463_CMD_PART_INFO:
+			resp[0] = 0x22;
+			resp[1] = RF4463_PART >> 8;
+			resp[2] = RF4463_PART & 0xFF;
+			break;
+
+		case RF4463_CMD_SET_PROPERTY:
+			if (frame[1] == 0x12 && frame[3] == 0x0D && frame[2] >= 2)
+			{
+				pktLen = frame[5];
+			}
+			break;
+
+		case RF4463_CMD_FIFO_INFO:
+			if (frame[1] & 0x02)
+			{
+				rxCount = rxPos = 0;
+			}
+			if (frame[1] & 0x01)
+			{
+				txCount = 0;
+			}
+			resp[0] = rxCount - rxPos;
+			resp[1] = FIFO_SIZE - txCount;
+			break;
+
+		case RF4463_CMD_GET_INT_STATUS:
+			resp[0] = phPend ? 0x01 : 0x00;
+			resp[2] = phPend;
+			phPend &= frame[1];
+			break;
+
+		case RF4463_CMD_GET_MODEM_STATUS:
+			resp[3] = latchRssi;
+			break;
+
+		case RF4463_CMD_START_RX:
+			state = SIM_RX;
+			break;
+
+		case RF4463_CMD_START_TX:
+			/* airtime is not modelled, the packet leaves at once */
+			txNext = frame[2] >> 4;
+			stats.sent++;
+			txCount = 0;
+			state = (txNext == RF4463_STATE_RX) ? SIM_RX : SIM_READY;
+			irq(RF4463_PH_PACKET_SENT);
+			break;
+
+		case RF4463_CMD_CHANGE_STATE:
+			state = (frame[1] == RF4463_STATE_RX) ? SIM_RX : SIM_READY;
+			break;
+
+		default:
+			/* WDS property list, GPIO config: accepted */
+			break;
+	}
+}
+
+int RFSIM_Deliver(const uint8_t *data, uint8_t len, float rssiDbm, uint8_t crcOk)
+{
+	float raw = (rssiDbm + 134.0f) * 2.0f;
+
+	if (state != SIM_RX)
+	{
+		stats.missed++;
+		return 0;
+	}
+
+	latchRssi = raw < 0.0f ? 0 : (raw > 255.0f ? 255 : (uint8_t)(raw + 0.5f));
+	state = SIM_READY;
+	stats.delivered++;
+
+	if (!crcOk)
+	{
+		irq(RF4463_PH_CRC_ERROR);
+		return 1;
+	}
+
+	memset(rxFifo, 0, pktLen);
+	memcpy(rxFifo, data, len < pktLen ? len : pktLen);
+	rxCount = pktLen;
+	rxPos = 0;
+	irq(RF4463_PH_PACKET_RX);
+
+	return 1;
+}
+
+void RF4463_PortInit(void)
+{
+}
+
+void RF4463_PortShutdown(uint8_t on)
+{
+	state = on ? SIM_OFF : SIM_BOOT;
+	phPend = 0;
+	rxCount = rxPos = txCount = 0;
+}
+
+void RF4463_PortSelect(uint8_t on)
+{
+	if (on)
+	{
+		selected = 1;
+		frameLen = 0;
+		return;
+	}
+
+	if (selected && frameLen && frame[0] != RF4463_CMD_READ_CMD_BUFF &&
+		frame[0] != RF4463_CMD_READ_RX_FIFO && frame[0] != RF4463_CMD_WRITE_TX_FIFO)
+	{
+		execute();
+	}
+	selected = 0;
+}
+
+void RF4463_PortTransfer(const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+	while (len--)
+	{
+		uint8_t out = tx ? *tx++ : 0xFF, in = 0xFF;
+		uint32_t i = frameLen;
+
+		if (frameLen < sizeof(frame))
+		{
+			frame[frameLen] = out;
+		}
+		frameLen++;
+
+		if (i > 0)
+		{
+			switch (frame[0])
+			{
+				case RF4463_CMD_READ_CMD_BUFF:
+					if (i == 1)
+					{
+						in = respLen ? 0xFF : 0x00;	/* CTS */
+					}
+					else
+					{
+						in = (i - 2 < respLen) ? resp[i - 2] : 0xFF;
+					}
+					break;
+
+				case RF4463_CMD_READ_RX_FIFO:
+					in = (rxPos < rxCount) ? rxFifo[rxPos++] : 0x00;
+					break;
+
+				case RF4463_CMD_WRITE_TX_FIFO:
+					if (txCount < FIFO_SIZE)
+					{
+						txFifo[txCount++] = out;
+					}
+					break;
+
+				default:
+					break;
+			}
+		}
+
+		if (rx)
+		{
+			*rx++ = in;
+		}
+	}
+}
+
+void RF4463_PortDelayMs(uint32_t ms)
+{
+	HOST_AdvanceUs(ms * 1000);
+}
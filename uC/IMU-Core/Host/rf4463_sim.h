@@ -0,0 +1,30 @@
+/*
+ * rf4463_sim.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Simulated Si4463 behind the RF4463_Port* functions: decodes the SPI
+ *  command frames the driver sends, answers CTS and the status commands
+ *  and raises nIRQ (calls RF4463_IrqHandler()) when a packet is delivered
+ *  or sent.
+ */
+
+#ifndef RF4463_SIM_H_
+#define RF4463_SIM_H_
+
+#include <stdint.h>
+
+typedef struct
+{
+	uint32_t commands;
+	uint32_t delivered;
+	uint32_t missed;		/* packet arrived while the radio was not in RX */
+	uint32_t sent;
+} rfsim_stats_t;
+
+void RFSIM_Reset(void);
+/* returns 1 when the radio was listening and took the packet */
+int RFSIM_Deliver(const uint8_t *data, uint8_t len, float rssiDbm, uint8_t crcOk);
+const rfsim_stats_t* RFSIM_Stats(void);
+
+#endif /* RF4463_SIM_H_ */
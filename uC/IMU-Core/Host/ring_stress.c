@@ -0,0 +1,320 @@
+/*
+ * ring_stress.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Threaded stress run of ring.h. Threads stand in for the interrupts
+ *  and the main loop: the producers push sequence numbered elements as
+ *  fast as they can, and the consumer checks that every element arrives
+ *  once, intact and in order per producer.
+ *
+ *  ./ring_stress [-n elements] [-p producers] [-c capacity] [-y]
+ *
+ *  The SPSC pass rotates the producer through RING_Push() and reserve /
+ *  commit, and the consumer through RING_Pop(), RING_PopBatch() and
+ *  RING_PeekBatch(). The MPSC pass runs -p producers (default 3) on one
+ *  ring_mpsc_t. -y yields between reserve and commit now and then, the
+ *  host's stand-in for a producer preempted inside its critical window.
+ *  A full or empty ring yields the CPU, so the run also makes progress
+ *  with fewer cores than threads. Exit status is 1 on any lost,
+ *  duplicated, reordered or torn element.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ring.h"
+
+#define MAX_PRODUCERS 16
+#define BATCH 16
+#define PAYLOAD 5				/* words after the header, so a torn copy shows */
+
+typedef struct
+{
+	uint32_t producer;
+	uint32_t seq;
+	uint32_t payload[PAYLOAD];
+} elem_t;
+
+static uint32_t count = 10000000, producers = 3, capacity = 64;
+static int yield;
+
+static ring_t spsc;
+static ring_mpsc_t mpsc;
+static elem_t *slots;
+static uint32_t *seqs;
+
+static uint64_t fullSpins[MAX_PRODUCERS], emptySpins;
+static uint32_t errors;
+
+static void fill(elem_t *e, uint32_t producer, uint32_t seq)
+{
+	uint32_t i, x = producer * 2654435761u ^ seq;
+
+	e->producer = producer;
+	e->seq = seq;
+	for (i = 0; i < PAYLOAD; i++)
+	{
+		x = x * 1664525u + 1013904223u;
+		e->payload[i] = x;
+	}
+}
+
+static void check(const elem_t *e, uint32_t *next)
+{
+	elem_t want;
+
+	if (e->producer >= producers)
+	{
+		if (errors++ < 10)
+		{
+			fprintf(stderr, "bad producer %u\n", e->producer);
+		}
+		return;
+	}
+	fill(&want, e->producer, next[e->producer]);
+	if (memcmp(e, &want, sizeof(want)) != 0)
+	{
+		if (errors++ < 10)
+		{
+			fprintf(stderr, "producer %u: got seq %u, expected %u%s\n", e->producer, e->seq,
+					next[e->producer], e->seq == next[e->producer] ? " (torn)" : "");
+		}
+	}
+	next[e->producer] = e->seq + 1;
+}
+
+static int yield_now(uint32_t seq)
+{
+	return yield && (seq & 255) == 0;
+}
+
+static void* spsc_producer(void *arg)
+{
+	uint32_t seq;
+	elem_t e, *slot;
+
+	(void)arg;
+	for (seq = 0; seq < count; seq++)
+	{
+		if (seq & 1)
+		{
+			fill(&e, 0, seq);
+			while (RING_Push(&spsc, &e) != 0)
+			{
+				fullSpins[0]++;
+				sched_yield();
+			}
+			continue;
+		}
+		while ((slot = RING_Reserve(&spsc)) == NULL)
+		{
+			fullSpins[0]++;
+			sched_yield();
+		}
+		fill(slot, 0, seq);
+		if (yield_now(seq))
+		{
+			sched_yield();
+		}
+		RING_Commit(&spsc);
+	}
+
+	return NULL;
+}
+
+static void spsc_consumer(void)
+{
+	elem_t batch[BATCH];
+	uint32_t next[MAX_PRODUCERS] = { 0 }, got = 0, n, i, mode = 0;
+	void *first;
+
+	while (got < count)
+	{
+		switch (mode++ % 3)
+		{
+		case 0:
+			n = RING_Pop(&spsc, batch) == 0;
+			break;
+		case 1:
+			n = RING_PopBatch(&spsc, batch, BATCH);
+			break;
+		default:
+			n = RING_PeekBatch(&spsc, &first, BATCH);
+			memcpy(batch, first, n * sizeof(elem_t));
+			RING_Release(&spsc, n);
+			break;
+		}
+		if (n == 0)
+		{
+			emptySpins++;
+			sched_yield();
+			continue;
+		}
+		for (i = 0; i < n; i++)
+		{
+			check(&batch[i], next);
+		}
+		got += n;
+	}
+	if (RING_Count(&spsc) != 0)
+	{
+		errors++;
+		fprintf(stderr, "spsc: %u left over\n", RING_Count(&spsc));
+	}
+}
+
+static void* mpsc_producer(void *arg)
+{
+	uint32_t id = (uint32_t)(uintptr_t)arg, seq, ticket;
+	elem_t *slot;
+
+	for (seq = 0; seq < count / producers; seq++)
+	{
+		while ((slot = RING_MpscReserve(&mpsc, &ticket)) == NULL)
+		{
+			fullSpins[id]++;
+			sched_yield();
+		}
+		fill(slot, id, seq);
+		if (yield_now(seq))
+		{
+			sched_yield();
+		}
+		RING_MpscCommit(&mpsc, ticket);
+	}
+
+	return NULL;
+}
+
+static void mpsc_consumer(void)
+{
+	elem_t batch[BATCH];
+	uint32_t next[MAX_PRODUCERS] = { 0 }, got = 0, total = count / producers * producers, n, i;
+
+	while (got < total)
+	{
+		n = RING_MpscPopBatch(&mpsc, batch, BATCH);
+		if (n == 0)
+		{
+			emptySpins++;
+			sched_yield();
+			continue;
+		}
+		for (i = 0; i < n; i++)
+		{
+			check(&batch[i], next);
+		}
+		got += n;
+	}
+	for (i = 0; i < producers; i++)
+	{
+		if (next[i] != count / producers)
+		{
+			errors++;
+			fprintf(stderr, "mpsc: producer %u ended at %u of %u\n", i, next[i], count / producers);
+		}
+	}
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void report(const char *name, uint32_t n, double seconds, uint32_t threads)
+{
+	uint64_t full = 0;
+	uint32_t i;
+
+	for (i = 0; i < threads; i++)
+	{
+		full += fullSpins[i];
+	}
+	printf("%-4s %u producer(s) %u elements in %.2f s, %.1f M/s, full spins %llu, empty spins %llu, errors %u\n",
+			name, threads, n, seconds, n / seconds * 1e-6, (unsigned long long)full,
+			(unsigned long long)emptySpins, errors);
+}
+
+int main(int argc, char **argv)
+{
+	pthread_t threads[MAX_PRODUCERS];
+	uint32_t i, failed;
+	double t0;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:p:c:y")) != -1)
+	{
+		switch (opt)
+		{
+		case 'n':
+			count = (uint32_t)strtoul(optarg, NULL, 0);
+			break;
+		case 'p':
+			producers = (uint32_t)strtoul(optarg, NULL, 0);
+			break;
+		case 'c':
+			capacity = (uint32_t)strtoul(optarg, NULL, 0);
+			break;
+		case 'y':
+			yield = 1;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-n elements] [-p producers] [-c capacity] [-y]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (producers == 0 || producers > MAX_PRODUCERS || count < producers)
+	{
+		fprintf(stderr, "1 to %d producers, at least one element each\n", MAX_PRODUCERS);
+		return 2;
+	}
+
+	slots = malloc(capacity * sizeof(elem_t));
+	seqs = malloc(capacity * sizeof(uint32_t));
+	if (!slots || !seqs || RING_Init(&spsc, slots, capacity, sizeof(elem_t)) != 0)
+	{
+		fprintf(stderr, "capacity must be a power of two\n");
+		return 2;
+	}
+
+	/* single producer: the sample interrupt and the main loop */
+	t0 = now();
+	pthread_create(&threads[0], NULL, spsc_producer, NULL);
+	spsc_consumer();
+	pthread_join(threads[0], NULL);
+	report("spsc", count, now() - t0, 1);
+	failed = errors;
+
+	/* several producers: interrupts of different priorities and the main loop */
+	errors = 0;
+	emptySpins = 0;
+	memset(fullSpins, 0, sizeof(fullSpins));
+	RING_MpscInit(&mpsc, slots, seqs, capacity, sizeof(elem_t));
+	t0 = now();
+	for (i = 0; i < producers; i++)
+	{
+		pthread_create(&threads[i], NULL, mpsc_producer, (void*)(uintptr_t)i);
+	}
+	mpsc_consumer();
+	for (i = 0; i < producers; i++)
+	{
+		pthread_join(threads[i], NULL);
+	}
+	report("mpsc", count / producers * producers, now() - t0, producers);
+	failed += errors;
+
+	free(slots);
+	free(seqs);
+
+	return failed ? 1 : 0;
+}
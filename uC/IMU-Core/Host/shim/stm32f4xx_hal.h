@@ -0,0 +1,21 @@
+/*
+ * stm32f4xx_hal.h (host shim)
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Stands in for the HAL header in host builds so that FatFs, its
+ *  configuration and the portable firmware modules compile on Linux.
+ *  Only what those modules use is provided; see host_port.c.
+ */
+
+#ifndef HOST_STM32F4XX_HAL_H_
+#define HOST_STM32F4XX_HAL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define __IO volatile
+
+uint32_t HAL_GetTick(void);
+
+#endif /* HOST_STM32F4XX_HAL_H_ */
@@ -0,0 +1,181 @@
+/*
+ * spec_bench.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Checks the arm_rfft_fast_f32 fallback against a direct DFT for 256,
+ *  512 and 1024 points, then feeds a synthetic walk through spectrum.c
+ *  one sample at a time, calling SPEC_Poll() once per sample as the main
+ *  loop would at least do:
+ *
+ *  - gravity plus the step frequency f of 2 m/s^2 and its second
+ *    harmonic of 0.8 m/s^2
+ *  - a 35 Hz vibration of 0.3 m/s^2
+ *  - white noise of 0.05 m/s^2
+ *
+ *  and prints the dominant frequency, the peak and band levels against
+ *  their true values, and the worst cost per call in 168 MHz cycles of
+ *  host time.
+ *
+ *  ./spec_bench [-r rate Hz] [-f step Hz] [-s seconds] [-v]
+ *
+ *  -v prints the SPEC message of every frame.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "spectrum.h"
+#include "dsp_port.h"
+
+static uint64_t rng = 99;
+
+static double gauss(void)
+{
+	double s = 0.0;
+	int i;
+
+	for (i = 0; i < 12; i++)
+	{
+		rng ^= rng << 13;
+		rng ^= rng >> 7;
+		rng ^= rng << 17;
+		s += (rng >> 11) * (1.0 / 9007199254740992.0);
+	}
+	return s - 6.0;
+}
+
+/* largest error of any bin relative to the largest bin */
+static double rfft_error(uint16_t n)
+{
+	static float32_t in[SPEC_MAX_POINTS], out[SPEC_MAX_POINTS];
+	static double x[SPEC_MAX_POINTS];
+	arm_rfft_fast_instance_f32 S;
+	double err = 0.0, top = 0.0, re, im;
+	uint32_t k, j;
+
+	for (k = 0; k < n; k++)
+	{
+		x[k] = gauss();
+		in[k] = (float32_t)x[k];
+	}
+	arm_rfft_fast_init_f32(&S, n);
+	arm_rfft_fast_f32(&S, in, out, 0);
+
+	for (k = 0; k <= n / 2u; k++)
+	{
+		re = 0.0;
+		im = 0.0;
+		for (j = 0; j < n; j++)
+		{
+			re += x[j] * cos(2.0 * M_PI * j * k / n);
+			im -= x[j] * sin(2.0 * M_PI * j * k / n);
+		}
+		if (k == 0)
+		{
+			err = fmax(err, fabs(out[0] - re));
+		}
+		else if (k == n / 2u)
+		{
+			err = fmax(err, fabs(out[1] - re));
+		}
+		else
+		{
+			err = fmax(err, hypot(out[2 * k] - re, out[2 * k + 1] - im));
+		}
+		top = fmax(top, hypot(re, im));
+	}
+
+	return err / top;
+}
+
+int main(int argc, char **argv)
+{
+	static const uint16_t sizes[] = { 256, 512, 1024 };
+	spec_config_t cfg = { 100.0f, 256, 0.5f, 5.0f, 4, { 0.5f, 3.0f, 8.0f, 20.0f, 50.0f }, 0 };
+	double step = 1.85, seconds = 120.0, vib = 35.0;
+	uint32_t n, k, i, frames, seen;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "r:f:s:v")) != -1)
+	{
+		switch (opt)
+		{
+		case 'r':
+			cfg.sampleHz = strtof(optarg, NULL);
+			cfg.edges[4] = cfg.sampleHz / 2.0f;
+			break;
+		case 'f':
+			step = strtod(optarg, NULL);
+			break;
+		case 's':
+			seconds = strtod(optarg, NULL);
+			break;
+		case 'v':
+			cfg.report = 1;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-r rate Hz] [-f step Hz] [-s seconds] [-v]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	for (i = 0; i < 3; i++)
+	{
+		printf("rfft %4u: max error %.2e of the largest bin\n", sizes[i], rfft_error(sizes[i]));
+	}
+
+	printf("truth: f=%.2f Hz a=%.3f bands %.3g,%.3g,%.3g,%.3g (+ noise %.2g per band Hz)\n", step, 2.0 / sqrt(2.0),
+			2.0, 0.32, 0.0, vib < cfg.sampleHz / 2.0 ? 0.045 : 0.0, 0.05 * 0.05 / (cfg.sampleHz / 2.0));
+
+	for (i = 0; i < 3; i++)
+	{
+		const spec_stats_t *st;
+		spec_result_t r;
+		double fSum = 0.0, fMax = 0.0, aSum = 0.0, b[4] = { 0.0, 0.0, 0.0, 0.0 };
+
+		cfg.points = sizes[i];
+		if (SPEC_Init(&cfg) != 0)
+		{
+			return 1;
+		}
+
+		n = (uint32_t)(seconds * cfg.sampleHz);
+		frames = 0;
+		seen = 0;
+		for (k = 0; k < n; k++)
+		{
+			double t = k / cfg.sampleHz;
+			double m = 9.807 + 2.0 * sin(2.0 * M_PI * step * t) + 0.8 * sin(2.0 * M_PI * 2.0 * step * t + 0.7)
+					+ 0.3 * sin(2.0 * M_PI * vib * t) + 0.05 * gauss();
+
+			SPEC_AddSample(0.0f, 0.0f, (float)m);
+			SPEC_Poll();
+
+			if (SPEC_Result(&r) == 0 && r.index + 1 != seen)
+			{
+				seen = r.index + 1;
+				frames++;
+				fSum += r.peakHz;
+				fMax = fmax(fMax, fabs(r.peakHz - step));
+				aSum += r.peakRms;
+				for (opt = 0; opt < 4; opt++)
+				{
+					b[opt] += r.band[opt];
+				}
+			}
+		}
+
+		st = SPEC_Stats();
+		printf("n=%4u %3u frames: f mean %.3f max err %.3f Hz (bin %.3f) a %.3f bands %.3g,%.3g,%.3g,%.3g\n", sizes[i],
+				frames, fSum / frames, fMax, cfg.sampleHz / sizes[i], aSum / frames, b[0] / frames, b[1] / frames,
+				b[2] / frames, b[3] / frames);
+		printf("       overruns %lu, max cycles sample %lu fft %lu step %lu\n", (unsigned long)st->overruns,
+				(unsigned long)st->maxSampleCycles, (unsigned long)st->maxFftCycles, (unsigned long)st->maxPollCycles);
+	}
+
+	return 0;
+}
@@ -0,0 +1,328 @@
+/*
+ * thermal_replay.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Learns the thermal model (thermal.c) from a warm-up log taken at rest
+ *  and replays a second log through the compensation, printing the bias
+ *  drift per axis before and after. The fit moves the static gyro bias
+ *  into the calibration, which is applied ahead of the compensation as
+ *  on the target, and both are saved to a RAM copy of the flash sector
+ *  and loaded back.
+ *
+ *  ./thermal_replay [-f rate Hz] [-o write synthetic logs prefix] [-S] [learn log] [test log]
+ *
+ *  Logs are in print_motion7() format (see eskf_replay.c). With -S two
+ *  synthetic runs are used instead: a 10 minute warm-up from 22 to 35
+ *  degC to learn from and a 10 minute cool-down to test on, with
+ *  quadratic gyro bias and accel drift plus noise.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "thermal.h"
+#include "calib.h"
+
+#define SECTOR 4096
+#define PER_G (32767.5f / 2.0f)
+#define PER_RAD (32767.5f / (250.0f * 0.017453293f))
+
+typedef struct
+{
+	FILE *in;
+	uint32_t k, n;
+	double rate, t0, t1;	/* synthetic temperature profile */
+	uint64_t rng;
+} source_t;
+
+/* per axis: b0, b1 (/degC), b2 (/degC^2) around 25 degC */
+static const double truth[6][3] = {
+	{ 0.010, 8e-4, -2.0e-5 }, { -0.006, -5e-4, 1.5e-5 }, { 0.004, 1.1e-3, 3.0e-5 },
+	{ 0.0, 2.5e-3, -4.0e-5 }, { 0.0, -1.5e-3, 6.0e-5 }, { 0.0, 4.0e-3, -8.0e-5 }
+};
+
+static uint32_t sector[SECTOR / 4];
+
+/* flash port on a RAM copy of the sector */
+uint32_t CALIB_PortSize(void)
+{
+	return SECTOR;
+}
+
+const void* CALIB_PortBase(void)
+{
+	return sector;
+}
+
+int32_t CALIB_PortErase(void)
+{
+	memset(sector, 0xFF, sizeof(sector));
+	return 0;
+}
+
+int32_t CALIB_PortWrite(uint32_t offset, const uint32_t *data, uint32_t words)
+{
+	uint32_t i;
+
+	for (i = 0; i < words; i++)
+	{
+		sector[offset / 4 + i] &= data[i];
+	}
+	return 0;
+}
+
+/* any checksum will do on the host */
+uint32_t CALIB_PortCrc(const uint32_t *data, uint32_t words)
+{
+	uint32_t crc = 0x811C9DC5u, i;
+
+	for (i = 0; i < words; i++)
+	{
+		crc = (crc ^ data[i]) * 16777619u;
+	}
+	return crc;
+}
+
+static double gauss(source_t *s)
+{
+	double u1, u2;
+
+	s->rng = s->rng * 6364136223846793005ULL + 1442695040888963407ULL;
+	u1 = ((s->rng >> 11) + 1.0) / 9007199254740993.0;
+	s->rng = s->rng * 6364136223846793005ULL + 1442695040888963407ULL;
+	u2 = (s->rng >> 11) / 9007199254740992.0;
+
+	return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static int next_sample(source_t *s, float *t, float a[3], float g[3], float *temp)
+{
+	char line[256];
+	double T, dT, v[6];
+	int i;
+
+	if (s->in)
+	{
+		while (fgets(line, sizeof(line), s->in))
+		{
+			if (sscanf(line, "%f;%f;%f;%f;%f;%f;%f;%f", t, &a[0], &a[1], &a[2], &g[0], &g[1], &g[2], temp) == 8)
+			{
+				return 1;
+			}
+		}
+		return 0;
+	}
+
+	if (s->k >= s->n)
+	{
+		return 0;
+	}
+
+	/* first order approach to t1 with a 3 minute time constant */
+	*t = (float)(s->k / s->rate);
+	T = s->t1 + (s->t0 - s->t1) * exp(-*t / 180.0);
+	dT = T - 25.0;
+	for (i = 0; i < 6; i++)
+	{
+		v[i] = truth[i][0] + truth[i][1] * dT + truth[i][2] * dT * dT;
+	}
+	for (i = 0; i < 3; i++)
+	{
+		g[i] = (float)(v[i] + 0.0012 * gauss(s));
+		a[i] = (float)(v[3 + i] + 0.02 * gauss(s));
+	}
+	a[2] += 9.80665f;
+	*temp = (float)(T + 0.02 * gauss(s));
+	s->k++;
+
+	return 1;
+}
+
+static FILE* open_log(const char *name)
+{
+	FILE *f = fopen(name, "r");
+
+	if (!f)
+	{
+		perror(name);
+		exit(1);
+	}
+	return f;
+}
+
+/* drift: spread of 10 s means over the run */
+static void run(source_t *s, double rate, int apply, FILE *out, double spread[6])
+{
+	double sum[6] = { 0 }, lo[6], hi[6];
+	uint32_t n = 0, win = (uint32_t)(10.0 * rate);
+	float t, a[3], g[3], temp;
+	int i;
+
+	for (i = 0; i < 6; i++)
+	{
+		lo[i] = 1e9;
+		hi[i] = -1e9;
+	}
+
+	while (next_sample(s, &t, a, g, &temp))
+	{
+		if (out)
+		{
+			fprintf(out, "%8.4f;%8.4f;%8.4f;%8.4f;%8.4f;%8.4f;%8.4f;%8.4f\n", t, a[0], a[1], a[2], g[0], g[1], g[2], temp);
+		}
+		if (apply)
+		{
+			/* CALIB_Correct() with an identity matrix */
+			for (i = 0; i < 3; i++)
+			{
+				g[i] -= CALIB_Coeffs()->s[CALIB_GYRO].b[i] / PER_RAD;
+			}
+			THERMAL_Apply(&a[0], &a[1], &a[2], &g[0], &g[1], &g[2], temp);
+		}
+		for (i = 0; i < 3; i++)
+		{
+			sum[i] += g[i];
+			sum[3 + i] += a[i];
+		}
+		if (++n == win)
+		{
+			for (i = 0; i < 6; i++)
+			{
+				lo[i] = fmin(lo[i], sum[i] / n);
+				hi[i] = fmax(hi[i], sum[i] / n);
+				sum[i] = 0.0;
+			}
+			n = 0;
+		}
+	}
+
+	for (i = 0; i < 6; i++)
+	{
+		spread[i] = hi[i] - lo[i];
+	}
+}
+
+int main(int argc, char **argv)
+{
+	source_t learn = { NULL, 0, 0, 100.0, 22.0, 35.0, 1 }, test = { NULL, 0, 0, 100.0, 35.0, 24.0, 2 };
+	const thermal_stats_t *st = THERMAL_Stats();
+	const thermal_coeffs_t *c;
+	thermal_coeffs_t saved;
+	double rate = 100.0, before[6], after[6];
+	const char *prefix = NULL;
+	int synthetic = 0, opt, i;
+	char name[256];
+	FILE *out = NULL;
+	long ret;
+
+	while ((opt = getopt(argc, argv, "f:o:S")) != -1)
+	{
+		switch (opt)
+		{
+			case 'f': rate = atof(optarg); break;
+			case 'o': prefix = optarg; break;
+			case 'S': synthetic = 1; break;
+			default:
+				fprintf(stderr, "see the header of thermal_replay.c for options\n");
+				return 2;
+		}
+	}
+
+	if (synthetic)
+	{
+		learn.rate = test.rate = rate;
+		learn.n = test.n = (uint32_t)(600.0 * rate);
+	}
+	else if (optind + 2 == argc)
+	{
+		learn.in = open_log(argv[optind]);
+		test.in = open_log(argv[optind + 1]);
+	}
+	else
+	{
+		fprintf(stderr, "need a learn log and a test log, or -S\n");
+		return 2;
+	}
+
+	/* learn: the whole first log is the warm-up run */
+	CALIB_PortErase();
+	CALIB_Init(PER_G, PER_RAD);
+	THERMAL_Init((float)rate);
+	THERMAL_StartLearning(0xFFFFFFFFu);
+	if (prefix)
+	{
+		snprintf(name, sizeof(name), "%s_learn.txt", prefix);
+		out = fopen(name, "w");
+	}
+	run(&learn, rate, 1, out, before);
+	if (out)
+	{
+		fclose(out);
+		out = NULL;
+	}
+	ret = THERMAL_Fit();
+	c = THERMAL_Coeffs();
+	printf("fit %ld: %lu samples binned, %lu rejected, %lu bins\n", ret, (unsigned long)st->learned,
+			(unsigned long)st->rejected, (unsigned long)st->binsUsed);
+	if (ret != 0)
+	{
+		return 1;
+	}
+	for (i = 0; i < 6; i++)
+	{
+		printf("%s%c tref %.2f b %+.4e %+.4e %+.4e  rms %.1e\n", i < 3 ? "g" : "a", "xyz"[i % 3], c->tref,
+				c->bias[i][0], c->bias[i][1], c->bias[i][2], st->fitRms[i]);
+	}
+	printf("static gyro bias moved to the calibration: %+.4e %+.4e %+.4e rad/s\n",
+			CALIB_Coeffs()->s[CALIB_GYRO].b[0] / PER_RAD, CALIB_Coeffs()->s[CALIB_GYRO].b[1] / PER_RAD,
+			CALIB_Coeffs()->s[CALIB_GYRO].b[2] / PER_RAD);
+
+	/* the record as the target writes it, read back as at boot */
+	saved = *c;
+	ret = THERMAL_Save();
+	CALIB_Init(PER_G, PER_RAD);
+	THERMAL_Init((float)rate);
+	c = THERMAL_Coeffs();
+	if (ret != 0 || !c || memcmp(c, &saved, sizeof(saved)) != 0)
+	{
+		printf("FAIL: coefficients not reloaded from flash (save %ld)\n", ret);
+		return 1;
+	}
+	printf("flash: saved and reloaded\n");
+
+	/* test: drift of the second log without and with compensation */
+	if (prefix)
+	{
+		snprintf(name, sizeof(name), "%s_test.txt", prefix);
+		out = fopen(name, "w");
+	}
+	run(&test, rate, 0, out, before);
+	if (out)
+	{
+		fclose(out);
+	}
+	if (synthetic)
+	{
+		test.k = 0;
+		test.rng = 2;
+	}
+	else
+	{
+		rewind(test.in);
+	}
+	run(&test, rate, 1, NULL, after);
+
+	printf("drift of 10 s means over the test run, raw -> compensated\n");
+	for (i = 0; i < 6; i++)
+	{
+		printf("%s%c %.2e -> %.2e %s\n", i < 3 ? "g" : "a", "xyz"[i % 3], before[i], after[i], i < 3 ? "rad/s" : "m/s^2");
+	}
+	printf("%lu polynomial evaluations for %lu samples, max %lu cycles per sample\n",
+			(unsigned long)st->evaluations, (unsigned long)st->samples, (unsigned long)st->maxCycles);
+
+	return 0;
+}
@@ -0,0 +1,50 @@
+/*
+ * ahrs.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Attitude estimator running at the sample rate. Keeps a body-to-earth
+ *  quaternion updated from gyro (rad/s), accel (any unit) and optionally
+ *  magnetometer (any unit) samples with a fixed per-update cost.
+ *  The filter variant is selected at build time with AHRS_FILTER.
+ */
+
+#ifndef AHRS_H_
+#define AHRS_H_
+
+#include <stdint.h>
+
+#define AHRS_MADGWICK 0
+#define AHRS_MAHONY 1
+
+#ifndef AHRS_FILTER
+#define AHRS_FILTER AHRS_MADGWICK
+#endif
+
+// 1/sqrt via magic constant + one Newton step instead of VSQRT + VDIV
+#ifndef AHRS_FAST_INVSQRT
+#define AHRS_FAST_INVSQRT 1
+#endif
+
+typedef struct
+{
+	uint32_t updates;
+	uint32_t lastCycles;
+	uint32_t maxCycles;
+	uint64_t totalCycles;
+} ahrs_stats_t;
+
+/* Madgwick: gain1 = beta, gain2 unused; Mahony: gain1 = Kp, gain2 = Ki */
+void AHRS_Init(float sampleHz, float gain1, float gain2);
+void AHRS_Reset(void);
+
+void AHRS_Update6(float gx, float gy, float gz, float ax, float ay, float az);
+void AHRS_Update9(float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz);
+
+void AHRS_GetQuat(float q[4]);
+void AHRS_GetEuler(float *roll, float *pitch, float *yaw);
+const ahrs_stats_t* AHRS_Stats(void);
+
+void AHRS_Command(const char *args);
+
+#endif /* AHRS_H_ */
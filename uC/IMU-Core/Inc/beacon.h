@@ -0,0 +1,77 @@
+/*
+ * beacon.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Range measurements to fixed RF beacons. Beacons broadcast a short
+ *  packet; the receiver turns the latched RSSI into a range with a
+ *  log-distance path loss model and queues it with the nIRQ timestamp.
+ *  BEACON_Fuse(), called in the IMU interrupt right after ESKF_Predict(),
+ *  applies the queued ranges as gated scalar ESKF updates, so the filter
+ *  is only ever touched from one context. Beacon positions are handed
+ *  over the same way: BEACON_Set() queues the entry and BEACON_Fuse()
+ *  copies it into its own table before the ranges that follow.
+ *
+ *  Beacon packet, RF4463_PACKET_LEN bytes:
+ *  'B' 'N' id seq rssi1m(int8 dBm) 0 0 0
+ */
+
+#ifndef BEACON_H_
+#define BEACON_H_
+
+#include <stdint.h>
+
+#include "rf4463.h"
+
+#define BEACON_MAX 8		/* also the position queue, a power of two */
+#define BEACON_QUEUE 8		/* power of two, ring.h */
+
+typedef struct
+{
+	float pathLossExp;		/* n, 2 free space, 2.5..4 indoors */
+	float shadowDb;			/* 1-sigma RSSI scatter */
+	float minRange;			/* m, ranges are clamped to this */
+	float maxAgeMs;			/* older measurements are dropped */
+	float gate;				/* chi-square gate for one dof, 0 = none */
+} beacon_config_t;
+
+typedef struct
+{
+	uint8_t id;
+	float rssi;
+	float range;
+	float var;
+	rf_stamp_t stamp;
+} beacon_meas_t;
+
+typedef struct
+{
+	uint32_t packets;
+	uint32_t unknown;		/* not a beacon packet or beacon not in the table */
+	uint32_t dropped;		/* queue full */
+	uint32_t stale;
+	uint32_t fused;
+	uint32_t rejected;		/* gated or refused by the filter */
+	float lastRange;
+	uint8_t lastId;
+} beacon_stats_t;
+
+/* every accepted range with the beacon position, main loop */
+typedef void (*beacon_range_callback)(const float pos[3], float range, float var);
+
+void BEACON_Init(const beacon_config_t *cfg);
+void BEACON_SetRangeCallback(beacon_range_callback cb);
+/* rssi1m 0 takes the value broadcast by the beacon; -1 for a bad id or BEACON_MAX
+ * changes pending before BEACON_Fuse() has run */
+int32_t BEACON_Set(uint8_t id, float x, float y, float z, float rssi1m);
+
+/* rf_rx_callback, main loop */
+void BEACON_OnPacket(const uint8_t *data, uint8_t len, float rssi, const rf_stamp_t *stamp);
+/* IMU interrupt, after ESKF_Predict() */
+void BEACON_Fuse(void);
+
+float BEACON_RangeFromRssi(float rssi, float rssi1m, float *var);
+const beacon_stats_t* BEACON_Stats(void);
+void BEACON_Command(const char *args);
+
+#endif /* BEACON_H_ */
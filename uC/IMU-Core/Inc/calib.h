@@ -0,0 +1,119 @@
+/*
+ * calib.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Sensor calibration: accelerometer from six static positions (scale,
+ *  misalignment and offset), gyro static bias and magnetometer hard and
+ *  soft iron from an ellipsoid fit. Every sensor is corrected in counts
+ *  as
+ *
+ *    out = M (raw - b)
+ *
+ *  in fixed point (M in Q14, b and out in Q4 counts) by the read
+ *  functions in mpu9250.c, before the nominal scale factor is applied.
+ *
+ *  Captures are accumulated by the correction calls themselves (sensor
+ *  read context), fits run in CALIB_Poll() from the main loop. The
+ *  coefficients live in a CRC protected record in the last flash sector;
+ *  records are appended until the sector is full, so a save only erases
+ *  once every few hundred times. CALIB_Init() loads the newest valid one.
+ *  The record also carries the temperature model (thermal.h), which
+ *  THERMAL_Init() takes from here.
+ *
+ *  The static gyro bias is this module's, referred to the thermal
+ *  reference temperature: a gyro capture has the thermal drift at the
+ *  capture temperature taken off (CALIB_SetGyroDriftCallback()), and a
+ *  thermal fit moves its constant gyro term in with CALIB_ShiftGyroBias().
+ */
+
+#ifndef CALIB_H_
+#define CALIB_H_
+
+#include <stdint.h>
+
+#include "thermal.h"
+
+#define CALIB_ACCEL 0
+#define CALIB_GYRO 1
+#define CALIB_MAG 2
+
+#define CALIB_Q 14				/* matrix fraction bits */
+#define CALIB_OUT_Q 4			/* offset and output fraction bits */
+
+#define CALIB_STILL_COUNTS 40.0f	/* max accel standard deviation of a static capture, counts */
+#define CALIB_MIN_MAG 200		/* samples before an ellipsoid fit */
+#define CALIB_MAG_NORM 256.0f	/* counts, scales the ellipsoid sums near unity */
+
+/* float form, as fitted and stored */
+typedef struct
+{
+	float M[3][3];
+	float b[3];			/* counts */
+} calib_axis3_t;
+
+typedef struct
+{
+	uint32_t valid;		/* bit per CALIB_ACCEL / GYRO / MAG */
+	calib_axis3_t s[3];
+} calib_coeffs_t;
+
+typedef struct
+{
+	uint32_t corrected;
+	uint32_t captured;
+	uint8_t positions;		/* bitmask of captured accel positions, +x -x +y -y +z -z */
+	uint32_t magSamples;
+	uint32_t saves;
+	uint32_t loadSeq;		/* sequence number of the record loaded at boot, 0 none */
+	int32_t lastFit;
+	float accelResidual;	/* counts, |M (r - b)| - 1 g over the six positions */
+	float magResidual;		/* fraction of the radius, rms */
+} calib_stats_t;
+
+/* current gyro bias drift, rad/s */
+typedef void (*calib_drift_callback)(float drift[3]);
+
+/* loads the newest record from flash; identity if there is none */
+int32_t CALIB_Init(float accelCountsPerG, float gyroCountsPerRad);
+void CALIB_Set(uint32_t sensor, const calib_axis3_t *c);
+void CALIB_Clear(uint32_t sensor);
+const calib_coeffs_t* CALIB_Coeffs(void);
+
+void CALIB_SetGyroDriftCallback(calib_drift_callback cb);
+/* takes a constant gyro output offset, rad/s, into the static bias */
+void CALIB_ShiftGyroBias(const float offset[3]);
+/* temperature model stored with the calibration, NULL if none; saved by CALIB_Save() */
+void CALIB_SetThermal(const thermal_coeffs_t *c);
+const thermal_coeffs_t* CALIB_Thermal(void);
+
+/* sensor read context: raw counts in, Q4 counts out */
+void CALIB_Correct(uint32_t sensor, const int16_t raw[3], int32_t out[3]);
+
+/* captures, fitted by CALIB_Poll() when complete */
+void CALIB_CaptureGyro(uint32_t samples);
+void CALIB_CaptureAccel(uint32_t samples);
+void CALIB_MagStart(void);
+void CALIB_MagStop(void);
+void CALIB_Poll(void);
+
+/* fits on sums, usable on the host */
+int32_t CALIB_FitAccel(const float mean[6][3], float countsPerG, calib_axis3_t *c, float *residual);
+int32_t CALIB_FitEllipsoid(const float sums[], uint32_t n, calib_axis3_t *c);
+void CALIB_EllipsoidAdd(float sums[], const int16_t raw[3]);
+#define CALIB_ELLIPSOID_SUMS 54
+
+int32_t CALIB_Save(void);
+int32_t CALIB_Load(void);
+
+const calib_stats_t* CALIB_Stats(void);
+void CALIB_Command(const char *args);
+
+/* flash sector and CRC, calib_port.c */
+uint32_t CALIB_PortSize(void);
+const void* CALIB_PortBase(void);
+int32_t CALIB_PortErase(void);
+int32_t CALIB_PortWrite(uint32_t offset, const uint32_t *data, uint32_t words);
+uint32_t CALIB_PortCrc(const uint32_t *data, uint32_t words);
+
+#endif /* CALIB_H_ */
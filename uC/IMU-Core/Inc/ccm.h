@@ -0,0 +1,39 @@
+/*
+ * ccm.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Placement in the 64 KB core coupled RAM at 0x10000000. CCM is on the
+ *  D-bus only: zero wait states and no contention with SPI1 DMA on the
+ *  bus matrix, but no DMA stream can reach it. Whatever a DMA transfer
+ *  reads or writes stays in SRAM1/2, and so do buffers handed to drivers
+ *  that might use DMA (FatFs, UART).
+ *
+ *  In CCM:
+ *
+ *  - the main stack, top of CCM (_Min_Stack_Size reserved, linker script)
+ *  - ESKF matrices (eskf.c, ESKF_USE_CCM), 3 KB
+ *  - particle arrays (pf.c, PF_USE_CCM), 36 KB at 2048 particles
+ *  - decimator FIR state (decim.c, DECIM_USE_CCM), 9 KB
+ *  - PDR step window (pdr.c), raw and output sample queues (pipeline.c)
+ *
+ *  The spectrum frames (20 KB, SPEC_USE_CCM) do not fit beside these and
+ *  are background work, so they stay in SRAM.
+ *
+ *  CCM_BSS is zeroed and CCM_DATA copied from flash by the startup code,
+ *  the same as .bss and .data. "map_report" on the linker map lists
+ *  what each region holds.
+ */
+
+#ifndef CCM_H_
+#define CCM_H_
+
+#ifdef HOST_BUILD
+#define CCM_DATA
+#define CCM_BSS
+#else
+#define CCM_DATA __attribute__((section(".ccmram")))
+#define CCM_BSS __attribute__((section(".ccmbss")))
+#endif
+
+#endif /* CCM_H_ */
@@ -0,0 +1,29 @@
+/*
+ * cmd.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Line based command channel on USART6. Bytes are collected from the
+ *  UART RX interrupt, complete lines are dispatched from the main loop
+ *  to the handler registered for the first word of the line. The RX
+ *  interrupt reads the data register itself and never touches the HAL
+ *  handle, which the blocking transmits of the output lock.
+ */
+
+#ifndef CMD_H_
+#define CMD_H_
+
+#include <stdint.h>
+
+#define CMD_LINE_MAX 48
+#define CMD_MAX_HANDLERS 24
+
+typedef void (*cmd_handler)(const char *args);
+
+void CMD_Init(void);
+int32_t CMD_Register(const char *name, cmd_handler handler);
+void CMD_Poll(void);
+/* USART6 interrupt, ahead of HAL_UART_IRQHandler() */
+void CMD_RxIrq(void);
+
+#endif /* CMD_H_ */
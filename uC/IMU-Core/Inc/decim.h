@@ -0,0 +1,105 @@
+/*
+ * decim.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Oversampled IMU input: the MPU9250 runs with its DLPF bypassed (gyro
+ *  8 kHz, accel 4 kHz, setFiltBypass()) into its FIFO, and the MCU
+ *  decimates to the output rate in two polyphase stages,
+ *
+ *    8 kHz --Q15, /8--> 1 kHz --f32, /M--> output rate
+ *
+ *  with arm_fir_decimate_q15 / _f32, six channels each. Stage 1 works on
+ *  the int16 counts where the data rate is high; stage 2 is float so the
+ *  resolution gained by averaging is kept. The coefficients are designed
+ *  offline by Host/decim_design (decim_coeffs.h); stage 2 has a "flat"
+ *  and a short, low delay "fast" design per output rate, selectable at
+ *  run time.
+ *
+ *  FIFO records are processed in blocks of DECIM_BLOCK1 samples as they
+ *  are drained, so TIM6 has to drain faster than the FIFO fills
+ *  (DECIM_DRAINS per output sample). Outputs are remapped to body axes
+ *  and calibrated with the float CALIB coefficients; like the Q15 path,
+ *  this one does not feed CALIB captures.
+ */
+
+#ifndef DECIM_H_
+#define DECIM_H_
+
+#include <stdint.h>
+
+#include "dsp_port.h"
+
+#define DECIM_IN_HZ 8000
+#define DECIM_MID_HZ 1000
+#define DECIM_M1 (DECIM_IN_HZ / DECIM_MID_HZ)
+#define DECIM_BLOCK1 16			/* stage 1 input samples per call, multiple of DECIM_M1 */
+#define DECIM_MAX_M2 20
+#define DECIM_MAX_TAPS 320		/* longest stage 2 design */
+#define DECIM_CHANNELS 6		/* ax ay az gx gy gz, sensor axes */
+#define DECIM_RECORD 14			/* FIFO record, ACCEL_OUT order */
+#define DECIM_OUT_QUEUE 4
+#define DECIM_DRAINS 4			/* FIFO drains per output sample */
+#define DECIM_USE_CCM 1
+
+typedef struct
+{
+	const char *name;
+	uint16_t outHz;
+	uint8_t M;
+	uint16_t taps;
+	float passHz;
+	const float32_t *coeffs;	/* time reversed, symmetric anyway */
+} decim_design_t;
+
+typedef struct
+{
+	float accelScale;			/* m/s^2 per count */
+	float gyroScale;			/* rad/s per count */
+	float tempScale;			/* counts per degC */
+	float tempOffset;			/* degC */
+	int16_t remap[3][3];		/* body = remap * sensor */
+	uint16_t outHz;
+} decim_config_t;
+
+typedef struct
+{
+	float a[3];
+	float g[3];
+	float t;					/* mean over the output interval */
+} decim_sample_t;
+
+typedef struct
+{
+	uint32_t records;
+	uint32_t batches;
+	uint32_t maxBatch;			/* records in one drain */
+	uint32_t overflows;			/* FIFO full, filters restarted */
+	uint32_t outputs;
+	uint32_t dropped;			/* output queue full */
+	uint32_t maxCycles;			/* one drain including the filters */
+	uint32_t design;
+} decim_stats_t;
+
+/* design is an index into the designs for cfg->outHz, -1 if there are none */
+int32_t DECIM_Init(const decim_config_t *cfg, uint32_t design);
+/* switches the stage 2 design at the next batch, -1 if it is for another rate */
+int32_t DECIM_Select(uint32_t design);
+const decim_design_t* DECIM_Design(uint32_t design);
+uint32_t DECIM_Designs(void);
+/* group delay of the chain, s */
+float DECIM_Delay(void);
+void DECIM_Reset(void);
+
+/* n FIFO records; returns the number of output samples produced */
+uint32_t DECIM_Process(const uint8_t *records, uint32_t n);
+int32_t DECIM_Pop(decim_sample_t *s);
+
+/* sensor side: bypass and FIFO on; drain and pop, 0 when a sample was returned */
+int32_t DECIM_Start(void);
+int32_t DECIM_Read(float *ax, float *ay, float *az, float *gx, float *gy, float *gz, float *t);
+
+const decim_stats_t* DECIM_Stats(void);
+void DECIM_Command(const char *args);
+
+#endif /* DECIM_H_ */
@@ -0,0 +1,233 @@
+/*
+ * decim_coeffs.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Generated by Host/decim_design, do not edit. Symmetric, so the
+ *  time reversed order CMSIS expects is the same as the natural one.
+ */
+
+#ifndef DECIM_COEFFS_H_
+#define DECIM_COEFFS_H_
+
+#include "decim.h"
+
+/* 8000 Hz to 1000 Hz, pass 200 Hz, stop 800 Hz, 70.0 dB */
+#define DECIM_STAGE1_TAPS 59
+
+static const q15_t decimStage1[DECIM_STAGE1_TAPS] = {
+	-2, -5, -9, -10, -8, 0, 16, 40, 69, 96, 113, 108,
+	73, 0, -109, -244, -384, -498, -551, -504, -326, 0, 474, 1074,
+	1755, 2456, 3105, 3632, 3975, 4095, 3975, 3632, 3105, 2456, 1755, 1074,
+	474, 0, -326, -504, -551, -498, -384, -244, -109, 0, 73, 108,
+	113, 96, 69, 40, 16, 0, -8, -10, -9, -5, -2,
+};
+
+/* flat, 500 Hz out, pass 200 Hz, stop 300 Hz, 59.2 dB */
+static const float32_t decimflat500[39] = {
+	-3.41579825e-04f, 0.00000000e+00f, 1.27995762e-03f, 0.00000000e+00f, -3.11253426e-03f, 0.00000000e+00f,
+	6.27543569e-03f, 0.00000000e+00f, -1.13593012e-02f, 0.00000000e+00f, 1.92745325e-02f, 0.00000000e+00f,
+	-3.17571921e-02f, 0.00000000e+00f, 5.31619834e-02f, 0.00000000e+00f, -9.95056433e-02f, 0.00000000e+00f,
+	3.16072220e-01f, 5.00024242e-01f, 3.16072220e-01f, 0.00000000e+00f, -9.95056433e-02f, 0.00000000e+00f,
+	5.31619834e-02f, 0.00000000e+00f, -3.17571921e-02f, 0.00000000e+00f, 1.92745325e-02f, 0.00000000e+00f,
+	-1.13593012e-02f, 0.00000000e+00f, 6.27543569e-03f, 0.00000000e+00f, -3.11253426e-03f, 0.00000000e+00f,
+	1.27995762e-03f, 0.00000000e+00f, -3.41579825e-04f,
+};
+
+/* fast, 500 Hz out, pass 100 Hz, stop 400 Hz, 49.8 dB */
+static const float32_t decimfast500[11] = {
+	3.54429965e-03f, 0.00000000e+00f, -4.85098330e-02f, 0.00000000e+00f, 2.94365452e-01f, 5.01200163e-01f,
+	2.94365452e-01f, 0.00000000e+00f, -4.85098330e-02f, 0.00000000e+00f, 3.54429965e-03f,
+};
+
+/* flat, 250 Hz out, pass 100 Hz, stop 150 Hz, 60.4 dB */
+static const float32_t decimflat250[75] = {
+	-1.23986623e-04f, 0.00000000e+00f, 2.66649746e-04f, 5.12755172e-04f, 4.77686315e-04f, 0.00000000e+00f,
+	-7.74734633e-04f, -1.36002490e-03f, -1.17787595e-03f, 0.00000000e+00f, 1.71008736e-03f, 2.87475463e-03f,
+	2.39806832e-03f, 0.00000000e+00f, -3.27370316e-03f, -5.36533646e-03f, -4.37660891e-03f, 0.00000000e+00f,
+	5.75857926e-03f, 9.29924289e-03f, 7.49147813e-03f, 0.00000000e+00f, -9.68176979e-03f, -1.55529835e-02f,
+	-1.24987696e-02f, 0.00000000e+00f, 1.62339775e-02f, 2.63059481e-02f, 2.14396976e-02f, 0.00000000e+00f,
+	-2.93053080e-02f, -4.95593661e-02f, -4.29362983e-02f, 0.00000000e+00f, 7.37485136e-02f, 1.57918481e-01f,
+	2.24589180e-01f, 2.49923333e-01f, 2.24589180e-01f, 1.57918481e-01f, 7.37485136e-02f, 0.00000000e+00f,
+	-4.29362983e-02f, -4.95593661e-02f, -2.93053080e-02f, 0.00000000e+00f, 2.14396976e-02f, 2.63059481e-02f,
+	1.62339775e-02f, 0.00000000e+00f, -1.24987696e-02f, -1.55529835e-02f, -9.68176979e-03f, 0.00000000e+00f,
+	7.49147813e-03f, 9.29924289e-03f, 5.75857926e-03f, 0.00000000e+00f, -4.37660891e-03f, -5.36533646e-03f,
+	-3.27370316e-03f, 0.00000000e+00f, 2.39806832e-03f, 2.87475463e-03f, 1.71008736e-03f, 0.00000000e+00f,
+	-1.17787595e-03f, -1.36002490e-03f, -7.74734633e-04f, 0.00000000e+00f, 4.77686315e-04f, 5.12755172e-04f,
+	2.66649746e-04f, 0.00000000e+00f, -1.23986623e-04f,
+};
+
+/* fast, 250 Hz out, pass 50 Hz, stop 200 Hz, 52.6 dB */
+static const float32_t decimfast250[21] = {
+	1.77326677e-03f, 3.12359118e-03f, 0.00000000e+00f, -1.06189208e-02f, -2.42702038e-02f, -2.65942514e-02f,
+	0.00000000e+00f, 6.26452302e-02f, 1.47275492e-01f, 2.21286782e-01f, 2.50758029e-01f, 2.21286782e-01f,
+	1.47275492e-01f, 6.26452302e-02f, 0.00000000e+00f, -2.65942514e-02f, -2.42702038e-02f, -1.06189208e-02f,
+	0.00000000e+00f, 3.12359118e-03f, 1.77326677e-03f,
+};
+
+/* flat, 200 Hz out, pass 80 Hz, stop 120 Hz, 60.1 dB */
+static const float32_t decimflat200[93] = {
+	-8.28953219e-05f, 0.00000000e+00f, 1.56362493e-04f, 3.28954535e-04f, 4.17450322e-04f, 3.21199653e-04f,
+	0.00000000e+00f, -4.76356820e-04f, -9.22338938e-04f, -1.09327040e-03f, -7.94265709e-04f, 0.00000000e+00f,
+	1.07451019e-03f, 2.00385655e-03f, 2.29748855e-03f, 1.62029097e-03f, 0.00000000e+00f, -2.08370252e-03f,
+	-3.80256041e-03f, -4.27515851e-03f, -2.96212788e-03f, 0.00000000e+00f, 3.69574162e-03f, 6.65894443e-03f,
+	7.40294288e-03f, 5.07961032e-03f, 0.00000000e+00f, -6.24395750e-03f, -1.11935447e-02f, -1.24027596e-02f,
+	-8.49782861e-03f, 0.00000000e+00f, 1.04827969e-02f, 1.88986102e-02f, 2.11250125e-02f, 1.46570740e-02f,
+	0.00000000e+00f, -1.88234047e-02f, -3.49880191e-02f, -4.07282992e-02f, -2.98369857e-02f, 0.00000000e+00f,
+	4.58588919e-02f, 9.97795219e-02f, 1.50579592e-01f, 1.86804443e-01f, 1.99928362e-01f, 1.86804443e-01f,
+	1.50579592e-01f, 9.97795219e-02f, 4.58588919e-02f, 0.00000000e+00f, -2.98369857e-02f, -4.07282992e-02f,
+	-3.49880191e-02f, -1.88234047e-02f, 0.00000000e+00f, 1.46570740e-02f, 2.11250125e-02f, 1.88986102e-02f,
+	1.04827969e-02f, 0.00000000e+00f, -8.49782861e-03f, -1.24027596e-02f, -1.11935447e-02f, -6.24395750e-03f,
+	0.00000000e+00f, 5.07961032e-03f, 7.40294288e-03f, 6.65894443e-03f, 3.69574162e-03f, 0.00000000e+00f,
+	-2.96212788e-03f, -4.27515851e-03f, -3.80256041e-03f, -2.08370252e-03f, 0.00000000e+00f, 1.62029097e-03f,
+	2.29748855e-03f, 2.00385655e-03f, 1.07451019e-03f, 0.00000000e+00f, -7.94265709e-04f, -1.09327040e-03f,
+	-9.22338938e-04f, -4.76356820e-04f, 0.00000000e+00f, 3.21199653e-04f, 4.17450322e-04f, 3.28954535e-04f,
+	1.56362493e-04f, 0.00000000e+00f, -8.28953219e-05f,
+};
+
+/* fast, 200 Hz out, pass 40 Hz, stop 160 Hz, 52.7 dB */
+static const float32_t decimfast200[27] = {
+	1.29708368e-03f, 2.69416168e-03f, 2.92412875e-03f, 0.00000000e+00f, -7.05909759e-03f, -1.65446724e-02f,
+	-2.33240187e-02f, -2.00029332e-02f, 0.00000000e+00f, 3.86712844e-02f, 9.08743976e-02f, 1.44754785e-01f,
+	1.85427617e-01f, 2.00574528e-01f, 1.85427617e-01f, 1.44754785e-01f, 9.08743976e-02f, 3.86712844e-02f,
+	0.00000000e+00f, -2.00029332e-02f, -2.33240187e-02f, -1.65446724e-02f, -7.05909759e-03f, 0.00000000e+00f,
+	2.92412875e-03f, 2.69416168e-03f, 1.29708368e-03f,
+};
+
+/* flat, 100 Hz out, pass 40 Hz, stop 60 Hz, 59.4 dB */
+static const float32_t decimflat100[183] = {
+	-2.20286384e-05f, 0.00000000e+00f, 3.10532316e-05f, 6.88600378e-05f, 1.09447528e-04f, 1.47381153e-04f,
+	1.76273877e-04f, 1.89536067e-04f, 1.81298487e-04f, 1.47405342e-04f, 8.63482204e-05f, 0.00000000e+00f,
+	-1.05986208e-04f, -2.22222645e-04f, -3.36142736e-04f, -4.33074085e-04f, -4.97767640e-04f, -5.16252950e-04f,
+	-4.77828004e-04f, -3.76947464e-04f, -2.14753048e-04f, 0.00000000e+00f, 2.50823485e-04f, 5.14312936e-04f,
+	7.61929645e-04f, 9.62661468e-04f, 1.08635625e-03f, 1.10741306e-03f, 1.00843305e-03f, 7.83387232e-04f,
+	4.39861980e-04f, 0.00000000e+00f, -5.00135957e-04f, -1.01289532e-03f, -1.48300081e-03f, -1.85287292e-03f,
+	-2.06886350e-03f, -2.08778743e-03f, -1.88303925e-03f, -1.44955086e-03f, -8.06898095e-04f, 0.00000000e+00f,
+	9.02931607e-04f, 1.81526103e-03f, 2.63937561e-03f, 3.27615768e-03f, 3.63564725e-03f, 3.64784551e-03f,
+	3.27248925e-03f, 2.50662379e-03f, 1.38892845e-03f, 0.00000000e+00f, -1.54183885e-03f, -3.08919857e-03f,
+	-4.47826293e-03f, -5.54445408e-03f, -6.13975848e-03f, -6.15004991e-03f, -5.51059656e-03f, -4.21796640e-03f,
+	-2.33676063e-03f, 0.00000000e+00f, 2.59746416e-03f, 5.21248830e-03f, 7.57339704e-03f, 9.40455724e-03f,
+	1.04537674e-02f, 1.05200300e-02f, 9.47905123e-03f, 7.30383114e-03f, 4.07799031e-03f, 0.00000000e+00f,
+	-4.62278053e-03f, -9.39047510e-03f, -1.38367307e-02f, -1.74627506e-02f, -1.97768124e-02f, -2.03361261e-02f,
+	-1.87875039e-02f, -1.49032432e-02f, -8.60887532e-03f, 0.00000000e+00f, 1.06537356e-02f, 2.29184091e-02f,
+	3.62190859e-02f, 4.98751399e-02f, 6.31451282e-02f, 7.52778316e-02f, 8.55654762e-02f, 9.33948855e-02f,
+	9.82924172e-02f, 9.99590051e-02f, 9.82924172e-02f, 9.33948855e-02f, 8.55654762e-02f, 7.52778316e-02f,
+	6.31451282e-02f, 4.98751399e-02f, 3.62190859e-02f, 2.29184091e-02f, 1.06537356e-02f, 0.00000000e+00f,
+	-8.60887532e-03f, -1.49032432e-02f, -1.87875039e-02f, -2.03361261e-02f, -1.97768124e-02f, -1.74627506e-02f,
+	-1.38367307e-02f, -9.39047510e-03f, -4.62278053e-03f, 0.00000000e+00f, 4.07799031e-03f, 7.30383114e-03f,
+	9.47905123e-03f, 1.05200300e-02f, 1.04537674e-02f, 9.40455724e-03f, 7.57339704e-03f, 5.21248830e-03f,
+	2.59746416e-03f, 0.00000000e+00f, -2.33676063e-03f, -4.21796640e-03f, -5.51059656e-03f, -6.15004991e-03f,
+	-6.13975848e-03f, -5.54445408e-03f, -4.47826293e-03f, -3.08919857e-03f, -1.54183885e-03f, 0.00000000e+00f,
+	1.38892845e-03f, 2.50662379e-03f, 3.27248925e-03f, 3.64784551e-03f, 3.63564725e-03f, 3.27615768e-03f,
+	2.63937561e-03f, 1.81526103e-03f, 9.02931607e-04f, 0.00000000e+00f, -8.06898095e-04f, -1.44955086e-03f,
+	-1.88303925e-03f, -2.08778743e-03f, -2.06886350e-03f, -1.85287292e-03f, -1.48300081e-03f, -1.01289532e-03f,
+	-5.00135957e-04f, 0.00000000e+00f, 4.39861980e-04f, 7.83387232e-04f, 1.00843305e-03f, 1.10741306e-03f,
+	1.08635625e-03f, 9.62661468e-04f, 7.61929645e-04f, 5.14312936e-04f, 2.50823485e-04f, 0.00000000e+00f,
+	-2.14753048e-04f, -3.76947464e-04f, -4.77828004e-04f, -5.16252950e-04f, -4.97767640e-04f, -4.33074085e-04f,
+	-3.36142736e-04f, -2.22222645e-04f, -1.05986208e-04f, 0.00000000e+00f, 8.63482204e-05f, 1.47405342e-04f,
+	1.81298487e-04f, 1.89536067e-04f, 1.76273877e-04f, 1.47381153e-04f, 1.09447528e-04f, 6.88600378e-05f,
+	3.10532316e-05f, 0.00000000e+00f, -2.20286384e-05f,
+};
+
+/* fast, 100 Hz out, pass 20 Hz, stop 80 Hz, 51.8 dB */
+static const float32_t decimfast100[51] = {
+	7.09856814e-04f, 1.01637349e-03f, 1.22303957e-03f, 1.20509714e-03f, 8.33180150e-04f, 0.00000000e+00f,
+	-1.34906858e-03f, -3.18630016e-03f, -5.37842225e-03f, -7.67540247e-03f, -9.71561065e-03f, -1.10497099e-02f,
+	-1.11828979e-02f, -9.63208434e-03f, -5.99174203e-03f, 0.00000000e+00f, 8.40450066e-03f, 1.90441334e-02f,
+	3.14895511e-02f, 4.50769793e-02f, 5.89558846e-02f, 7.21630996e-02f, 8.37155522e-02f, 9.27107623e-02f,
+	9.84227269e-02f, 1.00381002e-01f, 9.84227269e-02f, 9.27107623e-02f, 8.37155522e-02f, 7.21630996e-02f,
+	5.89558846e-02f, 4.50769793e-02f, 3.14895511e-02f, 1.90441334e-02f, 8.40450066e-03f, 0.00000000e+00f,
+	-5.99174203e-03f, -9.63208434e-03f, -1.11828979e-02f, -1.10497099e-02f, -9.71561065e-03f, -7.67540247e-03f,
+	-5.37842225e-03f, -3.18630016e-03f, -1.34906858e-03f, 0.00000000e+00f, 8.33180150e-04f, 1.20509714e-03f,
+	1.22303957e-03f, 1.01637349e-03f, 7.09856814e-04f,
+};
+
+/* flat, 50 Hz out, pass 20 Hz, stop 30 Hz, 49.9 dB */
+static const float32_t decimflat50[295] = {
+	-1.07034846e-04f, -1.04788175e-04f, -9.84947949e-05f, -8.78377528e-05f, -7.26254586e-05f, -5.28109146e-05f,
+	-2.85074301e-05f, 0.00000000e+00f, 3.22483786e-05f, 6.75960567e-05f, 1.05228203e-04f, 1.44168666e-04f,
+	1.83298315e-04f, 2.21379715e-04f, 2.57087792e-04f, 2.89045904e-04f, 3.15866529e-04f, 3.36195560e-04f,
+	3.48759028e-04f, 3.52410901e-04f, 3.46180489e-04f, 3.29317904e-04f, 3.01335973e-04f, 2.62047017e-04f,
+	2.11592964e-04f, 1.50467387e-04f, 7.95282036e-05f, 0.00000000e+00f, -8.65348072e-05f, -1.78156456e-04f,
+	-2.72640128e-04f, -3.67499839e-04f, -4.60043369e-04f, -5.47437279e-04f, -6.26780714e-04f, -6.95186330e-04f,
+	-7.49866367e-04f, -7.88221627e-04f, -8.07930871e-04f, -8.07038005e-04f, -7.84034329e-04f, -7.37933100e-04f,
+	-6.68333742e-04f, -5.75473166e-04f, -4.60261911e-04f, -3.24303123e-04f, -1.69892776e-04f, 0.00000000e+00f,
+	1.81773107e-04f, 3.71252251e-04f, 5.63771770e-04f, 7.54274376e-04f, 9.37428080e-04f, 1.10775797e-03f,
+	1.25978993e-03f, 1.38820300e-03f, 1.48798645e-03f, 1.55459757e-03f, 1.58411561e-03f, 1.57338754e-03f,
+	1.52016095e-03f, 1.42319985e-03f, 1.28237898e-03f, 1.09875314e-03f, 8.74597983e-04f, 6.13419863e-04f,
+	3.19932573e-04f, 0.00000000e+00f, -3.39455643e-04f, -6.90579312e-04f, -1.04474074e-03f, -1.39272157e-03f,
+	-1.72492858e-03f, -2.03162848e-03f, -2.30319934e-03f, -2.53039256e-03f, -2.70459907e-03f, -2.81811297e-03f,
+	-2.86438536e-03f, -2.83826125e-03f, -2.73619255e-03f, -2.55642017e-03f, -2.29911919e-03f, -1.96650125e-03f,
+	-1.56286955e-03f, -1.09462270e-03f, -5.70204731e-04f, 0.00000000e+00f, 6.03826986e-04f, 1.22754547e-03f,
+	1.85612317e-03f, 2.47353766e-03f, 3.06312867e-03f, 3.60798461e-03f, 4.09135522e-03f, 4.49708134e-03f,
+	4.81003208e-03f, 5.01653910e-03f, 5.10481709e-03f, 5.06536003e-03f, 4.89130221e-03f, 4.57873432e-03f,
+	4.12696470e-03f, 3.53871771e-03f, 2.82026161e-03f, 1.98146027e-03f, 1.03574443e-03f, 0.00000000e+00f,
+	-1.10562728e-03f, -2.25800934e-03f, -3.43139234e-03f, -4.59782691e-03f, -5.72766501e-03f, -6.79011462e-03f,
+	-7.75384161e-03f, -8.58760708e-03f, -9.26092712e-03f, -9.74474103e-03f, -1.00120737e-02f, -1.00386771e-02f,
+	-9.80363701e-03f, -9.28992953e-03f, -8.48491539e-03f, -7.38075864e-03f, -5.97475926e-03f, -4.26959036e-03f,
+	-2.27343248e-03f, 0.00000000e+00f, 2.53154362e-03f, 5.29678201e-03f, 8.26635187e-03f, 1.14063543e-02f,
+	1.46788651e-02f, 1.80425345e-02f, 2.14532666e-02f, 2.48649636e-02f, 2.82303234e-02f, 3.15016714e-02f,
+	3.46318126e-02f, 3.75748855e-02f, 4.02872003e-02f, 4.27280449e-02f, 4.48604409e-02f, 4.66518346e-02f,
+	4.80747086e-02f, 4.91071006e-02f, 4.97330187e-02f, 4.99427448e-02f, 4.97330187e-02f, 4.91071006e-02f,
+	4.80747086e-02f, 4.66518346e-02f, 4.48604409e-02f, 4.27280449e-02f, 4.02872003e-02f, 3.75748855e-02f,
+	3.46318126e-02f, 3.15016714e-02f, 2.82303234e-02f, 2.48649636e-02f, 2.14532666e-02f, 1.80425345e-02f,
+	1.46788651e-02f, 1.14063543e-02f, 8.26635187e-03f, 5.29678201e-03f, 2.53154362e-03f, 0.00000000e+00f,
+	-2.27343248e-03f, -4.26959036e-03f, -5.97475926e-03f, -7.38075864e-03f, -8.48491539e-03f, -9.28992953e-03f,
+	-9.80363701e-03f, -1.00386771e-02f, -1.00120737e-02f, -9.74474103e-03f, -9.26092712e-03f, -8.58760708e-03f,
+	-7.75384161e-03f, -6.79011462e-03f, -5.72766501e-03f, -4.59782691e-03f, -3.43139234e-03f, -2.25800934e-03f,
+	-1.10562728e-03f, 0.00000000e+00f, 1.03574443e-03f, 1.98146027e-03f, 2.82026161e-03f, 3.53871771e-03f,
+	4.12696470e-03f, 4.57873432e-03f, 4.89130221e-03f, 5.06536003e-03f, 5.10481709e-03f, 5.01653910e-03f,
+	4.81003208e-03f, 4.49708134e-03f, 4.09135522e-03f, 3.60798461e-03f, 3.06312867e-03f, 2.47353766e-03f,
+	1.85612317e-03f, 1.22754547e-03f, 6.03826986e-04f, 0.00000000e+00f, -5.70204731e-04f, -1.09462270e-03f,
+	-1.56286955e-03f, -1.96650125e-03f, -2.29911919e-03f, -2.55642017e-03f, -2.73619255e-03f, -2.83826125e-03f,
+	-2.86438536e-03f, -2.81811297e-03f, -2.70459907e-03f, -2.53039256e-03f, -2.30319934e-03f, -2.03162848e-03f,
+	-1.72492858e-03f, -1.39272157e-03f, -1.04474074e-03f, -6.90579312e-04f, -3.39455643e-04f, 0.00000000e+00f,
+	3.19932573e-04f, 6.13419863e-04f, 8.74597983e-04f, 1.09875314e-03f, 1.28237898e-03f, 1.42319985e-03f,
+	1.52016095e-03f, 1.57338754e-03f, 1.58411561e-03f, 1.55459757e-03f, 1.48798645e-03f, 1.38820300e-03f,
+	1.25978993e-03f, 1.10775797e-03f, 9.37428080e-04f, 7.54274376e-04f, 5.63771770e-04f, 3.71252251e-04f,
+	1.81773107e-04f, 0.00000000e+00f, -1.69892776e-04f, -3.24303123e-04f, -4.60261911e-04f, -5.75473166e-04f,
+	-6.68333742e-04f, -7.37933100e-04f, -7.84034329e-04f, -8.07038005e-04f, -8.07930871e-04f, -7.88221627e-04f,
+	-7.49866367e-04f, -6.95186330e-04f, -6.26780714e-04f, -5.47437279e-04f, -4.60043369e-04f, -3.67499839e-04f,
+	-2.72640128e-04f, -1.78156456e-04f, -8.65348072e-05f, 0.00000000e+00f, 7.95282036e-05f, 1.50467387e-04f,
+	2.11592964e-04f, 2.62047017e-04f, 3.01335973e-04f, 3.29317904e-04f, 3.46180489e-04f, 3.52410901e-04f,
+	3.48759028e-04f, 3.36195560e-04f, 3.15866529e-04f, 2.89045904e-04f, 2.57087792e-04f, 2.21379715e-04f,
+	1.83298315e-04f, 1.44168666e-04f, 1.05228203e-04f, 6.75960567e-05f, 3.22483786e-05f, 0.00000000e+00f,
+	-2.85074301e-05f, -5.28109146e-05f, -7.26254586e-05f, -8.78377528e-05f, -9.84947949e-05f, -1.04788175e-04f,
+	-1.07034846e-04f,
+};
+
+/* fast, 50 Hz out, pass 10 Hz, stop 40 Hz, 50.5 dB */
+static const float32_t decimfast50[99] = {
+	3.57834607e-04f, 4.28634344e-04f, 4.89693815e-04f, 5.33721565e-04f, 5.52810880e-04f, 5.38762410e-04f,
+	4.83470974e-04f, 3.79365794e-04f, 2.19889761e-04f, 0.00000000e+00f, -2.83330653e-04f, -6.30633731e-04f,
+	-1.03951036e-03f, -1.50426536e-03f, -2.01563317e-03f, -2.56061638e-03f, -3.12245494e-03f, -3.68073968e-03f,
+	-4.21167919e-03f, -4.68852346e-03f, -5.08214116e-03f, -5.36174156e-03f, -5.49572521e-03f, -5.45264160e-03f,
+	-5.20222613e-03f, -4.71648404e-03f, -3.97078516e-03f, -2.94493059e-03f, -1.62415141e-03f, 0.00000000e+00f,
+	1.92890384e-03f, 4.15630590e-03f, 6.66795898e-03f, 9.44149542e-03f, 1.24465464e-02f, 1.56451149e-02f,
+	1.89922009e-02f, 2.24366682e-02f, 2.59223325e-02f, 2.93892437e-02f, 3.27751263e-02f, 3.60169350e-02f,
+	3.90524794e-02f, 4.18220666e-02f, 4.42701086e-02f, 4.63466445e-02f, 4.80087246e-02f, 4.92216139e-02f,
+	4.99597717e-02f, 5.02075767e-02f, 4.99597717e-02f, 4.92216139e-02f, 4.80087246e-02f, 4.63466445e-02f,
+	4.42701086e-02f, 4.18220666e-02f, 3.90524794e-02f, 3.60169350e-02f, 3.27751263e-02f, 2.93892437e-02f,
+	2.59223325e-02f, 2.24366682e-02f, 1.89922009e-02f, 1.56451149e-02f, 1.24465464e-02f, 9.44149542e-03f,
+	6.66795898e-03f, 4.15630590e-03f, 1.92890384e-03f, 0.00000000e+00f, -1.62415141e-03f, -2.94493059e-03f,
+	-3.97078516e-03f, -4.71648404e-03f, -5.20222613e-03f, -5.45264160e-03f, -5.49572521e-03f, -5.36174156e-03f,
+	-5.08214116e-03f, -4.68852346e-03f, -4.21167919e-03f, -3.68073968e-03f, -3.12245494e-03f, -2.56061638e-03f,
+	-2.01563317e-03f, -1.50426536e-03f, -1.03951036e-03f, -6.30633731e-04f, -2.83330653e-04f, 0.00000000e+00f,
+	2.19889761e-04f, 3.79365794e-04f, 4.83470974e-04f, 5.38762410e-04f, 5.52810880e-04f, 5.33721565e-04f,
+	4.89693815e-04f, 4.28634344e-04f, 3.57834607e-04f,
+};
+
+static const decim_design_t decimDesigns[] = {
+	{ "flat", 500, 2, 39, 200.0f, decimflat500 },
+	{ "fast", 500, 2, 11, 100.0f, decimfast500 },
+	{ "flat", 250, 4, 75, 100.0f, decimflat250 },
+	{ "fast", 250, 4, 21, 50.0f, decimfast250 },
+	{ "flat", 200, 5, 93, 80.0f, decimflat200 },
+	{ "fast", 200, 5, 27, 40.0f, decimfast200 },
+	{ "flat", 100, 10, 183, 40.0f, decimflat100 },
+	{ "fast", 100, 10, 51, 20.0f, decimfast100 },
+	{ "flat", 50, 20, 295, 20.0f, decimflat50 },
+	{ "fast", 50, 20, 99, 10.0f, decimfast50 },
+};
+
+#endif /* DECIM_COEFFS_H_ */
@@ -0,0 +1,59 @@
+/*
+ * disk_stats.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Latency/throughput instrumentation of the FatFs disk path.
+ *  Every disk_read/disk_write/disk_ioctl is timed with the DWT cycle
+ *  counter and binned into log2(us) histograms per operation and per
+ *  sector count class. Drivers may additionally report busy-wait time
+ *  and retries for the operation in flight.
+ */
+
+#ifndef DISK_STATS_H_
+#define DISK_STATS_H_
+
+#include <stdint.h>
+
+/* latency buckets: bucket 0 is < 1 us, bucket i is [2^(i-1), 2^i) us, last bucket is open */
+#define DISKSTAT_LAT_BUCKETS 24
+/* sector count classes: 1, 2-3, 4-7, ... 128 (ioctl: control code) */
+#define DISKSTAT_CNT_CLASSES 8
+
+typedef enum
+{
+	DISKSTAT_OP_READ,
+	DISKSTAT_OP_WRITE,
+	DISKSTAT_OP_IOCTL,
+	DISKSTAT_OP_COUNT
+} diskstat_op;
+
+typedef struct
+{
+	uint32_t calls;
+	uint32_t errors;
+	uint32_t sectors;
+	uint32_t retries;
+	uint32_t maxCycles;
+	uint64_t cycles;		/* total time spent inside the driver */
+	uint64_t busyCycles;	/* part of it the driver reported as busy-waiting on the card */
+	uint32_t hist[DISKSTAT_CNT_CLASSES][DISKSTAT_LAT_BUCKETS];
+} diskstat_op_t;
+
+void DISKSTAT_Reset(void);
+
+/* called by the diskio glue around every driver call */
+uint32_t DISKSTAT_Begin(diskstat_op op);
+void DISKSTAT_End(diskstat_op op, uint32_t start, uint32_t count, uint8_t failed);
+
+/* called by drivers while an operation is in flight */
+void DISKSTAT_Busy(uint32_t cycles);
+void DISKSTAT_Retry(void);
+
+const diskstat_op_t* DISKSTAT_Get(diskstat_op op);
+uint32_t DISKSTAT_Percentile(diskstat_op op, uint32_t permille); // upper bucket bound in us
+
+void DISKSTAT_Report(void);
+void DISKSTAT_Command(const char *args);
+
+#endif /* DISK_STATS_H_ */
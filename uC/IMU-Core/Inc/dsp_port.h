@@ -0,0 +1,140 @@
+/*
+ * dsp_port.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  CMSIS-DSP entry point for the navigation code. With ARM_MATH_CM4
+ *  defined (and libarm_cortexM4lf_math linked) this is arm_math.h.
+ *  Otherwise the types and the subset of functions the firmware uses are
+ *  provided by dsp_port.c with the same names and semantics, so the same
+ *  sources build on the target without the library and on the host.
+ */
+
+#ifndef DSP_PORT_H_
+#define DSP_PORT_H_
+
+#ifdef ARM_MATH_CM4
+
+#include "arm_math.h"
+
+#else
+
+#include <stdint.h>
+
+typedef float float32_t;
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+typedef int64_t q63_t;
+
+typedef enum
+{
+	ARM_MATH_SUCCESS = 0,
+	ARM_MATH_ARGUMENT_ERROR = -1,
+	ARM_MATH_LENGTH_ERROR = -2,
+	ARM_MATH_SIZE_MISMATCH = -3,
+	ARM_MATH_NANINF = -4,
+	ARM_MATH_SINGULAR = -5,
+	ARM_MATH_TEST_FAILURE = -6
+} arm_status;
+
+typedef struct
+{
+	uint16_t numRows;
+	uint16_t numCols;
+	float32_t *pData;
+} arm_matrix_instance_f32;
+
+void arm_mat_init_f32(arm_matrix_instance_f32 *S, uint16_t nRows, uint16_t nColumns, float32_t *pData);
+arm_status arm_mat_add_f32(const arm_matrix_instance_f32 *pSrcA, const arm_matrix_instance_f32 *pSrcB, arm_matrix_instance_f32 *pDst);
+arm_status arm_mat_sub_f32(const arm_matrix_instance_f32 *pSrcA, const arm_matrix_instance_f32 *pSrcB, arm_matrix_instance_f32 *pDst);
+arm_status arm_mat_mult_f32(const arm_matrix_instance_f32 *pSrcA, const arm_matrix_instance_f32 *pSrcB, arm_matrix_instance_f32 *pDst);
+arm_status arm_mat_trans_f32(const arm_matrix_instance_f32 *pSrc, arm_matrix_instance_f32 *pDst);
+arm_status arm_mat_scale_f32(const arm_matrix_instance_f32 *pSrc, float32_t scale, arm_matrix_instance_f32 *pDst);
+/* like the library, the source matrix is used as scratch and destroyed */
+arm_status arm_mat_inverse_f32(const arm_matrix_instance_f32 *pSrc, arm_matrix_instance_f32 *pDst);
+
+/* coefficients in time reversed order, state of numTaps + blockSize - 1 samples */
+typedef struct
+{
+	uint8_t M;
+	uint16_t numTaps;
+	const q15_t *pCoeffs;
+	q15_t *pState;
+} arm_fir_decimate_instance_q15;
+
+typedef struct
+{
+	uint8_t M;
+	uint16_t numTaps;
+	const float32_t *pCoeffs;
+	float32_t *pState;
+} arm_fir_decimate_instance_f32;
+
+arm_status arm_fir_decimate_init_q15(arm_fir_decimate_instance_q15 *S, uint16_t numTaps, uint8_t M,
+		const q15_t *pCoeffs, q15_t *pState, uint32_t blockSize);
+/* 64 bit accumulator, result shifted by 15 and saturated */
+void arm_fir_decimate_q15(const arm_fir_decimate_instance_q15 *S, const q15_t *pSrc, q15_t *pDst, uint32_t blockSize);
+arm_status arm_fir_decimate_init_f32(arm_fir_decimate_instance_f32 *S, uint16_t numTaps, uint8_t M,
+		const float32_t *pCoeffs, float32_t *pState, uint32_t blockSize);
+void arm_fir_decimate_f32(const arm_fir_decimate_instance_f32 *S, const float32_t *pSrc, float32_t *pDst, uint32_t blockSize);
+
+/* dst = src / 32768 */
+void arm_q15_to_float(const q15_t *pSrc, float32_t *pDst, uint32_t blockSize);
+
+typedef struct
+{
+	uint16_t fftLenRFFT;
+} arm_rfft_fast_instance_f32;
+
+/* fftLen a power of two, 32 to 4096 */
+arm_status arm_rfft_fast_init_f32(arm_rfft_fast_instance_f32 *S, uint16_t fftLen);
+/*
+ * Forward only (ifftFlag 0), unscaled. p is used as scratch and destroyed.
+ * pOut[0] is X[0], pOut[1] X[N/2], then re, im of X[1] .. X[N/2 - 1].
+ */
+void arm_rfft_fast_f32(const arm_rfft_fast_instance_f32 *S, float32_t *p, float32_t *pOut, uint8_t ifftFlag);
+
+#endif /* ARM_MATH_CM4 */
+
+/* Cortex-M4 SIMD intrinsics: CMSIS core on the target, plain C on the host */
+#ifdef HOST_BUILD
+
+static inline int32_t dsp_sat16(int32_t v)
+{
+	return v > 32767 ? 32767 : (v < -32768 ? -32768 : v);
+}
+
+static inline uint32_t __SMLAD(uint32_t x, uint32_t y, uint32_t sum)
+{
+	return sum + (uint32_t)((int16_t)x * (int16_t)y) + (uint32_t)((int16_t)(x >> 16) * (int16_t)(y >> 16));
+}
+
+static inline uint32_t __QADD16(uint32_t x, uint32_t y)
+{
+	uint32_t lo = (uint16_t)dsp_sat16((int16_t)x + (int16_t)y);
+	uint32_t hi = (uint16_t)dsp_sat16((int16_t)(x >> 16) + (int16_t)(y >> 16));
+
+	return lo | (hi << 16);
+}
+
+static inline uint32_t __REV16(uint32_t x)
+{
+	return ((x & 0xFF00FF00u) >> 8) | ((x & 0x00FF00FFu) << 8);
+}
+
+static inline int32_t dsp_ssat(int32_t v, uint32_t bits)
+{
+	int32_t max = (1 << (bits - 1)) - 1;
+
+	return v > max ? max : (v < -max - 1 ? -max - 1 : v);
+}
+
+#define __SSAT(v, bits) dsp_ssat((v), (bits))
+
+#else
+
+#include "stm32f4xx.h"
+
+#endif /* HOST_BUILD */
+
+#endif /* DSP_PORT_H_ */
@@ -0,0 +1,100 @@
+/*
+ * eskf.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Error-state Kalman filter for inertial navigation. The nominal state
+ *  (position, velocity, body-to-nav quaternion, gyro and accel biases) is
+ *  integrated at the IMU rate; a 15 element error state
+ *  [dtheta dv dp dbg dba] carries the covariance. Navigation frame is
+ *  local level, z up, SI units.
+ *
+ *  All matrices live in static storage, in CCM RAM when ESKF_USE_CCM is
+ *  set. Predict has a fixed cost; an update costs at most one
+ *  ESKF_MAX_MEAS sized measurement.
+ */
+
+#ifndef ESKF_H_
+#define ESKF_H_
+
+#include <stdint.h>
+
+#define ESKF_N 15
+#define ESKF_MAX_MEAS 6
+
+/* error state indices */
+#define ESKF_THETA 0
+#define ESKF_VEL 3
+#define ESKF_POS 6
+#define ESKF_BG 9
+#define ESKF_BA 12
+
+#ifndef ESKF_USE_CCM
+#define ESKF_USE_CCM 1
+#endif
+
+// predict + update cycles allowed per 1 ms sample before an overrun is counted
+#ifndef ESKF_BUDGET_CYCLES
+#define ESKF_BUDGET_CYCLES 40000
+#endif
+
+#define ESKF_GRAVITY 9.80665f
+
+/* continuous-time noise densities */
+typedef struct
+{
+	float gyroNoise;	/* rad/s/sqrt(Hz) */
+	float accelNoise;	/* m/s^2/sqrt(Hz) */
+	float gyroBiasRw;	/* rad/s^2/sqrt(Hz) */
+	float accelBiasRw;	/* m/s^3/sqrt(Hz) */
+} eskf_noise_t;
+
+typedef struct
+{
+	float p[3];
+	float v[3];
+	float q[4];			/* w x y z, body to nav */
+	float bg[3];
+	float ba[3];
+} eskf_state_t;
+
+typedef struct
+{
+	uint32_t predicts;
+	uint32_t updates;
+	uint32_t rejected;		/* singular innovation covariance or bad size */
+	uint32_t gated;			/* innovation outside the gate of ESKF_UpdateGated() */
+	uint32_t overruns;		/* samples over ESKF_BUDGET_CYCLES */
+	uint32_t maxPredictCycles;
+	uint32_t maxUpdateCycles;
+	uint32_t maxSampleCycles;	/* predict plus all updates since the previous predict */
+} eskf_stats_t;
+
+void ESKF_Init(const eskf_noise_t *noise);
+void ESKF_Reset(void);
+
+/* initial 1-sigma uncertainties of each error block */
+void ESKF_SetInitialSigma(float att, float vel, float pos, float gyroBias, float accelBias);
+void ESKF_AlignFromAccel(float ax, float ay, float az);
+void ESKF_SetAttitude(const float q[4]);
+void ESKF_SetPosition(const float p[3]);
+void ESKF_SetGyroBias(const float bg[3]);
+
+/* gyro rad/s, accel m/s^2 (specific force), dt s */
+void ESKF_Predict(float gx, float gy, float gz, float ax, float ay, float az, float dt);
+
+/* measurements selecting error state elements directly: H = unit rows at idx,
+ * y = z - h(x), r = measurement variances */
+int32_t ESKF_UpdateSelect(const uint8_t *idx, const float *y, const float *r, uint32_t m);
+/* general measurement: H is m x ESKF_N row major, R is m x m row major */
+int32_t ESKF_Update(const float *H, const float *y, const float *R, uint32_t m);
+/* same, skipped (returns -3) when y' S^-1 y exceeds gate, e.g. a chi-square quantile */
+int32_t ESKF_UpdateGated(const float *H, const float *y, const float *R, uint32_t m, float gate);
+
+const eskf_state_t* ESKF_State(void);
+float ESKF_Variance(uint32_t i);
+const eskf_stats_t* ESKF_Stats(void);
+
+void ESKF_Command(const char *args);
+
+#endif /* ESKF_H_ */
@@ -62,7 +62,8 @@ extern char USER_Path[4]; /* USER logical drive path */
 void MX_FATFS_Init(void);
 
 /* USER CODE BEGIN Prototypes */
-
+/* mounts the volume on first use, FR_OK once mounted; main loop only */
+FRESULT FATFS_Mount(void);
 /* USER CODE END Prototypes */
 #ifdef __cplusplus
 }
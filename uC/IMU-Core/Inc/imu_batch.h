@@ -0,0 +1,53 @@
+/*
+ * imu_batch.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Counts to SI for many samples at once. Input is n samples of
+ *  interleaved int16 counts in burst / FIFO record order (ax ay az t gx
+ *  gy gz, sensor axes), output is one float array per quantity. Each
+ *  chunk of IMUB_CHUNK samples is deinterleaved, converted with
+ *  arm_q15_to_float and then mapped by one 3x3 affine pass per sensor,
+ *  which holds the axis remap, the nominal scale and the float CALIB
+ *  coefficients together. Every pass is a straight loop over contiguous
+ *  arrays, so it vectorises on the host as well.
+ *
+ *  Results match getMotion7() up to the fixed point rounding of
+ *  CALIB_Correct() (Q14 matrix, Q4 output).
+ */
+
+#ifndef IMU_BATCH_H_
+#define IMU_BATCH_H_
+
+#include <stdint.h>
+
+#define IMUB_VALUES 7			/* int16 counts per sample */
+#define IMUB_CHUNK 64			/* samples per pass, sizes the scratch */
+
+typedef struct
+{
+	float accelScale;			/* m/s^2 per count */
+	float gyroScale;			/* rad/s per count */
+	float tempScale;			/* counts per degC */
+	float tempOffset;			/* degC */
+	int16_t remap[3][3];		/* body = remap * sensor */
+	uint8_t calibrate;			/* apply CALIB_Coeffs() */
+} imub_config_t;
+
+/* structure of arrays, n floats each */
+typedef struct
+{
+	float *a[3];				/* m/s^2 */
+	float *g[3];				/* rad/s */
+	float *t;					/* degC, may be NULL */
+} imub_soa_t;
+
+void IMUB_Init(const imub_config_t *cfg);
+/* rebuilds the affine maps from CALIB_Coeffs() */
+void IMUB_Reload(void);
+
+/* big endian sensor bytes to native int16, values = 7 per sample */
+void IMUB_Swap(const uint8_t *be, int16_t *counts, uint32_t values);
+void IMUB_Convert(const int16_t *counts, uint32_t n, const imub_soa_t *out);
+
+#endif /* IMU_BATCH_H_ */
@@ -0,0 +1,80 @@
+/*
+ * imu_q15.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Fixed point alternative to getMotion7() + float filtering. The 14 byte
+ *  ACCEL_OUT burst stays in int16 from the SPI buffer on: bytes are swapped
+ *  in pairs (__REV16), the calibration offset is removed with __QADD16 in
+ *  sensor axes, and the axis remap is folded into the Q14 calibration
+ *  matrix so one pair of __SMLAD per output axis does both. An IMUQ_TAPS
+ *  low-pass FIR runs on the int16 counts (Q15 taps, __SMLAD on tap pairs)
+ *  and the result is converted to float once, at the navigation filter
+ *  boundary.
+ *
+ *  IMUQ_ProcessFloat() is the same chain in float, as the reference and
+ *  for the cycle comparison of "imuq bench". The Q15 path reads the
+ *  calibration from CALIB_Coeffs() but does not feed CALIB captures;
+ *  use the normal read path (IMU_Q15_PIPELINE 0) to calibrate.
+ */
+
+#ifndef IMU_Q15_H_
+#define IMU_Q15_H_
+
+#include <stdint.h>
+
+#define IMUQ_TAPS 8				/* even, taps are processed in pairs */
+#define IMUQ_RAW_LEN 14			/* ACCEL_OUT .. GYRO_ZOUT_L */
+
+typedef struct
+{
+	float accelScale;			/* m/s^2 per count */
+	float gyroScale;			/* rad/s per count */
+	float tempScale;			/* counts per degC */
+	float tempOffset;			/* degC */
+	int16_t remap[3][3];		/* body = remap * sensor, entries -1, 0, 1 */
+	float cutoff;				/* FIR cutoff, fraction of the sample rate; 0 passes through */
+} imuq_config_t;
+
+typedef struct
+{
+	float a[3];					/* m/s^2 */
+	float g[3];					/* rad/s */
+	float t;					/* degC */
+} imuq_sample_t;
+
+/* filter history, one per stream; int16 for the Q15 path, float for the reference */
+typedef struct
+{
+	int16_t hq[6][IMUQ_TAPS] __attribute__((aligned(4)));
+	float hf[6][IMUQ_TAPS];
+} imuq_filter_t;
+
+typedef struct
+{
+	uint32_t samples;
+	uint32_t saturated;			/* outputs clipped to int16 after calibration */
+	uint32_t maxCycles;			/* IMUQ_Convert() */
+	uint32_t benchQ15;			/* cycles per sample of the last "imuq bench" */
+	uint32_t benchFloat;
+	float benchDiff;			/* largest |q15 - float| over the bench, in counts */
+} imuq_stats_t;
+
+void IMUQ_Init(const imuq_config_t *cfg);
+/* rebuilds the fixed point tables from CALIB_Coeffs() */
+void IMUQ_Reload(void);
+void IMUQ_ResetFilter(imuq_filter_t *f);
+
+void IMUQ_Process(imuq_filter_t *f, const uint8_t raw[IMUQ_RAW_LEN], imuq_sample_t *out);
+void IMUQ_ProcessFloat(imuq_filter_t *f, const uint8_t raw[IMUQ_RAW_LEN], imuq_sample_t *out);
+
+/* IMUQ_Process() on the live filter, for a burst read by the pipeline's DMA */
+void IMUQ_Convert(const uint8_t raw[IMUQ_RAW_LEN], float *ax, float *ay, float *az, float *gx, float *gy, float *gz, float *t);
+
+/* runs both paths n times over the last raw burst on a private filter */
+void IMUQ_Bench(uint32_t n);
+
+const imuq_stats_t* IMUQ_Stats(void);
+void IMUQ_Command(const char *args);
+
+#endif /* IMU_Q15_H_ */
@@ -0,0 +1,57 @@
+/*
+ * ins.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Strapdown inertial navigation, split in two rates. INS_AddIncrement()
+ *  runs at the IMU rate (sample interrupt) and only accumulates angle and
+ *  velocity increments with coning and sculling corrections. Every
+ *  navDivider samples the compensated interval is handed to INS_Poll()
+ *  (main loop), which updates attitude, velocity and position.
+ *
+ *  Local level navigation frame, z up, flat non-rotating earth; SI units.
+ */
+
+#ifndef INS_H_
+#define INS_H_
+
+#include <stdint.h>
+
+#define INS_GRAVITY 9.80665f
+
+typedef struct
+{
+	float p[3];
+	float v[3];
+	float q[4];			/* w x y z, body to nav */
+	float time;			/* s since INS_Init() */
+} ins_state_t;
+
+typedef struct
+{
+	uint32_t samples;
+	uint32_t navUpdates;
+	uint32_t overruns;		/* intervals dropped because INS_Poll() fell behind */
+	uint32_t maxSampleCycles;
+	uint32_t maxNavCycles;
+} ins_stats_t;
+
+void INS_Init(float sampleHz, uint32_t navDivider);
+void INS_SetAttitude(const float q[4]);
+/* coning and sculling terms on/off, on by default */
+void INS_SetCompensation(uint8_t on);
+
+/* IMU rate, interrupt context: dtheta rad, dv m/s over one sample */
+void INS_AddIncrement(const float dtheta[3], const float dv[3]);
+/* same from rate samples (rad/s, m/s^2) */
+void INS_AddSample(float gx, float gy, float gz, float ax, float ay, float az);
+
+/* navigation rate, returns 1 when a navigation update was done */
+uint8_t INS_Poll(void);
+
+const ins_state_t* INS_State(void);
+const ins_stats_t* INS_Stats(void);
+
+void INS_Command(const char *args);
+
+#endif /* INS_H_ */
@@ -0,0 +1,72 @@
+/*
+ * log_session.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Session logger on top of FatFs. A session is written as a sequence of
+ *  part files SSSSPPPP.LOG (session id in hex, part index in decimal),
+ *  each starting with a log_part_header_t. Parts rotate on a size or time
+ *  threshold at record boundaries. The next part is created and
+ *  preallocated from LOG_Poll() while the current one is being written,
+ *  so a rotation only swaps file and block buffer pointers; the previous
+ *  part is flushed, truncated and closed from LOG_Poll() afterwards.
+ *
+ *  A part keeps its preallocated size until it is closed, so after an
+ *  unclean shutdown the file is longer than its payload. Every sync and
+ *  the close rewrite the header with the payload length on the card;
+ *  readers stop there.
+ */
+
+#ifndef LOG_SESSION_H_
+#define LOG_SESSION_H_
+
+#include <stdint.h>
+
+#define LOG_MAGIC 0x474C5250 // "PRLG"
+#define LOG_VERSION 2
+#define LOG_BLOCK_SIZE 512
+#define LOG_PREALLOC_STEP (32 * 1024) // bytes preallocated per LOG_Poll() call
+
+/* first bytes of every part file, little endian */
+typedef struct
+{
+	uint32_t magic;
+	uint16_t version;
+	uint16_t headerSize;
+	uint32_t sessionId;
+	uint32_t partIndex;
+	uint32_t startTick;		/* HAL_GetTick() when the part became current */
+	uint32_t sessionOffset;	/* payload bytes written in earlier parts of the session */
+	uint32_t payloadBytes;	/* payload bytes in this part as of the last sync or the close */
+	uint32_t reserved;
+} log_part_header_t;
+
+typedef struct
+{
+	uint32_t sessionId;		/* 0 picks the first id without an existing part 0 */
+	uint32_t maxBytes;		/* part size cap including the header, 0 = none */
+	uint32_t maxMs;			/* part duration cap, 0 = none */
+	uint32_t syncMs;		/* f_sync and header period of the current part, 0 = only on rotation */
+} log_config_t;
+
+typedef struct
+{
+	uint32_t parts;
+	uint32_t bytes;			/* payload bytes of the whole session */
+	uint32_t syncRotations;	/* rotations that had to allocate the next part inline */
+	uint32_t errors;
+	uint32_t maxWriteCycles;	/* worst LOG_Write() including rotation */
+} log_stats_t;
+
+int32_t LOG_Open(const log_config_t *cfg);
+int32_t LOG_Write(const void *data, uint32_t len);
+void LOG_Poll(void);
+int32_t LOG_Close(void);
+
+uint32_t LOG_SessionId(void);
+const log_stats_t* LOG_Stats(void);
+void LOG_PartName(char *name, uint32_t sessionId, uint32_t partIndex);
+/* "log open [part KB] [part s] [sync ms]" mounts the volume and starts a session, "log close", "log" */
+void LOG_Command(const char *args);
+
+#endif /* LOG_SESSION_H_ */
@@ -53,6 +53,15 @@
 
 /* USER CODE BEGIN Private defines */
 
+/* IMU sample rate, TIM6 update: 84 MHz / 100 / 8401 */
+#define IMU_SAMPLE_HZ 100
+#define INS_NAV_DIVIDER 10 // strapdown navigation update every n samples
+#define IMU_Q15_PIPELINE 0 // 1: int16 calibration and filter path (imu_q15.h) on the DMA burst
+#define IMU_Q15_CUTOFF 0.15f // its FIR cutoff, fraction of IMU_SAMPLE_HZ
+#define IMU_OVERSAMPLE 0 // 1: sensor at 8 kHz into its FIFO, decimated to IMU_SAMPLE_HZ on the MCU (decim.h)
+#define IMU_DECIM_DESIGN 1 // stage 2 design for the rate, "decim list"
+#define IMU_MAG 0 // 1: magnetometer from the same burst (getMotion10) into AHRS_Update9, direct read path only
+
 /* USER CODE END Private defines */
 
 /**
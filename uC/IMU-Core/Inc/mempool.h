@@ -0,0 +1,59 @@
+/*
+ * mempool.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Fixed block pools in static storage. Free blocks form a list through
+ *  their first word, so MEMPOOL_Alloc() and MEMPOOL_Free() are O(1) and
+ *  run with interrupts masked for a few instructions, from any priority.
+ *  Blocks are 8 byte aligned. Each pool keeps its fill level, high water
+ *  mark and failed allocations; "pool" lists every initialised pool. An
+ *  in-use bit per block rejects a double free.
+ *
+ *  newlib_heap.c routes malloc() and friends to a pool of their own, so
+ *  nothing takes the newlib heap; map_report -x mallocr on the linker
+ *  map fails the build if newlib's allocator is linked all the same.
+ */
+
+#ifndef MEMPOOL_H_
+#define MEMPOOL_H_
+
+#include <stdint.h>
+
+#define MEMPOOL_MAX_POOLS 8
+
+#define MEMPOOL_ALIGN 8
+#define MEMPOOL_BLOCK(size) (((size) + MEMPOOL_ALIGN - 1) / MEMPOOL_ALIGN * MEMPOOL_ALIGN)
+
+typedef struct
+{
+	const char *name;
+	uint8_t *mem;
+	uint32_t blockSize;
+	uint32_t blocks;
+	uint32_t *inUse;		/* one bit per block */
+	void *free;
+	uint32_t used;
+	uint32_t highWater;
+	uint32_t allocs;
+	uint32_t fails;			/* pool empty */
+	uint32_t errors;		/* freed a pointer that is not an allocated block of the pool */
+} mempool_t;
+
+/* a pool and its storage, MEMPOOL_Init() before use */
+#define MEMPOOL_DEFINE(var, size, count) \
+	static uint64_t var##Mem[MEMPOOL_BLOCK(size) / 8 * (count)]; \
+	static uint32_t var##InUse[((count) + 31) / 32]; \
+	mempool_t var = { #var, (uint8_t*)var##Mem, MEMPOOL_BLOCK(size), (count), var##InUse }
+
+/* links the free list and lists the pool for "pool"; -1 when the table is full */
+int32_t MEMPOOL_Init(mempool_t *p);
+/* NULL when the pool is empty */
+void* MEMPOOL_Alloc(mempool_t *p);
+/* -1 for a pointer that is not an allocated block of the pool, a double free included */
+int32_t MEMPOOL_Free(mempool_t *p, void *block);
+
+/* "pool" prints every pool, "pool reset" clears the high water marks and counters */
+void MEMPOOL_Command(const char *args);
+
+#endif /* MEMPOOL_H_ */
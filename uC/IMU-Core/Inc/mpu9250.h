@@ -42,6 +42,10 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #define CS_ON HAL_GPIO_WritePin(SPI_CS, GPIO_PIN_RESET)
 #define CS_OFF HAL_GPIO_WritePin(SPI_CS, GPIO_PIN_SET)
 
+/* 1 from CS low to CS high of readRegisters() and writeRegister(): the SPI handle is idle between their
+ * transfers, so the pipeline's DMA read checks this before it takes the bus */
+extern volatile uint8_t mpuSpiOwned;
+
 #define MPU_SPI_TX(data) HAL_SPI_Transmit(&hspi1, data, 1, 100)
 #define MPU_SPI_RX(buff) HAL_SPI_Receive(&hspi1, buff, 1, 100)
 #define USE_SPI 1		// Use SPI rather I2C
@@ -77,9 +81,44 @@ typedef enum
     DLPF_BANDWIDTH_5HZ
 }mpu9250_dlpf_bandwidth;
 
+typedef enum
+{
+    MAG_FRESH,      // new AK8963 measurement
+    MAG_STALE,      // same measurement as the previous read
+    MAG_OVERFLOW,   // ST2 HOFL, counts returned as zeros
+    MAG_NODATA      // slave 0 not reading, counts returned as zeros
+}mpu9250_mag_status;
+
+typedef struct
+{
+    uint32_t fresh;
+    uint32_t stale;
+    uint32_t overflows;
+    uint32_t nodata;
+}mpu9250_mag_stats;
+
+// nominal scale factors set by Init_MPU9250()
+extern const float G;
+extern float _accelScale;
+extern float _gyroScale;
+extern const float _tempScale;
+extern const float _tempOffset;
+// sensor to body axis remap rows
+extern const int16_t tX[3];
+extern const int16_t tY[3];
+extern const int16_t tZ[3];
+
 int32_t Init_MPU9250(mpu9250_accel_range accelRange, mpu9250_gyro_range gyroRange);
 int32_t setFilt(mpu9250_dlpf_bandwidth bandwidth, uint8_t SRD);
 int32_t enableInt(uint8_t enable);
+int32_t setFiltBypass(void);
+int32_t enableFifo(uint8_t enable);
+uint16_t getFifoCount(void);
+int32_t enableWakeOnMotion(uint16_t thresholdMg, uint8_t lpOdr);
+int32_t disableWakeOnMotion(void);
+mpu9250_mag_status getMagStatus(void);
+const mpu9250_mag_stats* getMagStats(void);
+int32_t getMagInit(void);
 
 void getAccel(float* ax, float* ay, float* az);
 void getGyro(float* gx, float* gy, float* gz);
@@ -89,6 +128,9 @@ void getMotion6(float* ax, float* ay, float* az, float* gx, float* gy, float* gz
 void getMotion7(float* ax, float* ay, float* az, float* gx, float* gy, float* gz, float* t);
 void getMotion9(float* ax, float* ay, float* az, float* gx, float* gy, float* gz, float* hx, float* hy, float* hz);
 void getMotion10(float* ax, float* ay, float* az, float* gx, float* gy, float* gz, float* hx, float* hy, float* hz, float* t);
+// from a burst read at ACCEL_OUT done elsewhere: 14 bytes, 21 with the mag
+void unpackMotion7(const uint8_t* raw, float* ax, float* ay, float* az, float* gx, float* gy, float* gz, float* t);
+void unpackMotion10(const uint8_t* raw, float* ax, float* ay, float* az, float* gx, float* gy, float* gz, float* hx, float* hy, float* hz, float* t);
 
 void getAccelCounts(int16_t* ax, int16_t* ay, int16_t* az);
 void getGyroCounts(int16_t* gx, int16_t* gy, int16_t* gz);
@@ -124,6 +166,7 @@ void getMotion10Counts(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int16
 #define ACCEL_DLPF_20 0x04
 #define ACCEL_DLPF_10 0x05
 #define ACCEL_DLPF_5 0x06
+#define ACCEL_FCHOICE_B 0x08 // DLPF bypassed, 4 kHz, 1.13 kHz bandwidth
 
 #define CONFIG 0x1A
 #define GYRO_DLPF_184 0x01
@@ -132,6 +175,7 @@ void getMotion10Counts(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int16
 #define GYRO_DLPF_20 0x04
 #define GYRO_DLPF_10 0x05
 #define GYRO_DLPF_5 0x06
+#define GYRO_DLPF_250 0x00 // 8 kHz, 250 Hz bandwidth
 
 #define SMPDIV 0x19
 
@@ -140,15 +184,34 @@ void getMotion10Counts(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int16
 #define INT_DISABLE 0x00
 #define INT_PULSE_50US 0x00
 #define INT_RAW_RDY_EN 0x01
+#define INT_WOM_EN 0x40
+
+#define LP_ACCEL_ODR 0x1E // 0.24 Hz << code, 0..11
+#define WOM_THR 0x1F // 4 mg per LSB
+#define MOT_DETECT_CTRL 0x69
+#define ACCEL_INTEL_EN 0x80
+#define ACCEL_INTEL_MODE 0x40 // compare against the previous sample
 
 #define PWR_MGMNT_1 0x6B
 #define PWR_RESET 0x80
 #define CLOCK_SEL_PLL 0x01
+#define PWR_CYCLE 0x20
 
 #define PWR_MGMNT_2 0x6C
 #define SEN_ENABLE 0x00
+#define DIS_GYRO 0x07
+
+#define FIFO_EN 0x23
+#define FIFO_TEMP 0x80
+#define FIFO_GYRO 0x70
+#define FIFO_ACCEL 0x08
+#define FIFO_COUNT 0x72
+#define FIFO_R_W 0x74
+#define FIFO_SIZE 512
 
 #define USER_CTRL 0x6A
+#define USER_FIFO_EN 0x40
+#define USER_FIFO_RST 0x04
 #define I2C_MST_EN 0x20
 #define I2C_IF_DIS 0x10
 #define I2C_MST_CLK 0x0D
@@ -166,6 +229,10 @@ void getMotion10Counts(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int16
 #define AK8963_I2C_ADDR 0x0C
 
 #define AK8963_HXL 0x03
+#define AK8963_ST2 0x09
+#define AK8963_HOFL 0x08 // ST2 magnetic sensor overflow
+#define AK8963_BITM 0x10 // ST2 16 bit output
+#define AK8963_DATA_LEN 7 // HXL..ST2, reading ST2 ends the measurement's read
 
 #define AK8963_CNTL1 0x0A
 #define AK8963_PWR_DOWN 0x00
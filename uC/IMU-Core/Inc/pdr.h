@@ -0,0 +1,74 @@
+/*
+ * pdr.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Foot-mounted pedestrian dead reckoning on top of the ESKF. A GLRT
+ *  stance detector (SHOE, Skog et al. 2010) runs over a sliding window of
+ *  accel and gyro samples at the IMU rate; every stance sample feeds a
+ *  zero velocity pseudo-measurement to the ESKF. Swing phases between
+ *  confirmed stances are reported as steps with their displacement.
+ *
+ *  PDR_Update() must run after ESKF_Predict() for the same sample.
+ */
+
+#ifndef PDR_H_
+#define PDR_H_
+
+#include <stdint.h>
+
+#define PDR_MAX_WINDOW 32
+#define PDR_STEP_QUEUE 8
+
+typedef struct
+{
+	float sampleHz;
+	uint16_t window;		/* GLRT window, samples, <= PDR_MAX_WINDOW */
+	uint16_t minStance;		/* consecutive stance samples that confirm a stance */
+	float sigmaAccel;		/* accel noise, m/s^2 */
+	float sigmaGyro;		/* gyro noise, rad/s */
+	float threshold;		/* stance when the test statistic is below */
+	float zuptVar;			/* zero velocity measurement variance, (m/s)^2 */
+} pdr_config_t;
+
+typedef struct
+{
+	uint32_t index;
+	uint32_t endSample;		/* sample count when the step's stance was confirmed */
+	float duration;			/* s, stance to stance */
+	float dp[3];			/* displacement since the previous stance, nav frame */
+	float length;			/* horizontal */
+	float heading;			/* rad, of the horizontal displacement, from x towards y */
+} pdr_step_t;
+
+typedef void (*pdr_step_callback)(const pdr_step_t *step);
+
+typedef struct
+{
+	uint32_t samples;
+	uint32_t stanceSamples;
+	uint32_t steps;
+	uint32_t droppedSteps;	/* step queue full */
+	uint32_t zuptRejected;
+	float distance;			/* sum of step lengths */
+	float lastStatistic;
+	uint32_t maxCycles;		/* detector plus zero velocity update */
+} pdr_stats_t;
+
+void PDR_Init(const pdr_config_t *cfg);
+/* not while PDR_Update() may run; "pdr reset" clears at the next sample instead */
+void PDR_Reset(void);
+
+/* gyro rad/s, accel m/s^2; returns 1 for a stance sample */
+uint8_t PDR_Update(float gx, float gy, float gz, float ax, float ay, float az);
+
+/* oldest completed step, -1 if none */
+int32_t PDR_PopStep(pdr_step_t *step);
+/* main loop: prints completed steps and hands them to the step callback */
+void PDR_Poll(void);
+void PDR_SetStepCallback(pdr_step_callback cb);
+const pdr_stats_t* PDR_Stats(void);
+
+void PDR_Command(const char *args);
+
+#endif /* PDR_H_ */
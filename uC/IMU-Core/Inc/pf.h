@@ -0,0 +1,116 @@
+/*
+ * pf.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Map constrained particle filter for indoor position. Particles carry
+ *  x, y and a heading offset against the PDR heading; every step moves
+ *  them by the reported length and heading plus noise and kills those
+ *  whose path crosses a wall cell. Beacon ranges reweight them.
+ *  Systematic resampling when the effective sample size drops.
+ *
+ *  Runs in the main loop, fed by PDR_Poll() and the beacon receiver.
+ *  The walls come from a PBM file on the card, PF_MAP_FILE at boot or
+ *  "pf map <file>"; without one the particles only follow steps and
+ *  ranges. Particles are stored as separate arrays per component in CCM RAM
+ *  (PF_USE_CCM) so every pass reads memory sequentially.
+ */
+
+#ifndef PF_H_
+#define PF_H_
+
+#include <stdint.h>
+
+#include "pdr.h"
+
+#ifndef PF_MAX_PARTICLES
+#define PF_MAX_PARTICLES 2048
+#endif
+
+#ifndef PF_USE_CCM
+#define PF_USE_CCM 1
+#endif
+
+#define PF_MAP_FILE "map.pbm"
+/* largest map file, 256 x 256 cells with the header */
+#ifndef PF_MAP_BYTES
+#define PF_MAP_BYTES 8256
+#endif
+
+/*
+ * Wall grid, one bit per cell, 1 = wall. Rows of (width + 7) / 8 bytes,
+ * most significant bit first, the same packing as a PBM (P4) image body;
+ * row 0 is the one at y0. Outside the grid counts as wall.
+ *
+ * A map file is a binary PBM with the cell size and origin in a comment:
+ *
+ *   P4
+ *   # pf <cell m> <x0 m> <y0 m>
+ *   <width> <height>
+ *   <rows>
+ *
+ * Without the comment the cell is 0.1 m at (0, 0).
+ */
+typedef struct
+{
+	uint16_t width;
+	uint16_t height;
+	float cell;				/* m */
+	float x0, y0;			/* m, corner of cell (0, 0) */
+	const uint8_t *bits;
+} pf_map_t;
+
+typedef struct
+{
+	uint16_t particles;		/* <= PF_MAX_PARTICLES */
+	float stepSigma;		/* step length scatter, fraction of the length */
+	float headingSigma;		/* heading offset random walk per step, rad */
+	float initHeadingSigma;	/* rad */
+	float resampleRatio;	/* resample when Neff < ratio * particles */
+	float height;			/* m, receiver antenna above the map plane */
+	uint32_t seed;
+} pf_config_t;
+
+typedef struct
+{
+	float x, y;
+	float sx, sy;			/* weighted standard deviation */
+	float heading;			/* mean heading offset, rad */
+	float neff;
+} pf_estimate_t;
+
+typedef struct
+{
+	uint32_t steps;
+	uint32_t ranges;
+	uint32_t resamples;
+	uint32_t depletions;	/* every particle died, reset around the last estimate */
+	uint32_t lastWallHits;
+	uint32_t maxStepCycles;
+	uint32_t maxRangeCycles;
+	uint32_t maxResampleCycles;
+} pf_stats_t;
+
+void PF_Init(const pf_config_t *cfg);
+/* NULL removes the map */
+void PF_SetMap(const pf_map_t *map);
+/* map file in memory, map->bits points into pbm; -1 if it is not a PBM (P4) */
+int32_t PF_ParseMap(const uint8_t *pbm, uint32_t len, pf_map_t *map);
+/* reads a map file from the card and sets it, main loop; on an error the map is removed */
+int32_t PF_LoadMap(const char *path);
+/* spreads the particles around (x, y), avoiding wall cells */
+void PF_Reset(float x, float y, float sigma);
+
+void PF_Step(float length, float heading);
+/* beacon at b[3], map frame */
+void PF_Range(const float b[3], float range, float var);
+
+/* pdr_step_callback and beacon_range_callback */
+void PF_OnStep(const pdr_step_t *step);
+void PF_OnRange(const float b[3], float range, float var);
+
+const pf_estimate_t* PF_Estimate(void);
+const pf_stats_t* PF_Stats(void);
+void PF_Command(const char *args);
+
+#endif /* PF_H_ */
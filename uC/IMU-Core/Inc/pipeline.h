@@ -0,0 +1,87 @@
+/*
+ * pipeline.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Staged IMU sample path, one stage per priority:
+ *
+ *  - TIM6 (priority 0) stamps the tick and starts the burst read from
+ *    ACCEL_OUT on SPI1 DMA, nothing else
+ *  - the DMA completion (priority 0) queues the raw bytes with their
+ *    stamps and pends PendSV
+ *  - PendSV (lowest priority) converts and runs the filters, then queues
+ *    the sample for output
+ *  - PIPE_Poll() in the main loop prints it, and with a log session
+ *    open ("log open") also writes it there as a 36 byte record: tick,
+ *    DWT stamp, accel, gyro and temperature as floats
+ *
+ *  A slow UART write now only delays the main loop, and the filters
+ *  only run ahead of the main loop, not of the other interrupts. Both
+ *  queues are single producer, single consumer rings.
+ *
+ *  With IMU_OVERSAMPLE the FIFO drain is several dependent reads, so the
+ *  tick only queues its stamps and the blocking DECIM_Read() runs in
+ *  PendSV.
+ *
+ *  Stage times are DWT cycles:
+ *
+ *  - read: tick to DMA completion
+ *  - wait: DMA completion to the start of processing
+ *  - process: conversion and filters
+ *  - output: print_motion7() and LOG_Write()
+ *  - total: tick to the end of the output
+ */
+
+#ifndef PIPELINE_H_
+#define PIPELINE_H_
+
+#include <stdint.h>
+
+#define PIPE_RAW_QUEUE 8		/* power of two */
+#define PIPE_OUT_QUEUE 16		/* power of two */
+
+typedef enum
+{
+	PIPE_READ,
+	PIPE_WAIT,
+	PIPE_PROCESS,
+	PIPE_OUTPUT,
+	PIPE_TOTAL,
+	PIPE_STAGES
+} pipe_stage;
+
+typedef struct
+{
+	uint32_t last;
+	uint32_t max;
+	uint32_t count;
+	uint64_t sum;
+} pipe_timing_t;
+
+typedef struct
+{
+	uint32_t ticks;
+	uint32_t samples;
+	uint32_t busy;			/* tick while the previous read or a main loop transfer held SPI1 */
+	uint32_t dmaErrors;
+	uint32_t rawDrops;		/* raw queue full, PendSV behind */
+	uint32_t outDrops;		/* output queue full, main loop behind */
+	pipe_timing_t stage[PIPE_STAGES];
+} pipe_stats_t;
+
+void PIPE_Init(void);
+
+/* TIM6 update */
+void PIPE_Tick(void);
+/* PendSV */
+void PIPE_Process(void);
+/* main loop: output */
+void PIPE_Poll(void);
+
+/* a read, queued or pending work; the sensor is free once TIM6 is stopped and this is 0 */
+uint8_t PIPE_Busy(void);
+
+const pipe_stats_t* PIPE_Stats(void);
+void PIPE_Command(const char *args);
+
+#endif /* PIPELINE_H_ */
@@ -0,0 +1,88 @@
+/*
+ * power.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Wake on motion power manager. The sample path (pipeline.h) feeds
+ *  every sample to POWER_AddSample(), which counts how long the wearer
+ *  has been still (gyro and accel magnitude inside their thresholds).
+ *  After stillSeconds POWER_Poll() stops the sample timer, puts the
+ *  MPU9250 into accel only low power wake on motion and from then on
+ *  sleeps the MCU once per main loop pass, WFI or Stop, until an
+ *  interrupt.
+ *  The MPU9250 INT pulse (POWER_MotionIrq()) brings the sensor and the
+ *  sample timer back, with the first sample due at once.
+ *
+ *  Time is kept on the LSI clocked RTC, which also runs in Stop, so the
+ *  time in each state and the wake latency (INT edge, or the wake up
+ *  from Stop, to the first full rate sample) are measured the same way
+ *  whichever sleep mode is used. Hardware goes through the POWER_Port*
+ *  functions: power_port.c on the board, a simulation on the host.
+ */
+
+#ifndef POWER_H_
+#define POWER_H_
+
+#include <stdint.h>
+
+typedef enum
+{
+	POWER_ACTIVE,			/* full rate sampling */
+	POWER_LOW,				/* wake on motion, MCU awake in the main loop */
+	POWER_ASLEEP,			/* wake on motion, MCU in WFI or Stop */
+	POWER_STATES
+} power_state;
+
+typedef struct
+{
+	float sampleHz;
+	float stillSeconds;		/* stationary this long before wake on motion */
+	float gyroThreshold;	/* rad/s, norm */
+	float accelThreshold;	/* m/s^2, | |a| - g | */
+	uint16_t womMg;			/* MPU9250 WOM_THR, 4 mg steps */
+	uint8_t lpOdr;			/* MPU9250 LP_ACCEL_ODR, 0.24 Hz << lpOdr */
+	uint8_t stop;			/* Stop mode instead of WFI sleep */
+	uint8_t enable;
+} power_config_t;
+
+typedef struct
+{
+	uint64_t us[POWER_STATES];	/* time in each state */
+	uint32_t entries;		/* into wake on motion */
+	uint32_t wakes;			/* back to full rate */
+	uint32_t falseWakes;	/* woke and went back without leaving the still thresholds */
+	uint32_t sleeps;
+	uint32_t errors;		/* sensor did not take the low power settings */
+	uint32_t latencyMinUs;
+	uint32_t latencyMaxUs;
+	uint32_t latencyLastUs;
+	uint64_t latencySumUs;
+} power_stats_t;
+
+void POWER_Init(const power_config_t *cfg);
+void POWER_Enable(uint8_t on);
+
+/* from the sample path, rad/s and m/s^2 */
+void POWER_AddSample(float gx, float gy, float gz, float ax, float ay, float az);
+/* MPU9250 INT while in wake on motion */
+void POWER_MotionIrq(void);
+
+/* main loop, may sleep until the next interrupt */
+void POWER_Poll(void);
+
+power_state POWER_State(void);
+/* brings the time of the current state up to date */
+const power_stats_t* POWER_Stats(void);
+void POWER_Command(const char *args);
+
+/* power_port.c */
+void POWER_PortInit(void);
+uint32_t POWER_PortTicks(void);		/* free running, wraps at 2^32 */
+float POWER_PortTickUs(void);
+void POWER_PortSampling(uint8_t on);	/* sample timer, on gives a sample at once */
+int32_t POWER_PortSensor(uint8_t lowPower, const power_config_t *cfg);
+void POWER_PortWakeIrq(uint8_t on);
+/* sleeps unless *wake is set, returns the ticks at the wake up */
+uint32_t POWER_PortSleep(uint8_t stop, volatile const uint8_t *wake);
+
+#endif /* POWER_H_ */
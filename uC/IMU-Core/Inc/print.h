@@ -9,5 +9,6 @@
 #define PRINT_H_
 
 void print_motion7(uint32_t tick, float ax, float ay, float az, float gx, float gy, float gz, float t);
+void print_str(const char *str);
 
 #endif /* PRINT_H_ */
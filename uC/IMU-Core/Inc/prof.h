@@ -0,0 +1,96 @@
+/*
+ * prof.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  DWT cycle profiler with a fixed set of named probes. PROF_BEGIN() and
+ *  PROF_END() bracket a scope in one function; each pass records its
+ *  cycles into the probe's count, min, max, sum and a histogram of
+ *  power of two bins (PROF_HIST_MIN cycles and below in bin 0). Records
+ *  mask interrupts for the update only, so a probe may be hit from any
+ *  priority, and a probe interrupted by another counts the other's
+ *  cycles too: the ISR probes show what preempts what.
+ *
+ *  Probes nest: pendsv contains the filter probes, tasks the main loop
+ *  work the scheduler runs. Load is the probe's share of all cycles in
+ *  the window, so the top level probes (the interrupts, pendsv, tasks)
+ *  add up to the busy CPU, counting twice any interrupt that lands in
+ *  pendsv or a task; the rest is idle.
+ *
+ *  Every PROF_REPORT_MS the probes are copied and cleared for the next
+ *  window, and PROF_Poll() sends the copy on the UART telemetry stream a
+ *  line per call. The probes compile to nothing with PROF_ENABLE 0, by
+ *  default in an NDEBUG (release) build.
+ */
+
+#ifndef PROF_H_
+#define PROF_H_
+
+#include <stdint.h>
+
+#ifndef PROF_ENABLE
+#ifdef NDEBUG
+#define PROF_ENABLE 0
+#else
+#define PROF_ENABLE 1
+#endif
+#endif
+
+#define PROF_HIST_BINS 16
+#define PROF_HIST_MIN 64			/* cycles, top of bin 0; bin i up to 64 << i */
+#define PROF_REPORT_MS 10000		/* periodic report window, "prof every" */
+
+typedef enum
+{
+	/* interrupts */
+	PROF_TIM6,
+	PROF_SPI_DMA,
+	PROF_SYSTICK,
+	PROF_UART,
+	PROF_RF_IRQ,
+	PROF_PENDSV,
+	/* in pendsv, per sample */
+	PROF_THERMAL,
+	PROF_AHRS,
+	PROF_ESKF,
+	PROF_PDR,
+	PROF_BEACON,
+	PROF_INS,
+	PROF_SPEC,
+	PROF_POWER,
+	/* main loop */
+	PROF_TASKS,
+	PROF_PROBES
+} prof_probe;
+
+typedef struct
+{
+	uint32_t count;
+	uint32_t min;
+	uint32_t max;
+	uint64_t sum;
+	uint32_t hist[PROF_HIST_BINS];
+} prof_stats_t;
+
+#if PROF_ENABLE
+#include "dwt_delay.h"
+#define PROF_BEGIN(p) uint32_t prof_##p = DWT_Get()
+#define PROF_END(p) PROF_Record((p), DWT_Get() - prof_##p)
+#else
+#define PROF_BEGIN(p)
+#define PROF_END(p)
+#endif
+
+/* starts the DWT cycle counter and clears the probes */
+void PROF_Init(void);
+void PROF_Record(prof_probe p, uint32_t cycles);
+void PROF_Reset(void);
+/* copy of one probe, consistent */
+void PROF_Get(prof_probe p, prof_stats_t *out);
+
+/* main loop: the periodic report, which starts a new window */
+void PROF_Poll(void);
+/* "prof" prints the window so far, "prof reset", "prof every <ms>" (0 stops) */
+void PROF_Command(const char *args);
+
+#endif /* PROF_H_ */
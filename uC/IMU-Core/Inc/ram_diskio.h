@@ -0,0 +1,21 @@
+/*
+ * ram_diskio.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  FatFs diskio driver on a caller supplied memory block. Useful as a
+ *  scratch volume on the target (e.g. in CCM) and for host benchmarks.
+ */
+
+#ifndef RAM_DISKIO_H_
+#define RAM_DISKIO_H_
+
+#include "ff_gen_drv.h"
+
+#define RAMDISK_SECTOR_SIZE 512
+
+extern Diskio_drvTypeDef RAMDISK_Driver;
+
+void RAMDISK_Setup(uint8_t *mem, uint32_t sectors);
+
+#endif /* RAM_DISKIO_H_ */
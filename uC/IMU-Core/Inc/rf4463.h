@@ -0,0 +1,92 @@
+/*
+ * rf4463.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  NiceRF RF4463PRO (Si4463 rev. C2) driver. The modem configuration is
+ *  the WDS output shipped with the NiceRF library (radio_config_Si4463.h,
+ *  433.5 MHz 2GFSK 1200 sps), with fixed length packets of
+ *  RF4463_PACKET_LEN bytes on top.
+ *
+ *  nIRQ only timestamps the event (RF4463_IrqHandler(), EXTI context);
+ *  the SPI traffic to fetch the packet and its latched RSSI is done by
+ *  RF4463_Poll() from the main loop. The bus and pins go through the
+ *  RF4463_Port* functions: rf4463_port.c on the board (SPI3), a simulated
+ *  radio on the host.
+ */
+
+#ifndef RF4463_H_
+#define RF4463_H_
+
+#include <stdint.h>
+
+#define RF4463_PACKET_LEN 8
+#define RF4463_CHANNEL 0
+#define RF4463_CTS_TRIES 2000
+#define RF4463_PART 0x4463
+
+/* Si4463 API commands */
+#define RF4463_CMD_POWER_UP 0x02
+#define RF4463_CMD_PART_INFO 0x01
+#define RF4463_CMD_SET_PROPERTY 0x11
+#define RF4463_CMD_FIFO_INFO 0x15
+#define RF4463_CMD_GET_INT_STATUS 0x20
+#define RF4463_CMD_GET_MODEM_STATUS 0x22
+#define RF4463_CMD_START_TX 0x31
+#define RF4463_CMD_START_RX 0x32
+#define RF4463_CMD_CHANGE_STATE 0x34
+#define RF4463_CMD_READ_CMD_BUFF 0x44
+#define RF4463_CMD_WRITE_TX_FIFO 0x66
+#define RF4463_CMD_READ_RX_FIFO 0x77
+
+/* GET_INT_STATUS PH_PEND bits */
+#define RF4463_PH_PACKET_SENT 0x20
+#define RF4463_PH_PACKET_RX 0x10
+#define RF4463_PH_CRC_ERROR 0x08
+
+#define RF4463_STATE_READY 0x03
+#define RF4463_STATE_RX 0x08
+
+/* time base shared with the IMU path: DWT cycles plus HAL tick */
+typedef struct
+{
+	uint32_t cycles;
+	uint32_t tick;
+} rf_stamp_t;
+
+typedef void (*rf_rx_callback)(const uint8_t *data, uint8_t len, float rssi, const rf_stamp_t *stamp);
+
+typedef struct
+{
+	uint32_t irqs;
+	uint32_t packets;
+	uint32_t crcErrors;
+	uint32_t sent;
+	uint32_t ctsTimeouts;
+	uint32_t missedIrqs;	/* nIRQ again before RF4463_Poll() served the previous one */
+	float lastRssi;
+	uint32_t maxPollCycles;
+} rf_stats_t;
+
+int32_t RF4463_Init(void);
+void RF4463_SetRxCallback(rf_rx_callback cb);
+
+/* nIRQ falling edge */
+void RF4463_IrqHandler(void);
+/* main loop */
+void RF4463_Poll(void);
+
+/* queues one packet and returns to RX once it is sent */
+int32_t RF4463_Send(const uint8_t *data, uint8_t len);
+
+const rf_stats_t* RF4463_Stats(void);
+void RF4463_Command(const char *args);
+
+/* bus and pins, rf4463_port.c */
+void RF4463_PortInit(void);
+void RF4463_PortShutdown(uint8_t on);
+void RF4463_PortSelect(uint8_t on);
+void RF4463_PortTransfer(const uint8_t *tx, uint8_t *rx, uint16_t len);
+void RF4463_PortDelayMs(uint32_t ms);
+
+#endif /* RF4463_H_ */
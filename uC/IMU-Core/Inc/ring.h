@@ -0,0 +1,303 @@
+/*
+ * ring.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Lock free rings of fixed size elements for interrupt to main loop
+ *  hand over, header only. Capacity is a power of two; indices run free
+ *  and are masked on use, so head - tail is the fill level at any wrap.
+ *
+ *  ring_t is single producer, single consumer. Each index is written by
+ *  one side only and published with a release store, read with an
+ *  acquire load (DMB on the M4), so no interrupt masking is needed at
+ *  any priority. The producer fills a slot in place (RING_Reserve(),
+ *  then RING_Commit()), which lets a DMA completion or a converter write
+ *  straight into the queue; the consumer can take one element, or a run
+ *  of contiguous ones (RING_PeekBatch() / RING_Release()) without a copy.
+ *
+ *  ring_mpsc_t takes several producers, interrupts of any priority and
+ *  the main loop, and one consumer. Producers claim a slot by compare
+ *  and swap on the claim index (LDREX/STREX on the M4; an interrupt in
+ *  between makes the STREX fail and the claim is retried) and publish
+ *  it through its sequence number, so slots may be committed out of
+ *  order. The consumer stops at the first slot not yet committed: a
+ *  producer that is preempted between reserve and commit holds back
+ *  everything behind it until it runs again.
+ *
+ *  The M4 has no data cache; on the host the two indices sit on their
+ *  own cache lines so the threads of ring_stress do not share one.
+ */
+
+#ifndef RING_H_
+#define RING_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef HOST_BUILD
+#define RING_CACHE_LINE 64
+#else
+#define RING_CACHE_LINE 4
+#endif
+
+#define RING_ALIGNED __attribute__((aligned(RING_CACHE_LINE)))
+
+#define RING_LOAD(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define RING_STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+typedef struct
+{
+	RING_ALIGNED uint32_t head;		/* producer */
+	RING_ALIGNED uint32_t tail;		/* consumer */
+	RING_ALIGNED uint8_t *buf;
+	uint32_t mask;
+	uint32_t size;					/* bytes per element */
+} ring_t;
+
+typedef struct
+{
+	RING_ALIGNED uint32_t claim;	/* producers */
+	RING_ALIGNED uint32_t tail;		/* consumer */
+	RING_ALIGNED uint8_t *buf;
+	uint32_t *seq;					/* per slot: index + 1 once committed */
+	uint32_t mask;
+	uint32_t size;
+} ring_mpsc_t;
+
+/* buf holds count elements of size bytes; -1 unless count is a power of two */
+static inline int32_t RING_Init(ring_t *r, void *buf, uint32_t count, uint32_t size)
+{
+	if (count == 0 || (count & (count - 1)) != 0)
+	{
+		return -1;
+	}
+	r->head = r->tail = 0;
+	r->buf = (uint8_t*)buf;
+	r->mask = count - 1;
+	r->size = size;
+
+	return 0;
+}
+
+static inline uint32_t RING_Count(const ring_t *r)
+{
+	return RING_LOAD(&r->head) - RING_LOAD(&r->tail);
+}
+
+static inline uint32_t RING_Capacity(const ring_t *r)
+{
+	return r->mask + 1;
+}
+
+/* producer: the next free slot, NULL when full; nothing is visible before RING_Commit() */
+static inline void* RING_Reserve(ring_t *r)
+{
+	uint32_t head = r->head;
+
+	if (head - RING_LOAD(&r->tail) > r->mask)
+	{
+		return NULL;
+	}
+
+	return r->buf + (head & r->mask) * r->size;
+}
+
+static inline void RING_Commit(ring_t *r)
+{
+	RING_STORE(&r->head, r->head + 1);
+}
+
+static inline int32_t RING_Push(ring_t *r, const void *e)
+{
+	void *slot = RING_Reserve(r);
+
+	if (!slot)
+	{
+		return -1;
+	}
+	memcpy(slot, e, r->size);
+	RING_Commit(r);
+
+	return 0;
+}
+
+/* consumer: the oldest element, NULL when empty; the slot stays owned until RING_Release() */
+static inline void* RING_Peek(ring_t *r)
+{
+	uint32_t tail = r->tail;
+
+	if (RING_LOAD(&r->head) == tail)
+	{
+		return NULL;
+	}
+
+	return r->buf + (tail & r->mask) * r->size;
+}
+
+/* consumer: up to max elements in place, as many as are contiguous before the wrap */
+static inline uint32_t RING_PeekBatch(ring_t *r, void **first, uint32_t max)
+{
+	uint32_t tail = r->tail;
+	uint32_t n = RING_LOAD(&r->head) - tail;
+	uint32_t run = r->mask + 1 - (tail & r->mask);
+
+	if (n > run)
+	{
+		n = run;
+	}
+	if (n > max)
+	{
+		n = max;
+	}
+	*first = r->buf + (tail & r->mask) * r->size;
+
+	return n;
+}
+
+static inline void RING_Release(ring_t *r, uint32_t n)
+{
+	RING_STORE(&r->tail, r->tail + n);
+}
+
+static inline int32_t RING_Pop(ring_t *r, void *e)
+{
+	void *slot = RING_Peek(r);
+
+	if (!slot)
+	{
+		return -1;
+	}
+	memcpy(e, slot, r->size);
+	RING_Release(r, 1);
+
+	return 0;
+}
+
+/* copies out up to max elements across the wrap, returns how many */
+static inline uint32_t RING_PopBatch(ring_t *r, void *out, uint32_t max)
+{
+	uint8_t *dst = (uint8_t*)out;
+	uint32_t total = 0, n;
+	void *first;
+
+	while (total < max && (n = RING_PeekBatch(r, &first, max - total)) != 0)
+	{
+		memcpy(dst, first, n * r->size);
+		dst += n * r->size;
+		total += n;
+		RING_Release(r, n);
+	}
+
+	return total;
+}
+
+/* seq holds count words next to buf */
+static inline int32_t RING_MpscInit(ring_mpsc_t *r, void *buf, uint32_t *seq, uint32_t count, uint32_t size)
+{
+	uint32_t i;
+
+	if (count == 0 || (count & (count - 1)) != 0)
+	{
+		return -1;
+	}
+	for (i = 0; i < count; i++)
+	{
+		seq[i] = i;
+	}
+	r->claim = r->tail = 0;
+	r->buf = (uint8_t*)buf;
+	r->seq = seq;
+	r->mask = count - 1;
+	r->size = size;
+
+	return 0;
+}
+
+/* any producer: claims a slot, NULL when full; *ticket goes to RING_MpscCommit() */
+static inline void* RING_MpscReserve(ring_mpsc_t *r, uint32_t *ticket)
+{
+	uint32_t pos = __atomic_load_n(&r->claim, __ATOMIC_RELAXED);
+
+	for (;;)
+	{
+		int32_t diff = (int32_t)(RING_LOAD(&r->seq[pos & r->mask]) - pos);
+
+		if (diff < 0)
+		{
+			/* the consumer has not freed this slot yet */
+			return NULL;
+		}
+		if (diff > 0)
+		{
+			/* another producer took it */
+			pos = __atomic_load_n(&r->claim, __ATOMIC_RELAXED);
+			continue;
+		}
+		if (__atomic_compare_exchange_n(&r->claim, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		{
+			*ticket = pos;
+			return r->buf + (pos & r->mask) * r->size;
+		}
+	}
+}
+
+static inline void RING_MpscCommit(ring_mpsc_t *r, uint32_t ticket)
+{
+	RING_STORE(&r->seq[ticket & r->mask], ticket + 1);
+}
+
+static inline int32_t RING_MpscPush(ring_mpsc_t *r, const void *e)
+{
+	uint32_t ticket;
+	void *slot = RING_MpscReserve(r, &ticket);
+
+	if (!slot)
+	{
+		return -1;
+	}
+	memcpy(slot, e, r->size);
+	RING_MpscCommit(r, ticket);
+
+	return 0;
+}
+
+/* consumer: the oldest committed element, NULL when empty or the oldest claim is not committed */
+static inline void* RING_MpscPeek(ring_mpsc_t *r)
+{
+	uint32_t tail = r->tail;
+
+	if (RING_LOAD(&r->seq[tail & r->mask]) != tail + 1)
+	{
+		return NULL;
+	}
+
+	return r->buf + (tail & r->mask) * r->size;
+}
+
+static inline void RING_MpscRelease(ring_mpsc_t *r)
+{
+	uint32_t tail = r->tail;
+
+	/* free for the producer one lap on */
+	RING_STORE(&r->seq[tail & r->mask], tail + r->mask + 1);
+	r->tail = tail + 1;
+}
+
+static inline uint32_t RING_MpscPopBatch(ring_mpsc_t *r, void *out, uint32_t max)
+{
+	uint8_t *dst = (uint8_t*)out;
+	uint32_t n = 0;
+	void *slot;
+
+	while (n < max && (slot = RING_MpscPeek(r)) != NULL)
+	{
+		memcpy(dst, slot, r->size);
+		dst += r->size;
+		n++;
+		RING_MpscRelease(r);
+	}
+
+	return n;
+}
+
+#endif /* RING_H_ */
@@ -0,0 +1,64 @@
+/*
+ * scheduler.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Time triggered cooperative executive for the main loop work. Tasks
+ *  are released every period ticks of SysTick (1 ms), offset ticks into
+ *  the period, and run to completion in registration order, so the
+ *  table order is the priority. Each run is timed with DWT against the
+ *  task's cycle budget:
+ *
+ *  - a run over budget counts an overrun and sets the WCET
+ *  - releases that passed while a task was still running or waiting are
+ *    skipped and counted, not run back to back
+ *  - jitter is the start of a run after the SysTick of its release
+ *
+ *  With nothing due the idle hook runs, then WFI until the next tick.
+ *  The power manager is the idle hook, and its sleeps suspend SysTick;
+ *  releases passed over while the idle hook ran are not lateness, they
+ *  are realigned without counting skips.
+ */
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <stdint.h>
+
+#define SCHED_MAX_TASKS 16
+
+typedef void (*sched_fn)(void);
+
+typedef struct
+{
+	const char *name;
+	sched_fn fn;
+	uint32_t period;		/* ticks */
+	uint32_t offset;		/* ticks */
+	uint32_t budget;		/* DWT cycles */
+	uint32_t next;			/* tick of the next release */
+
+	uint32_t runs;
+	uint32_t overruns;
+	uint32_t skips;
+	uint32_t lastCycles;
+	uint32_t wcet;
+	uint64_t sumCycles;
+	uint32_t maxJitter;		/* cycles */
+	uint64_t sumJitter;
+} sched_task_t;
+
+void SCHED_Init(void);
+/* index of the task, -1 when the table is full or the period is 0; budget 0 counts no overruns */
+int32_t SCHED_Add(const char *name, sched_fn fn, uint32_t periodMs, uint32_t offsetMs, uint32_t budgetUs);
+void SCHED_SetIdle(sched_fn fn);
+
+/* SysTick */
+void SCHED_Tick(void);
+/* main loop body: runs the due tasks or idles */
+void SCHED_Run(void);
+
+const sched_task_t* SCHED_Task(uint32_t i);
+void SCHED_Command(const char *args);
+
+#endif /* SCHEDULER_H_ */
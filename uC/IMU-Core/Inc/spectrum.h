@@ -0,0 +1,84 @@
+/*
+ * spectrum.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Spectrum of the accel magnitude for step cadence and vibration
+ *  diagnostics on the board. Frames of 256, 512 or 1024 samples
+ *  overlap by half and are Hann windowed; arm_rfft_fast_f32 gives the
+ *  power spectrum, from which each frame reports
+ *
+ *  - the dominant frequency in [minHz, maxHz], parabolic interpolation
+ *  - the mean square in up to SPEC_MAX_BANDS bands, (m/s^2)^2
+ *  - SPEC_MSG_BINS groups of bins in 0.5 dB steps for a compact message
+ *
+ *  The IMU interrupt only windows its sample into the two frames that
+ *  are filling, two multiplies per sample. A full frame is handed to
+ *  SPEC_Poll(), which removes the weighted mean into the FFT buffer in
+ *  one call, then runs SPEC_POLL_BUTTERFLIES butterflies of the FFT per
+ *  call and works through the bins SPEC_POLL_BINS at a time, so neither
+ *  the interrupt nor one pass of the main loop carries a whole frame.
+ *  A 1024 point frame takes about 25 calls.
+ */
+
+#ifndef SPECTRUM_H_
+#define SPECTRUM_H_
+
+#include <stdint.h>
+
+#define SPEC_MAX_POINTS 1024
+#define SPEC_MAX_BANDS 6
+#define SPEC_MSG_BINS 32
+#define SPEC_POLL_BINS 64		/* bins per SPEC_Poll() call */
+#define SPEC_POLL_BUTTERFLIES 256	/* FFT butterflies per SPEC_Poll() call, one stage at 1024 points */
+#define SPEC_USE_CCM 0			/* no room beside the filters, ccm.h */
+
+typedef struct
+{
+	float sampleHz;
+	uint16_t points;			/* 256, 512 or 1024 */
+	float minHz, maxHz;			/* dominant frequency search */
+	uint8_t bands;
+	float edges[SPEC_MAX_BANDS + 1];	/* Hz, band i is [edges[i], edges[i + 1]) */
+	uint8_t report;				/* print a SPEC message per frame */
+} spec_config_t;
+
+typedef struct
+{
+	uint32_t index;
+	uint32_t endSample;			/* sample count at the last sample of the frame */
+	uint16_t points;
+	float peakHz;
+	float peakRms;				/* m/s^2, of the peak bin */
+	float rms;					/* m/s^2, mean removed */
+	float band[SPEC_MAX_BANDS];	/* (m/s^2)^2 */
+	uint8_t level[SPEC_MSG_BINS];	/* 2 * (dB + 80) of (m/s^2)^2, 0 below */
+} spec_result_t;
+
+typedef struct
+{
+	uint32_t samples;
+	uint32_t frames;
+	uint32_t overruns;			/* frame full while the previous was still in SPEC_Poll() */
+	uint32_t maxSampleCycles;	/* SPEC_AddSample() */
+	uint32_t maxFftCycles;		/* any detrend, butterfly or split step */
+	uint32_t maxPollCycles;		/* any other SPEC_Poll() step */
+} spec_stats_t;
+
+int32_t SPEC_Init(const spec_config_t *cfg);
+/* main loop only; restarts the frames */
+int32_t SPEC_SetPoints(uint16_t points);
+void SPEC_SetReport(uint8_t on);
+
+/* from the IMU interrupt, accel in m/s^2 */
+void SPEC_AddSample(float ax, float ay, float az);
+
+/* main loop: works on a completed frame, one step per call */
+void SPEC_Poll(void);
+/* last completed frame, -1 if none yet */
+int32_t SPEC_Result(spec_result_t *r);
+const spec_stats_t* SPEC_Stats(void);
+
+void SPEC_Command(const char *args);
+
+#endif /* SPECTRUM_H_ */
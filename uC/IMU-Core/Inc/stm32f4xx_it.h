@@ -66,6 +66,10 @@ void USART6_IRQHandler(void);
 void I2C3_EV_IRQHandler(void);
 void I2C3_ER_IRQHandler(void);
 void FPU_IRQHandler(void);
+void EXTI0_IRQHandler(void);
+void EXTI2_IRQHandler(void);
+void DMA2_Stream0_IRQHandler(void);
+void DMA2_Stream3_IRQHandler(void);
 
 #ifdef __cplusplus
 }
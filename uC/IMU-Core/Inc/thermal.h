@@ -0,0 +1,90 @@
+/*
+ * thermal.h
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Temperature compensation of the MPU9250 gyro and accel from the die
+ *  temperature read with every sample. Per axis, with dT = T - tref:
+ *
+ *    bias(T)  = b0 + b1 dT + b2 dT^2 ...
+ *    scale(T) = 1 + s1 dT + s2 dT^2 ...
+ *    out      = (raw - bias(T)) / scale(T)
+ *
+ *  The polynomials are evaluated only when the filtered temperature has
+ *  moved by THERMAL_HYSTERESIS; every other sample costs a subtract and a
+ *  multiply per axis.
+ *
+ *  Bias coefficients are learned from a warm-up run with the sensor at
+ *  rest: samples are averaged in temperature bins by the IMU interrupt
+ *  and THERMAL_Poll() fits the polynomials once the run is over. Only the
+ *  drift is kept here, b0 is always zero: the static offsets belong to
+ *  the calibration (calib.h), which has already been applied to what is
+ *  learned. The accel reads gravity on top of its offset, so its b0 is
+ *  dropped; the gyro b0 is what the calibration bias misses at tref and
+ *  is moved into it with CALIB_ShiftGyroBias(). Scale is not observable
+ *  at rest; its coefficients come from a turntable or the datasheet
+ *  through THERMAL_SetCoeffs() or the "thermal scale" command.
+ *
+ *  The coefficients are stored in the calibration record: a successful
+ *  fit saves them, THERMAL_Init() loads them, so it runs after
+ *  CALIB_Init().
+ */
+
+#ifndef THERMAL_H_
+#define THERMAL_H_
+
+#include <stdint.h>
+
+#define THERMAL_ORDER 2
+#define THERMAL_BINS 64
+#define THERMAL_BIN_WIDTH 0.5f		/* degC */
+#define THERMAL_MIN_BIN 100			/* samples for a bin to enter the fit */
+#define THERMAL_HYSTERESIS 0.05f	/* degC */
+#define THERMAL_STILL_GYRO 0.05f	/* rad/s, learning skips samples above */
+
+/* axis order of the coefficient tables */
+#define THERMAL_GX 0
+#define THERMAL_AX 3
+
+typedef struct
+{
+	float tref;
+	float bias[6][THERMAL_ORDER + 1];
+	float scale[6][THERMAL_ORDER + 1];	/* scale[i][0] is unused, the constant term is 1 */
+} thermal_coeffs_t;
+
+typedef struct
+{
+	uint32_t samples;
+	uint32_t evaluations;		/* polynomial evaluations */
+	uint32_t learned;			/* samples binned */
+	uint32_t rejected;			/* moving or outside the bin range */
+	uint32_t binsUsed;
+	int32_t fitStatus;			/* last THERMAL fit, 0 ok, 1 not run */
+	float fitRms[6];			/* residual of the bin means */
+	float temperature;			/* filtered */
+	uint32_t maxCycles;
+} thermal_stats_t;
+
+void THERMAL_Init(float sampleHz);
+/* NULL disables the compensation */
+void THERMAL_SetCoeffs(const thermal_coeffs_t *c);
+const thermal_coeffs_t* THERMAL_Coeffs(void);
+/* stores the coefficients with the calibration, CALIB_Save() result */
+int32_t THERMAL_Save(void);
+/* gyro bias drift from tref at the current temperature, rad/s; for CALIB_SetGyroDriftCallback() */
+void THERMAL_GyroDrift(float drift[3]);
+
+/* IMU interrupt, in place; rad/s, m/s^2, degC */
+void THERMAL_Apply(float *ax, float *ay, float *az, float *gx, float *gy, float *gz, float t);
+
+/* learn for the given number of samples, then fit in THERMAL_Poll() */
+void THERMAL_StartLearning(uint32_t samples);
+int32_t THERMAL_Fit(void);
+/* main loop */
+void THERMAL_Poll(void);
+
+const thermal_stats_t* THERMAL_Stats(void);
+void THERMAL_Command(const char *args);
+
+#endif /* THERMAL_H_ */
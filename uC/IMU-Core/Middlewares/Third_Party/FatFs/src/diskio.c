@@ -38,6 +38,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "diskio.h"
 #include "ff_gen_drv.h"
+#include "disk_stats.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
@@ -97,8 +98,10 @@ DRESULT disk_read (
 )
 {
   DRESULT res;
+  uint32_t start = DISKSTAT_Begin(DISKSTAT_OP_READ);
  
   res = disk.drv[pdrv]->disk_read(disk.lun[pdrv], buff, sector, count);
+  DISKSTAT_End(DISKSTAT_OP_READ, start, count, res != RES_OK);
   return res;
 }
 
@@ -119,8 +122,10 @@ DRESULT disk_write (
 )
 {
   DRESULT res;
+  uint32_t start = DISKSTAT_Begin(DISKSTAT_OP_WRITE);
   
   res = disk.drv[pdrv]->disk_write(disk.lun[pdrv], buff, sector, count);
+  DISKSTAT_End(DISKSTAT_OP_WRITE, start, count, res != RES_OK);
   return res;
 }
 #endif /* _USE_WRITE == 1 */
@@ -140,8 +145,10 @@ DRESULT disk_ioctl (
 )
 {
   DRESULT res;
+  uint32_t start = DISKSTAT_Begin(DISKSTAT_OP_IOCTL);
 
   res = disk.drv[pdrv]->disk_ioctl(disk.lun[pdrv], cmd, buff);
+  DISKSTAT_End(DISKSTAT_OP_IOCTL, start, cmd, res != RES_OK);
   return res;
 }
 #endif /* _USE_IOCTL == 1 */
@@ -0,0 +1,424 @@
+/*
+ * ahrs.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Madgwick and Mahony filters after S. Madgwick's open source AHRS
+ *  reference implementations, rewritten around a fixed sample period.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "ahrs.h"
+#include "dwt_delay.h"
+#include "print.h"
+
+extern uint32_t SystemCoreClock;
+
+static float q0 = 1.0f, q1 = 0.0f, q2 = 0.0f, q3 = 0.0f;
+static float dt = 0.01f;
+
+#if AHRS_FILTER == AHRS_MADGWICK
+static float beta = 0.1f;
+#else
+static float twoKp = 1.0f, twoKi = 0.0f;
+static float integralFBx = 0.0f, integralFBy = 0.0f, integralFBz = 0.0f;
+#endif
+
+static ahrs_stats_t stats;
+
+static inline float inv_sqrt(float x)
+{
+#if AHRS_FAST_INVSQRT
+	/* magic constant with tuned Newton step (Moroz et al.), rel. error < 7e-4 */
+	union { float f; int32_t i; } u = { x };
+
+	u.i = 0x5F1FFFF9 - (u.i >> 1);
+	u.f *= 0.703952253f * (2.38924456f - x * u.f * u.f);
+
+	return u.f;
+#else
+	return 1.0f / sqrtf(x);
+#endif
+}
+
+static inline void normalize_quat(void)
+{
+	float recipNorm = inv_sqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+
+	q0 *= recipNorm;
+	q1 *= recipNorm;
+	q2 *= recipNorm;
+	q3 *= recipNorm;
+}
+
+static inline void account(uint32_t start)
+{
+	uint32_t cycles = DWT_Get() - start;
+
+	stats.updates++;
+	stats.lastCycles = cycles;
+	stats.totalCycles += cycles;
+	if (cycles > stats.maxCycles)
+	{
+		stats.maxCycles = cycles;
+	}
+}
+
+void AHRS_Init(float sampleHz, float gain1, float gain2)
+{
+	dt = 1.0f / sampleHz;
+
+#if AHRS_FILTER == AHRS_MADGWICK
+	beta = gain1;
+	(void)gain2;
+#else
+	twoKp = 2.0f * gain1;
+	twoKi = 2.0f * gain2;
+#endif
+
+	AHRS_Reset();
+}
+
+void AHRS_Reset(void)
+{
+	q0 = 1.0f;
+	q1 = q2 = q3 = 0.0f;
+
+#if AHRS_FILTER == AHRS_MAHONY
+	integralFBx = integralFBy = integralFBz = 0.0f;
+#endif
+
+	memset(&stats, 0, sizeof(stats));
+}
+
+#if AHRS_FILTER == AHRS_MADGWICK
+
+static void update6(float gx, float gy, float gz, float ax, float ay, float az)
+{
+	float recipNorm;
+	float s0, s1, s2, s3;
+	float qDot1, qDot2, qDot3, qDot4;
+	float _2q0, _2q1, _2q2, _2q3, _4q0, _4q1, _4q2, _8q1, _8q2, q0q0, q1q1, q2q2, q3q3;
+
+	/* rate of change of quaternion from gyroscope */
+	qDot1 = 0.5f * (-q1 * gx - q2 * gy - q3 * gz);
+	qDot2 = 0.5f * (q0 * gx + q2 * gz - q3 * gy);
+	qDot3 = 0.5f * (q0 * gy - q1 * gz + q3 * gx);
+	qDot4 = 0.5f * (q0 * gz + q1 * gy - q2 * gx);
+
+	/* feedback only if the accelerometer measurement is valid */
+	if (!((ax == 0.0f) && (ay == 0.0f) && (az == 0.0f)))
+	{
+		recipNorm = inv_sqrt(ax * ax + ay * ay + az * az);
+		ax *= recipNorm;
+		ay *= recipNorm;
+		az *= recipNorm;
+
+		_2q0 = 2.0f * q0;
+		_2q1 = 2.0f * q1;
+		_2q2 = 2.0f * q2;
+		_2q3 = 2.0f * q3;
+		_4q0 = 4.0f * q0;
+		_4q1 = 4.0f * q1;
+		_4q2 = 4.0f * q2;
+		_8q1 = 8.0f * q1;
+		_8q2 = 8.0f * q2;
+		q0q0 = q0 * q0;
+		q1q1 = q1 * q1;
+		q2q2 = q2 * q2;
+		q3q3 = q3 * q3;
+
+		/* gradient descent corrective step */
+		s0 = _4q0 * q2q2 + _2q2 * ax + _4q0 * q1q1 - _2q1 * ay;
+		s1 = _4q1 * q3q3 - _2q3 * ax + 4.0f * q0q0 * q1 - _2q0 * ay - _4q1 + _8q1 * q1q1 + _8q1 * q2q2 + _4q1 * az;
+		s2 = 4.0f * q0q0 * q2 + _2q0 * ax + _4q2 * q3q3 - _2q3 * ay - _4q2 + _8q2 * q1q1 + _8q2 * q2q2 + _4q2 * az;
+		s3 = 4.0f * q1q1 * q3 - _2q1 * ax + 4.0f * q2q2 * q3 - _2q2 * ay;
+		recipNorm = inv_sqrt(s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3);
+		s0 *= recipNorm;
+		s1 *= recipNorm;
+		s2 *= recipNorm;
+		s3 *= recipNorm;
+
+		qDot1 -= beta * s0;
+		qDot2 -= beta * s1;
+		qDot3 -= beta * s2;
+		qDot4 -= beta * s3;
+	}
+
+	q0 += qDot1 * dt;
+	q1 += qDot2 * dt;
+	q2 += qDot3 * dt;
+	q3 += qDot4 * dt;
+
+	normalize_quat();
+}
+
+static void update9(float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz)
+{
+	float recipNorm;
+	float s0, s1, s2, s3;
+	float qDot1, qDot2, qDot3, qDot4;
+	float hx, hy;
+	float _2q0mx, _2q0my, _2q0mz, _2q1mx, _2bx, _2bz, _4bx, _4bz, _2q0, _2q1, _2q2, _2q3, _2q0q2, _2q2q3;
+	float q0q0, q0q1, q0q2, q0q3, q1q1, q1q2, q1q3, q2q2, q2q3, q3q3;
+
+	qDot1 = 0.5f * (-q1 * gx - q2 * gy - q3 * gz);
+	qDot2 = 0.5f * (q0 * gx + q2 * gz - q3 * gy);
+	qDot3 = 0.5f * (q0 * gy - q1 * gz + q3 * gx);
+	qDot4 = 0.5f * (q0 * gz + q1 * gy - q2 * gx);
+
+	if (!((ax == 0.0f) && (ay == 0.0f) && (az == 0.0f)))
+	{
+		recipNorm = inv_sqrt(ax * ax + ay * ay + az * az);
+		ax *= recipNorm;
+		ay *= recipNorm;
+		az *= recipNorm;
+
+		recipNorm = inv_sqrt(mx * mx + my * my + mz * mz);
+		mx *= recipNorm;
+		my *= recipNorm;
+		mz *= recipNorm;
+
+		_2q0mx = 2.0f * q0 * mx;
+		_2q0my = 2.0f * q0 * my;
+		_2q0mz = 2.0f * q0 * mz;
+		_2q1mx = 2.0f * q1 * mx;
+		_2q0 = 2.0f * q0;
+		_2q1 = 2.0f * q1;
+		_2q2 = 2.0f * q2;
+		_2q3 = 2.0f * q3;
+		_2q0q2 = 2.0f * q0 * q2;
+		_2q2q3 = 2.0f * q2 * q3;
+		q0q0 = q0 * q0;
+		q0q1 = q0 * q1;
+		q0q2 = q0 * q2;
+		q0q3 = q0 * q3;
+		q1q1 = q1 * q1;
+		q1q2 = q1 * q2;
+		q1q3 = q1 * q3;
+		q2q2 = q2 * q2;
+		q2q3 = q2 * q3;
+		q3q3 = q3 * q3;
+
+		/* reference direction of earth's magnetic field */
+		hx = mx * q0q0 - _2q0my * q3 + _2q0mz * q2 + mx * q1q1 + _2q1 * my * q2 + _2q1 * mz * q3 - mx * q2q2 - mx * q3q3;
+		hy = _2q0mx * q3 + my * q0q0 - _2q0mz * q1 + _2q1mx * q2 - my * q1q1 + my * q2q2 + _2q2 * mz * q3 - my * q3q3;
+		_2bx = sqrtf(hx * hx + hy * hy);
+		_2bz = -_2q0mx * q2 + _2q0my * q1 + mz * q0q0 + _2q1mx * q3 - mz * q1q1 + _2q2 * my * q3 - mz * q2q2 + mz * q3q3;
+		_4bx = 2.0f * _2bx;
+		_4bz = 2.0f * _2bz;
+
+		s0 = -_2q2 * (2.0f * q1q3 - _2q0q2 - ax) + _2q1 * (2.0f * q0q1 + _2q2q3 - ay) - _2bz * q2 * (_2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx) + (-_2bx * q3 + _2bz * q1) * (_2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - my) + _2bx * q2 * (_2bx * (q0q2 + q1q3) + _2bz * (0.5f - q1q1 - q2q2) - mz);
+		s1 = _2q3 * (2.0f * q1q3 - _2q0q2 - ax) + _2q0 * (2.0f * q0q1 + _2q2q3 - ay) - 4.0f * q1 * (1 - 2.0f * q1q1 - 2.0f * q2q2 - az) + _2bz * q3 * (_2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx) + (_2bx * q2 + _2bz * q0) * (_2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - my) + (_2bx * q3 - _4bz * q1) * (_2bx * (q0q2 + q1q3) + _2bz * (0.5f - q1q1 - q2q2) - mz);
+		s2 = -_2q0 * (2.0f * q1q3 - _2q0q2 - ax) + _2q3 * (2.0f * q0q1 + _2q2q3 - ay) - 4.0f * q2 * (1 - 2.0f * q1q1 - 2.0f * q2q2 - az) + (-_4bx * q2 - _2bz * q0) * (_2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx) + (_2bx * q1 + _2bz * q3) * (_2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - my) + (_2bx * q0 - _4bz * q2) * (_2bx * (q0q2 + q1q3) + _2bz * (0.5f - q1q1 - q2q2) - mz);
+		s3 = _2q1 * (2.0f * q1q3 - _2q0q2 - ax) + _2q2 * (2.0f * q0q1 + _2q2q3 - ay) + (-_4bx * q3 + _2bz * q1) * (_2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx) + (-_2bx * q0 + _2bz * q2) * (_2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - my) + _2bx * q1 * (_2bx * (q0q2 + q1q3) + _2bz * (0.5f - q1q1 - q2q2) - mz);
+		recipNorm = inv_sqrt(s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3);
+		s0 *= recipNorm;
+		s1 *= recipNorm;
+		s2 *= recipNorm;
+		s3 *= recipNorm;
+
+		qDot1 -= beta * s0;
+		qDot2 -= beta * s1;
+		qDot3 -= beta * s2;
+		qDot4 -= beta * s3;
+	}
+
+	q0 += qDot1 * dt;
+	q1 += qDot2 * dt;
+	q2 += qDot3 * dt;
+	q3 += qDot4 * dt;
+
+	normalize_quat();
+}
+
+#else /* AHRS_MAHONY */
+
+/* proportional-integral feedback of the error vector, then quaternion integration */
+static inline void integrate(float gx, float gy, float gz, float halfex, float halfey, float halfez)
+{
+	float qa, qb, qc;
+
+	if (twoKi > 0.0f)
+	{
+		integralFBx += twoKi * halfex * dt;
+		integralFBy += twoKi * halfey * dt;
+		integralFBz += twoKi * halfez * dt;
+		gx += integralFBx;
+		gy += integralFBy;
+		gz += integralFBz;
+	}
+
+	gx += twoKp * halfex;
+	gy += twoKp * halfey;
+	gz += twoKp * halfez;
+
+	gx *= 0.5f * dt;
+	gy *= 0.5f * dt;
+	gz *= 0.5f * dt;
+	qa = q0;
+	qb = q1;
+	qc = q2;
+	q0 += (-qb * gx - qc * gy - q3 * gz);
+	q1 += (qa * gx + qc * gz - q3 * gy);
+	q2 += (qa * gy - qb * gz + q3 * gx);
+	q3 += (qa * gz + qb * gy - qc * gx);
+
+	normalize_quat();
+}
+
+static void update6(float gx, float gy, float gz, float ax, float ay, float az)
+{
+	float recipNorm;
+	float halfvx, halfvy, halfvz;
+	float halfex = 0.0f, halfey = 0.0f, halfez = 0.0f;
+
+	if (!((ax == 0.0f) && (ay == 0.0f) && (az == 0.0f)))
+	{
+		recipNorm = inv_sqrt(ax * ax + ay * ay + az * az);
+		ax *= recipNorm;
+		ay *= recipNorm;
+		az *= recipNorm;
+
+		/* estimated direction of gravity */
+		halfvx = q1 * q3 - q0 * q2;
+		halfvy = q0 * q1 + q2 * q3;
+		halfvz = q0 * q0 - 0.5f + q3 * q3;
+
+		/* error is the cross product between estimated and measured gravity */
+		halfex = (ay * halfvz - az * halfvy);
+		halfey = (az * halfvx - ax * halfvz);
+		halfez = (ax * halfvy - ay * halfvx);
+	}
+
+	integrate(gx, gy, gz, halfex, halfey, halfez);
+}
+
+static void update9(float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz)
+{
+	float recipNorm;
+	float q0q0, q0q1, q0q2, q0q3, q1q1, q1q2, q1q3, q2q2, q2q3, q3q3;
+	float hx, hy, bx, bz;
+	float halfvx, halfvy, halfvz, halfwx, halfwy, halfwz;
+	float halfex = 0.0f, halfey = 0.0f, halfez = 0.0f;
+
+	if (!((ax == 0.0f) && (ay == 0.0f) && (az == 0.0f)))
+	{
+		recipNorm = inv_sqrt(ax * ax + ay * ay + az * az);
+		ax *= recipNorm;
+		ay *= recipNorm;
+		az *= recipNorm;
+
+		recipNorm = inv_sqrt(mx * mx + my * my + mz * mz);
+		mx *= recipNorm;
+		my *= recipNorm;
+		mz *= recipNorm;
+
+		q0q0 = q0 * q0;
+		q0q1 = q0 * q1;
+		q0q2 = q0 * q2;
+		q0q3 = q0 * q3;
+		q1q1 = q1 * q1;
+		q1q2 = q1 * q2;
+		q1q3 = q1 * q3;
+		q2q2 = q2 * q2;
+		q2q3 = q2 * q3;
+		q3q3 = q3 * q3;
+
+		/* reference direction of earth's magnetic field */
+		hx = 2.0f * (mx * (0.5f - q2q2 - q3q3) + my * (q1q2 - q0q3) + mz * (q1q3 + q0q2));
+		hy = 2.0f * (mx * (q1q2 + q0q3) + my * (0.5f - q1q1 - q3q3) + mz * (q2q3 - q0q1));
+		bx = sqrtf(hx * hx + hy * hy);
+		bz = 2.0f * (mx * (q1q3 - q0q2) + my * (q2q3 + q0q1) + mz * (0.5f - q1q1 - q2q2));
+
+		/* estimated direction of gravity and magnetic field */
+		halfvx = q1q3 - q0q2;
+		halfvy = q0q1 + q2q3;
+		halfvz = q0q0 - 0.5f + q3q3;
+		halfwx = bx * (0.5f - q2q2 - q3q3) + bz * (q1q3 - q0q2);
+		halfwy = bx * (q1q2 - q0q3) + bz * (q0q1 + q2q3);
+		halfwz = bx * (q0q2 + q1q3) + bz * (0.5f - q1q1 - q2q2);
+
+		halfex = (ay * halfvz - az * halfvy) + (my * halfwz - mz * halfwy);
+		halfey = (az * halfvx - ax * halfvz) + (mz * halfwx - mx * halfwz);
+		halfez = (ax * halfvy - ay * halfvx) + (mx * halfwy - my * halfwx);
+	}
+
+	integrate(gx, gy, gz, halfex, halfey, halfez);
+}
+
+#endif /* AHRS_FILTER */
+
+void AHRS_Update6(float gx, float gy, float gz, float ax, float ay, float az)
+{
+	uint32_t start = DWT_Get();
+
+	update6(gx, gy, gz, ax, ay, az);
+	account(start);
+}
+
+void AHRS_Update9(float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz)
+{
+	uint32_t start = DWT_Get();
+
+	/* getMag() returns zeros on magnetometer overflow */
+	if ((mx == 0.0f) && (my == 0.0f) && (mz == 0.0f))
+	{
+		update6(gx, gy, gz, ax, ay, az);
+	}
+	else
+	{
+		update9(gx, gy, gz, ax, ay, az, mx, my, mz);
+	}
+	account(start);
+}
+
+void AHRS_GetQuat(float q[4])
+{
+	q[0] = q0;
+	q[1] = q1;
+	q[2] = q2;
+	q[3] = q3;
+}
+
+/* ZYX Euler angles in rad */
+void AHRS_GetEuler(float *roll, float *pitch, float *yaw)
+{
+	*roll = atan2f(q0 * q1 + q2 * q3, 0.5f - q1 * q1 - q2 * q2);
+	*pitch = asinf(-2.0f * (q1 * q3 - q0 * q2));
+	*yaw = atan2f(q1 * q2 + q0 * q3, 0.5f - q2 * q2 - q3 * q3);
+}
+
+const ahrs_stats_t* AHRS_Stats(void)
+{
+	return &stats;
+}
+
+/* "ahrs" prints attitude and update cost, "ahrs reset" restarts the filter */
+void AHRS_Command(const char *args)
+{
+	char line[128];
+	float roll, pitch, yaw;
+	uint32_t cyclesPerUs = SystemCoreClock / 1000000;
+
+	if (strncmp(args, "reset", 5) == 0)
+	{
+		AHRS_Reset();
+		print_str("AHRS reset\n");
+		return;
+	}
+
+	AHRS_GetEuler(&roll, &pitch, &yaw);
+	snprintf(line, sizeof(line), "AHRS q=%.4f %.4f %.4f %.4f rpy=%.2f %.2f %.2f\n",
+			q0, q1, q2, q3, roll * 57.29578f, pitch * 57.29578f, yaw * 57.29578f);
+	print_str(line);
+
+	snprintf(line, sizeof(line), "AHRS n=%lu cyc last=%lu max=%lu avg=%lu (max %lu ns)\n",
+			(unsigned long)stats.updates, (unsigned long)stats.lastCycles, (unsigned long)stats.maxCycles,
+			(unsigned long)(stats.updates ? stats.totalCycles / stats.updates : 0),
+			(unsigned long)(stats.maxCycles * 1000 / cyclesPerUs));
+	print_str(line);
+}
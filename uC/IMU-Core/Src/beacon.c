@@ -0,0 +1,220 @@
+/*
+ * beacon.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  RSSI rather than two-way timing: the Si4463 has no packet timestamp
+ *  unit, and nIRQ to EXTI jitter is on the order of a symbol (833 us at
+ *  1200 sps), i.e. hundreds of kilometres of light travel.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "beacon.h"
+#include "eskf.h"
+#include "ring.h"
+#include "dwt_delay.h"
+#include "print.h"
+
+extern uint32_t SystemCoreClock;
+
+typedef struct
+{
+	uint8_t used;
+	float pos[3];
+	float rssi1m;
+} beacon_t;
+
+typedef struct
+{
+	uint8_t id;
+	beacon_t b;
+} beacon_set_t;
+
+static beacon_config_t config = { 2.5f, 4.0f, 0.5f, 200.0f, 9.0f };
+/* the main loop's table and the IMU interrupt's copy, kept in step through setRing */
+static beacon_t beacons[BEACON_MAX];
+static beacon_t fuseBeacons[BEACON_MAX];
+static beacon_stats_t stats;
+static beacon_range_callback rangeCallback = NULL;
+
+/* main loop -> IMU interrupt */
+static beacon_meas_t queue[BEACON_QUEUE];
+static beacon_set_t sets[BEACON_MAX];
+static ring_t measRing, setRing;
+
+void BEACON_Init(const beacon_config_t *cfg)
+{
+	config = *cfg;
+	memset(beacons, 0, sizeof(beacons));
+	memset(fuseBeacons, 0, sizeof(fuseBeacons));
+	memset(&stats, 0, sizeof(stats));
+	RING_Init(&measRing, queue, BEACON_QUEUE, sizeof(queue[0]));
+	RING_Init(&setRing, sets, BEACON_MAX, sizeof(sets[0]));
+}
+
+void BEACON_SetRangeCallback(beacon_range_callback cb)
+{
+	rangeCallback = cb;
+}
+
+int32_t BEACON_Set(uint8_t id, float x, float y, float z, float rssi1m)
+{
+	beacon_set_t *s;
+
+	if (id >= BEACON_MAX || (s = RING_Reserve(&setRing)) == NULL)
+	{
+		return -1;
+	}
+
+	beacons[id].pos[0] = x;
+	beacons[id].pos[1] = y;
+	beacons[id].pos[2] = z;
+	beacons[id].rssi1m = rssi1m;
+	beacons[id].used = 1;
+
+	/* BEACON_Fuse() takes it over at its next run */
+	s->id = id;
+	s->b = beacons[id];
+	RING_Commit(&setRing);
+
+	return 0;
+}
+
+/* d = 10^((P1 - rssi) / 10n); a shadowing scatter of s dB is d ln10 s / 10n metres */
+float BEACON_RangeFromRssi(float rssi, float rssi1m, float *var)
+{
+	float k = 1.0f / (10.0f * config.pathLossExp);
+	float d = powf(10.0f, (rssi1m - rssi) * k);
+	float sd;
+
+	if (d < config.minRange)
+	{
+		d = config.minRange;
+	}
+	sd = d * 2.302585f * config.shadowDb * k;
+	*var = sd * sd;
+
+	return d;
+}
+
+void BEACON_OnPacket(const uint8_t *data, uint8_t len, float rssi, const rf_stamp_t *stamp)
+{
+	beacon_meas_t *m;
+	beacon_t *b;
+	float range, var;
+
+	stats.packets++;
+
+	if (len < 5 || data[0] != 'B' || data[1] != 'N' || data[2] >= BEACON_MAX || !beacons[data[2]].used)
+	{
+		stats.unknown++;
+		return;
+	}
+
+	b = &beacons[data[2]];
+	range = BEACON_RangeFromRssi(rssi, b->rssi1m != 0.0f ? b->rssi1m : (float)(int8_t)data[4], &var);
+	stats.lastId = data[2];
+	stats.lastRange = range;
+
+	if (rangeCallback)
+	{
+		rangeCallback(b->pos, range, var);
+	}
+
+	m = RING_Reserve(&measRing);
+	if (!m)
+	{
+		stats.dropped++;
+		return;
+	}
+
+	m->id = data[2];
+	m->rssi = rssi;
+	m->range = range;
+	m->var = var;
+	m->stamp = *stamp;
+	RING_Commit(&measRing);
+}
+
+void BEACON_Fuse(void)
+{
+	uint32_t cyclesPerMs = SystemCoreClock / 1000;
+	const eskf_state_t *x = ESKF_State();
+	float H[ESKF_N], d[3], h, y;
+	beacon_set_t *s;
+	beacon_meas_t *m;
+	int i;
+
+	while ((s = RING_Peek(&setRing)) != NULL)
+	{
+		fuseBeacons[s->id] = s->b;
+		RING_Release(&setRing, 1);
+	}
+
+	while ((m = RING_Peek(&measRing)) != NULL)
+	{
+		beacon_t *b = &fuseBeacons[m->id];
+
+		if ((DWT_Get() - m->stamp.cycles) / cyclesPerMs > config.maxAgeMs)
+		{
+			stats.stale++;
+			RING_Release(&measRing, 1);
+			continue;
+		}
+
+		for (i = 0; i < 3; i++)
+		{
+			d[i] = x->p[i] - b->pos[i];
+		}
+		h = sqrtf(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+
+		if (h > 1e-3f)
+		{
+			memset(H, 0, sizeof(H));
+			for (i = 0; i < 3; i++)
+			{
+				H[ESKF_POS + i] = d[i] / h;
+			}
+			y = m->range - h;
+
+			if (ESKF_UpdateGated(H, &y, &m->var, 1, config.gate) == 0)
+			{
+				stats.fused++;
+			}
+			else
+			{
+				stats.rejected++;
+			}
+		}
+
+		RING_Release(&measRing, 1);
+	}
+}
+
+const beacon_stats_t* BEACON_Stats(void)
+{
+	return &stats;
+}
+
+/* "beacon" prints the counters, "beacon <id> <x> <y> <z> [rssi1m]" adds or moves a beacon */
+void BEACON_Command(const char *args)
+{
+	char line[160];
+	unsigned id;
+	float x, y, z, p1 = 0.0f;
+
+	if (sscanf(args, "%u %f %f %f %f", &id, &x, &y, &z, &p1) >= 4)
+	{
+		print_str(BEACON_Set(id, x, y, z, p1) == 0 ? "BEACON set\n" : "BEACON bad id or busy\n");
+		return;
+	}
+
+	snprintf(line, sizeof(line), "BEACON rx=%lu unknown=%lu dropped=%lu stale=%lu fused=%lu rejected=%lu last=%u %.2f m\n",
+			(unsigned long)stats.packets, (unsigned long)stats.unknown, (unsigned long)stats.dropped,
+			(unsigned long)stats.stale, (unsigned long)stats.fused, (unsigned long)stats.rejected,
+			stats.lastId, stats.lastRange);
+	print_str(line);
+}
@@ -0,0 +1,814 @@
+/*
+ * calib.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Six position accel calibration: with the positions +x -x +y -y +z -z
+ *  up, r = K a + b gives the columns of K as half the difference of each
+ *  opposite pair and b as the mean of all six; M = (1 g in counts) K^-1.
+ *
+ *  Ellipsoid fit: least squares on the general quadric
+ *    a x^2 + b y^2 + c z^2 + 2d xy + 2e xz + 2f yz + 2g x + 2h y + 2i z = 1
+ *  with the 9x9 normal equations summed sample by sample. The centre is
+ *  the hard iron offset; the symmetric square root of the shape matrix,
+ *  scaled to the mean radius, is the soft iron correction.
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "calib.h"
+#include "dsp_port.h"
+#include "print.h"
+
+#define MAGIC 0x324C4143u	/* "CAL2" */
+#define MAGIC_V1 0x314C4143u	/* "CAL1", before the temperature model */
+
+typedef struct
+{
+	uint32_t magic;
+	uint32_t seq;
+	calib_coeffs_t c;
+	uint32_t thermalValid;
+	thermal_coeffs_t thermal;
+	uint32_t crc;
+} calib_record_t;
+
+typedef struct
+{
+	uint32_t magic;
+	uint32_t seq;
+	calib_coeffs_t c;
+	uint32_t crc;
+} calib_record_v1_t;
+
+/* fixed point form, double buffered against the sensor read context */
+typedef struct
+{
+	uint8_t on;
+	int32_t M[3][3];
+	int32_t b[3];
+} fixed_t;
+
+static fixed_t fixed[3][2];
+static volatile uint8_t cur[3];
+
+static calib_coeffs_t coeffs;
+static thermal_coeffs_t thermal;
+static uint8_t haveThermal = 0;
+static calib_stats_t stats;
+static float countsPerG = 16384.0f, countsPerRad = 7509.9f;
+static calib_drift_callback driftCallback = NULL;
+static uint32_t seq = 0;
+
+/* captures */
+static volatile uint32_t gyroLeft, accelLeft;
+static volatile uint8_t gyroDone, accelDone, magOn;
+static int64_t capSum[3], capSq[3];
+static uint32_t capN;
+static float accelMean[6][3];
+static float magSums[CALIB_ELLIPSOID_SUMS];
+
+static const calib_axis3_t identity = { { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } }, { 0, 0, 0 } };
+
+static void publish(uint32_t s)
+{
+	fixed_t *f = &fixed[s][cur[s] ^ 1];
+	const calib_axis3_t *c = &coeffs.s[s];
+	int i, j;
+
+	f->on = (coeffs.valid >> s) & 1;
+	for (i = 0; i < 3; i++)
+	{
+		for (j = 0; j < 3; j++)
+		{
+			f->M[i][j] = (int32_t)lroundf(c->M[i][j] * (1 << CALIB_Q));
+		}
+		f->b[i] = (int32_t)lroundf(c->b[i] * (1 << CALIB_OUT_Q));
+	}
+	cur[s] ^= 1;
+}
+
+void CALIB_Set(uint32_t s, const calib_axis3_t *c)
+{
+	if (s > CALIB_MAG)
+	{
+		return;
+	}
+	coeffs.s[s] = *c;
+	coeffs.valid |= 1u << s;
+	publish(s);
+}
+
+void CALIB_Clear(uint32_t s)
+{
+	if (s > CALIB_MAG)
+	{
+		return;
+	}
+	coeffs.s[s] = identity;
+	coeffs.valid &= ~(1u << s);
+	publish(s);
+}
+
+const calib_coeffs_t* CALIB_Coeffs(void)
+{
+	return &coeffs;
+}
+
+void CALIB_SetThermal(const thermal_coeffs_t *c)
+{
+	if (c)
+	{
+		thermal = *c;
+	}
+	haveThermal = (c != NULL);
+}
+
+const thermal_coeffs_t* CALIB_Thermal(void)
+{
+	return haveThermal ? &thermal : NULL;
+}
+
+void CALIB_SetGyroDriftCallback(calib_drift_callback cb)
+{
+	driftCallback = cb;
+}
+
+int32_t CALIB_Init(float perG, float perRad)
+{
+	uint32_t s;
+
+	countsPerG = perG;
+	countsPerRad = perRad;
+	haveThermal = 0;
+	memset(&stats, 0, sizeof(stats));
+	memset(fixed, 0, sizeof(fixed));
+	gyroLeft = accelLeft = 0;
+	gyroDone = accelDone = magOn = 0;
+
+	for (s = 0; s <= CALIB_MAG; s++)
+	{
+		CALIB_Clear(s);
+	}
+
+	return CALIB_Load();
+}
+
+void CALIB_Correct(uint32_t s, const int16_t raw[3], int32_t out[3])
+{
+	const fixed_t *f = &fixed[s][cur[s]];
+	int32_t d[3];
+	int i;
+
+	/* captures see the raw counts */
+	if (s == CALIB_GYRO && gyroLeft)
+	{
+		for (i = 0; i < 3; i++)
+		{
+			capSum[i] += raw[i];
+		}
+		capN++;
+		if (--gyroLeft == 0)
+		{
+			gyroDone = 1;
+		}
+	}
+	else if (s == CALIB_ACCEL && accelLeft)
+	{
+		for (i = 0; i < 3; i++)
+		{
+			capSum[i] += raw[i];
+			capSq[i] += (int32_t)raw[i] * raw[i];
+		}
+		capN++;
+		if (--accelLeft == 0)
+		{
+			accelDone = 1;
+		}
+	}
+	else if (s == CALIB_MAG && magOn && (raw[0] | raw[1] | raw[2]))
+	{
+		CALIB_EllipsoidAdd(magSums, raw);
+		stats.magSamples++;
+	}
+
+	stats.corrected++;
+
+	if (!f->on)
+	{
+		for (i = 0; i < 3; i++)
+		{
+			out[i] = (int32_t)raw[i] << CALIB_OUT_Q;
+		}
+		return;
+	}
+
+	for (i = 0; i < 3; i++)
+	{
+		d[i] = ((int32_t)raw[i] << CALIB_OUT_Q) - f->b[i];
+	}
+	for (i = 0; i < 3; i++)
+	{
+		int64_t acc = (int64_t)f->M[i][0] * d[0] + (int64_t)f->M[i][1] * d[1] + (int64_t)f->M[i][2] * d[2];
+
+		out[i] = (int32_t)((acc + (1 << (CALIB_Q - 1))) >> CALIB_Q);
+	}
+}
+
+static void start_capture(void)
+{
+	memset(capSum, 0, sizeof(capSum));
+	memset(capSq, 0, sizeof(capSq));
+	capN = 0;
+}
+
+void CALIB_CaptureGyro(uint32_t samples)
+{
+	gyroLeft = 0;
+	accelLeft = 0;
+	start_capture();
+	gyroLeft = samples ? samples : 1;
+}
+
+void CALIB_CaptureAccel(uint32_t samples)
+{
+	gyroLeft = 0;
+	accelLeft = 0;
+	start_capture();
+	accelLeft = samples ? samples : 1;
+}
+
+void CALIB_MagStart(void)
+{
+	magOn = 0;
+	memset(magSums, 0, sizeof(magSums));
+	stats.magSamples = 0;
+	magOn = 1;
+}
+
+static int32_t invert3(const float A[3][3], float B[3][3])
+{
+	float det, k;
+	int i, j;
+
+	B[0][0] = A[1][1] * A[2][2] - A[1][2] * A[2][1];
+	B[0][1] = A[0][2] * A[2][1] - A[0][1] * A[2][2];
+	B[0][2] = A[0][1] * A[1][2] - A[0][2] * A[1][1];
+	B[1][0] = A[1][2] * A[2][0] - A[1][0] * A[2][2];
+	B[1][1] = A[0][0] * A[2][2] - A[0][2] * A[2][0];
+	B[1][2] = A[0][2] * A[1][0] - A[0][0] * A[1][2];
+	B[2][0] = A[1][0] * A[2][1] - A[1][1] * A[2][0];
+	B[2][1] = A[0][1] * A[2][0] - A[0][0] * A[2][1];
+	B[2][2] = A[0][0] * A[1][1] - A[0][1] * A[1][0];
+
+	det = A[0][0] * B[0][0] + A[0][1] * B[1][0] + A[0][2] * B[2][0];
+	if (fabsf(det) < 1e-20f)
+	{
+		return -1;
+	}
+
+	k = 1.0f / det;
+	for (i = 0; i < 3; i++)
+	{
+		for (j = 0; j < 3; j++)
+		{
+			B[i][j] *= k;
+		}
+	}
+
+	return 0;
+}
+
+/* out = M (raw - b): an output offset d is M^-1 d counts of b */
+void CALIB_ShiftGyroBias(const float offset[3])
+{
+	calib_axis3_t c = coeffs.s[CALIB_GYRO];
+	float Mi[3][3];
+	int i;
+
+	if (invert3(c.M, Mi) != 0)
+	{
+		return;
+	}
+	for (i = 0; i < 3; i++)
+	{
+		c.b[i] += (Mi[i][0] * offset[0] + Mi[i][1] * offset[1] + Mi[i][2] * offset[2]) * countsPerRad;
+	}
+	CALIB_Set(CALIB_GYRO, &c);
+}
+
+int32_t CALIB_FitAccel(const float mean[6][3], float perG, calib_axis3_t *c, float *residual)
+{
+	float K[3][3], Ki[3][3], e = 0.0f;
+	int i, j, p;
+
+	for (i = 0; i < 3; i++)
+	{
+		c->b[i] = 0.0f;
+		for (p = 0; p < 6; p++)
+		{
+			c->b[i] += mean[p][i] * (1.0f / 6.0f);
+		}
+		/* column j: response to +1 g along j */
+		for (j = 0; j < 3; j++)
+		{
+			K[i][j] = 0.5f * (mean[2 * j][i] - mean[2 * j + 1][i]);
+		}
+	}
+
+	if (invert3(K, Ki) != 0)
+	{
+		return -1;
+	}
+	for (i = 0; i < 3; i++)
+	{
+		for (j = 0; j < 3; j++)
+		{
+			c->M[i][j] = perG * Ki[i][j];
+		}
+	}
+
+	for (p = 0; p < 6; p++)
+	{
+		float a[3], n;
+
+		for (i = 0; i < 3; i++)
+		{
+			a[i] = c->M[i][0] * (mean[p][0] - c->b[0]) + c->M[i][1] * (mean[p][1] - c->b[1]) +
+					c->M[i][2] * (mean[p][2] - c->b[2]);
+		}
+		n = sqrtf(a[0] * a[0] + a[1] * a[1] + a[2] * a[2]) - perG;
+		e += n * n;
+	}
+	if (residual)
+	{
+		*residual = sqrtf(e / 6.0f);
+	}
+
+	return 0;
+}
+
+/* sums: upper triangle of D'D (45) then D'1 (9) */
+void CALIB_EllipsoidAdd(float sums[], const int16_t raw[3])
+{
+	float x = raw[0] * (1.0f / CALIB_MAG_NORM), y = raw[1] * (1.0f / CALIB_MAG_NORM), z = raw[2] * (1.0f / CALIB_MAG_NORM);
+	float d[9] = { x * x, y * y, z * z, 2.0f * x * y, 2.0f * x * z, 2.0f * y * z, 2.0f * x, 2.0f * y, 2.0f * z };
+	int i, j, k = 0;
+
+	for (i = 0; i < 9; i++)
+	{
+		for (j = i; j < 9; j++)
+		{
+			sums[k++] += d[i] * d[j];
+		}
+	}
+	for (i = 0; i < 9; i++)
+	{
+		sums[k++] += d[i];
+	}
+}
+
+/* eigen decomposition of a symmetric 3x3 by cyclic Jacobi rotations, A = V diag(w) V' */
+static void jacobi3(float A[3][3], float V[3][3], float w[3])
+{
+	int sweep, p, q, r;
+
+	memcpy(V, identity.M, sizeof(identity.M));
+
+	for (sweep = 0; sweep < 12; sweep++)
+	{
+		float off = fabsf(A[0][1]) + fabsf(A[0][2]) + fabsf(A[1][2]);
+
+		if (off < 1e-12f)
+		{
+			break;
+		}
+		for (p = 0; p < 2; p++)
+		{
+			for (q = p + 1; q < 3; q++)
+			{
+				float th, t, cs, sn;
+
+				if (fabsf(A[p][q]) < 1e-15f)
+				{
+					continue;
+				}
+				th = (A[q][q] - A[p][p]) / (2.0f * A[p][q]);
+				t = (th >= 0.0f ? 1.0f : -1.0f) / (fabsf(th) + sqrtf(th * th + 1.0f));
+				cs = 1.0f / sqrtf(t * t + 1.0f);
+				sn = t * cs;
+
+				/* A = J' A J */
+				for (r = 0; r < 3; r++)
+				{
+					float arp = A[r][p], arq = A[r][q];
+
+					A[r][p] = cs * arp - sn * arq;
+					A[r][q] = sn * arp + cs * arq;
+				}
+				for (r = 0; r < 3; r++)
+				{
+					float apr = A[p][r], aqr = A[q][r];
+
+					A[p][r] = cs * apr - sn * aqr;
+					A[q][r] = sn * apr + cs * aqr;
+				}
+				for (r = 0; r < 3; r++)
+				{
+					float vrp = V[r][p], vrq = V[r][q];
+
+					V[r][p] = cs * vrp - sn * vrq;
+					V[r][q] = sn * vrp + cs * vrq;
+				}
+			}
+		}
+	}
+
+	for (p = 0; p < 3; p++)
+	{
+		w[p] = A[p][p];
+	}
+}
+
+int32_t CALIB_FitEllipsoid(const float sums[], uint32_t n, calib_axis3_t *c)
+{
+	float N[81], Ni[81], p[9], Q[3][3], Qi[3][3], V[3][3], w[3], x0[3], k, r0;
+	arm_matrix_instance_f32 mN, mNi;
+	int i, j, m = 0;
+
+	if (n < CALIB_MIN_MAG)
+	{
+		return -1;
+	}
+
+	for (i = 0; i < 9; i++)
+	{
+		for (j = i; j < 9; j++, m++)
+		{
+			N[i * 9 + j] = N[j * 9 + i] = sums[m];
+		}
+	}
+	arm_mat_init_f32(&mN, 9, 9, N);
+	arm_mat_init_f32(&mNi, 9, 9, Ni);
+	if (arm_mat_inverse_f32(&mN, &mNi) != ARM_MATH_SUCCESS)
+	{
+		return -2;
+	}
+	for (i = 0; i < 9; i++)
+	{
+		p[i] = 0.0f;
+		for (j = 0; j < 9; j++)
+		{
+			p[i] += Ni[i * 9 + j] * sums[45 + j];
+		}
+	}
+
+	Q[0][0] = p[0]; Q[1][1] = p[1]; Q[2][2] = p[2];
+	Q[0][1] = Q[1][0] = p[3];
+	Q[0][2] = Q[2][0] = p[4];
+	Q[1][2] = Q[2][1] = p[5];
+
+	/* centre x0 = -Q^-1 v, then (x - x0)' Q/k (x - x0) = 1 with k = 1 + x0' Q x0 */
+	if (invert3(Q, Qi) != 0)
+	{
+		return -3;
+	}
+	for (i = 0; i < 3; i++)
+	{
+		x0[i] = -(Qi[i][0] * p[6] + Qi[i][1] * p[7] + Qi[i][2] * p[8]);
+	}
+	k = 1.0f;
+	for (i = 0; i < 3; i++)
+	{
+		for (j = 0; j < 3; j++)
+		{
+			k += x0[i] * Q[i][j] * x0[j];
+		}
+	}
+	if (!(k > 0.0f))
+	{
+		return -4;
+	}
+
+	for (i = 0; i < 3; i++)
+	{
+		for (j = 0; j < 3; j++)
+		{
+			Q[i][j] /= k;
+		}
+	}
+	jacobi3(Q, V, w);
+	if (!(w[0] > 0.0f && w[1] > 0.0f && w[2] > 0.0f))
+	{
+		return -5;
+	}
+
+	/* W = V sqrt(w) V', radii 1/sqrt(w); keep the geometric mean radius */
+	r0 = 1.0f / sqrtf(cbrtf(w[0] * w[1] * w[2]));
+	for (i = 0; i < 3; i++)
+	{
+		for (j = 0; j < 3; j++)
+		{
+			c->M[i][j] = r0 * (V[i][0] * sqrtf(w[0]) * V[j][0] + V[i][1] * sqrtf(w[1]) * V[j][1] +
+					V[i][2] * sqrtf(w[2]) * V[j][2]);
+		}
+		c->b[i] = x0[i] * CALIB_MAG_NORM;
+	}
+
+	/* rms of 1 - |W (x - x0)| is not available from the sums, the eigenvalue spread is reported instead */
+	stats.magResidual = sqrtf(fmaxf(w[0], fmaxf(w[1], w[2])) / fminf(w[0], fminf(w[1], w[2]))) - 1.0f;
+
+	return 0;
+}
+
+void CALIB_MagStop(void)
+{
+	calib_axis3_t c;
+
+	magOn = 0;
+	stats.lastFit = CALIB_FitEllipsoid(magSums, stats.magSamples, &c);
+	if (stats.lastFit == 0)
+	{
+		CALIB_Set(CALIB_MAG, &c);
+	}
+}
+
+static void accel_position(void)
+{
+	float mean[3], sd = 0.0f, best = 0.0f;
+	int i, axis = 0, pos;
+
+	for (i = 0; i < 3; i++)
+	{
+		mean[i] = (float)capSum[i] / capN;
+		sd = fmaxf(sd, sqrtf(fmaxf((float)capSq[i] / capN - mean[i] * mean[i], 0.0f)));
+		if (fabsf(mean[i]) > best)
+		{
+			best = fabsf(mean[i]);
+			axis = i;
+		}
+	}
+
+	if (sd > CALIB_STILL_COUNTS || best < 0.5f * countsPerG)
+	{
+		stats.lastFit = -10;
+		print_str("CALIB position rejected, not still\n");
+		return;
+	}
+
+	pos = 2 * axis + (mean[axis] < 0.0f);
+	memcpy(accelMean[pos], mean, sizeof(mean));
+	stats.positions |= 1 << pos;
+	stats.captured++;
+
+	if (stats.positions == 0x3F)
+	{
+		calib_axis3_t c;
+
+		stats.lastFit = CALIB_FitAccel(accelMean, countsPerG, &c, &stats.accelResidual);
+		if (stats.lastFit == 0)
+		{
+			CALIB_Set(CALIB_ACCEL, &c);
+			print_str("CALIB accel fitted\n");
+		}
+		stats.positions = 0;
+	}
+}
+
+void CALIB_Poll(void)
+{
+	if (gyroDone)
+	{
+		calib_axis3_t c = identity;
+		float drift[3] = { 0.0f, 0.0f, 0.0f };
+		int i;
+
+		gyroDone = 0;
+		/* the bias at the thermal reference temperature */
+		if (driftCallback)
+		{
+			driftCallback(drift);
+		}
+		for (i = 0; i < 3; i++)
+		{
+			c.b[i] = (float)capSum[i] / capN - drift[i] * countsPerRad;
+		}
+		CALIB_Set(CALIB_GYRO, &c);
+		stats.captured++;
+		print_str("CALIB gyro bias set\n");
+	}
+
+	if (accelDone)
+	{
+		accelDone = 0;
+		accel_position();
+	}
+}
+
+/* newest valid record of one layout: magic and seq lead, crc over the words before it */
+static const uint32_t* newest(uint32_t magic, uint32_t size, uint32_t crcOffset)
+{
+	const uint8_t *base = (const uint8_t*)CALIB_PortBase();
+	const uint32_t *r, *best = NULL;
+	uint32_t n = CALIB_PortSize() / size, i;
+
+	for (i = 0; i < n; i++)
+	{
+		r = (const uint32_t*)(base + i * size);
+		if (r[0] == 0xFFFFFFFFu)
+		{
+			break;
+		}
+		if (r[0] == magic && CALIB_PortCrc(r, crcOffset / 4) == r[crcOffset / 4] && (!best || r[1] > best[1]))
+		{
+			best = r;
+		}
+	}
+
+	return best;
+}
+
+int32_t CALIB_Load(void)
+{
+	const calib_record_t *best;
+	const calib_record_v1_t *old;
+	uint32_t s;
+
+	best = (const calib_record_t*)newest(MAGIC, sizeof(calib_record_t), offsetof(calib_record_t, crc));
+	if (best)
+	{
+		seq = best->seq;
+		coeffs = best->c;
+		CALIB_SetThermal(best->thermalValid ? &best->thermal : NULL);
+	}
+	else
+	{
+		/* a sector written before the temperature model, replaced at the next save */
+		old = (const calib_record_v1_t*)newest(MAGIC_V1, sizeof(calib_record_v1_t), offsetof(calib_record_v1_t, crc));
+		if (!old)
+		{
+			return -1;
+		}
+		seq = old->seq;
+		coeffs = old->c;
+		CALIB_SetThermal(NULL);
+	}
+
+	stats.loadSeq = seq;
+	for (s = 0; s <= CALIB_MAG; s++)
+	{
+		if (!((coeffs.valid >> s) & 1))
+		{
+			coeffs.s[s] = identity;
+		}
+		publish(s);
+	}
+
+	return 0;
+}
+
+/* appends a record; erases the sector only when it is full. Flash stalls the CPU meanwhile. */
+int32_t CALIB_Save(void)
+{
+	const calib_record_t *base = (const calib_record_t*)CALIB_PortBase();
+	uint32_t n = CALIB_PortSize() / sizeof(calib_record_t), i;
+	calib_record_t rec;
+
+	for (i = 0; i < n && base[i].magic != 0xFFFFFFFFu; i++)
+	{
+	}
+	if (i == n || base[0].magic == MAGIC_V1)
+	{
+		if (CALIB_PortErase() != 0)
+		{
+			return -1;
+		}
+		i = 0;
+	}
+
+	memset(&rec, 0, sizeof(rec));
+	rec.magic = MAGIC;
+	rec.seq = seq + 1;
+	rec.c = coeffs;
+	rec.thermalValid = haveThermal;
+	if (haveThermal)
+	{
+		rec.thermal = thermal;
+	}
+	rec.crc = CALIB_PortCrc((const uint32_t*)&rec, offsetof(calib_record_t, crc) / 4);
+
+	if (CALIB_PortWrite(i * sizeof(rec), (const uint32_t*)&rec, sizeof(rec) / 4) != 0 ||
+		memcmp(&base[i], &rec, sizeof(rec)) != 0)
+	{
+		return -2;
+	}
+
+	seq = rec.seq;
+	stats.saves++;
+
+	return 0;
+}
+
+const calib_stats_t* CALIB_Stats(void)
+{
+	return &stats;
+}
+
+static void print_axis3(const char *name, uint32_t s)
+{
+	const calib_axis3_t *c = &coeffs.s[s];
+	char line[192];
+
+	snprintf(line, sizeof(line), "CALIB %s %s M=%.5f %.5f %.5f %.5f %.5f %.5f %.5f %.5f %.5f b=%.2f %.2f %.2f\n", name,
+			(coeffs.valid >> s) & 1 ? "on" : "off", c->M[0][0], c->M[0][1], c->M[0][2], c->M[1][0], c->M[1][1],
+			c->M[1][2], c->M[2][0], c->M[2][1], c->M[2][2], c->b[0], c->b[1], c->b[2]);
+	print_str(line);
+}
+
+/*
+ * "calib" prints coefficients and state,
+ * "calib gyro [n]" / "calib accel [n]" capture n still samples (one position per accel capture),
+ * "calib mag start|stop" collects and fits the ellipsoid,
+ * "calib set <accel|gyro|mag> m00 .. m22 b0 b1 b2" installs host fitted values,
+ * "calib clear <sensor>", "calib save", "calib load".
+ */
+void CALIB_Command(const char *args)
+{
+	static const char *names[3] = { "accel", "gyro", "mag" };
+	calib_axis3_t c;
+	char name[8], line[160];
+	unsigned n = 200;
+	uint32_t s;
+
+	if (strncmp(args, "gyro", 4) == 0)
+	{
+		sscanf(args, "gyro %u", &n);
+		CALIB_CaptureGyro(n);
+		print_str("CALIB gyro capture, keep still\n");
+		return;
+	}
+	if (strncmp(args, "accel", 5) == 0)
+	{
+		sscanf(args, "accel %u", &n);
+		CALIB_CaptureAccel(n);
+		print_str("CALIB accel capture, keep still\n");
+		return;
+	}
+	if (strncmp(args, "mag start", 9) == 0)
+	{
+		CALIB_MagStart();
+		print_str("CALIB mag collecting, rotate through all orientations\n");
+		return;
+	}
+	if (strncmp(args, "mag stop", 8) == 0)
+	{
+		CALIB_MagStop();
+		snprintf(line, sizeof(line), "CALIB mag fit %ld from %lu samples\n", (long)stats.lastFit,
+				(unsigned long)stats.magSamples);
+		print_str(line);
+		return;
+	}
+	if (sscanf(args, "set %7s %f %f %f %f %f %f %f %f %f %f %f %f", name, &c.M[0][0], &c.M[0][1], &c.M[0][2],
+			&c.M[1][0], &c.M[1][1], &c.M[1][2], &c.M[2][0], &c.M[2][1], &c.M[2][2], &c.b[0], &c.b[1], &c.b[2]) == 13)
+	{
+		for (s = 0; s <= CALIB_MAG && strcmp(name, names[s]) != 0; s++)
+		{
+		}
+		CALIB_Set(s, &c);
+		print_str(s <= CALIB_MAG ? "CALIB set\n" : "CALIB bad sensor\n");
+		return;
+	}
+	if (sscanf(args, "clear %7s", name) == 1)
+	{
+		for (s = 0; s <= CALIB_MAG && strcmp(name, names[s]) != 0; s++)
+		{
+		}
+		CALIB_Clear(s);
+		print_str(s <= CALIB_MAG ? "CALIB cleared\n" : "CALIB bad sensor\n");
+		return;
+	}
+	if (strncmp(args, "save", 4) == 0)
+	{
+		snprintf(line, sizeof(line), "CALIB save %ld seq %lu\n", (long)CALIB_Save(), (unsigned long)seq);
+		print_str(line);
+		return;
+	}
+	if (strncmp(args, "load", 4) == 0)
+	{
+		snprintf(line, sizeof(line), "CALIB load %ld seq %lu\n", (long)CALIB_Load(), (unsigned long)seq);
+		print_str(line);
+		return;
+	}
+
+	for (s = 0; s <= CALIB_MAG; s++)
+	{
+		print_axis3(names[s], s);
+	}
+	snprintf(line, sizeof(line), "CALIB positions=%02x captured=%lu fit=%ld accel res=%.1f mag res=%.3f seq=%lu saves=%lu\n",
+			stats.positions, (unsigned long)stats.captured, (long)stats.lastFit, stats.accelResidual,
+			stats.magResidual, (unsigned long)seq, (unsigned long)stats.saves);
+	print_str(line);
+}
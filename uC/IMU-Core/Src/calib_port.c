@@ -0,0 +1,79 @@
+/*
+ * calib_port.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Calibration records in flash sector 11 (0x080E0000, 128 KB), kept out
+ *  of the image by the FLASH length in STM32F407VGTx_FLASH.ld. CRC is the
+ *  hardware unit (CRC-32/MPEG-2 over words).
+ */
+
+#include "stm32f4xx_hal.h"
+#include "crc.h"
+#include "calib.h"
+
+#define CALIB_FLASH_ADDR 0x080E0000u
+#define CALIB_FLASH_SIZE 0x20000u
+#define CALIB_FLASH_SECTOR FLASH_SECTOR_11
+
+uint32_t CALIB_PortSize(void)
+{
+	return CALIB_FLASH_SIZE;
+}
+
+const void* CALIB_PortBase(void)
+{
+	return (const void*)CALIB_FLASH_ADDR;
+}
+
+int32_t CALIB_PortErase(void)
+{
+	FLASH_EraseInitTypeDef erase;
+	uint32_t error = 0;
+	HAL_StatusTypeDef status;
+
+	erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+	erase.Banks = FLASH_BANK_1;
+	erase.Sector = CALIB_FLASH_SECTOR;
+	erase.NbSectors = 1;
+	erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+
+	HAL_FLASH_Unlock();
+	__HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR |
+			FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR);
+	status = HAL_FLASHEx_Erase(&erase, &error);
+	HAL_FLASH_Lock();
+
+	return (status == HAL_OK && error == 0xFFFFFFFFu) ? 0 : -1;
+}
+
+int32_t CALIB_PortWrite(uint32_t offset, const uint32_t *data, uint32_t words)
+{
+	uint32_t i;
+	int32_t ret = 0;
+
+	if (offset + words * 4 > CALIB_FLASH_SIZE)
+	{
+		return -1;
+	}
+
+	HAL_FLASH_Unlock();
+	__HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR |
+			FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR);
+	for (i = 0; i < words; i++)
+	{
+		if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, CALIB_FLASH_ADDR + offset + i * 4, data[i]) != HAL_OK)
+		{
+			ret = -2;
+			break;
+		}
+	}
+	HAL_FLASH_Lock();
+
+	return ret;
+}
+
+uint32_t CALIB_PortCrc(const uint32_t *data, uint32_t words)
+{
+	return HAL_CRC_Calculate(&hcrc, (uint32_t*)data, words);
+}
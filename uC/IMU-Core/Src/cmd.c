@@ -0,0 +1,120 @@
+/*
+ * cmd.c
+ *
+ *  Created on: 18 Oct 2026
+ */
+
+#include <string.h>
+
+#include "stm32f4xx_hal.h"
+#include "usart.h"
+#include "cmd.h"
+#include "print.h"
+
+typedef struct
+{
+	const char *name;
+	cmd_handler handler;
+} cmd_entry_t;
+
+static cmd_entry_t handlers[CMD_MAX_HANDLERS];
+static uint8_t handlersNum = 0;
+
+static char rxLine[CMD_LINE_MAX];
+static uint8_t rxLen = 0;
+static uint8_t rxDrop = 0;
+
+/* completed line handed over from the RX interrupt to the main loop */
+static char cmdLine[CMD_LINE_MAX];
+static volatile uint8_t cmdPending = 0;
+
+void CMD_Init(void)
+{
+	rxLen = 0;
+	rxDrop = 0;
+	cmdPending = 0;
+	/* not HAL_UART_Receive_IT(): its re-arm fails while a blocking transmit holds the handle lock */
+	__HAL_UART_ENABLE_IT(&huart6, UART_IT_RXNE);
+}
+
+int32_t CMD_Register(const char *name, cmd_handler handler)
+{
+	if (handlersNum >= CMD_MAX_HANDLERS)
+	{
+		return -1;
+	}
+
+	handlers[handlersNum].name = name;
+	handlers[handlersNum].handler = handler;
+	handlersNum++;
+
+	return 0;
+}
+
+/* dispatches the pending line, if any; call from the main loop */
+void CMD_Poll(void)
+{
+	char *args;
+	size_t len;
+	int i;
+
+	if (!cmdPending)
+	{
+		return;
+	}
+
+	args = strchr(cmdLine, ' ');
+	len = args ? (size_t)(args - cmdLine) : strlen(cmdLine);
+	args = args ? args + 1 : &cmdLine[len];
+
+	for (i = 0; i < handlersNum; i++)
+	{
+		if (strlen(handlers[i].name) == len && strncmp(handlers[i].name, cmdLine, len) == 0)
+		{
+			handlers[i].handler(args);
+			break;
+		}
+	}
+
+	if (i == handlersNum)
+	{
+		print_str("ERR unknown command\n");
+	}
+
+	cmdPending = 0;
+}
+
+void CMD_RxIrq(void)
+{
+	uint32_t sr = huart6.Instance->SR;
+	uint8_t byte;
+
+	if ((sr & (USART_SR_RXNE | USART_SR_ORE)) == 0)
+	{
+		return;
+	}
+	/* reading DR after SR clears the overrun, noise and framing flags */
+	byte = (uint8_t)huart6.Instance->DR;
+
+	if (sr & (USART_SR_ORE | USART_SR_NE | USART_SR_FE))
+	{
+		/* a byte is lost or garbled, drop the rest of the line */
+		rxDrop = 1;
+	}
+	if (byte == '\r' || byte == '\n')
+	{
+		/* a line arriving while the previous one is still pending is dropped */
+		if (rxLen > 0 && !rxDrop && !cmdPending)
+		{
+			memcpy(cmdLine, rxLine, rxLen);
+			cmdLine[rxLen] = '\0';
+			cmdPending = 1;
+		}
+		rxLen = 0;
+		rxDrop = 0;
+	}
+	else if (rxLen < CMD_LINE_MAX - 1)
+	{
+		rxLine[rxLen++] = (char)byte;
+	}
+}
@@ -0,0 +1,394 @@
+/*
+ * decim.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Stage 1 takes DECIM_BLOCK1 input samples per call and gives
+ *  DECIM_BLOCK1 / DECIM_M1 samples at 1 kHz; those are collected until
+ *  stage 2 has its M inputs for one output. arm_fir_decimate_q15
+ *  truncates, so half a count is added back to its outputs.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "decim.h"
+#include "ccm.h"
+#include "decim_coeffs.h"
+#include "calib.h"
+#include "dwt_delay.h"
+#include "print.h"
+
+#ifndef HOST_BUILD
+#include "mpu9250.h"
+#endif
+
+#if DECIM_USE_CCM
+#define DECIM_STORAGE CCM_BSS
+#else
+#define DECIM_STORAGE
+#endif
+
+#define DESIGNS (sizeof(decimDesigns) / sizeof(decimDesigns[0]))
+
+/* byte offset of each channel in a record, temperature at 6 */
+static const uint8_t offset[DECIM_CHANNELS] = { 0, 2, 4, 8, 10, 12 };
+
+static decim_config_t config;
+static const decim_design_t *active = NULL;
+static volatile int32_t pending = -1;
+static float stage1Gain = 1.0f;
+
+static arm_fir_decimate_instance_q15 s1[DECIM_CHANNELS];
+static arm_fir_decimate_instance_f32 s2[DECIM_CHANNELS];
+static DECIM_STORAGE q15_t state1[DECIM_CHANNELS][DECIM_STAGE1_TAPS + DECIM_BLOCK1 - 1];
+static DECIM_STORAGE float32_t state2[DECIM_CHANNELS][DECIM_MAX_TAPS + DECIM_MAX_M2 - 1];
+
+static q15_t in1[DECIM_CHANNELS][DECIM_BLOCK1];
+static float32_t mid[DECIM_CHANNELS][DECIM_MAX_M2];
+static uint32_t n1, n2;
+static int32_t tempSum;
+static uint32_t tempCount;
+
+static decim_sample_t queue[DECIM_OUT_QUEUE];
+static volatile uint32_t head, tail;
+
+static decim_stats_t stats;
+
+/* the i-th design for rate outHz */
+static int32_t find(uint16_t outHz, uint32_t i)
+{
+	uint32_t d;
+
+	for (d = 0; d < DESIGNS; d++)
+	{
+		if (decimDesigns[d].outHz == outHz && i-- == 0)
+		{
+			return d;
+		}
+	}
+	return -1;
+}
+
+void DECIM_Reset(void)
+{
+	uint32_t c;
+
+	for (c = 0; c < DECIM_CHANNELS; c++)
+	{
+		arm_fir_decimate_init_q15(&s1[c], DECIM_STAGE1_TAPS, DECIM_M1, decimStage1, state1[c], DECIM_BLOCK1);
+		arm_fir_decimate_init_f32(&s2[c], active->taps, active->M, active->coeffs, state2[c], active->M);
+	}
+	n1 = 0;
+	n2 = 0;
+	tempSum = 0;
+	tempCount = 0;
+}
+
+int32_t DECIM_Init(const decim_config_t *cfg, uint32_t design)
+{
+	int32_t d = find(cfg->outHz, design);
+	uint32_t k;
+
+	if (d < 0 || decimDesigns[d].taps > DECIM_MAX_TAPS || decimDesigns[d].M > DECIM_MAX_M2)
+	{
+		return -1;
+	}
+
+	config = *cfg;
+	active = &decimDesigns[d];
+	pending = -1;
+
+	stage1Gain = 0.0f;
+	for (k = 0; k < DECIM_STAGE1_TAPS; k++)
+	{
+		stage1Gain += decimStage1[k] * (1.0f / 32768.0f);
+	}
+
+	memset(&stats, 0, sizeof(stats));
+	stats.design = design;
+	head = 0;
+	tail = 0;
+	DECIM_Reset();
+
+	return 0;
+}
+
+int32_t DECIM_Select(uint32_t design)
+{
+	int32_t d = find(config.outHz, design);
+
+	if (d < 0 || decimDesigns[d].taps > DECIM_MAX_TAPS)
+	{
+		return -1;
+	}
+	stats.design = design;
+	pending = d;
+
+	return 0;
+}
+
+const decim_design_t* DECIM_Design(uint32_t design)
+{
+	int32_t d = find(config.outHz, design);
+
+	return d < 0 ? NULL : &decimDesigns[d];
+}
+
+uint32_t DECIM_Designs(void)
+{
+	uint32_t n = 0;
+
+	while (find(config.outHz, n) >= 0)
+	{
+		n++;
+	}
+	return n;
+}
+
+float DECIM_Delay(void)
+{
+	return 0.5f * (DECIM_STAGE1_TAPS - 1) / DECIM_IN_HZ + (active ? 0.5f * (active->taps - 1) / DECIM_MID_HZ : 0.0f);
+}
+
+/* stage 2 output in sensor axes and counts to a calibrated body axes sample */
+static void emit(const float32_t y[DECIM_CHANNELS])
+{
+	static const uint32_t sensor[2] = { CALIB_ACCEL, CALIB_GYRO };
+	const calib_coeffs_t *cc = CALIB_Coeffs();
+	uint32_t next = (head + 1) % DECIM_OUT_QUEUE, s, i;
+	decim_sample_t *out = &queue[head];
+	float body[3], v;
+
+	stats.outputs++;
+	if (next == tail)
+	{
+		stats.dropped++;
+		return;
+	}
+
+	for (s = 0; s < 2; s++)
+	{
+		const float32_t *r = &y[3 * s];
+		const calib_axis3_t *c = &cc->s[sensor[s]];
+		float k = (s ? config.gyroScale : config.accelScale) / stage1Gain;
+
+		for (i = 0; i < 3; i++)
+		{
+			body[i] = config.remap[i][0] * r[0] + config.remap[i][1] * r[1] + config.remap[i][2] * r[2];
+		}
+		for (i = 0; i < 3; i++)
+		{
+			if (cc->valid & (1u << sensor[s]))
+			{
+				v = c->M[i][0] * (body[0] - c->b[0]) + c->M[i][1] * (body[1] - c->b[1]) + c->M[i][2] * (body[2] - c->b[2]);
+			}
+			else
+			{
+				v = body[i];
+			}
+			if (s)
+			{
+				out->g[i] = v * k;
+			}
+			else
+			{
+				out->a[i] = v * k;
+			}
+		}
+	}
+
+	out->t = tempCount ? ((float)tempSum / tempCount - config.tempOffset) / config.tempScale + config.tempOffset : 0.0f;
+	tempSum = 0;
+	tempCount = 0;
+
+	head = next;
+}
+
+static uint32_t run_blocks(void)
+{
+	q15_t out1[DECIM_CHANNELS][DECIM_BLOCK1 / DECIM_M1];
+	float32_t y[DECIM_CHANNELS];
+	uint32_t c, j, outputs = 0;
+
+	for (c = 0; c < DECIM_CHANNELS; c++)
+	{
+		arm_fir_decimate_q15(&s1[c], in1[c], out1[c], DECIM_BLOCK1);
+	}
+
+	for (j = 0; j < DECIM_BLOCK1 / DECIM_M1; j++)
+	{
+		for (c = 0; c < DECIM_CHANNELS; c++)
+		{
+			mid[c][n2] = out1[c][j] + 0.5f;
+		}
+		if (++n2 == active->M)
+		{
+			for (c = 0; c < DECIM_CHANNELS; c++)
+			{
+				arm_fir_decimate_f32(&s2[c], mid[c], &y[c], active->M);
+			}
+			n2 = 0;
+			emit(y);
+			outputs++;
+		}
+	}
+
+	return outputs;
+}
+
+uint32_t DECIM_Process(const uint8_t *records, uint32_t n)
+{
+	uint32_t outputs = 0, c;
+
+	if (!active)
+	{
+		return 0;
+	}
+
+	if (pending >= 0)
+	{
+		active = &decimDesigns[pending];
+		pending = -1;
+		DECIM_Reset();
+	}
+
+	stats.records += n;
+	for (; n; n--, records += DECIM_RECORD)
+	{
+		for (c = 0; c < DECIM_CHANNELS; c++)
+		{
+			in1[c][n1] = (int16_t)(((uint16_t)records[offset[c]] << 8) | records[offset[c] + 1]);
+		}
+		tempSum += (int16_t)(((uint16_t)records[6] << 8) | records[7]);
+		tempCount++;
+
+		if (++n1 == DECIM_BLOCK1)
+		{
+			n1 = 0;
+			outputs += run_blocks();
+		}
+	}
+
+	return outputs;
+}
+
+int32_t DECIM_Pop(decim_sample_t *s)
+{
+	if (tail == head)
+	{
+		return -1;
+	}
+
+	*s = queue[tail];
+	tail = (tail + 1) % DECIM_OUT_QUEUE;
+
+	return 0;
+}
+
+#ifndef HOST_BUILD
+int32_t DECIM_Start(void)
+{
+	if (!active || setFiltBypass() != 0 || enableFifo(1) != 0)
+	{
+		return -1;
+	}
+	DECIM_Reset();
+
+	return 0;
+}
+
+int32_t DECIM_Read(float *ax, float *ay, float *az, float *gx, float *gy, float *gz, float *t)
+{
+	/* readRegisters() bounces through a 42 byte buffer, three records */
+	uint8_t buf[3 * DECIM_RECORD];
+	uint32_t start = DWT_Get(), cycles, n, k;
+	decim_sample_t s;
+
+	n = getFifoCount();
+	if (n >= FIFO_SIZE - DECIM_RECORD)
+	{
+		/* overwritten, the record boundaries are lost */
+		stats.overflows++;
+		enableFifo(1);
+		DECIM_Reset();
+	}
+	else
+	{
+		n /= DECIM_RECORD;
+		stats.batches++;
+		if (n > stats.maxBatch)
+		{
+			stats.maxBatch = n;
+		}
+		while (n)
+		{
+			k = n > 3 ? 3 : n;
+			readRegisters(FIFO_R_W, k * DECIM_RECORD, buf);
+			DECIM_Process(buf, k);
+			n -= k;
+		}
+	}
+
+	cycles = DWT_Get() - start;
+	if (cycles > stats.maxCycles)
+	{
+		stats.maxCycles = cycles;
+	}
+
+	if (DECIM_Pop(&s) != 0)
+	{
+		return -1;
+	}
+
+	*ax = s.a[0];
+	*ay = s.a[1];
+	*az = s.a[2];
+	*gx = s.g[0];
+	*gy = s.g[1];
+	*gz = s.g[2];
+	*t = s.t;
+
+	return 0;
+}
+#endif
+
+const decim_stats_t* DECIM_Stats(void)
+{
+	return &stats;
+}
+
+/* "decim" prints counters, "decim list" the designs for the rate, "decim set <i>" switches */
+void DECIM_Command(const char *args)
+{
+	char line[160];
+	uint32_t i;
+
+	if (strncmp(args, "list", 4) == 0)
+	{
+		for (i = 0; i < DECIM_Designs(); i++)
+		{
+			const decim_design_t *d = DECIM_Design(i);
+
+			snprintf(line, sizeof(line), "DECIM %lu %s %u Hz taps=%u pass=%.0f Hz delay=%.1f ms\n", (unsigned long)i,
+					d->name, d->outHz, d->taps, d->passHz,
+					(0.5f * (DECIM_STAGE1_TAPS - 1) / DECIM_IN_HZ + 0.5f * (d->taps - 1) / DECIM_MID_HZ) * 1e3f);
+			print_str(line);
+		}
+		return;
+	}
+
+	if (strncmp(args, "set", 3) == 0)
+	{
+		i = strtoul(args + 3, NULL, 10);
+		print_str(DECIM_Select(i) == 0 ? "DECIM design switched\n" : "DECIM no such design\n");
+		return;
+	}
+
+	snprintf(line, sizeof(line), "DECIM %s %u Hz delay=%.1f ms rec=%lu batch max=%lu ovf=%lu out=%lu drop=%lu cyc max=%lu\n",
+			active ? active->name : "-", config.outHz, DECIM_Delay() * 1e3f, (unsigned long)stats.records,
+			(unsigned long)stats.maxBatch, (unsigned long)stats.overflows, (unsigned long)stats.outputs,
+			(unsigned long)stats.dropped, (unsigned long)stats.maxCycles);
+	print_str(line);
+}
@@ -0,0 +1,198 @@
+/*
+ * disk_stats.c
+ *
+ *  Created on: 18 Oct 2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "disk_stats.h"
+#include "dwt_delay.h"
+#include "print.h"
+
+extern uint32_t SystemCoreClock;
+
+static diskstat_op_t stats[DISKSTAT_OP_COUNT];
+
+/* operation currently inside the driver, target of Busy/Retry reports */
+static diskstat_op_t *inflight = NULL;
+
+static const char *opNames[DISKSTAT_OP_COUNT] = { "RD", "WR", "IO" };
+
+static uint32_t log2_class(uint32_t v, uint32_t classes)
+{
+	uint32_t c = (v == 0) ? 0 : 32 - __builtin_clz(v);
+
+	return (c < classes) ? c : classes - 1;
+}
+
+static uint64_t cycles_to_us(uint64_t cycles)
+{
+	return cycles / (SystemCoreClock/1000000);
+}
+
+void DISKSTAT_Reset(void)
+{
+	memset(stats, 0, sizeof(stats));
+}
+
+uint32_t DISKSTAT_Begin(diskstat_op op)
+{
+	inflight = &stats[op];
+
+	return DWT_Get();
+}
+
+void DISKSTAT_End(diskstat_op op, uint32_t start, uint32_t count, uint8_t failed)
+{
+	uint32_t dt = DWT_Get() - start; // CYCCNT wraps after ~25 s, no single call takes that long
+	diskstat_op_t *s = &stats[op];
+	uint32_t cls;
+
+	inflight = NULL;
+
+	/* sector count 1 -> class 0, 2..3 -> 1, ..., ioctl is binned by control code */
+	if (op == DISKSTAT_OP_IOCTL || count == 0)
+	{
+		cls = count;
+	}
+	else
+	{
+		cls = log2_class(count, DISKSTAT_CNT_CLASSES + 1) - 1;
+	}
+	if (cls >= DISKSTAT_CNT_CLASSES)
+	{
+		cls = DISKSTAT_CNT_CLASSES - 1;
+	}
+
+	s->calls++;
+	s->cycles += dt;
+	if (dt > s->maxCycles)
+	{
+		s->maxCycles = dt;
+	}
+	if (failed)
+	{
+		s->errors++;
+	}
+	if (op != DISKSTAT_OP_IOCTL)
+	{
+		s->sectors += count;
+	}
+
+	s->hist[cls][log2_class((uint32_t)cycles_to_us(dt), DISKSTAT_LAT_BUCKETS)]++;
+}
+
+void DISKSTAT_Busy(uint32_t cycles)
+{
+	if (inflight)
+	{
+		inflight->busyCycles += cycles;
+	}
+}
+
+void DISKSTAT_Retry(void)
+{
+	if (inflight)
+	{
+		inflight->retries++;
+	}
+}
+
+const diskstat_op_t* DISKSTAT_Get(diskstat_op op)
+{
+	return &stats[op];
+}
+
+uint32_t DISKSTAT_Percentile(diskstat_op op, uint32_t permille)
+{
+	const diskstat_op_t *s = &stats[op];
+	uint32_t bucket[DISKSTAT_LAT_BUCKETS] = {0,};
+	uint32_t target, acc = 0;
+	int i, c;
+
+	if (s->calls == 0)
+	{
+		return 0;
+	}
+
+	for (c = 0; c < DISKSTAT_CNT_CLASSES; c++)
+	{
+		for (i = 0; i < DISKSTAT_LAT_BUCKETS; i++)
+		{
+			bucket[i] += s->hist[c][i];
+		}
+	}
+
+	target = (uint32_t)(((uint64_t)s->calls * permille + 999) / 1000);
+
+	for (i = 0; i < DISKSTAT_LAT_BUCKETS - 1; i++)
+	{
+		acc += bucket[i];
+		if (acc >= target)
+		{
+			break;
+		}
+	}
+
+	return 1UL << i;
+}
+
+/* prints totals, tail latencies and non-empty histogram rows */
+void DISKSTAT_Report(void)
+{
+	char line[192];
+	int op, c, i, n;
+
+	for (op = 0; op < DISKSTAT_OP_COUNT; op++)
+	{
+		const diskstat_op_t *s = &stats[op];
+		uint64_t us = cycles_to_us(s->cycles);
+
+		snprintf(line, sizeof(line),
+				"DSTAT %s n=%lu err=%lu sec=%lu kBps=%lu avg=%lu max=%lu p99=%lu p999=%lu busy=%lu rty=%lu\n",
+				opNames[op], (unsigned long)s->calls, (unsigned long)s->errors, (unsigned long)s->sectors,
+				(unsigned long)(us ? ((uint64_t)s->sectors * 512 * 1000000) / (us * 1024) : 0),
+				(unsigned long)(s->calls ? us / s->calls : 0), (unsigned long)cycles_to_us(s->maxCycles),
+				(unsigned long)DISKSTAT_Percentile(op, 990), (unsigned long)DISKSTAT_Percentile(op, 999),
+				(unsigned long)cycles_to_us(s->busyCycles), (unsigned long)s->retries);
+		print_str(line);
+
+		for (c = 0; c < DISKSTAT_CNT_CLASSES; c++)
+		{
+			uint32_t sum = 0;
+
+			for (i = 0; i < DISKSTAT_LAT_BUCKETS; i++)
+			{
+				sum += s->hist[c][i];
+			}
+			if (sum == 0)
+			{
+				continue;
+			}
+
+			n = snprintf(line, sizeof(line), "DSTAT %s c%d", opNames[op], c);
+			for (i = 0; i < DISKSTAT_LAT_BUCKETS && n < (int)sizeof(line) - 12; i++)
+			{
+				n += snprintf(&line[n], sizeof(line) - n, " %lu", (unsigned long)s->hist[c][i]);
+			}
+			snprintf(&line[n], sizeof(line) - n, "\n");
+			print_str(line);
+		}
+	}
+}
+
+/* "dstat" shows the report, "dstat reset" clears the counters */
+void DISKSTAT_Command(const char *args)
+{
+	if (strncmp(args, "reset", 5) == 0)
+	{
+		DISKSTAT_Reset();
+		print_str("DSTAT reset\n");
+	}
+	else
+	{
+		DISKSTAT_Report();
+	}
+}
@@ -0,0 +1,372 @@
+/*
+ * dsp_port.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Portable fallbacks for the CMSIS-DSP functions listed in dsp_port.h.
+ *  Compiled out when the real library is used.
+ */
+
+#include "dsp_port.h"
+
+#ifndef ARM_MATH_CM4
+
+#include <math.h>
+#include <string.h>
+
+void arm_mat_init_f32(arm_matrix_instance_f32 *S, uint16_t nRows, uint16_t nColumns, float32_t *pData)
+{
+	S->numRows = nRows;
+	S->numCols = nColumns;
+	S->pData = pData;
+}
+
+arm_status arm_mat_add_f32(const arm_matrix_instance_f32 *pSrcA, const arm_matrix_instance_f32 *pSrcB, arm_matrix_instance_f32 *pDst)
+{
+	uint32_t i, n = (uint32_t)pSrcA->numRows * pSrcA->numCols;
+
+	if (pSrcA->numRows != pSrcB->numRows || pSrcA->numCols != pSrcB->numCols ||
+		pSrcA->numRows != pDst->numRows || pSrcA->numCols != pDst->numCols)
+	{
+		return ARM_MATH_SIZE_MISMATCH;
+	}
+
+	for (i = 0; i < n; i++)
+	{
+		pDst->pData[i] = pSrcA->pData[i] + pSrcB->pData[i];
+	}
+
+	return ARM_MATH_SUCCESS;
+}
+
+arm_status arm_mat_sub_f32(const arm_matrix_instance_f32 *pSrcA, const arm_matrix_instance_f32 *pSrcB, arm_matrix_instance_f32 *pDst)
+{
+	uint32_t i, n = (uint32_t)pSrcA->numRows * pSrcA->numCols;
+
+	if (pSrcA->numRows != pSrcB->numRows || pSrcA->numCols != pSrcB->numCols ||
+		pSrcA->numRows != pDst->numRows || pSrcA->numCols != pDst->numCols)
+	{
+		return ARM_MATH_SIZE_MISMATCH;
+	}
+
+	for (i = 0; i < n; i++)
+	{
+		pDst->pData[i] = pSrcA->pData[i] - pSrcB->pData[i];
+	}
+
+	return ARM_MATH_SUCCESS;
+}
+
+arm_status arm_mat_mult_f32(const arm_matrix_instance_f32 *pSrcA, const arm_matrix_instance_f32 *pSrcB, arm_matrix_instance_f32 *pDst)
+{
+	uint16_t i, j, k;
+	const float32_t *a, *b;
+	float32_t sum;
+
+	if (pSrcA->numCols != pSrcB->numRows || pSrcA->numRows != pDst->numRows || pSrcB->numCols != pDst->numCols)
+	{
+		return ARM_MATH_SIZE_MISMATCH;
+	}
+
+	for (i = 0; i < pSrcA->numRows; i++)
+	{
+		for (j = 0; j < pSrcB->numCols; j++)
+		{
+			a = &pSrcA->pData[i * pSrcA->numCols];
+			b = &pSrcB->pData[j];
+			sum = 0.0f;
+			for (k = 0; k < pSrcA->numCols; k++)
+			{
+				sum += a[k] * b[k * pSrcB->numCols];
+			}
+			pDst->pData[i * pDst->numCols + j] = sum;
+		}
+	}
+
+	return ARM_MATH_SUCCESS;
+}
+
+arm_status arm_mat_trans_f32(const arm_matrix_instance_f32 *pSrc, arm_matrix_instance_f32 *pDst)
+{
+	uint16_t i, j;
+
+	if (pSrc->numRows != pDst->numCols || pSrc->numCols != pDst->numRows)
+	{
+		return ARM_MATH_SIZE_MISMATCH;
+	}
+
+	for (i = 0; i < pSrc->numRows; i++)
+	{
+		for (j = 0; j < pSrc->numCols; j++)
+		{
+			pDst->pData[j * pDst->numCols + i] = pSrc->pData[i * pSrc->numCols + j];
+		}
+	}
+
+	return ARM_MATH_SUCCESS;
+}
+
+arm_status arm_mat_scale_f32(const arm_matrix_instance_f32 *pSrc, float32_t scale, arm_matrix_instance_f32 *pDst)
+{
+	uint32_t i, n = (uint32_t)pSrc->numRows * pSrc->numCols;
+
+	if (pSrc->numRows != pDst->numRows || pSrc->numCols != pDst->numCols)
+	{
+		return ARM_MATH_SIZE_MISMATCH;
+	}
+
+	for (i = 0; i < n; i++)
+	{
+		pDst->pData[i] = pSrc->pData[i] * scale;
+	}
+
+	return ARM_MATH_SUCCESS;
+}
+
+/* Gauss-Jordan elimination with partial pivoting */
+arm_status arm_mat_inverse_f32(const arm_matrix_instance_f32 *pSrc, arm_matrix_instance_f32 *pDst)
+{
+	uint16_t n = pSrc->numRows;
+	float32_t *a = pSrc->pData, *b = pDst->pData;
+	float32_t f, tmp;
+	uint16_t i, j, k, piv;
+
+	if (pSrc->numRows != pSrc->numCols || pDst->numRows != n || pDst->numCols != n)
+	{
+		return ARM_MATH_SIZE_MISMATCH;
+	}
+
+	for (i = 0; i < n; i++)
+	{
+		for (j = 0; j < n; j++)
+		{
+			b[i * n + j] = (i == j) ? 1.0f : 0.0f;
+		}
+	}
+
+	for (k = 0; k < n; k++)
+	{
+		piv = k;
+		for (i = k + 1; i < n; i++)
+		{
+			if (fabsf(a[i * n + k]) > fabsf(a[piv * n + k]))
+			{
+				piv = i;
+			}
+		}
+		if (a[piv * n + k] == 0.0f)
+		{
+			return ARM_MATH_SINGULAR;
+		}
+
+		if (piv != k)
+		{
+			for (j = 0; j < n; j++)
+			{
+				tmp = a[k * n + j]; a[k * n + j] = a[piv * n + j]; a[piv * n + j] = tmp;
+				tmp = b[k * n + j]; b[k * n + j] = b[piv * n + j]; b[piv * n + j] = tmp;
+			}
+		}
+
+		f = 1.0f / a[k * n + k];
+		for (j = 0; j < n; j++)
+		{
+			a[k * n + j] *= f;
+			b[k * n + j] *= f;
+		}
+
+		for (i = 0; i < n; i++)
+		{
+			if (i == k)
+			{
+				continue;
+			}
+			f = a[i * n + k];
+			if (f == 0.0f)
+			{
+				continue;
+			}
+			for (j = 0; j < n; j++)
+			{
+				a[i * n + j] -= f * a[k * n + j];
+				b[i * n + j] -= f * b[k * n + j];
+			}
+		}
+	}
+
+	return ARM_MATH_SUCCESS;
+}
+
+arm_status arm_fir_decimate_init_q15(arm_fir_decimate_instance_q15 *S, uint16_t numTaps, uint8_t M,
+		const q15_t *pCoeffs, q15_t *pState, uint32_t blockSize)
+{
+	if (M == 0 || blockSize % M != 0)
+	{
+		return ARM_MATH_LENGTH_ERROR;
+	}
+
+	S->M = M;
+	S->numTaps = numTaps;
+	S->pCoeffs = pCoeffs;
+	S->pState = pState;
+	memset(pState, 0, (numTaps + blockSize - 1) * sizeof(q15_t));
+
+	return ARM_MATH_SUCCESS;
+}
+
+void arm_fir_decimate_q15(const arm_fir_decimate_instance_q15 *S, const q15_t *pSrc, q15_t *pDst, uint32_t blockSize)
+{
+	q15_t *state = S->pState;
+	uint32_t i, k, taps = S->numTaps;
+	q63_t acc;
+
+	/* new samples behind the numTaps - 1 kept from the last block */
+	memcpy(&state[taps - 1], pSrc, blockSize * sizeof(q15_t));
+
+	for (i = 0; i < blockSize / S->M; i++)
+	{
+		const q15_t *x = &state[i * S->M + S->M - 1];
+
+		acc = 0;
+		for (k = 0; k < taps; k++)
+		{
+			acc += (q31_t)x[k] * S->pCoeffs[k];
+		}
+		acc >>= 15;
+		pDst[i] = (q15_t)(acc > 32767 ? 32767 : (acc < -32768 ? -32768 : acc));
+	}
+
+	memmove(state, &state[blockSize], (taps - 1) * sizeof(q15_t));
+}
+
+arm_status arm_fir_decimate_init_f32(arm_fir_decimate_instance_f32 *S, uint16_t numTaps, uint8_t M,
+		const float32_t *pCoeffs, float32_t *pState, uint32_t blockSize)
+{
+	if (M == 0 || blockSize % M != 0)
+	{
+		return ARM_MATH_LENGTH_ERROR;
+	}
+
+	S->M = M;
+	S->numTaps = numTaps;
+	S->pCoeffs = pCoeffs;
+	S->pState = pState;
+	memset(pState, 0, (numTaps + blockSize - 1) * sizeof(float32_t));
+
+	return ARM_MATH_SUCCESS;
+}
+
+void arm_fir_decimate_f32(const arm_fir_decimate_instance_f32 *S, const float32_t *pSrc, float32_t *pDst, uint32_t blockSize)
+{
+	float32_t *state = S->pState, acc;
+	uint32_t i, k, taps = S->numTaps;
+
+	memcpy(&state[taps - 1], pSrc, blockSize * sizeof(float32_t));
+
+	for (i = 0; i < blockSize / S->M; i++)
+	{
+		const float32_t *x = &state[i * S->M + S->M - 1];
+
+		acc = 0.0f;
+		for (k = 0; k < taps; k++)
+		{
+			acc += x[k] * S->pCoeffs[k];
+		}
+		pDst[i] = acc;
+	}
+
+	memmove(state, &state[blockSize], (taps - 1) * sizeof(float32_t));
+}
+
+void arm_q15_to_float(const q15_t *pSrc, float32_t *pDst, uint32_t blockSize)
+{
+	uint32_t i;
+
+	for (i = 0; i < blockSize; i++)
+	{
+		pDst[i] = pSrc[i] * (1.0f / 32768.0f);
+	}
+}
+
+arm_status arm_rfft_fast_init_f32(arm_rfft_fast_instance_f32 *S, uint16_t fftLen)
+{
+	if (fftLen < 32 || fftLen > 4096 || (fftLen & (fftLen - 1)))
+	{
+		return ARM_MATH_ARGUMENT_ERROR;
+	}
+	S->fftLenRFFT = fftLen;
+
+	return ARM_MATH_SUCCESS;
+}
+
+/* in place radix 2 FFT of n interleaved complex values */
+static void cfft(float32_t *x, uint32_t n)
+{
+	uint32_t i, j, k, len;
+	float32_t t;
+
+	for (i = 1, j = 0; i < n; i++)
+	{
+		for (k = n >> 1; j & k; k >>= 1)
+		{
+			j ^= k;
+		}
+		j |= k;
+		if (i < j)
+		{
+			t = x[2 * i];
+			x[2 * i] = x[2 * j];
+			x[2 * j] = t;
+			t = x[2 * i + 1];
+			x[2 * i + 1] = x[2 * j + 1];
+			x[2 * j + 1] = t;
+		}
+	}
+
+	for (len = 2; len <= n; len <<= 1)
+	{
+		for (k = 0; k < len / 2; k++)
+		{
+			float32_t a = -6.28318531f * k / len, wr = cosf(a), wi = sinf(a);
+
+			for (i = k; i < n; i += len)
+			{
+				float32_t *u = &x[2 * i], *v = &x[2 * (i + len / 2)];
+				float32_t vr = v[0] * wr - v[1] * wi, vi = v[0] * wi + v[1] * wr;
+
+				v[0] = u[0] - vr;
+				v[1] = u[1] - vi;
+				u[0] += vr;
+				u[1] += vi;
+			}
+		}
+	}
+}
+
+void arm_rfft_fast_f32(const arm_rfft_fast_instance_f32 *S, float32_t *p, float32_t *pOut, uint8_t ifftFlag)
+{
+	uint32_t n = S->fftLenRFFT / 2, k;
+
+	if (ifftFlag)
+	{
+		return;
+	}
+
+	/* even samples as real, odd as imaginary parts of an n point FFT Z */
+	cfft(p, n);
+
+	pOut[0] = p[0] + p[1];
+	pOut[1] = p[0] - p[1];
+	for (k = 1; k < n; k++)
+	{
+		/* X[k] = (Z[k] + Z*[n-k]) / 2 - j e^(-j pi k / n) (Z[k] - Z*[n-k]) / 2 */
+		float32_t er = 0.5f * (p[2 * k] + p[2 * (n - k)]), ei = 0.5f * (p[2 * k + 1] - p[2 * (n - k) + 1]);
+		float32_t dr = 0.5f * (p[2 * k + 1] + p[2 * (n - k) + 1]), di = -0.5f * (p[2 * k] - p[2 * (n - k)]);
+		float32_t a = -3.14159265f * k / n, wr = cosf(a), wi = sinf(a);
+
+		pOut[2 * k] = er + dr * wr - di * wi;
+		pOut[2 * k + 1] = ei + dr * wi + di * wr;
+	}
+}
+
+#endif /* ARM_MATH_CM4 */
@@ -0,0 +1,486 @@
+/*
+ * eskf.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Error-state EKF after J. Sola, "Quaternion kinematics for the
+ *  error-state Kalman filter" (local angular error, global gravity).
+ *
+ *  The transition matrix has only seven non-trivial 3x3 blocks, so
+ *  F*P*F' is expanded by hand over those blocks; only the upper triangle
+ *  is computed and mirrored, and the bias-bias blocks, which F leaves
+ *  untouched, are skipped. Measurement updates go through arm_mat_*_f32.
+ *  No step depends on the data, so every call costs the same.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "eskf.h"
+#include "ccm.h"
+#include "dsp_port.h"
+#include "dwt_delay.h"
+#include "print.h"
+
+extern uint32_t SystemCoreClock;
+
+#if ESKF_USE_CCM
+#define ESKF_STORAGE CCM_BSS
+#else
+#define ESKF_STORAGE
+#endif
+
+#define N ESKF_N
+#define M ESKF_MAX_MEAS
+
+static float P[N][N] ESKF_STORAGE;
+static float FP[9][N] ESKF_STORAGE;	/* rows of F*P that differ from P */
+static float Ht[N * M] ESKF_STORAGE;
+static float PHt[N * M] ESKF_STORAGE;
+static float S[M * M] ESKF_STORAGE;
+static float Sinv[M * M] ESKF_STORAGE;
+static float K[N * M] ESKF_STORAGE;
+static float dx[N] ESKF_STORAGE;
+
+static eskf_state_t x;
+static eskf_noise_t noise;
+static eskf_stats_t stats;
+static float sigma0[5] = { 0.1f, 0.1f, 0.1f, 0.01f, 0.2f };
+static uint32_t sampleCycles;
+
+static void quat_mult(const float a[4], const float b[4], float out[4])
+{
+	out[0] = a[0] * b[0] - a[1] * b[1] - a[2] * b[2] - a[3] * b[3];
+	out[1] = a[0] * b[1] + a[1] * b[0] + a[2] * b[3] - a[3] * b[2];
+	out[2] = a[0] * b[2] - a[1] * b[3] + a[2] * b[0] + a[3] * b[1];
+	out[3] = a[0] * b[3] + a[1] * b[2] - a[2] * b[1] + a[3] * b[0];
+}
+
+static void quat_normalize(float q[4])
+{
+	float n = 1.0f / sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+
+	q[0] *= n;
+	q[1] *= n;
+	q[2] *= n;
+	q[3] *= n;
+}
+
+/* q * [1, d/2], d a small rotation vector */
+static void quat_rotate_small(float q[4], const float d[3])
+{
+	float dq[4] = { 1.0f, 0.5f * d[0], 0.5f * d[1], 0.5f * d[2] };
+	float out[4];
+
+	quat_mult(q, dq, out);
+	memcpy(q, out, sizeof(out));
+	quat_normalize(q);
+}
+
+static void quat_to_rot(const float q[4], float R[3][3])
+{
+	float ww = q[0] * q[0], xx = q[1] * q[1], yy = q[2] * q[2], zz = q[3] * q[3];
+	float wx = q[0] * q[1], wy = q[0] * q[2], wz = q[0] * q[3];
+	float xy = q[1] * q[2], xz = q[1] * q[3], yz = q[2] * q[3];
+
+	R[0][0] = ww + xx - yy - zz;
+	R[0][1] = 2.0f * (xy - wz);
+	R[0][2] = 2.0f * (xz + wy);
+	R[1][0] = 2.0f * (xy + wz);
+	R[1][1] = ww - xx + yy - zz;
+	R[1][2] = 2.0f * (yz - wx);
+	R[2][0] = 2.0f * (xz - wy);
+	R[2][1] = 2.0f * (yz + wx);
+	R[2][2] = ww - xx - yy + zz;
+}
+
+static inline void account(uint32_t cycles, uint32_t *max)
+{
+	sampleCycles += cycles;
+	if (cycles > *max)
+	{
+		*max = cycles;
+	}
+}
+
+void ESKF_SetInitialSigma(float att, float vel, float pos, float gyroBias, float accelBias)
+{
+	sigma0[0] = att;
+	sigma0[1] = vel;
+	sigma0[2] = pos;
+	sigma0[3] = gyroBias;
+	sigma0[4] = accelBias;
+}
+
+void ESKF_Reset(void)
+{
+	uint32_t i;
+
+	memset(P, 0, sizeof(P));
+	memset(&x, 0, sizeof(x));
+	x.q[0] = 1.0f;
+
+	for (i = 0; i < N; i++)
+	{
+		P[i][i] = sigma0[i / 3] * sigma0[i / 3];
+	}
+
+	memset(&stats, 0, sizeof(stats));
+	sampleCycles = 0;
+}
+
+void ESKF_Init(const eskf_noise_t *n)
+{
+	memset(FP, 0, sizeof(FP));
+	noise = *n;
+	ESKF_Reset();
+}
+
+/* roll and pitch from a resting accel sample, yaw zero */
+void ESKF_AlignFromAccel(float ax, float ay, float az)
+{
+	float roll = atan2f(ay, az);
+	float pitch = atan2f(-ax, sqrtf(ay * ay + az * az));
+	float cr = cosf(roll * 0.5f), sr = sinf(roll * 0.5f);
+	float cp = cosf(pitch * 0.5f), sp = sinf(pitch * 0.5f);
+
+	x.q[0] = cr * cp;
+	x.q[1] = sr * cp;
+	x.q[2] = cr * sp;
+	x.q[3] = -sr * sp;
+}
+
+void ESKF_SetAttitude(const float q[4])
+{
+	memcpy(x.q, q, sizeof(x.q));
+	quat_normalize(x.q);
+}
+
+void ESKF_SetPosition(const float p[3])
+{
+	memcpy(x.p, p, sizeof(x.p));
+}
+
+void ESKF_SetGyroBias(const float bg[3])
+{
+	memcpy(x.bg, bg, sizeof(x.bg));
+}
+
+void ESKF_Predict(float gx, float gy, float gz, float ax, float ay, float az, float dt)
+{
+	uint32_t start = DWT_Get();
+	float w[3] = { (gx - x.bg[0]) * dt, (gy - x.bg[1]) * dt, (gz - x.bg[2]) * dt };
+	float f[3] = { ax - x.ba[0], ay - x.ba[1], az - x.ba[2] };
+	float R[3][3], A[3][3], B[3][3], acc[3], dq[4], q[4];
+	float th2, qv, qg, qa, qbg, qba;
+	uint32_t i, k, r;
+
+	/* close the accounting of the previous sample */
+	if (sampleCycles > ESKF_BUDGET_CYCLES)
+	{
+		stats.overruns++;
+	}
+	if (sampleCycles > stats.maxSampleCycles)
+	{
+		stats.maxSampleCycles = sampleCycles;
+	}
+	sampleCycles = 0;
+
+	/* nominal state */
+	quat_to_rot(x.q, R);
+
+	for (r = 0; r < 3; r++)
+	{
+		acc[r] = R[r][0] * f[0] + R[r][1] * f[1] + R[r][2] * f[2];
+	}
+	acc[2] -= ESKF_GRAVITY;
+
+	for (r = 0; r < 3; r++)
+	{
+		x.p[r] += (x.v[r] + 0.5f * acc[r] * dt) * dt;
+		x.v[r] += acc[r] * dt;
+	}
+
+	/* exp(w) to fourth order, no branch on small angles */
+	th2 = w[0] * w[0] + w[1] * w[1] + w[2] * w[2];
+	qv = 0.5f * (1.0f - th2 * (1.0f / 24.0f));
+	dq[0] = 1.0f - th2 * 0.125f;
+	dq[1] = w[0] * qv;
+	dq[2] = w[1] * qv;
+	dq[3] = w[2] * qv;
+	quat_mult(x.q, dq, q);
+	memcpy(x.q, q, sizeof(q));
+	quat_normalize(x.q);
+
+	/* A = I - [w]x, B = -R [f]x dt, C = -R dt */
+	A[0][0] = 1.0f;  A[0][1] = w[2];  A[0][2] = -w[1];
+	A[1][0] = -w[2]; A[1][1] = 1.0f;  A[1][2] = w[0];
+	A[2][0] = w[1];  A[2][1] = -w[0]; A[2][2] = 1.0f;
+
+	for (r = 0; r < 3; r++)
+	{
+		B[r][0] = (R[r][2] * f[1] - R[r][1] * f[2]) * dt;
+		B[r][1] = (R[r][0] * f[2] - R[r][2] * f[0]) * dt;
+		B[r][2] = (R[r][1] * f[0] - R[r][0] * f[1]) * dt;
+	}
+
+	/* F*P, rows theta, v, p; the bias rows are P itself */
+	for (k = 0; k < N; k++)
+	{
+		for (r = 0; r < 3; r++)
+		{
+			FP[r][k] = A[r][0] * P[0][k] + A[r][1] * P[1][k] + A[r][2] * P[2][k] - dt * P[ESKF_BG + r][k];
+
+			FP[3 + r][k] = B[r][0] * P[0][k] + B[r][1] * P[1][k] + B[r][2] * P[2][k] + P[ESKF_VEL + r][k]
+					- dt * (R[r][0] * P[ESKF_BA][k] + R[r][1] * P[ESKF_BA + 1][k] + R[r][2] * P[ESKF_BA + 2][k]);
+
+			FP[6 + r][k] = dt * P[ESKF_VEL + r][k] + P[ESKF_POS + r][k];
+		}
+	}
+
+	/* (F*P)*F', upper triangle of rows theta, v, p, mirrored; bias-bias blocks stay */
+	for (i = 0; i < 9; i++)
+	{
+		const float *t = FP[i];
+
+		for (k = i; k < N; k++)
+		{
+			float s;
+
+			if (k < ESKF_VEL)
+			{
+				r = k;
+				s = t[0] * A[r][0] + t[1] * A[r][1] + t[2] * A[r][2] - dt * t[ESKF_BG + r];
+			}
+			else if (k < ESKF_POS)
+			{
+				r = k - ESKF_VEL;
+				s = t[0] * B[r][0] + t[1] * B[r][1] + t[2] * B[r][2] + t[ESKF_VEL + r]
+						- dt * (t[ESKF_BA] * R[r][0] + t[ESKF_BA + 1] * R[r][1] + t[ESKF_BA + 2] * R[r][2]);
+			}
+			else if (k < ESKF_BG)
+			{
+				r = k - ESKF_POS;
+				s = dt * t[ESKF_VEL + r] + t[ESKF_POS + r];
+			}
+			else
+			{
+				s = t[k];
+			}
+
+			P[i][k] = s;
+			P[k][i] = s;
+		}
+	}
+
+	/* discrete process noise, densities squared times dt */
+	qg = noise.gyroNoise * noise.gyroNoise * dt;
+	qa = noise.accelNoise * noise.accelNoise * dt;
+	qbg = noise.gyroBiasRw * noise.gyroBiasRw * dt;
+	qba = noise.accelBiasRw * noise.accelBiasRw * dt;
+
+	for (r = 0; r < 3; r++)
+	{
+		P[ESKF_THETA + r][ESKF_THETA + r] += qg;
+		P[ESKF_VEL + r][ESKF_VEL + r] += qa;
+		P[ESKF_BG + r][ESKF_BG + r] += qbg;
+		P[ESKF_BA + r][ESKF_BA + r] += qba;
+	}
+
+	stats.predicts++;
+	account(DWT_Get() - start, &stats.maxPredictCycles);
+}
+
+/* K = PHt S^-1, dx = K y, P -= K PHt', inject dx into the nominal state; gate 0 = no gate */
+static int32_t correct(const float *y, uint32_t m, float gate)
+{
+	arm_matrix_instance_f32 mS, mSinv, mPHt, mK;
+	uint32_t i, j, l;
+
+	arm_mat_init_f32(&mS, m, m, S);
+	arm_mat_init_f32(&mSinv, m, m, Sinv);
+	arm_mat_init_f32(&mPHt, N, m, PHt);
+	arm_mat_init_f32(&mK, N, m, K);
+
+	if (arm_mat_inverse_f32(&mS, &mSinv) != ARM_MATH_SUCCESS)
+	{
+		stats.rejected++;
+		return -2;
+	}
+
+	if (gate > 0.0f)
+	{
+		float d2 = 0.0f;
+
+		for (i = 0; i < m; i++)
+		{
+			for (j = 0; j < m; j++)
+			{
+				d2 += y[i] * Sinv[i * m + j] * y[j];
+			}
+		}
+		if (d2 > gate)
+		{
+			stats.gated++;
+			return -3;
+		}
+	}
+
+	arm_mat_mult_f32(&mPHt, &mSinv, &mK);
+
+	for (i = 0; i < N; i++)
+	{
+		float s = 0.0f;
+
+		for (l = 0; l < m; l++)
+		{
+			s += K[i * m + l] * y[l];
+		}
+		dx[i] = s;
+	}
+
+	/* K S K' = K PHt' is symmetric, only the upper triangle is computed */
+	for (i = 0; i < N; i++)
+	{
+		for (j = i; j < N; j++)
+		{
+			float s = 0.0f;
+
+			for (l = 0; l < m; l++)
+			{
+				s += K[i * m + l] * PHt[j * m + l];
+			}
+			P[i][j] -= s;
+			P[j][i] = P[i][j];
+		}
+	}
+
+	/* the reset Jacobian is taken as identity */
+	for (i = 0; i < 3; i++)
+	{
+		x.v[i] += dx[ESKF_VEL + i];
+		x.p[i] += dx[ESKF_POS + i];
+		x.bg[i] += dx[ESKF_BG + i];
+		x.ba[i] += dx[ESKF_BA + i];
+	}
+	quat_rotate_small(x.q, &dx[ESKF_THETA]);
+
+	stats.updates++;
+
+	return 0;
+}
+
+int32_t ESKF_UpdateSelect(const uint8_t *idx, const float *y, const float *r, uint32_t m)
+{
+	uint32_t start = DWT_Get();
+	uint32_t i, l, l2;
+	int32_t result;
+
+	if (m == 0 || m > M)
+	{
+		stats.rejected++;
+		return -1;
+	}
+
+	/* H P H' and P H' are plain element picks */
+	for (i = 0; i < N; i++)
+	{
+		for (l = 0; l < m; l++)
+		{
+			PHt[i * m + l] = P[i][idx[l]];
+		}
+	}
+	for (l = 0; l < m; l++)
+	{
+		for (l2 = 0; l2 < m; l2++)
+		{
+			S[l * m + l2] = P[idx[l]][idx[l2]];
+		}
+		S[l * m + l] += r[l];
+	}
+
+	result = correct(y, m, 0.0f);
+	account(DWT_Get() - start, &stats.maxUpdateCycles);
+
+	return result;
+}
+
+int32_t ESKF_Update(const float *H, const float *y, const float *R, uint32_t m)
+{
+	return ESKF_UpdateGated(H, y, R, m, 0.0f);
+}
+
+int32_t ESKF_UpdateGated(const float *H, const float *y, const float *R, uint32_t m, float gate)
+{
+	uint32_t start = DWT_Get();
+	arm_matrix_instance_f32 mH, mHt, mP, mPHt, mS, mR;
+	int32_t result;
+
+	if (m == 0 || m > M)
+	{
+		stats.rejected++;
+		return -1;
+	}
+
+	arm_mat_init_f32(&mH, m, N, (float32_t *)H);
+	arm_mat_init_f32(&mHt, N, m, Ht);
+	arm_mat_init_f32(&mP, N, N, &P[0][0]);
+	arm_mat_init_f32(&mPHt, N, m, PHt);
+	arm_mat_init_f32(&mS, m, m, S);
+	arm_mat_init_f32(&mR, m, m, (float32_t *)R);
+
+	arm_mat_trans_f32(&mH, &mHt);
+	arm_mat_mult_f32(&mP, &mHt, &mPHt);
+	arm_mat_mult_f32(&mH, &mPHt, &mS);
+	arm_mat_add_f32(&mS, &mR, &mS);
+
+	result = correct(y, m, gate);
+	account(DWT_Get() - start, &stats.maxUpdateCycles);
+
+	return result;
+}
+
+const eskf_state_t* ESKF_State(void)
+{
+	return &x;
+}
+
+float ESKF_Variance(uint32_t i)
+{
+	return (i < N) ? P[i][i] : 0.0f;
+}
+
+const eskf_stats_t* ESKF_Stats(void)
+{
+	return &stats;
+}
+
+/* "eskf" prints the state and filter cost, "eskf reset" restarts the filter */
+void ESKF_Command(const char *args)
+{
+	char line[160];
+	uint32_t cyclesPerUs = SystemCoreClock / 1000000;
+
+	if (strncmp(args, "reset", 5) == 0)
+	{
+		ESKF_Reset();
+		print_str("ESKF reset\n");
+		return;
+	}
+
+	snprintf(line, sizeof(line), "ESKF p=%.3f %.3f %.3f v=%.3f %.3f %.3f q=%.4f %.4f %.4f %.4f\n",
+			x.p[0], x.p[1], x.p[2], x.v[0], x.v[1], x.v[2], x.q[0], x.q[1], x.q[2], x.q[3]);
+	print_str(line);
+
+	snprintf(line, sizeof(line), "ESKF bg=%.5f %.5f %.5f ba=%.4f %.4f %.4f\n",
+			x.bg[0], x.bg[1], x.bg[2], x.ba[0], x.ba[1], x.ba[2]);
+	print_str(line);
+
+	snprintf(line, sizeof(line), "ESKF n=%lu upd=%lu rej=%lu gated=%lu cyc pred=%lu upd=%lu sample=%lu (%lu us) overruns=%lu\n",
+			(unsigned long)stats.predicts, (unsigned long)stats.updates, (unsigned long)stats.rejected,
+			(unsigned long)stats.gated, (unsigned long)stats.maxPredictCycles, (unsigned long)stats.maxUpdateCycles,
+			(unsigned long)stats.maxSampleCycles, (unsigned long)(stats.maxSampleCycles / cyclesPerUs),
+			(unsigned long)stats.overruns);
+	print_str(line);
+}
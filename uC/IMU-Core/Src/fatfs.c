@@ -47,7 +47,8 @@ uint8_t retUSER;    /* Return value for USER */
 char USER_Path[4];  /* USER logical drive path */
 
 /* USER CODE BEGIN Variables */
-
+FATFS USERFatFS;    /* File system object for USER logical drive */
+static uint8_t mounted = 0;
 /* USER CODE END Variables */    
 
 void MX_FATFS_Init(void) 
@@ -73,7 +74,19 @@ DWORD get_fattime(void)
 }
 
 /* USER CODE BEGIN Application */
-     
+/* one file system object for every user of the card: a second f_mount() would drop the files open through the first */
+FRESULT FATFS_Mount(void)
+{
+  FRESULT res = FR_OK;
+
+  if (!mounted)
+  {
+    res = f_mount(&USERFatFS, USER_Path, 1);
+    mounted = (res == FR_OK);
+  }
+
+  return res;
+}
 /* USER CODE END Application */
 
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,149 @@
+/*
+ * imu_batch.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  With f = counts / 32768 from arm_q15_to_float, T the remap, s the
+ *  nominal scale and (M, b) the calibration in body axes,
+ *
+ *    out = s M (T 32768 f - b) = A f + c,  A = 32768 s M T,  c = -s M b
+ *
+ *  The scratch is static: IMUB_Convert() is meant for one context.
+ */
+
+#include <string.h>
+
+#include "imu_batch.h"
+#include "calib.h"
+#include "dsp_port.h"
+
+typedef struct
+{
+	float A[2][3][3];			/* accel, gyro */
+	float c[2][3];
+	float tk, t0;				/* t = tk f + t0 */
+} imub_map_t;
+
+static imub_config_t config;
+static imub_map_t maps[2];
+static volatile uint8_t active;
+
+static q15_t split[IMUB_VALUES][IMUB_CHUNK];
+static float32_t unit[IMUB_VALUES][IMUB_CHUNK];
+
+static void build(imub_map_t *m)
+{
+	static const uint32_t sensor[2] = { CALIB_ACCEL, CALIB_GYRO };
+	const calib_coeffs_t *cc = CALIB_Coeffs();
+	int32_t s, i, j, k;
+
+	for (s = 0; s < 2; s++)
+	{
+		float scale = s ? config.gyroScale : config.accelScale;
+		float M[3][3] = { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } };
+		float b[3] = { 0.0f, 0.0f, 0.0f };
+
+		if (config.calibrate && (cc->valid & (1u << sensor[s])))
+		{
+			memcpy(M, cc->s[sensor[s]].M, sizeof(M));
+			memcpy(b, cc->s[sensor[s]].b, sizeof(b));
+		}
+
+		for (i = 0; i < 3; i++)
+		{
+			m->c[s][i] = -scale * (M[i][0] * b[0] + M[i][1] * b[1] + M[i][2] * b[2]);
+			for (j = 0; j < 3; j++)
+			{
+				m->A[s][i][j] = 0.0f;
+				for (k = 0; k < 3; k++)
+				{
+					m->A[s][i][j] += M[i][k] * config.remap[k][j];
+				}
+				m->A[s][i][j] *= 32768.0f * scale;
+			}
+		}
+	}
+
+	m->tk = 32768.0f / config.tempScale;
+	m->t0 = config.tempOffset - config.tempOffset / config.tempScale;
+}
+
+void IMUB_Init(const imub_config_t *cfg)
+{
+	config = *cfg;
+	build(&maps[0]);
+	active = 0;
+}
+
+void IMUB_Reload(void)
+{
+	uint8_t next = active ^ 1;
+
+	build(&maps[next]);
+	active = next;
+}
+
+void IMUB_Swap(const uint8_t *be, int16_t *counts, uint32_t values)
+{
+	uint32_t i;
+
+	for (i = 0; i < values; i++)
+	{
+		counts[i] = (int16_t)(((uint16_t)be[2 * i] << 8) | be[2 * i + 1]);
+	}
+}
+
+static void affine(float *restrict dst, const float *restrict x, const float *restrict y, const float *restrict z,
+		const float a[3], float c, uint32_t n)
+{
+	const float a0 = a[0], a1 = a[1], a2 = a[2];
+	uint32_t k;
+
+	for (k = 0; k < n; k++)
+	{
+		dst[k] = a0 * x[k] + a1 * y[k] + a2 * z[k] + c;
+	}
+}
+
+void IMUB_Convert(const int16_t *counts, uint32_t n, const imub_soa_t *out)
+{
+	const imub_map_t *m = &maps[active];
+	uint32_t base, len, v, k, s, i;
+
+	for (base = 0; base < n; base += len)
+	{
+		len = n - base < IMUB_CHUNK ? n - base : IMUB_CHUNK;
+
+		for (v = 0; v < IMUB_VALUES; v++)
+		{
+			const int16_t *src = &counts[base * IMUB_VALUES + v];
+
+			for (k = 0; k < len; k++)
+			{
+				split[v][k] = src[k * IMUB_VALUES];
+			}
+			arm_q15_to_float(split[v], unit[v], len);
+		}
+
+		for (s = 0; s < 2; s++)
+		{
+			/* x y z of the sensor, temperature sits between accel and gyro */
+			const uint32_t x = s ? 4 : 0;
+
+			for (i = 0; i < 3; i++)
+			{
+				affine((s ? out->g[i] : out->a[i]) + base, unit[x], unit[x + 1], unit[x + 2], m->A[s][i], m->c[s][i], len);
+			}
+		}
+
+		if (out->t)
+		{
+			float *t = out->t + base;
+
+			for (k = 0; k < len; k++)
+			{
+				t[k] = m->tk * unit[3][k] + m->t0;
+			}
+		}
+	}
+}
@@ -0,0 +1,426 @@
+/*
+ * imu_q15.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  With T the axis remap and (M, b) the calibration in body axes,
+ *
+ *    out = M (T r - b) = (M T) (r - T' b)
+ *
+ *  so the offset is removed in sensor axes, where the burst is already
+ *  packed as (x, y) and (z, 0) halfword pairs, and M T is one Q14 matrix.
+ *  The integer part of T' b goes through __QADD16, the fractional part
+ *  is folded into the rounding constant of the __SMLAD accumulator.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "imu_q15.h"
+#include "calib.h"
+#include "dsp_port.h"
+#include "dwt_delay.h"
+#include "print.h"
+
+extern uint32_t SystemCoreClock;
+
+/* fixed point and float forms of the same chain; index 0..2 accel, 3..5 gyro */
+typedef struct
+{
+	uint32_t m01[6];			/* (M T)[i][0], (M T)[i][1], Q14 pair */
+	uint32_t m2[6];				/* (M T)[i][2], 0 */
+	uint32_t nb[2][2];			/* -round(T' b) as (x, y) and (z, 0) pairs, per sensor */
+	int32_t c[6];				/* rounding minus (M T) frac(T' b), Q14 */
+	float outScale[6];			/* SI per Q15 count, DC gain of the quantised taps removed */
+	float M[2][3][3];
+	float b[2][3];
+} imuq_tables_t;
+
+static imuq_config_t config;
+static imuq_tables_t tables[2];
+static volatile uint8_t active;
+
+static uint32_t tapsQ[IMUQ_TAPS / 2];	/* Q15 tap pairs */
+static float tapsF[IMUQ_TAPS];
+
+static imuq_filter_t live, benchQ, benchF;
+static uint8_t lastRaw[IMUQ_RAW_LEN];
+static imuq_stats_t stats;
+
+static inline uint32_t pack(int32_t lo, int32_t hi)
+{
+	return (uint16_t)lo | ((uint32_t)(uint16_t)hi << 16);
+}
+
+static inline int16_t q_round(float v, float limit)
+{
+	v = v > limit ? limit : (v < -limit ? -limit : v);
+
+	return (int16_t)lrintf(v);
+}
+
+/* Hamming windowed sinc, DC gain 1; a single unit tap when cutoff is 0 */
+static void design_taps(float cutoff)
+{
+	int16_t q[IMUQ_TAPS];
+	float sum = 0.0f;
+	int32_t k;
+
+	for (k = 0; k < IMUQ_TAPS; k++)
+	{
+		float x = k - 0.5f * (IMUQ_TAPS - 1);
+
+		if (cutoff <= 0.0f)
+		{
+			tapsF[k] = (k == IMUQ_TAPS - 1) ? 1.0f : 0.0f;
+		}
+		else
+		{
+			tapsF[k] = (0.54f - 0.46f * cosf(6.2831853f * k / (IMUQ_TAPS - 1)))
+					* sinf(6.2831853f * cutoff * x) / (3.14159265f * x);
+		}
+		sum += tapsF[k];
+	}
+
+	for (k = 0; k < IMUQ_TAPS; k++)
+	{
+		tapsF[k] /= sum;
+		q[k] = q_round(tapsF[k] * 32768.0f, 32767.0f);
+	}
+	for (k = 0; k < IMUQ_TAPS / 2; k++)
+	{
+		tapsQ[k] = pack(q[2 * k], q[2 * k + 1]);
+	}
+}
+
+static void build(imuq_tables_t *tb)
+{
+	static const uint32_t sensor[2] = { CALIB_ACCEL, CALIB_GYRO };
+	const calib_coeffs_t *cc = CALIB_Coeffs();
+	float tapSum = 0.0f;
+	int32_t s, i, j, k;
+
+	for (k = 0; k < IMUQ_TAPS / 2; k++)
+	{
+		tapSum += (int16_t)tapsQ[k] + (int16_t)(tapsQ[k] >> 16);
+	}
+
+	for (s = 0; s < 2; s++)
+	{
+		float braw[3], frac[3], mt[3][3];
+		int32_t bi[3];
+
+		if (cc->valid & (1u << sensor[s]))
+		{
+			memcpy(tb->M[s], cc->s[sensor[s]].M, sizeof(tb->M[s]));
+			memcpy(tb->b[s], cc->s[sensor[s]].b, sizeof(tb->b[s]));
+		}
+		else
+		{
+			memset(tb->M[s], 0, sizeof(tb->M[s]));
+			memset(tb->b[s], 0, sizeof(tb->b[s]));
+			tb->M[s][0][0] = tb->M[s][1][1] = tb->M[s][2][2] = 1.0f;
+		}
+
+		for (j = 0; j < 3; j++)
+		{
+			braw[j] = 0.0f;
+			for (k = 0; k < 3; k++)
+			{
+				braw[j] += config.remap[k][j] * tb->b[s][k];
+			}
+			bi[j] = lrintf(braw[j]);
+			frac[j] = braw[j] - bi[j];
+		}
+
+		for (i = 0; i < 3; i++)
+		{
+			int16_t q[3];
+			float fc = 0.0f;
+
+			for (j = 0; j < 3; j++)
+			{
+				mt[i][j] = 0.0f;
+				for (k = 0; k < 3; k++)
+				{
+					mt[i][j] += tb->M[s][i][k] * config.remap[k][j];
+				}
+				q[j] = q_round(mt[i][j] * (1 << CALIB_Q), 32767.0f);
+				fc += q[j] * frac[j];
+			}
+
+			tb->m01[3 * s + i] = pack(q[0], q[1]);
+			tb->m2[3 * s + i] = pack(q[2], 0);
+			tb->c[3 * s + i] = (1 << (CALIB_Q - 1)) - lrintf(fc);
+			tb->outScale[3 * s + i] = (s ? config.gyroScale : config.accelScale) / tapSum;
+		}
+
+		tb->nb[s][0] = pack(-bi[0], -bi[1]);
+		tb->nb[s][1] = pack(-bi[2], 0);
+	}
+}
+
+void IMUQ_ResetFilter(imuq_filter_t *f)
+{
+	memset(f, 0, sizeof(*f));
+}
+
+void IMUQ_Init(const imuq_config_t *cfg)
+{
+	config = *cfg;
+	design_taps(config.cutoff);
+	build(&tables[0]);
+	active = 0;
+
+	IMUQ_ResetFilter(&live);
+	memset(lastRaw, 0, sizeof(lastRaw));
+	memset(&stats, 0, sizeof(stats));
+}
+
+void IMUQ_Reload(void)
+{
+	uint8_t next = active ^ 1;
+
+	build(&tables[next]);
+	active = next;
+}
+
+/* shift in one count, return the Q15 filtered value */
+static inline int32_t fir_q15(int16_t *h, int16_t x)
+{
+	const uint32_t *hp = (const uint32_t *)h;
+	uint32_t acc = 0;
+	int32_t k;
+
+	for (k = 0; k < IMUQ_TAPS - 1; k++)
+	{
+		h[k] = h[k + 1];
+	}
+	h[IMUQ_TAPS - 1] = x;
+
+	for (k = 0; k < IMUQ_TAPS / 2; k++)
+	{
+		acc = __SMLAD(tapsQ[k], hp[k], acc);
+	}
+
+	return (int32_t)acc;
+}
+
+static inline float fir_f32(float *h, float x)
+{
+	float acc = 0.0f;
+	int32_t k;
+
+	for (k = 0; k < IMUQ_TAPS - 1; k++)
+	{
+		h[k] = h[k + 1];
+	}
+	h[IMUQ_TAPS - 1] = x;
+
+	for (k = 0; k < IMUQ_TAPS; k++)
+	{
+		acc += tapsF[k] * h[k];
+	}
+
+	return acc;
+}
+
+static inline uint32_t load32(const uint8_t *p)
+{
+	uint32_t w;
+
+	memcpy(&w, p, sizeof(w));
+
+	return w;
+}
+
+void IMUQ_Process(imuq_filter_t *f, const uint8_t raw[IMUQ_RAW_LEN], imuq_sample_t *out)
+{
+	const imuq_tables_t *tb = &tables[active];
+	uint32_t v[4], zt;
+	int32_t i;
+
+	/* big endian burst to (x, y) and (z, 0) pairs, temperature on its own */
+	v[0] = __REV16(load32(&raw[0]));
+	zt = __REV16(load32(&raw[4]));
+	v[1] = zt & 0xFFFF;
+	v[2] = __REV16(load32(&raw[8]));
+	v[3] = __REV16(((uint32_t)raw[12]) | ((uint32_t)raw[13] << 8));
+
+	v[0] = __QADD16(v[0], tb->nb[0][0]);
+	v[1] = __QADD16(v[1], tb->nb[0][1]);
+	v[2] = __QADD16(v[2], tb->nb[1][0]);
+	v[3] = __QADD16(v[3], tb->nb[1][1]);
+
+	for (i = 0; i < 6; i++)
+	{
+		const uint32_t *p = &v[i < 3 ? 0 : 2];
+		int32_t y = (int32_t)__SMLAD(tb->m01[i], p[0], __SMLAD(tb->m2[i], p[1], (uint32_t)tb->c[i])) >> CALIB_Q;
+		int32_t ys = __SSAT(y, 16);
+		float r;
+
+		if (ys != y)
+		{
+			stats.saturated++;
+		}
+
+		r = fir_q15(f->hq[i], (int16_t)ys) * tb->outScale[i];
+		if (i < 3)
+		{
+			out->a[i] = r;
+		}
+		else
+		{
+			out->g[i - 3] = r;
+		}
+	}
+
+	out->t = (((float)(int16_t)(zt >> 16) - config.tempOffset) / config.tempScale) + config.tempOffset;
+	stats.samples++;
+}
+
+void IMUQ_ProcessFloat(imuq_filter_t *f, const uint8_t raw[IMUQ_RAW_LEN], imuq_sample_t *out)
+{
+	const imuq_tables_t *tb = &tables[active];
+	float r[7], body[3], y;
+	int32_t s, i, k;
+
+	for (k = 0; k < 7; k++)
+	{
+		r[k] = (int16_t)(((uint16_t)raw[2 * k] << 8) | raw[2 * k + 1]);
+	}
+
+	for (s = 0; s < 2; s++)
+	{
+		const float *rs = &r[s ? 4 : 0];
+
+		for (i = 0; i < 3; i++)
+		{
+			body[i] = config.remap[i][0] * rs[0] + config.remap[i][1] * rs[1] + config.remap[i][2] * rs[2]
+					- tb->b[s][i];
+		}
+		for (i = 0; i < 3; i++)
+		{
+			y = tb->M[s][i][0] * body[0] + tb->M[s][i][1] * body[1] + tb->M[s][i][2] * body[2];
+			y = fir_f32(f->hf[3 * s + i], y);
+			if (s)
+			{
+				out->g[i] = y * config.gyroScale;
+			}
+			else
+			{
+				out->a[i] = y * config.accelScale;
+			}
+		}
+	}
+
+	out->t = ((r[3] - config.tempOffset) / config.tempScale) + config.tempOffset;
+}
+
+void IMUQ_Convert(const uint8_t raw[IMUQ_RAW_LEN], float *ax, float *ay, float *az, float *gx, float *gy, float *gz, float *t)
+{
+	uint32_t start = DWT_Get(), cycles;
+	imuq_sample_t s;
+
+	/* kept for "imuq bench" */
+	memcpy(lastRaw, raw, IMUQ_RAW_LEN);
+	IMUQ_Process(&live, lastRaw, &s);
+
+	*ax = s.a[0];
+	*ay = s.a[1];
+	*az = s.a[2];
+	*gx = s.g[0];
+	*gy = s.g[1];
+	*gz = s.g[2];
+	*t = s.t;
+
+	cycles = DWT_Get() - start;
+	if (cycles > stats.maxCycles)
+	{
+		stats.maxCycles = cycles;
+	}
+}
+
+/* best of n per path, so a preempting interrupt does not count; inputs vary around the last burst */
+void IMUQ_Bench(uint32_t n)
+{
+	uint32_t bestQ = 0xFFFFFFFF, bestF = 0xFFFFFFFF, start, cycles;
+	uint32_t samples = stats.samples, saturated = stats.saturated;
+	uint8_t raw[IMUQ_RAW_LEN];
+	imuq_sample_t q, f;
+	float diff = 0.0f, d;
+	int32_t i;
+
+	IMUQ_ResetFilter(&benchQ);
+	IMUQ_ResetFilter(&benchF);
+
+	while (n--)
+	{
+		memcpy(raw, lastRaw, sizeof(raw));
+		for (i = 1; i < IMUQ_RAW_LEN; i += 2)
+		{
+			raw[i] ^= (uint8_t)(n * 37 + i);
+		}
+
+		start = DWT_Get();
+		IMUQ_Process(&benchQ, raw, &q);
+		cycles = DWT_Get() - start;
+		bestQ = cycles < bestQ ? cycles : bestQ;
+
+		start = DWT_Get();
+		IMUQ_ProcessFloat(&benchF, raw, &f);
+		cycles = DWT_Get() - start;
+		bestF = cycles < bestF ? cycles : bestF;
+
+		for (i = 0; i < 3; i++)
+		{
+			d = fabsf(q.a[i] - f.a[i]) / config.accelScale;
+			diff = d > diff ? d : diff;
+			d = fabsf(q.g[i] - f.g[i]) / config.gyroScale;
+			diff = d > diff ? d : diff;
+		}
+	}
+
+	/* the bench is not sensor data */
+	stats.samples = samples;
+	stats.saturated = saturated;
+	stats.benchQ15 = bestQ;
+	stats.benchFloat = bestF;
+	stats.benchDiff = diff;
+}
+
+const imuq_stats_t* IMUQ_Stats(void)
+{
+	return &stats;
+}
+
+/* "imuq" prints counters, "imuq bench [n]" compares both paths, "imuq reload" picks up new calibration */
+void IMUQ_Command(const char *args)
+{
+	char line[160];
+
+	if (strncmp(args, "bench", 5) == 0)
+	{
+		uint32_t n = strtoul(args + 5, NULL, 10);
+
+		IMUQ_Bench(n ? n : 1000);
+		snprintf(line, sizeof(line), "IMUQ bench cyc q15=%lu float=%lu (%.2f us / %.2f us) max diff=%.2f counts\n",
+				(unsigned long)stats.benchQ15, (unsigned long)stats.benchFloat,
+				stats.benchQ15 * 1e6f / SystemCoreClock, stats.benchFloat * 1e6f / SystemCoreClock, stats.benchDiff);
+		print_str(line);
+		return;
+	}
+
+	if (strncmp(args, "reload", 6) == 0)
+	{
+		IMUQ_Reload();
+		print_str("IMUQ reloaded\n");
+		return;
+	}
+
+	snprintf(line, sizeof(line), "IMUQ n=%lu sat=%lu cyc max=%lu\n", (unsigned long)stats.samples,
+			(unsigned long)stats.saturated, (unsigned long)stats.maxCycles);
+	print_str(line);
+}
@@ -0,0 +1,457 @@
+/*
+ * log_session.c
+ *
+ *  Created on: 18 Oct 2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "stm32f4xx_hal.h"
+#include "fatfs.h"
+#include "dwt_delay.h"
+#include "disk_stats.h"
+#include "print.h"
+#include "log_session.h"
+
+typedef enum
+{
+	SLOT_FREE,
+	SLOT_CURRENT,
+	SLOT_NEXT_ALLOC,	/* created, being preallocated from LOG_Poll() */
+	SLOT_NEXT_READY,
+	SLOT_CLOSING		/* previous part, tail block not yet flushed */
+} log_slot_state;
+
+typedef struct
+{
+	FIL fil;
+	log_slot_state state;
+	uint32_t partIndex;
+	uint32_t allocated;	/* bytes preallocated so far */
+	uint32_t size;		/* bytes already passed to f_write */
+	uint32_t fill;		/* bytes waiting in blk */
+	uint32_t startTick;
+	log_part_header_t hdr;
+	uint8_t blk[LOG_BLOCK_SIZE];
+} log_slot_t;
+
+static log_slot_t slots[2];
+static log_slot_t *cur = &slots[0];
+static log_slot_t *other = &slots[1];
+
+static log_config_t config;
+static log_stats_t stats;
+static uint8_t isOpen = 0;
+static uint32_t lastSync;
+
+void LOG_PartName(char *name, uint32_t sessionId, uint32_t partIndex)
+{
+	sprintf(name, "%04lX%04lu.LOG", (unsigned long)(sessionId & 0xFFFF), (unsigned long)(partIndex % 10000));
+}
+
+static int32_t fail(void)
+{
+	stats.errors++;
+	return -1;
+}
+
+static int32_t open_part(log_slot_t *slot, uint32_t partIndex)
+{
+	char name[13];
+
+	LOG_PartName(name, config.sessionId, partIndex);
+	if (f_open(&slot->fil, name, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK)
+	{
+		slot->state = SLOT_FREE;
+		return fail();
+	}
+
+	slot->partIndex = partIndex;
+	slot->allocated = 0;
+	slot->size = 0;
+	slot->fill = 0;
+	slot->state = config.maxBytes ? SLOT_NEXT_ALLOC : SLOT_NEXT_READY;
+
+	return 0;
+}
+
+/* extends the file by up to step bytes, the cluster chain is committed once the cap is reached */
+static int32_t prealloc_step(log_slot_t *slot, uint32_t step)
+{
+	uint32_t target = slot->allocated + step;
+
+	if (target > config.maxBytes)
+	{
+		target = config.maxBytes;
+	}
+
+	if (f_lseek(&slot->fil, target) != FR_OK || f_tell(&slot->fil) != target)
+	{
+		/* volume full, the part will grow on demand */
+		f_lseek(&slot->fil, 0);
+		slot->state = SLOT_NEXT_READY;
+		return fail();
+	}
+	slot->allocated = target;
+
+	if (slot->allocated == config.maxBytes)
+	{
+		slot->state = SLOT_NEXT_READY;
+		if (f_lseek(&slot->fil, 0) != FR_OK || f_sync(&slot->fil) != FR_OK)
+		{
+			return fail();
+		}
+	}
+
+	return 0;
+}
+
+/* makes the slot current, the part header goes into the block buffer and costs no I/O here */
+static void begin_part(log_slot_t *slot)
+{
+	log_part_header_t *hdr = &slot->hdr;
+
+	memset(hdr, 0, sizeof(*hdr));
+	hdr->magic = LOG_MAGIC;
+	hdr->version = LOG_VERSION;
+	hdr->headerSize = sizeof(log_part_header_t);
+	hdr->sessionId = config.sessionId;
+	hdr->partIndex = slot->partIndex;
+	hdr->startTick = HAL_GetTick();
+	hdr->sessionOffset = stats.bytes;
+	memcpy(slot->blk, hdr, sizeof(*hdr));
+
+	slot->startTick = hdr->startTick;
+	slot->fill = sizeof(log_part_header_t);
+	slot->state = SLOT_CURRENT;
+	stats.parts++;
+}
+
+static int32_t flush_block(log_slot_t *slot)
+{
+	UINT bw = 0;
+	UINT len = slot->fill;
+	FRESULT res;
+
+	res = f_write(&slot->fil, slot->blk, len, &bw);
+	slot->size += bw;
+	slot->fill = 0;
+
+	return (res == FR_OK && bw == len) ? 0 : fail();
+}
+
+/* puts the payload length on the card into the header; one sector read-modify-write */
+static int32_t update_header(log_slot_t *slot)
+{
+	UINT bw = 0;
+
+	if (slot->size == 0)
+	{
+		/* the header is still in the block buffer */
+		return 0;
+	}
+	slot->hdr.payloadBytes = slot->size - sizeof(log_part_header_t);
+	if (f_lseek(&slot->fil, 0) != FR_OK || f_write(&slot->fil, &slot->hdr, sizeof(slot->hdr), &bw) != FR_OK
+			|| bw != sizeof(slot->hdr) || f_lseek(&slot->fil, slot->size) != FR_OK)
+	{
+		return fail();
+	}
+
+	return 0;
+}
+
+/* writes the tail block and the header, drops the preallocated remainder and closes the part */
+static int32_t close_part(log_slot_t *slot)
+{
+	int32_t result = 0;
+
+	if (slot->fill && flush_block(slot) != 0)
+	{
+		result = -1;
+	}
+	if (update_header(slot) != 0)
+	{
+		result = -1;
+	}
+	if (f_truncate(&slot->fil) != FR_OK || f_close(&slot->fil) != FR_OK)
+	{
+		result = fail();
+	}
+	slot->state = SLOT_FREE;
+
+	return result;
+}
+
+static void rotate(void)
+{
+	log_slot_t *prev;
+	uint8_t inline_work = 0;
+
+	/* normally LOG_Poll() already did all of this */
+	if (other->state == SLOT_CLOSING)
+	{
+		close_part(other);
+		inline_work = 1;
+	}
+	if (other->state == SLOT_FREE)
+	{
+		open_part(other, cur->partIndex + 1);
+		inline_work = 1;
+	}
+	while (other->state == SLOT_NEXT_ALLOC)
+	{
+		prealloc_step(other, config.maxBytes);
+		inline_work = 1;
+	}
+	if (other->state != SLOT_NEXT_READY)
+	{
+		/* could not create the next part, keep appending to the current one */
+		return;
+	}
+
+	stats.syncRotations += inline_work;
+
+	prev = cur;
+	cur = other;
+	other = prev;
+	other->state = SLOT_CLOSING;
+
+	begin_part(cur);
+	lastSync = cur->startTick;
+}
+
+static uint8_t rotation_due(uint32_t len)
+{
+	uint32_t used = cur->size + cur->fill;
+
+	if (config.maxBytes && used + len > config.maxBytes && used > sizeof(log_part_header_t))
+	{
+		return 1;
+	}
+	if (config.maxMs && (HAL_GetTick() - cur->startTick) >= config.maxMs)
+	{
+		return 1;
+	}
+
+	return 0;
+}
+
+int32_t LOG_Open(const log_config_t *cfg)
+{
+	char name[13];
+	FILINFO fno;
+
+	if (isOpen)
+	{
+		return -1;
+	}
+
+	config = *cfg;
+	memset(&stats, 0, sizeof(stats));
+
+	if (config.sessionId == 0)
+	{
+		for (config.sessionId = 1; config.sessionId <= 0xFFFF; config.sessionId++)
+		{
+			LOG_PartName(name, config.sessionId, 0);
+			if (f_stat(name, &fno) == FR_NO_FILE)
+			{
+				break;
+			}
+		}
+		if (config.sessionId > 0xFFFF)
+		{
+			return -2;
+		}
+	}
+
+	cur = &slots[0];
+	other = &slots[1];
+	other->state = SLOT_FREE;
+
+	/* the first part is preallocated inline, opening is not time critical */
+	if (open_part(cur, 0) != 0)
+	{
+		return -3;
+	}
+	while (cur->state == SLOT_NEXT_ALLOC)
+	{
+		prealloc_step(cur, config.maxBytes);
+	}
+
+	begin_part(cur);
+	lastSync = cur->startTick;
+	isOpen = 1;
+
+	return 0;
+}
+
+int32_t LOG_Write(const void *data, uint32_t len)
+{
+	const uint8_t *src = (const uint8_t *)data;
+	uint32_t start = DWT_Get(), dt, n;
+	int32_t result = 0;
+
+	if (!isOpen)
+	{
+		return -1;
+	}
+
+	/* records never straddle parts, each part stands on its own */
+	if (rotation_due(len))
+	{
+		rotate();
+	}
+
+	stats.bytes += len;
+
+	while (len)
+	{
+		n = LOG_BLOCK_SIZE - cur->fill;
+		if (n > len)
+		{
+			n = len;
+		}
+		memcpy(&cur->blk[cur->fill], src, n);
+		cur->fill += n;
+		src += n;
+		len -= n;
+
+		/* whole, aligned blocks into preallocated clusters: no FAT update, no read-modify-write */
+		if (cur->fill == LOG_BLOCK_SIZE && flush_block(cur) != 0)
+		{
+			result = -1;
+		}
+	}
+
+	dt = DWT_Get() - start;
+	if (dt > stats.maxWriteCycles)
+	{
+		stats.maxWriteCycles = dt;
+	}
+
+	return result;
+}
+
+/* background work, at most one bounded step per call; call from the main loop */
+void LOG_Poll(void)
+{
+	if (!isOpen)
+	{
+		return;
+	}
+
+	switch (other->state)
+	{
+		case SLOT_CLOSING:
+			close_part(other);
+			break;
+
+		case SLOT_FREE:
+			open_part(other, cur->partIndex + 1);
+			break;
+
+		case SLOT_NEXT_ALLOC:
+			prealloc_step(other, LOG_PREALLOC_STEP);
+			break;
+
+		default:
+			if (config.syncMs && (HAL_GetTick() - lastSync) >= config.syncMs)
+			{
+				if (update_header(cur) != 0 || f_sync(&cur->fil) != FR_OK)
+				{
+					fail();
+				}
+				lastSync = HAL_GetTick();
+			}
+			break;
+	}
+}
+
+int32_t LOG_Close(void)
+{
+	char name[13];
+	int32_t result = 0;
+
+	if (!isOpen)
+	{
+		return -1;
+	}
+
+	if (other->state == SLOT_CLOSING)
+	{
+		result |= close_part(other);
+	}
+	else if (other->state != SLOT_FREE)
+	{
+		/* unused next part */
+		f_close(&other->fil);
+		LOG_PartName(name, config.sessionId, other->partIndex);
+		f_unlink(name);
+		other->state = SLOT_FREE;
+	}
+
+	result |= close_part(cur);
+	isOpen = 0;
+
+	DISKSTAT_Report();
+
+	return result;
+}
+
+uint32_t LOG_SessionId(void)
+{
+	return config.sessionId;
+}
+
+const log_stats_t* LOG_Stats(void)
+{
+	return &stats;
+}
+
+void LOG_Command(const char *args)
+{
+	log_config_t cfg = { 0, 4 * 1024 * 1024, 0, 1000 };
+	unsigned kb = 0, sec = 0, ms = 1000;
+	char line[120];
+	int32_t n;
+
+	if (strncmp(args, "open", 4) == 0)
+	{
+		n = sscanf(args + 4, "%u %u %u", &kb, &sec, &ms);
+		if (n >= 1)
+		{
+			cfg.maxBytes = kb * 1024;
+		}
+		if (n >= 2)
+		{
+			cfg.maxMs = sec * 1000;
+		}
+		if (n >= 3)
+		{
+			cfg.syncMs = ms;
+		}
+		if (FATFS_Mount() != FR_OK)
+		{
+			print_str("LOG no volume\n");
+			return;
+		}
+		n = LOG_Open(&cfg);
+		snprintf(line, sizeof(line), "LOG open session=%04lX result=%ld\n", (unsigned long)config.sessionId, (long)n);
+		print_str(line);
+		return;
+	}
+	if (strncmp(args, "close", 5) == 0)
+	{
+		n = LOG_Close();
+		snprintf(line, sizeof(line), "LOG close result=%ld\n", (long)n);
+		print_str(line);
+		return;
+	}
+
+	snprintf(line, sizeof(line), "LOG %s session=%04lX parts=%lu bytes=%lu inline=%lu errors=%lu\n",
+			isOpen ? "open" : "closed", (unsigned long)config.sessionId, (unsigned long)stats.parts,
+			(unsigned long)stats.bytes, (unsigned long)stats.syncRotations, (unsigned long)stats.errors);
+	print_str(line);
+}
@@ -58,6 +58,27 @@
 #include "tm_stm32_i2c.h"
 
 #include "mpu9250.h"
+#include "cmd.h"
+#include "print.h"
+#include "disk_stats.h"
+#include "log_session.h"
+#include "ahrs.h"
+#include "eskf.h"
+#include "ins.h"
+#include "pdr.h"
+#include "rf4463.h"
+#include "beacon.h"
+#include "pf.h"
+#include "thermal.h"
+#include "calib.h"
+#include "imu_q15.h"
+#include "decim.h"
+#include "spectrum.h"
+#include "power.h"
+#include "pipeline.h"
+#include "scheduler.h"
+#include "mempool.h"
+#include "prof.h"
 /* USER CODE END Includes */
 
 /* Private variables ---------------------------------------------------------*/
@@ -83,6 +104,10 @@ void Error_Handler(void);
 /* USER CODE END PFP */
 
 /* USER CODE BEGIN 0 */
+static void ins_task(void)
+{
+	INS_Poll();
+}
 
 /* USER CODE END 0 */
 
@@ -123,21 +148,86 @@ int main(void)
 	char greets[100]="-= PRION v0.1 =-\nHello, World!\n\n";
 	HAL_StatusTypeDef status = HAL_UART_Transmit(&huart6, &greets[0], 32, 100);
 
-	volatile uint32_t *DWT_CONTROL = (uint32_t *) 0xE0001000;
-	volatile uint32_t *DWT_CYCCNT = (uint32_t *) 0xE0001004;
-	volatile uint32_t *DEMCR = (uint32_t *) 0xE000EDFC;
-	volatile uint32_t *LAR  = (uint32_t *) 0xE0001FB0;   // <-- added lock access register
-
-	*DEMCR = *DEMCR | 0x01000000;     // enable trace
-	*LAR = 0xC5ACCE55;                // <-- added unlock access to DWT (ITM, etc.)registers
-	*DWT_CYCCNT = 0;                  // clear DWT cycle counter
-	*DWT_CONTROL = *DWT_CONTROL | 1;  // enable DWT cycle counter
+	/* DWT cycle counter, the time base of every cycle count and of DWT_Delay() */
+	PROF_Init();
 
 	int32_t mpuInitResult = 0;
 
 	mpuInitResult = Init_MPU9250(ACCEL_RANGE_2G, GYRO_RANGE_250DPS);
 
-	//HAL_TIM_Base_Start_IT(&htim6);
+	AHRS_Init(IMU_SAMPLE_HZ, 0.1f, 0.0f);
+
+	/* MPU9250 datasheet densities: 0.01 dps/rtHz, 300 ug/rtHz */
+	eskf_noise_t eskfNoise = { 1.75e-4f, 2.94e-3f, 1e-5f, 1e-4f };
+	float ax, ay, az, gx, gy, gz, temp;
+
+	/* calibration from flash, identity if none was saved */
+	CALIB_Init(G / _accelScale, 1.0f / _gyroScale);
+
+	/* fixed point read path, also built for "imuq bench" when not selected */
+	imuq_config_t imuqConfig = { _accelScale, _gyroScale, _tempScale, _tempOffset,
+			{ { tX[0], tX[1], tX[2] }, { tY[0], tY[1], tY[2] }, { tZ[0], tZ[1], tZ[2] } }, IMU_Q15_CUTOFF };
+	IMUQ_Init(&imuqConfig);
+
+	/* oversampled input, the sensor is only switched over with IMU_OVERSAMPLE */
+	decim_config_t decimConfig = { _accelScale, _gyroScale, _tempScale, _tempOffset,
+			{ { tX[0], tX[1], tX[2] }, { tY[0], tY[1], tY[2] }, { tZ[0], tZ[1], tZ[2] } }, IMU_SAMPLE_HZ };
+	DECIM_Init(&decimConfig, IMU_DECIM_DESIGN);
+#if IMU_OVERSAMPLE
+	DECIM_Start();
+#endif
+
+	/* saved with the calibration, or none until a warm-up run is learned with "thermal learn" */
+	THERMAL_Init(IMU_SAMPLE_HZ);
+	CALIB_SetGyroDriftCallback(THERMAL_GyroDrift);
+
+	ESKF_Init(&eskfNoise);
+	getMotion7(&ax, &ay, &az, &gx, &gy, &gz, &temp);
+	ESKF_AlignFromAccel(ax, ay, az);
+
+	INS_Init(IMU_SAMPLE_HZ, INS_NAV_DIVIDER);
+	INS_SetAttitude(ESKF_State()->q);
+
+	/* foot-mounted stance detector, thresholds for the 100 Hz sample rate */
+	pdr_config_t pdrConfig = { IMU_SAMPLE_HZ, 5, 5, 0.02f, 0.002f, 3e4f, 1e-4f };
+
+	PDR_Init(&pdrConfig);
+
+	/* accel magnitude spectrum: cadence in the first band, vibration above */
+	spec_config_t specConfig = { IMU_SAMPLE_HZ, 256, 0.5f, 5.0f, 4, { 0.5f, 3.0f, 8.0f, 20.0f, IMU_SAMPLE_HZ / 2.0f }, 1 };
+
+	SPEC_Init(&specConfig);
+
+	/* wake on motion after 5 s still, 80 mg at 7.8 Hz; in Stop the command UART does not wake the MCU, moving does */
+	power_config_t powerConfig = { IMU_SAMPLE_HZ, 5.0f, 0.05f, 0.3f, 80, 5, 1, 1 };
+
+	POWER_Init(&powerConfig);
+
+	/* RSSI ranging to RF beacons, positions are set with the "beacon" command */
+	beacon_config_t beaconConfig = { 2.5f, 4.0f, 0.5f, 200.0f, 9.0f };
+
+	BEACON_Init(&beaconConfig);
+	RF4463_SetRxCallback(BEACON_OnPacket);
+	RF4463_Init();
+
+	/* particle filter on steps and beacon ranges, walls from the map file on the card */
+	pf_config_t pfConfig = { PF_MAX_PARTICLES, 0.1f, 0.01f, 0.05f, 0.5f, 1.0f, 1 };
+
+	PF_Init(&pfConfig);
+	if (PF_LoadMap(PF_MAP_FILE) != 0)
+	{
+		print_str("PF no " PF_MAP_FILE ", walls off until \"pf map\"\n");
+	}
+	PDR_SetStepCallback(PF_OnStep);
+	BEACON_SetRangeCallback(PF_OnRange);
+
+	/* TIM6 only starts the read, processing in PendSV, output in the main loop */
+	PIPE_Init();
+
+#if IMU_OVERSAMPLE
+	/* TIM6 drains the FIFO DECIM_DRAINS times per output sample */
+	__HAL_TIM_SET_AUTORELOAD(&htim6, (htim6.Init.Period + 1) / DECIM_DRAINS - 1);
+#endif
 
 	/* Init I2C, SCL = PB6, SDA = PB9, available on Arduino headers and on all discovery boards */
 	/* For STM32F4xx and STM32F7xx lines */
@@ -154,6 +244,63 @@ int main(void)
 	/* Read one byte, device address = MPU6050_ADDRESS, register address = 0x1A */
 	TM_I2C_Read(I2C1, MPU6050_ADDRESS, 0x1A, &read);
 
+	/* command channel on USART6 */
+	CMD_Init();
+	CMD_Register("dstat", DISKSTAT_Command);
+	CMD_Register("ahrs", AHRS_Command);
+	CMD_Register("eskf", ESKF_Command);
+	CMD_Register("ins", INS_Command);
+	CMD_Register("pdr", PDR_Command);
+	CMD_Register("rf", RF4463_Command);
+	CMD_Register("beacon", BEACON_Command);
+	CMD_Register("pf", PF_Command);
+	CMD_Register("thermal", THERMAL_Command);
+	CMD_Register("calib", CALIB_Command);
+	CMD_Register("imuq", IMUQ_Command);
+	CMD_Register("decim", DECIM_Command);
+	CMD_Register("spec", SPEC_Command);
+	CMD_Register("power", POWER_Command);
+	CMD_Register("pipe", PIPE_Command);
+	CMD_Register("sched", SCHED_Command);
+	CMD_Register("pool", MEMPOOL_Command);
+	CMD_Register("prof", PROF_Command);
+	CMD_Register("log", LOG_Command);
+
+	/* acquisition and fusion stay on TIM6, DMA and PendSV (pipeline.h).
+	 * Budgets in us cover a task's normal worst run; print_str() blocks at
+	 * 921600 baud, about 11 us a character, which is most of several of
+	 * them. "sched" and "prof" report the WCET on the board to check them. */
+	SCHED_Init();
+	/* one print_motion7() line, 0.9 ms, and a block to the card when logging */
+	SCHED_Add("out", PIPE_Poll, 1, 0, 2000);
+	/* FFT steps stay under 100 us, the SPEC line at the end of a frame is 1.6 ms */
+	SCHED_Add("spec", SPEC_Poll, 1, 0, 1800);
+	/* replies are as long as asked for, not budgeted */
+	SCHED_Add("cmd", CMD_Poll, 10, 1, 0);
+	SCHED_Add("log", LOG_Poll, 10, 2, 5000);
+	SCHED_Add("ins", ins_task, 10, 3, 500);
+	/* STEP line 0.6 ms, PF_Step() over 2048 particles about 4 ms and a resample 2 ms */
+	SCHED_Add("pdr", PDR_Poll, 10, 4, 7000);
+	/* PF_Range() over 2048 particles about 3.5 ms and a resample 2 ms */
+	SCHED_Add("rf", RF4463_Poll, 5, 0, 6000);
+	/* a fit, its line and a calibration record written to flash; a sector erase overruns */
+	SCHED_Add("thermal", THERMAL_Poll, 100, 6, 2500);
+	SCHED_Add("calib", CALIB_Poll, 100, 7, 1000);
+	/* one PROF line per call */
+	SCHED_Add("prof", PROF_Poll, 10, 9, 2500);
+	/* may sleep until the next interrupt */
+	SCHED_SetIdle(POWER_Poll);
+
+	/* sampling starts once the tasks that drain the pipeline are registered */
+	if (mpuInitResult == 0)
+	{
+		HAL_TIM_Base_Start_IT(&htim6);
+	}
+	else
+	{
+		print_str("MPU9250 init failed, no sampling\n");
+	}
+
 	/* USER CODE END 2 */
 
 	/* Infinite loop */
@@ -166,6 +313,7 @@ int main(void)
 
 		/* USER CODE BEGIN 3 */
 
+		SCHED_Run();
 	}
 	/* USER CODE END 3 */
 
@@ -0,0 +1,135 @@
+/*
+ * mempool.c
+ *
+ *  Created on: 18 Oct 2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "stm32f4xx_hal.h"
+#include "print.h"
+#include "mempool.h"
+
+static mempool_t *pools[MEMPOOL_MAX_POOLS];
+static uint32_t poolsNum = 0;
+
+int32_t MEMPOOL_Init(mempool_t *p)
+{
+	uint32_t i;
+
+	p->free = NULL;
+	for (i = p->blocks; i > 0; i--)
+	{
+		void **block = (void**)(p->mem + (i - 1) * p->blockSize);
+
+		*block = p->free;
+		p->free = block;
+	}
+	memset(p->inUse, 0, (p->blocks + 31) / 32 * sizeof(uint32_t));
+	p->used = p->highWater = 0;
+	p->allocs = p->fails = p->errors = 0;
+
+	for (i = 0; i < poolsNum; i++)
+	{
+		if (pools[i] == p)
+		{
+			return 0;
+		}
+	}
+	if (poolsNum >= MEMPOOL_MAX_POOLS)
+	{
+		return -1;
+	}
+	pools[poolsNum++] = p;
+
+	return 0;
+}
+
+void* MEMPOOL_Alloc(mempool_t *p)
+{
+	uint32_t primask = __get_PRIMASK(), i;
+	void **block;
+
+	__disable_irq();
+	block = p->free;
+	if (block)
+	{
+		i = ((uint8_t*)block - p->mem) / p->blockSize;
+		p->inUse[i / 32] |= 1u << (i % 32);
+		p->free = *block;
+		p->allocs++;
+		if (++p->used > p->highWater)
+		{
+			p->highWater = p->used;
+		}
+	}
+	else
+	{
+		p->fails++;
+	}
+	__set_PRIMASK(primask);
+
+	return block;
+}
+
+int32_t MEMPOOL_Free(mempool_t *p, void *block)
+{
+	uint32_t primask, offset = (uint8_t*)block - p->mem, i, bit;
+	int32_t result = 0;
+
+	if ((uint8_t*)block < p->mem || offset >= p->blocks * p->blockSize || offset % p->blockSize != 0)
+	{
+		p->errors++;
+		return -1;
+	}
+	i = offset / p->blockSize;
+	bit = 1u << (i % 32);
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	if (p->inUse[i / 32] & bit)
+	{
+		p->inUse[i / 32] &= ~bit;
+		*(void**)block = p->free;
+		p->free = block;
+		p->used--;
+	}
+	else
+	{
+		/* already free: linking it again would make a cycle */
+		p->errors++;
+		result = -1;
+	}
+	__set_PRIMASK(primask);
+
+	return result;
+}
+
+void MEMPOOL_Command(const char *args)
+{
+	char line[160];
+	uint32_t i;
+
+	if (strncmp(args, "reset", 5) == 0)
+	{
+		for (i = 0; i < poolsNum; i++)
+		{
+			/* the high water mark restarts from what is in use now */
+			pools[i]->highWater = pools[i]->used;
+			pools[i]->allocs = pools[i]->fails = pools[i]->errors = 0;
+		}
+		return;
+	}
+
+	for (i = 0; i < poolsNum; i++)
+	{
+		const mempool_t *p = pools[i];
+
+		snprintf(line, sizeof(line), "POOL %-10s %4lu x %4lu B used=%lu high=%lu allocs=%lu fails=%lu errors=%lu\n",
+				p->name, (unsigned long)p->blocks, (unsigned long)p->blockSize, (unsigned long)p->used,
+				(unsigned long)p->highWater, (unsigned long)p->allocs, (unsigned long)p->fails,
+				(unsigned long)p->errors);
+		print_str(line);
+	}
+}
@@ -30,6 +30,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "stm32f4xx_hal_gpio.h"
 #include "spi.h"
 #include "i2c.h"
+#include "calib.h"
 
 // constants
 const float G = 9.807f;
@@ -37,7 +38,8 @@ const float _d2r = 3.14159265359f/180.0f;
 
 float _accelScale;
 float _gyroScale;
-float _magScaleX, _magScaleY, _magScaleZ;
+// nominal until initAK8963() has read the ASA fuse ROM
+float _magScaleX = 4912.0f / 32760.0f, _magScaleY = 4912.0f / 32760.0f, _magScaleZ = 4912.0f / 32760.0f;
 const float _tempScale = 333.87f;
 const float _tempOffset = 21.0f;
 
@@ -49,6 +51,178 @@ const int16_t tZ[3] = {0,  0, -1};
 
 /* SHARED BUFFER */
 static uint8_t buff[42] = {0,};
+/* set while a register access holds CS low, see mpu9250.h */
+volatile uint8_t mpuSpiOwned = 0;
+
+/* USER_CTRL base, I2C master on once the AK8963 is set up */
+static uint8_t _userCtrl = I2C_IF_DIS;
+
+static mpu9250_mag_status _magStatus = MAG_NODATA;
+static mpu9250_mag_stats _magStats;
+static int32_t _magInit = -1;
+static uint8_t lastMag[6];
+
+/* full rate settings kept while wake on motion is on */
+static uint8_t _accelConfig2, _intEnable, _fifoOn;
+
+/* calibration (calib.c) in Q4 counts, then the nominal scale */
+static void scaleAccel(const int16_t accel[3], float* ax, float* ay, float* az){
+    int32_t c[3];
+    const float k = _accelScale * (1.0f / (1 << CALIB_OUT_Q));
+
+    CALIB_Correct(CALIB_ACCEL, accel, c);
+    *ax = ((float) c[0]) * k;
+    *ay = ((float) c[1]) * k;
+    *az = ((float) c[2]) * k;
+}
+
+static void scaleGyro(const int16_t gyro[3], float* gx, float* gy, float* gz){
+    int32_t c[3];
+    const float k = _gyroScale * (1.0f / (1 << CALIB_OUT_Q));
+
+    CALIB_Correct(CALIB_GYRO, gyro, c);
+    *gx = ((float) c[0]) * k;
+    *gy = ((float) c[1]) * k;
+    *gz = ((float) c[2]) * k;
+}
+
+/* a fitted ellipsoid already equalises the axes, the ASA factors only set the overall scale then */
+static void scaleMag(const int16_t mag[3], float* hx, float* hy, float* hz){
+    int32_t c[3];
+    const float q = 1.0f / (1 << CALIB_OUT_Q);
+
+    CALIB_Correct(CALIB_MAG, mag, c);
+    if( CALIB_Coeffs()->valid & (1 << CALIB_MAG) ) {
+        const float k = (_magScaleX + _magScaleY + _magScaleZ) * (1.0f / 3.0f) * q;
+
+        *hx = ((float) c[0]) * k;
+        *hy = ((float) c[1]) * k;
+        *hz = ((float) c[2]) * k;
+    }
+    else{
+        *hx = ((float) c[0]) * _magScaleX * q;
+        *hy = ((float) c[1]) * _magScaleY * q;
+        *hz = ((float) c[2]) * _magScaleZ * q;
+    }
+}
+
+/*
+ * AK8963 through the MPU9250 I2C master: ASA fuse ROM read once, 16 bit
+ * continuous 100 Hz mode, then slave 0 left reading HXL..ST2 into
+ * EXT_SENS_DATA_00..06 at every sample, so the 21 byte burst from
+ * ACCEL_OUT carries the mag without further bus traffic.
+ */
+static int32_t initAK8963(void){
+
+    // keep I2C master mode on
+    if( !writeRegister(USER_CTRL,I2C_IF_DIS | I2C_MST_EN) ){
+        return -31;
+    }
+
+    // set the I2C bus speed to 400 kHz
+    if( !writeRegister(I2C_MST_CTRL,I2C_MST_CLK) ){
+        return -32;
+    }
+
+    // check AK8963 WHO AM I register, expected value is 0x48 (decimal 72)
+    uint8_t ak8963 = whoAmIAK8963();
+    if( ak8963 != 0x48 ){
+        writeRegister(USER_CTRL,I2C_IF_DIS); // no slave reads on an empty bus
+        return -33;
+    }
+
+    /* get the magnetometer calibration */
+
+    // set AK8963 to Power Down
+    if( !writeAK8963Register(AK8963_CNTL1,AK8963_PWR_DOWN) ){
+        return -34;
+    }
+    DWT_Delay( 100 ); // long wait between AK8963 mode changes
+
+    // set AK8963 to FUSE ROM access
+    if( !writeAK8963Register(AK8963_CNTL1,AK8963_FUSE_ROM) ){
+        return -35;
+    }
+    DWT_Delay( 100 ); // long wait between AK8963 mode changes
+
+    // read the AK8963 ASA registers and compute magnetometer scale factors
+    readAK8963Registers(AK8963_ASA,3,&buff[0]);
+    _magScaleX = ((((float)buff[0]) - 128.0f)/(256.0f) + 1.0f) * 4912.0f / 32760.0f; // micro Tesla
+    _magScaleY = ((((float)buff[1]) - 128.0f)/(256.0f) + 1.0f) * 4912.0f / 32760.0f; // micro Tesla
+    _magScaleZ = ((((float)buff[2]) - 128.0f)/(256.0f) + 1.0f) * 4912.0f / 32760.0f; // micro Tesla
+
+    // set AK8963 to Power Down
+    if( !writeAK8963Register(AK8963_CNTL1,AK8963_PWR_DOWN) ){
+        return -36;
+    }
+    DWT_Delay( 100 ); // long wait between AK8963 mode changes
+
+    // set AK8963 to 16 bit resolution, 100 Hz update rate
+    if( !writeAK8963Register(AK8963_CNTL1,AK8963_CNT_MEAS2) ){
+        return -37;
+    }
+    DWT_Delay( 100 ); // long wait between AK8963 mode changes
+
+    // instruct the MPU9250 to get 7 bytes of data from the AK8963 at the sample rate
+    readAK8963Registers(AK8963_HXL,AK8963_DATA_LEN,&buff[0]);
+    _userCtrl = I2C_IF_DIS | I2C_MST_EN;
+
+    return 0;
+}
+
+/*
+ * HXL..ST2 as copied by slave 0, little endian. Zeros on overflow or when
+ * slave 0 is not reading (ST2 without BITM), like getMag() always did;
+ * unchanged bytes mean the AK8963 had no new measurement since the last
+ * sample and are passed on, marked MAG_STALE.
+ */
+static void unpackMag(const uint8_t* d, int16_t* hx, int16_t* hy, int16_t* hz){
+
+    if( !(d[6] & AK8963_BITM) ){
+        _magStatus = MAG_NODATA;
+        _magStats.nodata++;
+        *hx = 0;
+        *hy = 0;
+        *hz = 0;
+        return;
+    }
+    if( d[6] & AK8963_HOFL ){
+        _magStatus = MAG_OVERFLOW;
+        _magStats.overflows++;
+        *hx = 0;
+        *hy = 0;
+        *hz = 0;
+        return;
+    }
+
+    if( memcmp(d, lastMag, 6) == 0 ){
+        _magStatus = MAG_STALE;
+        _magStats.stale++;
+    }
+    else{
+        _magStatus = MAG_FRESH;
+        _magStats.fresh++;
+        memcpy(lastMag, d, 6);
+    }
+
+    *hx = (((int16_t)d[1]) << 8) | d[0];  // combine into 16 bit values
+    *hy = (((int16_t)d[3]) << 8) | d[2];
+    *hz = (((int16_t)d[5]) << 8) | d[4];
+}
+
+/* status of the last magnetometer read */
+mpu9250_mag_status getMagStatus(void){
+    return _magStatus;
+}
+
+const mpu9250_mag_stats* getMagStats(void){
+    return &_magStats;
+}
+
+/* initAK8963() result from Init_MPU9250(), 0 when the magnetometer is running */
+int32_t getMagInit(void){
+    return _magInit;
+}
 
 /* starts I2C communication and sets up the MPU-9250 */
 int32_t Init_MPU9250(mpu9250_accel_range accelRange, mpu9250_gyro_range gyroRange){
@@ -89,21 +263,19 @@ int32_t Init_MPU9250(mpu9250_accel_range accelRange, mpu9250_gyro_range gyroRang
         return -1;
     }
 
-    // enable I2C master mode
-    if( !writeRegister(USER_CTRL,I2C_IF_DIS) ){
+    // enable I2C master mode, the AK8963 sits on the auxiliary bus
+    if( !writeRegister(USER_CTRL,I2C_IF_DIS | I2C_MST_EN) ){
         return -2;
     }
 
     // set the I2C bus speed to 400 kHz
-//    if( !writeRegister(I2C_MST_CTRL,I2C_MST_CLK) ){
-//        return -1;
-//    }
+    if( !writeRegister(I2C_MST_CTRL,I2C_MST_CLK) ){
+        return -3;
+    }
+
+    // set AK8963 to Power Down, not checked: initAK8963() finds out whether it is there
+    writeAK8963Register(AK8963_CNTL1,AK8963_PWR_DOWN);
 
-//    // set AK8963 to Power Down
-//    if( !writeAK8963Register(AK8963_CNTL1,AK8963_PWR_DOWN) ){
-//        return -300;
-//    }
-//
 //    // reset the MPU9250
 //    if( !writeRegister(PWR_MGMNT_1,PWR_RESET) ){
 //    	return -301;
@@ -111,11 +283,10 @@ int32_t Init_MPU9250(mpu9250_accel_range accelRange, mpu9250_gyro_range gyroRang
 //
 //    // wait for MPU-9250 to come back up
 //    DWT_Delay( 100 );
-//
-//    // reset the AK8963
-//    if( !writeAK8963Register(AK8963_CNTL2,AK8963_RESET) ){
-//    	return -302;
-//    }
+
+    // reset the AK8963, self clearing so the read back differs
+    writeAK8963Register(AK8963_CNTL2,AK8963_RESET);
+    DWT_Delay( 100 );
 
     // select clock source to gyro
     if( !writeRegister(PWR_MGMNT_1,CLOCK_SEL_PLL) ){
@@ -197,63 +368,15 @@ int32_t Init_MPU9250(mpu9250_accel_range accelRange, mpu9250_gyro_range gyroRang
             break;
     }
 
-    // disable I2C master mode
-    if( !writeRegister(USER_CTRL,/*I2C_MST_EN*/I2C_IF_DIS) ){
-    	return -31;
-    }
-
-	// set the I2C bus speed to 400 kHz
-//	if( !writeRegister(I2C_MST_CTRL,I2C_MST_CLK) ){
-//		return -32;
-//	}
-
-//	// check AK8963 WHO AM I register, expected value is 0x48 (decimal 72)
-//    uint8_t ak8963 = whoAmIAK8963();
-//	if( ak8963 != 0x48 ){
-//        return -33;
-//	}
-//
-//    /* get the magnetometer calibration */
-//
-//    // set AK8963 to Power Down
-//    if( !writeAK8963Register(AK8963_CNTL1,AK8963_PWR_DOWN) ){
-//        return -34;
-//    }
-//    DWT_Delay( 100 ); // long wait between AK8963 mode changes
-//
-//    // set AK8963 to FUSE ROM access
-//    if( !writeAK8963Register(AK8963_CNTL1,AK8963_FUSE_ROM) ){
-//        return -35;
-//    }
-//    DWT_Delay( 100 ); // long wait between AK8963 mode changes
-//
-//    // read the AK8963 ASA registers and compute magnetometer scale factors
-//    readAK8963Registers(AK8963_ASA,3,&buff[0]);
-//    _magScaleX = ((((float)buff[0]) - 128.0f)/(256.0f) + 1.0f) * 4912.0f / 32760.0f; // micro Tesla
-//    _magScaleY = ((((float)buff[1]) - 128.0f)/(256.0f) + 1.0f) * 4912.0f / 32760.0f; // micro Tesla
-//    _magScaleZ = ((((float)buff[2]) - 128.0f)/(256.0f) + 1.0f) * 4912.0f / 32760.0f; // micro Tesla
-//
-//    // set AK8963 to Power Down
-//    if( !writeAK8963Register(AK8963_CNTL1,AK8963_PWR_DOWN) ){
-//        return -36;
-//    }
-//    DWT_Delay( 100 ); // long wait between AK8963 mode changes
-//
-//    // set AK8963 to 16 bit resolution, 100 Hz update rate
-//    if( !writeAK8963Register(AK8963_CNTL1,AK8963_CNT_MEAS2) ){
-//        return -37;
-//    }
-//    DWT_Delay( 100 ); // long wait between AK8963 mode changes
+    // magnetometer, accel and gyro work without it: kept for getMagInit()
+    _magInit = initAK8963();
 
     // select clock source to gyro
     if( !writeRegister(PWR_MGMNT_1,CLOCK_SEL_PLL) ){
         return -38;
     }
 
-    // instruct the MPU9250 to get 7 bytes of data from the AK8963 at the sample rate
-    //readAK8963Registers(AK8963_HXL,sizeof(data),&data[0]);
-
-    // successful init, return 0
+    // successful init
     return 0;
 }
 
@@ -375,6 +498,111 @@ int32_t enableInt(uint8_t enable){
     return 0;
 }
 
+/* sensor at its maximum rate for decimation on the MCU: gyro 8 kHz, accel 4 kHz DLPF bypassed */
+int32_t setFiltBypass(void){
+
+    if( !writeRegister(ACCEL_CONFIG2,ACCEL_FCHOICE_B) ){ // accel at 4 kHz, 1.13 kHz bandwidth
+        return -1;
+    }
+    if( !writeRegister(CONFIG,GYRO_DLPF_250) ){ // gyro at 8 kHz, 250 Hz bandwidth, FIFO overwrites when full
+        return -1;
+    }
+    if( !writeRegister(SMPDIV,0) ){ // FIFO at the internal 8 kHz
+        return -1;
+    }
+
+    return 0;
+}
+
+/* accel, temp and gyro records of 14 bytes in ACCEL_OUT order; enabling also resets the FIFO */
+int32_t enableFifo(uint8_t enable){
+
+    if( !writeRegister(FIFO_EN,0) ){
+        return -1;
+    }
+    writeRegister(USER_CTRL,_userCtrl | USER_FIFO_RST); // self clearing, the read back differs
+    _fifoOn = enable;
+    if(enable){
+        if( !writeRegister(USER_CTRL,_userCtrl | USER_FIFO_EN) ){
+            return -1;
+        }
+        if( !writeRegister(FIFO_EN,FIFO_ACCEL | FIFO_TEMP | FIFO_GYRO) ){
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/* accel only low power mode, INT pulses when any axis changes by more than thresholdMg between samples at 0.24 Hz << lpOdr */
+int32_t enableWakeOnMotion(uint16_t thresholdMg, uint8_t lpOdr){
+
+    readRegisters(ACCEL_CONFIG2,1,&_accelConfig2);
+    readRegisters(INT_ENABLE,1,&_intEnable);
+
+    if( !writeRegister(PWR_MGMNT_1,CLOCK_SEL_PLL) ){ // awake, no cycling while it is set up
+        return -1;
+    }
+    if( !writeRegister(PWR_MGMNT_2,DIS_GYRO) ){ // accel only
+        return -1;
+    }
+    if( !writeRegister(ACCEL_CONFIG2,ACCEL_FCHOICE_B | ACCEL_DLPF_184) ){ // 1 kHz internal rate, as the datasheet asks for
+        return -1;
+    }
+    if( !writeRegister(INT_ENABLE,INT_WOM_EN) ){
+        return -1;
+    }
+    if( !writeRegister(MOT_DETECT_CTRL,ACCEL_INTEL_EN | ACCEL_INTEL_MODE) ){
+        return -1;
+    }
+    if( !writeRegister(WOM_THR,(uint8_t)((thresholdMg + 2) / 4 > 255 ? 255 : (thresholdMg + 2) / 4)) ){
+        return -1;
+    }
+    if( !writeRegister(LP_ACCEL_ODR,lpOdr > 11 ? 11 : lpOdr) ){
+        return -1;
+    }
+    if( !writeRegister(PWR_MGMNT_1,CLOCK_SEL_PLL | PWR_CYCLE) ){ // wake up only at the low power rate
+        return -1;
+    }
+
+    return 0;
+}
+
+/* back to the settings before enableWakeOnMotion(); the gyro needs about 35 ms to start up */
+int32_t disableWakeOnMotion(void){
+
+    if( !writeRegister(PWR_MGMNT_1,CLOCK_SEL_PLL) ){
+        return -1;
+    }
+    if( !writeRegister(PWR_MGMNT_2,SEN_ENABLE) ){
+        return -1;
+    }
+    if( !writeRegister(MOT_DETECT_CTRL,0) ){
+        return -1;
+    }
+    if( !writeRegister(ACCEL_CONFIG2,_accelConfig2) ){
+        return -1;
+    }
+    if( !writeRegister(INT_ENABLE,_intEnable) ){
+        return -1;
+    }
+    if( _fifoOn ){
+        // the FIFO holds accel only records from the low power mode
+        return enableFifo(1);
+    }
+
+    return 0;
+}
+
+/* bytes in the FIFO, FIFO_SIZE when it has overflowed */
+uint16_t getFifoCount(void){
+    uint8_t data[2];
+
+    readRegisters(FIFO_COUNT,2,&data[0]);
+
+    return (((uint16_t)(data[0] & 0x1F)) << 8) | data[1];
+}
+
 
 /* get accelerometer data given pointers to store the three values, return data as counts */
 void getAccelCounts(int16_t* ax, int16_t* ay, int16_t* az){
@@ -398,9 +626,7 @@ void getAccel(float* ax, float* ay, float* az){
 
     getAccelCounts(&accel[0], &accel[1], &accel[2]);
 
-    *ax = ((float) accel[0]) * _accelScale; // typecast and scale to values
-    *ay = ((float) accel[1]) * _accelScale;
-    *az = ((float) accel[2]) * _accelScale;
+    scaleAccel(accel, ax, ay, az);
 }
 
 /* get gyro data given pointers to store the three values, return data as counts */
@@ -425,9 +651,7 @@ void getGyro(float* gx, float* gy, float* gz){
 
     getGyroCounts(&gyro[0], &gyro[1], &gyro[2]);
 
-    *gx = ((float) gyro[0]) * _gyroScale; // typecast and scale to values
-    *gy = ((float) gyro[1]) * _gyroScale;
-    *gz = ((float) gyro[2]) * _gyroScale;
+    scaleGyro(gyro, gx, gy, gz);
 }
 
 /* get magnetometer data given pointers to store the three values, return data as counts */
@@ -435,18 +659,9 @@ void getMagCounts(int16_t* hx, int16_t* hy, int16_t* hz){
     //_useSPIHS = true; // use the high speed SPI for data readout
 
     // read the magnetometer data off the external sensor buffer
-    readRegisters(EXT_SENS_DATA_00,7,&buff[0]);
+    readRegisters(EXT_SENS_DATA_00,AK8963_DATA_LEN,&buff[0]);
 
-    if( buff[6] == 0x10 ) { // check for overflow
-        *hx = (((int16_t)buff[1]) << 8) | buff[0];  // combine into 16 bit values
-        *hy = (((int16_t)buff[3]) << 8) | buff[2];
-        *hz = (((int16_t)buff[5]) << 8) | buff[4];
-    }
-    else{
-        *hx = 0;
-        *hy = 0;
-        *hz = 0;
-    }
+    unpackMag(&buff[0], hx, hy, hz);
 }
 
 /* get magnetometer data given pointers to store the three values */
@@ -455,9 +670,7 @@ void getMag(float* hx, float* hy, float* hz){
 
     getMagCounts(&mag[0], &mag[1], &mag[2]);
 
-    *hx = ((float) mag[0]) * _magScaleX; // typecast and scale to values
-    *hy = ((float) mag[1]) * _magScaleY;
-    *hz = ((float) mag[2]) * _magScaleZ;
+    scaleMag(mag, hx, hy, hz);
 }
 
 /* get temperature data given pointer to store the value, return data as counts */
@@ -509,13 +722,9 @@ void getMotion6(float* ax, float* ay, float* az, float* gx, float* gy, float* gz
 
     getMotion6Counts(&accel[0], &accel[1], &accel[2], &gyro[0], &gyro[1], &gyro[2]);
 
-    *ax = ((float) accel[0]) * _accelScale; // typecast and scale to values
-    *ay = ((float) accel[1]) * _accelScale;
-    *az = ((float) accel[2]) * _accelScale;
+    scaleAccel(accel, ax, ay, az);
 
-    *gx = ((float) gyro[0]) * _gyroScale;
-    *gy = ((float) gyro[1]) * _gyroScale;
-    *gz = ((float) gyro[2]) * _gyroScale;
+    scaleGyro(gyro, gx, gy, gz);
 }
 
 /* get accelerometer, gyro and temperature data given pointers to store values, return data as counts */
@@ -546,19 +755,46 @@ void getMotion7Counts(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int16_
 
 /* get accelerometer, gyro, and temperature data given pointers to store values */
 void getMotion7(float* ax, float* ay, float* az, float* gx, float* gy, float* gz, float* t){
+
+    readRegisters(ACCEL_OUT, 14, &buff[0]); // grab the data from the MPU9250
+
+    unpackMotion7(&buff[0], ax, ay, az, gx, gy, gz, t);
+}
+
+/* accel, temp and gyro counts from a burst read at ACCEL_OUT, axes transformed */
+static void unpackCounts(const uint8_t* raw, int16_t* accel, int16_t* gyro, int16_t* t){
+    int16_t axx, ayy, azz, gxx, gyy, gzz;
+
+    axx = (((int16_t)raw[0]) << 8) | raw[1];  // combine into 16 bit values
+    ayy = (((int16_t)raw[2]) << 8) | raw[3];
+    azz = (((int16_t)raw[4]) << 8) | raw[5];
+
+    *t = (((int16_t)raw[6]) << 8) | raw[7];
+
+    gxx = (((int16_t)raw[8]) << 8) | raw[9];
+    gyy = (((int16_t)raw[10]) << 8) | raw[11];
+    gzz = (((int16_t)raw[12]) << 8) | raw[13];
+
+    accel[0] = tX[0]*axx + tX[1]*ayy + tX[2]*azz; // transform axes
+    accel[1] = tY[0]*axx + tY[1]*ayy + tY[2]*azz;
+    accel[2] = tZ[0]*axx + tZ[1]*ayy + tZ[2]*azz;
+
+    gyro[0] = tX[0]*gxx + tX[1]*gyy + tX[2]*gzz;
+    gyro[1] = tY[0]*gxx + tY[1]*gyy + tY[2]*gzz;
+    gyro[2] = tZ[0]*gxx + tZ[1]*gyy + tZ[2]*gzz;
+}
+
+/* getMotion7() from the 14 bytes at ACCEL_OUT read elsewhere, e.g. by DMA */
+void unpackMotion7(const uint8_t* raw, float* ax, float* ay, float* az, float* gx, float* gy, float* gz, float* t){
     int16_t accel[3];
     int16_t gyro[3];
     int16_t tempCount;
 
-    getMotion7Counts(&accel[0], &accel[1], &accel[2], &gyro[0], &gyro[1], &gyro[2], &tempCount);
+    unpackCounts(raw, accel, gyro, &tempCount);
 
-    *ax = ((float) accel[0]) * _accelScale; // typecast and scale to values
-    *ay = ((float) accel[1]) * _accelScale;
-    *az = ((float) accel[2]) * _accelScale;
+    scaleAccel(accel, ax, ay, az);
 
-    *gx = ((float) gyro[0]) * _gyroScale;
-    *gy = ((float) gyro[1]) * _gyroScale;
-    *gz = ((float) gyro[2]) * _gyroScale;
+    scaleGyro(gyro, gx, gy, gz);
 
     *t = (( ((float) tempCount) - _tempOffset )/_tempScale) + _tempOffset;
 }
@@ -579,9 +815,7 @@ void getMotion9Counts(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int16_
     gyy = (((int16_t)buff[10]) << 8) | buff[11];
     gzz = (((int16_t)buff[12]) << 8) | buff[13];
 
-    *hx = (((int16_t)buff[15]) << 8) | buff[14];
-    *hy = (((int16_t)buff[17]) << 8) | buff[16];
-    *hz = (((int16_t)buff[19]) << 8) | buff[18];
+    unpackMag(&buff[14], hx, hy, hz); // EXT_SENS_DATA_00, HXL..ST2
 
     *ax = tX[0]*axx + tX[1]*ayy + tX[2]*azz; // transform axes
     *ay = tY[0]*axx + tY[1]*ayy + tY[2]*azz;
@@ -600,17 +834,11 @@ void getMotion9(float* ax, float* ay, float* az, float* gx, float* gy, float* gz
 
     getMotion9Counts(&accel[0], &accel[1], &accel[2], &gyro[0], &gyro[1], &gyro[2], &mag[0], &mag[1], &mag[2]);
 
-    *ax = ((float) accel[0]) * _accelScale; // typecast and scale to values
-    *ay = ((float) accel[1]) * _accelScale;
-    *az = ((float) accel[2]) * _accelScale;
+    scaleAccel(accel, ax, ay, az);
 
-    *gx = ((float) gyro[0]) * _gyroScale;
-    *gy = ((float) gyro[1]) * _gyroScale;
-    *gz = ((float) gyro[2]) * _gyroScale;
+    scaleGyro(gyro, gx, gy, gz);
 
-    *hx = ((float) mag[0]) * _magScaleX;
-    *hy = ((float) mag[1]) * _magScaleY;
-    *hz = ((float) mag[2]) * _magScaleZ;
+    scaleMag(mag, hx, hy, hz);
 }
 
 /* get accelerometer, magnetometer, and temperature data given pointers to store values, return data as counts */
@@ -631,9 +859,7 @@ void getMotion10Counts(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int16
     gyy = (((int16_t)buff[10]) << 8) | buff[11];
     gzz = (((int16_t)buff[12]) << 8) | buff[13];
 
-    *hx = (((int16_t)buff[15]) << 8) | buff[14];
-    *hy = (((int16_t)buff[17]) << 8) | buff[16];
-    *hz = (((int16_t)buff[19]) << 8) | buff[18];
+    unpackMag(&buff[14], hx, hy, hz); // EXT_SENS_DATA_00, HXL..ST2
 
     *ax = tX[0]*axx + tX[1]*ayy + tX[2]*azz; // transform axes
     *ay = tY[0]*axx + tY[1]*ayy + tY[2]*azz;
@@ -645,24 +871,27 @@ void getMotion10Counts(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int16
 }
 
 void getMotion10(float* ax, float* ay, float* az, float* gx, float* gy, float* gz, float* hx, float* hy, float* hz, float* t){
+
+    readRegisters(ACCEL_OUT, 21, &buff[0]); // grab the data from the MPU9250
+
+    unpackMotion10(&buff[0], ax, ay, az, gx, gy, gz, hx, hy, hz, t);
+}
+
+/* getMotion10() from the 21 bytes at ACCEL_OUT read elsewhere, e.g. by DMA */
+void unpackMotion10(const uint8_t* raw, float* ax, float* ay, float* az, float* gx, float* gy, float* gz, float* hx, float* hy, float* hz, float* t){
     int16_t accel[3];
     int16_t gyro[3];
     int16_t mag[3];
     int16_t tempCount;
 
-    getMotion10Counts(&accel[0], &accel[1], &accel[2], &gyro[0], &gyro[1], &gyro[2], &mag[0], &mag[1], &mag[2], &tempCount);
+    unpackCounts(raw, accel, gyro, &tempCount);
+    unpackMag(&raw[14], &mag[0], &mag[1], &mag[2]); // EXT_SENS_DATA_00, HXL..ST2
 
-    *ax = ((float) accel[0]) * _accelScale; // typecast and scale to values
-    *ay = ((float) accel[1]) * _accelScale;
-    *az = ((float) accel[2]) * _accelScale;
+    scaleAccel(accel, ax, ay, az);
 
-    *gx = ((float) gyro[0]) * _gyroScale;
-    *gy = ((float) gyro[1]) * _gyroScale;
-    *gz = ((float) gyro[2]) * _gyroScale;
+    scaleGyro(gyro, gx, gy, gz);
 
-    *hx = ((float) mag[0]) * _magScaleX;
-    *hy = ((float) mag[1]) * _magScaleY;
-    *hz = ((float) mag[2]) * _magScaleZ;
+    scaleMag(mag, hx, hy, hz);
 
     *t = (( ((float) tempCount) - _tempOffset )/_tempScale) + _tempOffset;
 }
@@ -675,10 +904,12 @@ uint8_t writeRegister(uint8_t subAddress, uint8_t data){
     /* write data to device */
     if( USE_SPI ){
     	// TODO: Check if this code works
+    	mpuSpiOwned = 1;
     	CS_ON; //    	digitalWriteFast(_csPin,LOW); // select the MPU9250 chip
     	spi_result = MPU_SPI_TX(&subAddress);//HAL_SPI_Transmit_DMA(&hspi1, &subAddress, 1);//		SPI.transfer(subAddress); // write the register address
     	spi_result = MPU_SPI_TX(&data);//HAL_SPI_Transmit_DMA(&hspi1, &data, 1);//		SPI.transfer(data); // write the data
     	CS_OFF;//		digitalWriteFast(_csPin,HIGH); // deselect the MPU9250 chip
+    	mpuSpiOwned = 0;
 
     }
     else{
@@ -711,6 +942,7 @@ void readRegisters(uint8_t subAddress, uint8_t count, uint8_t* dest){
     if( USE_SPI ){
 
     	// TODO: Check if this code works
+    	mpuSpiOwned = 1;
     	CS_ON;//    	digitalWriteFast(_csPin,LOW); // select the MPU9250 chip
 		buff[0] = subAddress | SPI_READ;
 
@@ -723,6 +955,7 @@ void readRegisters(uint8_t subAddress, uint8_t count, uint8_t* dest){
 		//}
 
 		CS_OFF;//		digitalWriteFast(_csPin,HIGH); // deselect the MPU9250 chip
+		mpuSpiOwned = 0;
 
     }
     else{
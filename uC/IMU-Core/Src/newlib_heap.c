@@ -0,0 +1,117 @@
+/*
+ * newlib_heap.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  malloc() and friends for the C library, from a fixed block pool
+ *  instead of the newlib heap (_sbrk into the 512 byte _Min_Heap_Size).
+ *  The one expected caller is the float conversion of printf, whose
+ *  _dtoa_r keeps its big integers, all well under a block, on a free
+ *  list in the reentrancy struct. A request over the block size fails
+ *  and counts as a pool failure; a call from an interrupt is served but
+ *  counted as a pool error, since no interrupt should reach the C
+ *  library's allocator.
+ *
+ *  Defining these keeps newlib's own allocator out of the link;
+ *  "map_report -x mallocr" checks that nothing pulled it in anyway.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "stm32f4xx_hal.h"
+#include "mempool.h"
+
+#define LIBC_BLOCK 128
+#define LIBC_BLOCKS 16
+
+struct _reent;
+
+MEMPOOL_DEFINE(libcPool, LIBC_BLOCK, LIBC_BLOCKS);
+static uint8_t ready = 0;
+
+void* _malloc_r(struct _reent *r, size_t n)
+{
+	(void)r;
+
+	if (!ready)
+	{
+		MEMPOOL_Init(&libcPool);
+		ready = 1;
+	}
+	if (__get_IPSR() != 0)
+	{
+		libcPool.errors++;
+	}
+	if (n > libcPool.blockSize)
+	{
+		libcPool.fails++;
+		return NULL;
+	}
+
+	return MEMPOOL_Alloc(&libcPool);
+}
+
+void _free_r(struct _reent *r, void *p)
+{
+	(void)r;
+
+	if (p)
+	{
+		MEMPOOL_Free(&libcPool, p);
+	}
+}
+
+void* _calloc_r(struct _reent *r, size_t count, size_t size)
+{
+	void *p;
+
+	if (size && count > libcPool.blockSize / size)
+	{
+		libcPool.fails++;
+		return NULL;
+	}
+	p = _malloc_r(r, count * size);
+	if (p)
+	{
+		memset(p, 0, count * size);
+	}
+
+	return p;
+}
+
+void* _realloc_r(struct _reent *r, void *p, size_t n)
+{
+	if (!p)
+	{
+		return _malloc_r(r, n);
+	}
+	/* every block is full size already */
+	if (n > libcPool.blockSize)
+	{
+		libcPool.fails++;
+		return NULL;
+	}
+
+	return p;
+}
+
+void* malloc(size_t n)
+{
+	return _malloc_r(NULL, n);
+}
+
+void free(void *p)
+{
+	_free_r(NULL, p);
+}
+
+void* calloc(size_t count, size_t size)
+{
+	return _calloc_r(NULL, count, size);
+}
+
+void* realloc(void *p, size_t n)
+{
+	return _realloc_r(NULL, p, n);
+}
@@ -0,0 +1,280 @@
+/*
+ * pdr.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  The SHOE statistic over a window of W samples
+ *
+ *    T = 1/W sum( |a_k - g a_mean/|a_mean||^2 / sa^2 + |w_k|^2 / sg^2 )
+ *
+ *  expands to (S_aa - 2 g |S_a| + W g^2) / sa^2 + S_ww / sg^2 with the
+ *  window sums S_a = sum a_k, S_aa = sum |a_k|^2, S_ww = sum |w_k|^2, so it
+ *  is kept up to date in O(1) by adding the new sample and subtracting the
+ *  one leaving the window. To stop float rounding from piling up in the
+ *  running sums, a second set of sums is built from scratch over each
+ *  pass of the ring and replaces the running one when the ring wraps.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "pdr.h"
+#include "ccm.h"
+#include "eskf.h"
+#include "dwt_delay.h"
+#include "print.h"
+
+/* one sample of the window, or the sums over it */
+typedef struct
+{
+	float a[3];
+	float aa;
+	float ww;
+} window_sample_t;
+
+static pdr_config_t config = { 100.0f, 5, 5, 0.02f, 0.002f, 3e4f, 1e-4f };
+
+static CCM_BSS window_sample_t ring[PDR_MAX_WINDOW];
+static window_sample_t sums, fresh;
+static uint32_t pos, filled;
+
+static uint32_t stanceRun;
+static uint8_t inStance;
+static float stanceP[3];
+static uint32_t stanceSample;
+
+static pdr_step_t steps[PDR_STEP_QUEUE];
+static volatile uint32_t stepHead, stepTail;
+
+static pdr_stats_t stats;
+static pdr_step_callback stepCallback = NULL;
+static volatile uint8_t resetPending;
+
+/* detector and totals; the step queue belongs to both sides and is left to PDR_Reset() */
+static void reset_detector(void)
+{
+	memset(ring, 0, sizeof(ring));
+	memset(&sums, 0, sizeof(sums));
+	memset(&fresh, 0, sizeof(fresh));
+	pos = 0;
+	filled = 0;
+
+	stanceRun = 0;
+	inStance = 0;
+	stanceSample = 0;
+	memset(stanceP, 0, sizeof(stanceP));
+
+	memset(&stats, 0, sizeof(stats));
+}
+
+void PDR_Reset(void)
+{
+	reset_detector();
+	stepHead = 0;
+	stepTail = 0;
+	resetPending = 0;
+}
+
+void PDR_Init(const pdr_config_t *cfg)
+{
+	config = *cfg;
+	if (config.window == 0 || config.window > PDR_MAX_WINDOW)
+	{
+		config.window = PDR_MAX_WINDOW;
+	}
+	PDR_Reset();
+}
+
+static float statistic(float ax, float ay, float az, float ww)
+{
+	window_sample_t *old = &ring[pos];
+	float W = (float)config.window;
+	float aa = ax * ax + ay * ay + az * az;
+	float norm, t;
+
+	/* slide: drop the oldest sample, add the new one */
+	sums.a[0] += ax - old->a[0];
+	sums.a[1] += ay - old->a[1];
+	sums.a[2] += az - old->a[2];
+	sums.aa += aa - old->aa;
+	sums.ww += ww - old->ww;
+
+	old->a[0] = ax;
+	old->a[1] = ay;
+	old->a[2] = az;
+	old->aa = aa;
+	old->ww = ww;
+
+	fresh.a[0] += ax;
+	fresh.a[1] += ay;
+	fresh.a[2] += az;
+	fresh.aa += aa;
+	fresh.ww += ww;
+
+	if (++pos == config.window)
+	{
+		/* fresh holds exactly the current window now */
+		pos = 0;
+		sums = fresh;
+		memset(&fresh, 0, sizeof(fresh));
+	}
+
+	if (filled < config.window)
+	{
+		filled++;
+		return INFINITY;
+	}
+
+	norm = sqrtf(sums.a[0] * sums.a[0] + sums.a[1] * sums.a[1] + sums.a[2] * sums.a[2]);
+	t = (sums.aa - 2.0f * ESKF_GRAVITY * norm + W * ESKF_GRAVITY * ESKF_GRAVITY) / (config.sigmaAccel * config.sigmaAccel)
+			+ sums.ww / (config.sigmaGyro * config.sigmaGyro);
+
+	return t / W;
+}
+
+static void push_step(const float p[3])
+{
+	pdr_step_t *s;
+	uint32_t next = (stepHead + 1) % PDR_STEP_QUEUE;
+
+	stats.steps++;
+
+	if (next == stepTail)
+	{
+		stats.droppedSteps++;
+		return;
+	}
+
+	s = &steps[stepHead];
+	s->index = stats.steps;
+	s->endSample = stats.samples;
+	s->duration = (stats.samples - stanceSample) / config.sampleHz;
+	s->dp[0] = p[0] - stanceP[0];
+	s->dp[1] = p[1] - stanceP[1];
+	s->dp[2] = p[2] - stanceP[2];
+	s->length = sqrtf(s->dp[0] * s->dp[0] + s->dp[1] * s->dp[1]);
+	s->heading = atan2f(s->dp[1], s->dp[0]);
+
+	stats.distance += s->length;
+	stepHead = next;
+}
+
+uint8_t PDR_Update(float gx, float gy, float gz, float ax, float ay, float az)
+{
+	static const uint8_t velIdx[3] = { ESKF_VEL, ESKF_VEL + 1, ESKF_VEL + 2 };
+	uint32_t start = DWT_Get(), cycles;
+	const eskf_state_t *x = ESKF_State();
+	float t;
+	uint8_t stance;
+
+	if (resetPending)
+	{
+		reset_detector();
+		resetPending = 0;
+	}
+
+	t = statistic(ax, ay, az, gx * gx + gy * gy + gz * gz);
+	stance = t < config.threshold;
+
+	stats.samples++;
+	stats.lastStatistic = t;
+
+	if (stance)
+	{
+		float y[3] = { -x->v[0], -x->v[1], -x->v[2] };
+		float r[3] = { config.zuptVar, config.zuptVar, config.zuptVar };
+
+		stats.stanceSamples++;
+		if (ESKF_UpdateSelect(velIdx, y, r, 3) != 0)
+		{
+			stats.zuptRejected++;
+		}
+
+		/* a stance is confirmed after minStance samples; the swing before it was a step */
+		if (++stanceRun == config.minStance)
+		{
+			if (stanceSample != 0)
+			{
+				push_step(x->p);
+			}
+			memcpy(stanceP, x->p, sizeof(stanceP));
+			stanceSample = stats.samples;
+			inStance = 1;
+		}
+	}
+	else
+	{
+		stanceRun = 0;
+		inStance = 0;
+	}
+
+	cycles = DWT_Get() - start;
+	if (cycles > stats.maxCycles)
+	{
+		stats.maxCycles = cycles;
+	}
+
+	return stance;
+}
+
+int32_t PDR_PopStep(pdr_step_t *step)
+{
+	if (stepTail == stepHead)
+	{
+		return -1;
+	}
+
+	*step = steps[stepTail];
+	stepTail = (stepTail + 1) % PDR_STEP_QUEUE;
+
+	return 0;
+}
+
+void PDR_Poll(void)
+{
+	char line[96];
+	pdr_step_t step;
+
+	while (PDR_PopStep(&step) == 0)
+	{
+		snprintf(line, sizeof(line), "STEP %lu len=%.3f hdg=%.1f dz=%.3f dur=%.2f\n", (unsigned long)step.index,
+				step.length, step.heading * 57.29578f, step.dp[2], step.duration);
+		print_str(line);
+
+		if (stepCallback)
+		{
+			stepCallback(&step);
+		}
+	}
+}
+
+void PDR_SetStepCallback(pdr_step_callback cb)
+{
+	stepCallback = cb;
+}
+
+const pdr_stats_t* PDR_Stats(void)
+{
+	return &stats;
+}
+
+/* "pdr" prints detector and step totals, "pdr reset" clears them at the next sample */
+void PDR_Command(const char *args)
+{
+	char line[160];
+
+	if (strncmp(args, "reset", 5) == 0)
+	{
+		/* PDR_Update() owns the detector state, it runs in PendSV */
+		resetPending = 1;
+		print_str("PDR reset\n");
+		return;
+	}
+
+	snprintf(line, sizeof(line), "PDR n=%lu stance=%lu %s T=%.0f steps=%lu dropped=%lu dist=%.2f m rej=%lu cyc max=%lu\n",
+			(unsigned long)stats.samples, (unsigned long)stats.stanceSamples, inStance ? "STANCE" : "swing",
+			stats.lastStatistic, (unsigned long)stats.steps, (unsigned long)stats.droppedSteps, stats.distance,
+			(unsigned long)stats.zuptRejected, (unsigned long)stats.maxCycles);
+	print_str(line);
+}
@@ -0,0 +1,506 @@
+/*
+ * pf.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Heading offsets stay small: the weighted mean offset is moved into a
+ *  filter wide reference whenever it grows, so the per particle rotation
+ *  uses short sin/cos polynomials instead of sinf/cosf. Gaussian noise is
+ *  the sum of the four bytes of one xorshift word (Irwin-Hall, n = 4).
+ *
+ *  Resampling is systematic and in place: the first pass counts the
+ *  copies of every particle, the second copies the ones drawn more than
+ *  once into the slots of those not drawn, so no second particle set is
+ *  needed.
+ */
+
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "pf.h"
+#include "ccm.h"
+#include "fatfs.h"
+#include "dwt_delay.h"
+#include "print.h"
+
+#if PF_USE_CCM
+#define PF_STORAGE CCM_BSS
+#else
+#define PF_STORAGE
+#endif
+
+/* fold the mean heading offset into the reference beyond this, rad */
+#define FOLD_HEADING 0.1f
+#define MAX_OFFSET 0.6f
+/* likelihood floor, in sigma^2 of the range residual */
+#define MAX_RANGE_Q 16.0f
+
+static PF_STORAGE float px[PF_MAX_PARTICLES];
+static PF_STORAGE float py[PF_MAX_PARTICLES];
+static PF_STORAGE float pd[PF_MAX_PARTICLES];
+static PF_STORAGE float pw[PF_MAX_PARTICLES];
+static PF_STORAGE uint16_t copies[PF_MAX_PARTICLES];
+
+static pf_config_t config = { 1024, 0.1f, 0.01f, 0.1f, 0.5f, 1.0f, 1 };
+static pf_map_t map;
+static uint8_t haveMap = 0;
+/* the loaded map file, SRAM: the card driver may DMA into it */
+static uint8_t mapFile[PF_MAP_BYTES];
+static float invCell;
+static uint32_t stride;
+
+static uint32_t rng = 1;
+static float base;			/* heading reference added to every offset */
+static pf_estimate_t est;
+static pf_stats_t stats;
+
+static inline uint32_t xorshift(void)
+{
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+	return rng;
+}
+
+/* zero mean, unit variance, |g| < 3.5 */
+static inline float gauss(void)
+{
+	uint32_t r = xorshift();
+	uint32_t s = (r & 0xFF) + ((r >> 8) & 0xFF) + ((r >> 16) & 0xFF) + (r >> 24);
+
+	return ((float)s - 510.0f) * (1.0f / 147.8f);
+}
+
+static inline float uniform(void)
+{
+	return (xorshift() >> 8) * (1.0f / 16777216.0f);
+}
+
+static inline uint8_t wall(float x, float y)
+{
+	float fx = (x - map.x0) * invCell, fy = (y - map.y0) * invCell;
+	uint32_t cx, cy;
+
+	/* also catches NaN */
+	if (!(fx >= 0.0f && fy >= 0.0f && fx < map.width && fy < map.height))
+	{
+		return 1;
+	}
+	cx = (uint32_t)fx;
+	cy = (uint32_t)fy;
+
+	return (map.bits[cy * stride + (cx >> 3)] >> (7 - (cx & 7))) & 1;
+}
+
+/* samples the segment at most every half cell */
+static uint8_t crosses(float x0, float y0, float x1, float y1)
+{
+	float dx = x1 - x0, dy = y1 - y0;
+	uint32_t n = (uint32_t)(2.0f * (fabsf(dx) + fabsf(dy)) * invCell) + 1, k;
+	float step = 1.0f / n;
+
+	dx *= step;
+	dy *= step;
+	for (k = 1; k <= n; k++)
+	{
+		if (wall(x0 + k * dx, y0 + k * dy))
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static inline void account(uint32_t start, uint32_t *max)
+{
+	uint32_t cycles = DWT_Get() - start;
+
+	if (cycles > *max)
+	{
+		*max = cycles;
+	}
+}
+
+void PF_Init(const pf_config_t *cfg)
+{
+	config = *cfg;
+	if (config.particles == 0 || config.particles > PF_MAX_PARTICLES)
+	{
+		config.particles = PF_MAX_PARTICLES;
+	}
+	rng = config.seed ? config.seed : 1;
+	memset(&stats, 0, sizeof(stats));
+	PF_Reset(0.0f, 0.0f, 0.5f);
+}
+
+void PF_SetMap(const pf_map_t *m)
+{
+	if (m)
+	{
+		map = *m;
+		invCell = 1.0f / map.cell;
+		stride = (map.width + 7) >> 3;
+	}
+	haveMap = (m != NULL);
+}
+
+int32_t PF_ParseMap(const uint8_t *pbm, uint32_t len, pf_map_t *m)
+{
+	const uint8_t *p = pbm + 2, *end = pbm + len;
+	uint32_t v[2] = { 0, 0 }, n = 0, k;
+	char comment[48];
+	float cell, x0, y0;
+
+	m->cell = 0.1f;
+	m->x0 = 0.0f;
+	m->y0 = 0.0f;
+
+	if (len < 2 || pbm[0] != 'P' || pbm[1] != '4')
+	{
+		return -1;
+	}
+
+	/* width and height, with comments and white space between the fields */
+	while (n < 2)
+	{
+		while (p < end && isspace(*p))
+		{
+			p++;
+		}
+		if (p < end && *p == '#')
+		{
+			for (k = 0; p < end && *p != '\n'; p++)
+			{
+				if (k < sizeof(comment) - 1)
+				{
+					comment[k++] = (char)*p;
+				}
+			}
+			comment[k] = 0;
+			if (sscanf(comment, "# pf %f %f %f", &cell, &x0, &y0) == 3 && cell > 0.0f)
+			{
+				m->cell = cell;
+				m->x0 = x0;
+				m->y0 = y0;
+			}
+			continue;
+		}
+		if (p >= end || !isdigit(*p))
+		{
+			return -1;
+		}
+		for (; p < end && isdigit(*p) && v[n] <= 0xFFFF; p++)
+		{
+			v[n] = v[n] * 10 + (*p - '0');
+		}
+		n++;
+	}
+
+	/* one white space character, then the rows */
+	if (p >= end || !isspace(*p) || v[0] == 0 || v[1] == 0 || v[0] > 0xFFFF || v[1] > 0xFFFF
+			|| (uint32_t)(end - p - 1) < ((v[0] + 7) >> 3) * v[1])
+	{
+		return -1;
+	}
+	m->width = (uint16_t)v[0];
+	m->height = (uint16_t)v[1];
+	m->bits = p + 1;
+
+	return 0;
+}
+
+int32_t PF_LoadMap(const char *path)
+{
+	static FIL f;
+	pf_map_t m;
+	UINT n;
+	FRESULT res;
+
+	/* the file goes where the current map's bits are */
+	PF_SetMap(NULL);
+
+	if (FATFS_Mount() != FR_OK || f_open(&f, path, FA_READ) != FR_OK)
+	{
+		return -1;
+	}
+	if (f_size(&f) > sizeof(mapFile))
+	{
+		f_close(&f);
+		return -2;
+	}
+	res = f_read(&f, mapFile, sizeof(mapFile), &n);
+	f_close(&f);
+	if (res != FR_OK)
+	{
+		return -1;
+	}
+	if (PF_ParseMap(mapFile, n, &m) != 0)
+	{
+		return -3;
+	}
+	PF_SetMap(&m);
+
+	return 0;
+}
+
+static void spread(float x, float y, float sigma, float heading)
+{
+	uint32_t i, n = config.particles, k;
+	float w = 1.0f / n;
+
+	for (i = 0; i < n; i++)
+	{
+		/* a few tries to land outside the walls, weight 0 if not */
+		for (k = 0; k < 8; k++)
+		{
+			px[i] = x + sigma * gauss();
+			py[i] = y + sigma * gauss();
+			if (!haveMap || !wall(px[i], py[i]))
+			{
+				break;
+			}
+		}
+		pd[i] = heading + config.initHeadingSigma * gauss();
+		pw[i] = (k < 8) ? w : 0.0f;
+	}
+
+	est.x = x;
+	est.y = y;
+	est.sx = sigma;
+	est.sy = sigma;
+	est.neff = (float)n;
+}
+
+void PF_Reset(float x, float y, float sigma)
+{
+	base = 0.0f;
+	spread(x, y, sigma, 0.0f);
+	est.heading = 0.0f;
+}
+
+static void resample(void)
+{
+	uint32_t start = DWT_Get();
+	uint32_t n = config.particles, i, j, k, total = 0, best = 0;
+	float step = 1.0f / n, u = uniform() * step, c = 0.0f;
+
+	for (i = 0; i < n; i++)
+	{
+		c += pw[i];
+		for (k = 0; u < c && total + k < n; k++)
+		{
+			u += step;
+		}
+		copies[i] = k;
+		total += k;
+		if (pw[i] > pw[best])
+		{
+			best = i;
+		}
+	}
+	/* rounding in the running sum can leave the last draws out */
+	copies[best] += n - total;
+
+	for (i = 0, j = 0; i < n; i++)
+	{
+		while (copies[i] > 1)
+		{
+			while (copies[j] != 0)
+			{
+				j++;
+			}
+			px[j] = px[i];
+			py[j] = py[i];
+			pd[j] = pd[i];
+			copies[j] = 1;
+			copies[i]--;
+		}
+	}
+
+	for (i = 0; i < n; i++)
+	{
+		pw[i] = step;
+	}
+
+	stats.resamples++;
+	account(start, &stats.maxResampleCycles);
+}
+
+/* normalises the weights, updates the estimate and resamples if needed */
+static void normalise(void)
+{
+	uint32_t n = config.particles, i;
+	float s = 0.0f, inv, sx = 0.0f, sy = 0.0f, sxx = 0.0f, syy = 0.0f, sd = 0.0f, sww = 0.0f;
+
+	for (i = 0; i < n; i++)
+	{
+		s += pw[i];
+	}
+
+	if (!(s > 1e-30f))
+	{
+		/* nothing survived, start over around the last estimate */
+		stats.depletions++;
+		spread(est.x, est.y, fmaxf(2.0f * fmaxf(est.sx, est.sy), 1.0f), 0.0f);
+		return;
+	}
+
+	inv = 1.0f / s;
+	for (i = 0; i < n; i++)
+	{
+		float w = pw[i] * inv;
+
+		pw[i] = w;
+		sx += w * px[i];
+		sy += w * py[i];
+		sxx += w * px[i] * px[i];
+		syy += w * py[i] * py[i];
+		sd += w * pd[i];
+		sww += w * w;
+	}
+
+	est.x = sx;
+	est.y = sy;
+	est.sx = sqrtf(fmaxf(sxx - sx * sx, 0.0f));
+	est.sy = sqrtf(fmaxf(syy - sy * sy, 0.0f));
+	est.neff = 1.0f / sww;
+
+	if (fabsf(sd) > FOLD_HEADING)
+	{
+		for (i = 0; i < n; i++)
+		{
+			pd[i] -= sd;
+		}
+		base += sd;
+		sd = 0.0f;
+	}
+	est.heading = base + sd;
+
+	if (est.neff < config.resampleRatio * n)
+	{
+		resample();
+	}
+}
+
+void PF_Step(float length, float heading)
+{
+	uint32_t start = DWT_Get();
+	uint32_t n = config.particles, i, hits = 0;
+	float ch = cosf(heading + base), sh = sinf(heading + base);
+
+	for (i = 0; i < n; i++)
+	{
+		float d = pd[i] + config.headingSigma * gauss();
+		float d2, cd, sd, L, x, y;
+
+		d = fminf(fmaxf(d, -MAX_OFFSET), MAX_OFFSET);
+		d2 = d * d;
+		cd = 1.0f - d2 * (0.5f - d2 * (1.0f / 24.0f));
+		sd = d * (1.0f - d2 * (1.0f / 6.0f));
+		L = length * (1.0f + config.stepSigma * gauss());
+
+		x = px[i] + L * (ch * cd - sh * sd);
+		y = py[i] + L * (sh * cd + ch * sd);
+
+		if (haveMap && pw[i] > 0.0f && crosses(px[i], py[i], x, y))
+		{
+			pw[i] = 0.0f;
+			hits++;
+		}
+		px[i] = x;
+		py[i] = y;
+		pd[i] = d;
+	}
+
+	stats.steps++;
+	stats.lastWallHits = hits;
+	normalise();
+	account(start, &stats.maxStepCycles);
+}
+
+void PF_Range(const float b[3], float range, float var)
+{
+	uint32_t start = DWT_Get();
+	uint32_t n = config.particles, i;
+	float dz = b[2] - config.height, dz2 = dz * dz, k = 1.0f / var;
+
+	for (i = 0; i < n; i++)
+	{
+		float dx = px[i] - b[0], dy = py[i] - b[1];
+		float e = sqrtf(dx * dx + dy * dy + dz2) - range;
+		float q = fminf(e * e * k, MAX_RANGE_Q);
+
+		pw[i] *= expf(-0.5f * q);
+	}
+
+	stats.ranges++;
+	normalise();
+	account(start, &stats.maxRangeCycles);
+}
+
+void PF_OnStep(const pdr_step_t *step)
+{
+	PF_Step(step->length, step->heading);
+}
+
+void PF_OnRange(const float b[3], float range, float var)
+{
+	PF_Range(b, range, var);
+}
+
+const pf_estimate_t* PF_Estimate(void)
+{
+	return &est;
+}
+
+const pf_stats_t* PF_Stats(void)
+{
+	return &stats;
+}
+
+/* "pf" prints the estimate and counters, "pf reset <x> <y> <sigma>" respreads the particles,
+ * "pf map [file]" loads the walls, PF_MAP_FILE by default, "pf map off" drops them */
+void PF_Command(const char *args)
+{
+	char line[160], path[32];
+	float x, y, s;
+	int32_t res;
+
+	if (sscanf(args, "reset %f %f %f", &x, &y, &s) == 3)
+	{
+		PF_Reset(x, y, s);
+		print_str("PF reset\n");
+		return;
+	}
+	if (strncmp(args, "map", 3) == 0)
+	{
+		if (sscanf(args + 3, "%31s", path) != 1)
+		{
+			strcpy(path, PF_MAP_FILE);
+		}
+		if (strcmp(path, "off") == 0)
+		{
+			PF_SetMap(NULL);
+			print_str("PF map off\n");
+			return;
+		}
+		res = PF_LoadMap(path);
+		snprintf(line, sizeof(line), "PF map %s result=%ld %ux%u cell=%.2f at %.2f %.2f\n", path, (long)res,
+				haveMap ? map.width : 0, haveMap ? map.height : 0, map.cell, map.x0, map.y0);
+		print_str(line);
+		return;
+	}
+
+	snprintf(line, sizeof(line), "PF n=%u x=%.2f y=%.2f sd=%.2f %.2f hdg=%.1f neff=%.0f map=%u\n",
+			config.particles, est.x, est.y, est.sx, est.sy, est.heading * 57.29578f, est.neff, haveMap);
+	print_str(line);
+
+	snprintf(line, sizeof(line), "PF steps=%lu ranges=%lu resamples=%lu depleted=%lu hits=%lu cyc step=%lu range=%lu resample=%lu\n",
+			(unsigned long)stats.steps, (unsigned long)stats.ranges, (unsigned long)stats.resamples,
+			(unsigned long)stats.depletions, (unsigned long)stats.lastWallHits, (unsigned long)stats.maxStepCycles,
+			(unsigned long)stats.maxRangeCycles, (unsigned long)stats.maxResampleCycles);
+	print_str(line);
+}
@@ -0,0 +1,333 @@
+/*
+ * pipeline.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Both queues are ring.h single producer rings filled in place: the
+ *  DMA completion reserves the raw slot, PendSV the output slot, and
+ *  each is committed once written.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "stm32f4xx_hal.h"
+#include "main.h"
+#include "spi.h"
+#include "mpu9250.h"
+#include "dwt_delay.h"
+#include "print.h"
+#include "pipeline.h"
+#include "ccm.h"
+#include "ring.h"
+#include "prof.h"
+#include "ahrs.h"
+#include "eskf.h"
+#include "ins.h"
+#include "pdr.h"
+#include "beacon.h"
+#include "thermal.h"
+#include "imu_q15.h"
+#include "decim.h"
+#include "spectrum.h"
+#include "power.h"
+#include "log_session.h"
+
+#if IMU_MAG && !IMU_OVERSAMPLE && !IMU_Q15_PIPELINE
+#define PIPE_READ_LEN 21		/* ACCEL_OUT .. EXT_SENS_DATA_06 */
+#else
+#define PIPE_READ_LEN 14		/* ACCEL_OUT .. GYRO_ZOUT_L */
+#endif
+
+typedef struct
+{
+	uint32_t tick;
+	uint32_t stamp;			/* DWT at the timer */
+	uint32_t done;			/* DWT at the DMA completion */
+	uint8_t data[PIPE_READ_LEN];
+} pipe_raw_t;
+
+typedef struct
+{
+	uint32_t tick;
+	uint32_t stamp;
+	float ax, ay, az, gx, gy, gz, t;
+} pipe_out_t;
+
+static CCM_BSS pipe_raw_t raw[PIPE_RAW_QUEUE];
+static CCM_BSS pipe_out_t out[PIPE_OUT_QUEUE];
+static ring_t rawRing, outRing;
+
+/* DMA buffers, register address then the burst; not in CCM, which DMA cannot reach */
+static uint8_t txBuf[PIPE_READ_LEN + 1] = { ACCEL_OUT | 0x80 };
+static uint8_t rxBuf[PIPE_READ_LEN + 1];
+static volatile uint8_t reading;
+static uint32_t readTick, readStamp;
+
+static pipe_stats_t stats;
+
+static void timing(pipe_stage s, uint32_t cycles)
+{
+	pipe_timing_t *t = &stats.stage[s];
+
+	t->last = cycles;
+	t->sum += cycles;
+	t->count++;
+	if (cycles > t->max)
+	{
+		t->max = cycles;
+	}
+}
+
+void PIPE_Init(void)
+{
+	RING_Init(&rawRing, raw, PIPE_RAW_QUEUE, sizeof(raw[0]));
+	RING_Init(&outRing, out, PIPE_OUT_QUEUE, sizeof(out[0]));
+	reading = 0;
+	memset(&stats, 0, sizeof(stats));
+
+	/* below every peripheral interrupt */
+	HAL_NVIC_SetPriority(PendSV_IRQn, 15, 0);
+}
+
+/* raw slot for the producer, NULL when the queue is full */
+static pipe_raw_t* raw_reserve(void)
+{
+	pipe_raw_t *r = RING_Reserve(&rawRing);
+
+	if (!r)
+	{
+		stats.rawDrops++;
+	}
+	return r;
+}
+
+static void raw_commit(void)
+{
+	RING_Commit(&rawRing);
+	SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+}
+
+void PIPE_Tick(void)
+{
+	stats.ticks++;
+
+#if IMU_OVERSAMPLE
+	pipe_raw_t *r = raw_reserve();
+
+	if (r)
+	{
+		r->tick = HAL_GetTick();
+		r->stamp = DWT_Get();
+		r->done = r->stamp;
+		raw_commit();
+	}
+#else
+	/* a register access in a lower priority context owns the bus, so only skip; the other way round,
+	 * callers must stop TIM6 and wait for PIPE_Busy() before touching the sensor (power_port.c) */
+	if (reading || mpuSpiOwned || hspi1.State != HAL_SPI_STATE_READY)
+	{
+		stats.busy++;
+		return;
+	}
+
+	readTick = HAL_GetTick();
+	readStamp = DWT_Get();
+	reading = 1;
+	CS_ON;
+	if (HAL_SPI_TransmitReceive_DMA(&hspi1, txBuf, rxBuf, PIPE_READ_LEN + 1) != HAL_OK)
+	{
+		CS_OFF;
+		reading = 0;
+		stats.dmaErrors++;
+	}
+#endif
+}
+
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+	uint32_t now = DWT_Get();
+	pipe_raw_t *r;
+
+	if (hspi != &hspi1 || !reading)
+	{
+		return;
+	}
+	CS_OFF;
+	timing(PIPE_READ, now - readStamp);
+
+	r = raw_reserve();
+	if (r)
+	{
+		r->tick = readTick;
+		r->stamp = readStamp;
+		r->done = now;
+		memcpy(r->data, &rxBuf[1], PIPE_READ_LEN);
+		raw_commit();
+	}
+	reading = 0;
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+	if (hspi == &hspi1 && reading)
+	{
+		CS_OFF;
+		reading = 0;
+		stats.dmaErrors++;
+	}
+}
+
+void PIPE_Process(void)
+{
+	float ax, ay, az, gx, gy, gz, t;
+#if IMU_MAG && !IMU_OVERSAMPLE && !IMU_Q15_PIPELINE
+	float hx, hy, hz;
+#endif
+	uint32_t start;
+	pipe_raw_t *r;
+	pipe_out_t *o;
+
+	while ((r = RING_Peek(&rawRing)) != NULL)
+	{
+		start = DWT_Get();
+		timing(PIPE_WAIT, start - r->done);
+
+#if IMU_OVERSAMPLE
+		if (DECIM_Read(&ax, &ay, &az, &gx, &gy, &gz, &t) != 0)
+		{
+			/* FIFO drained, no output sample due yet */
+			RING_Release(&rawRing, 1);
+			continue;
+		}
+#elif IMU_Q15_PIPELINE
+		IMUQ_Convert(r->data, &ax, &ay, &az, &gx, &gy, &gz, &t);
+#elif IMU_MAG
+		unpackMotion10(r->data, &ax, &ay, &az, &gx, &gy, &gz, &hx, &hy, &hz, &t);
+#else
+		unpackMotion7(r->data, &ax, &ay, &az, &gx, &gy, &gz, &t);
+#endif
+
+		/* the stamps are all that is still needed from the slot */
+		o = RING_Reserve(&outRing);
+		if (o)
+		{
+			o->tick = r->tick;
+			o->stamp = r->stamp;
+		}
+		else
+		{
+			stats.outDrops++;
+		}
+		RING_Release(&rawRing, 1);
+
+		PROF_BEGIN(PROF_THERMAL);
+		THERMAL_Apply(&ax, &ay, &az, &gx, &gy, &gz, t);
+		PROF_END(PROF_THERMAL);
+
+		PROF_BEGIN(PROF_AHRS);
+#if IMU_MAG && !IMU_OVERSAMPLE && !IMU_Q15_PIPELINE
+		/* zeros on overflow fall back to the 6 axis update, as does a magnetometer that did not start */
+		if (getMagInit() == 0)
+		{
+			AHRS_Update9(gx, gy, gz, ax, ay, az, hx, hy, hz);
+		}
+		else
+		{
+			AHRS_Update6(gx, gy, gz, ax, ay, az);
+		}
+#else
+		AHRS_Update6(gx, gy, gz, ax, ay, az);
+#endif
+		PROF_END(PROF_AHRS);
+		PROF_BEGIN(PROF_ESKF);
+		ESKF_Predict(gx, gy, gz, ax, ay, az, 1.0f / IMU_SAMPLE_HZ);
+		PROF_END(PROF_ESKF);
+		PROF_BEGIN(PROF_PDR);
+		PDR_Update(gx, gy, gz, ax, ay, az);
+		PROF_END(PROF_PDR);
+		PROF_BEGIN(PROF_BEACON);
+		BEACON_Fuse();
+		PROF_END(PROF_BEACON);
+		PROF_BEGIN(PROF_INS);
+		INS_AddSample(gx, gy, gz, ax, ay, az);
+		PROF_END(PROF_INS);
+		PROF_BEGIN(PROF_SPEC);
+		SPEC_AddSample(ax, ay, az);
+		PROF_END(PROF_SPEC);
+		PROF_BEGIN(PROF_POWER);
+		POWER_AddSample(gx, gy, gz, ax, ay, az);
+		PROF_END(PROF_POWER);
+		stats.samples++;
+
+		if (o)
+		{
+			o->ax = ax;
+			o->ay = ay;
+			o->az = az;
+			o->gx = gx;
+			o->gy = gy;
+			o->gz = gz;
+			o->t = t;
+			RING_Commit(&outRing);
+		}
+		timing(PIPE_PROCESS, DWT_Get() - start);
+	}
+}
+
+void PIPE_Poll(void)
+{
+	const pipe_out_t *o;
+	uint32_t start, end;
+
+	while ((o = RING_Peek(&outRing)) != NULL)
+	{
+		start = DWT_Get();
+		print_motion7(o->tick, o->ax, o->ay, o->az, o->gx, o->gy, o->gz, o->t);
+		/* nothing without an open session */
+		LOG_Write(o, sizeof(*o));
+		end = DWT_Get();
+		timing(PIPE_OUTPUT, end - start);
+		timing(PIPE_TOTAL, end - o->stamp);
+		RING_Release(&outRing, 1);
+	}
+}
+
+uint8_t PIPE_Busy(void)
+{
+	return reading || RING_Count(&rawRing) != 0 || (SCB->ICSR & SCB_ICSR_PENDSVSET_Msk) != 0;
+}
+
+const pipe_stats_t* PIPE_Stats(void)
+{
+	return &stats;
+}
+
+/* "pipe" prints the stage times in us (last, mean, max) and the counters, "pipe reset" */
+void PIPE_Command(const char *args)
+{
+	static const char *names[PIPE_STAGES] = { "read", "wait", "process", "output", "total" };
+	const float us = 1e6f / (float)SystemCoreClock;
+	char line[120];
+	uint32_t i;
+
+	if (strncmp(args, "reset", 5) == 0)
+	{
+		/* the counters are written from three priorities, a torn first sample does not matter */
+		memset(&stats, 0, sizeof(stats));
+		return;
+	}
+
+	snprintf(line, sizeof(line), "PIPE ticks=%lu samples=%lu busy=%lu dma err=%lu drops raw=%lu out=%lu\n",
+			(unsigned long)stats.ticks, (unsigned long)stats.samples, (unsigned long)stats.busy,
+			(unsigned long)stats.dmaErrors, (unsigned long)stats.rawDrops, (unsigned long)stats.outDrops);
+	print_str(line);
+	for (i = 0; i < PIPE_STAGES; i++)
+	{
+		const pipe_timing_t *t = &stats.stage[i];
+
+		snprintf(line, sizeof(line), "PIPE %-7s us last=%.1f mean=%.1f max=%.1f n=%lu\n", names[i], t->last * us,
+				t->count ? (float)t->sum / t->count * us : 0.0f, t->max * us, (unsigned long)t->count);
+		print_str(line);
+	}
+}
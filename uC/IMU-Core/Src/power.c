@@ -0,0 +1,246 @@
+/*
+ * power.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  The still count, the wake latency and the false wake flag belong to
+ *  the IMU interrupt; the state, its time and all sensor and timer
+ *  changes belong to the main loop, which only touches the sensor with
+ *  the sample timer stopped.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "power.h"
+#include "print.h"
+
+#define POWER_G 9.807f
+
+static power_config_t config;
+static volatile uint8_t state = POWER_ACTIVE;
+static uint32_t since;
+static float tickUs;
+static power_stats_t stats;
+
+/* interrupt side */
+static volatile uint32_t still;
+static uint32_t stillSamples;
+static volatile uint8_t moved;
+static volatile uint8_t timing;
+
+/* set by the INT pulse */
+static volatile uint8_t motion;
+static volatile uint32_t motionTicks;
+
+static void account(uint8_t next)
+{
+	uint32_t now = POWER_PortTicks();
+
+	stats.us[state] += (uint64_t)((float)(now - since) * tickUs);
+	since = now;
+	state = next;
+}
+
+void POWER_Init(const power_config_t *cfg)
+{
+	config = *cfg;
+	stillSamples = (uint32_t)(cfg->stillSeconds * cfg->sampleHz);
+
+	POWER_PortInit();
+	tickUs = POWER_PortTickUs();
+
+	memset(&stats, 0, sizeof(stats));
+	stats.latencyMinUs = UINT32_MAX;
+	state = POWER_ACTIVE;
+	since = POWER_PortTicks();
+	still = 0;
+	timing = 0;
+}
+
+void POWER_Enable(uint8_t on)
+{
+	config.enable = on;
+	still = 0;
+}
+
+void POWER_AddSample(float gx, float gy, float gz, float ax, float ay, float az)
+{
+	float w2 = gx * gx + gy * gy + gz * gz;
+	float a2 = ax * ax + ay * ay + az * az;
+	float lo = POWER_G - config.accelThreshold, hi = POWER_G + config.accelThreshold;
+
+	if (timing)
+	{
+		uint32_t us = (uint32_t)((float)(POWER_PortTicks() - motionTicks) * tickUs);
+
+		timing = 0;
+		stats.latencyLastUs = us;
+		stats.latencySumUs += us;
+		if (us < stats.latencyMinUs)
+		{
+			stats.latencyMinUs = us;
+		}
+		if (us > stats.latencyMaxUs)
+		{
+			stats.latencyMaxUs = us;
+		}
+	}
+
+	/* squares, no sqrtf in the interrupt */
+	if (w2 < config.gyroThreshold * config.gyroThreshold && a2 > lo * lo && a2 < hi * hi)
+	{
+		still++;
+	}
+	else
+	{
+		still = 0;
+		moved = 1;
+	}
+}
+
+void POWER_MotionIrq(void)
+{
+	if (!motion)
+	{
+		motionTicks = POWER_PortTicks();
+		motion = 1;
+	}
+}
+
+static void enter(void)
+{
+	POWER_PortSampling(0);
+	if (POWER_PortSensor(1, &config) != 0)
+	{
+		/* half configured is still a working full rate sensor once restored */
+		stats.errors++;
+		POWER_PortSensor(0, &config);
+		POWER_PortSampling(1);
+		still = 0;
+		return;
+	}
+
+	motion = 0;
+	POWER_PortWakeIrq(1);
+	if (!moved && stats.wakes > 0)
+	{
+		stats.falseWakes++;
+	}
+	stats.entries++;
+	account(POWER_LOW);
+}
+
+static void leave(void)
+{
+	POWER_PortWakeIrq(0);
+	if (POWER_PortSensor(0, &config) != 0)
+	{
+		stats.errors++;
+	}
+	account(POWER_ACTIVE);
+	stats.wakes++;
+	still = 0;
+	moved = 0;
+	timing = 1;
+	POWER_PortSampling(1);
+}
+
+void POWER_Poll(void)
+{
+	uint32_t slept, woke;
+
+	account(state);
+
+	if (state == POWER_ACTIVE)
+	{
+		if (config.enable && still >= stillSamples)
+		{
+			enter();
+		}
+		return;
+	}
+
+	if (!motion)
+	{
+		account(POWER_ASLEEP);
+		slept = since;
+		woke = POWER_PortSleep(config.stop, &motion);
+		stats.sleeps++;
+
+		/* up to the wake up it was sleep, the rest (clock restore, interrupts) is awake */
+		stats.us[POWER_ASLEEP] += (uint64_t)((float)(woke - slept) * tickUs);
+		since = woke;
+		state = POWER_LOW;
+
+		/* woken by the INT pulse: its handler only ran once the clock was back */
+		if (motion && (int32_t)(motionTicks - woke) > 0)
+		{
+			motionTicks = woke;
+		}
+		if (!motion)
+		{
+			/* another interrupt, the rest of the main loop has work */
+			return;
+		}
+	}
+
+	leave();
+}
+
+power_state POWER_State(void)
+{
+	return (power_state)state;
+}
+
+const power_stats_t* POWER_Stats(void)
+{
+	account(state);
+
+	return &stats;
+}
+
+static void report(void)
+{
+	static const char *names[POWER_STATES] = { "active", "low", "asleep" };
+	const power_stats_t *s = POWER_Stats();
+	char line[160];
+	uint32_t i;
+	int32_t n;
+
+	n = snprintf(line, sizeof(line), "POWER %s %s", config.enable ? "on" : "off", names[state]);
+	for (i = 0; i < POWER_STATES; i++)
+	{
+		n += snprintf(line + n, sizeof(line) - n, " %s=%lu.%03lus", names[i], (unsigned long)(s->us[i] / 1000000u),
+				(unsigned long)(s->us[i] / 1000u % 1000u));
+	}
+	snprintf(line + n, sizeof(line) - n, "\n");
+	print_str(line);
+
+	snprintf(line, sizeof(line), "POWER entries=%lu wakes=%lu false=%lu sleeps=%lu err=%lu lat us min=%lu avg=%lu max=%lu last=%lu\n",
+			(unsigned long)s->entries, (unsigned long)s->wakes, (unsigned long)s->falseWakes, (unsigned long)s->sleeps,
+			(unsigned long)s->errors, (unsigned long)(s->wakes ? s->latencyMinUs : 0),
+			(unsigned long)(s->wakes ? s->latencySumUs / s->wakes : 0), (unsigned long)s->latencyMaxUs,
+			(unsigned long)s->latencyLastUs);
+	print_str(line);
+}
+
+/* "power" prints the state times and wake counters, "power on|off", "power reset" */
+void POWER_Command(const char *args)
+{
+	if (strncmp(args, "on", 2) == 0 || strncmp(args, "off", 3) == 0)
+	{
+		POWER_Enable(args[1] == 'n');
+		return;
+	}
+	if (strncmp(args, "reset", 5) == 0)
+	{
+		memset(&stats, 0, sizeof(stats));
+		stats.latencyMinUs = UINT32_MAX;
+		since = POWER_PortTicks();
+		return;
+	}
+
+	report();
+}
@@ -0,0 +1,207 @@
+/*
+ * power_port.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  MPU9250 INT on PD2 / EXTI2, a 50 us high pulse. The pin also pulses
+ *  on every data ready at full rate, so EXTI2 is only enabled while the
+ *  sensor is in wake on motion.
+ *
+ *  Time base is the RTC on LSI with the shadow registers bypassed, the
+ *  prescalers at 2 x 16000 for 62.5 us per tick. LSI is only good to
+ *  tens of percent, so its rate is measured against the HSE driven
+ *  SysTick at start up.
+ */
+
+#include "stm32f4xx_hal.h"
+#include "tim.h"
+#include "mpu9250.h"
+#include "power.h"
+#include "pipeline.h"
+
+#define POWER_INT_PORT GPIOD
+#define POWER_INT_PIN GPIO_PIN_2
+
+#define POWER_RTC_PREDIV_A 1u
+#define POWER_RTC_PREDIV_S 15999u
+#define POWER_RTC_HZ 16000u
+#define POWER_TICKS_PER_DAY (86400u * POWER_RTC_HZ)
+#define POWER_CALIB_MS 200u
+
+/* main.c */
+void SystemClock_Config(void);
+
+static uint32_t lastTicks, dayTicks;
+static float tickUs = 1000000.0f / POWER_RTC_HZ;
+static uint8_t sampling;
+
+static void rtc_init(void)
+{
+	uint32_t start;
+
+	HAL_PWR_EnableBkUpAccess();
+	__HAL_RCC_LSI_ENABLE();
+	start = HAL_GetTick();
+	while (__HAL_RCC_GET_FLAG(RCC_FLAG_LSIRDY) == RESET && HAL_GetTick() - start < 10)
+	{
+	}
+	if ((RCC->BDCR & RCC_BDCR_RTCEN) == 0)
+	{
+		__HAL_RCC_RTC_CONFIG(RCC_RTCCLKSOURCE_LSI);
+		__HAL_RCC_RTC_ENABLE();
+	}
+
+	RTC->WPR = 0xCA;
+	RTC->WPR = 0x53;
+	RTC->ISR |= RTC_ISR_INIT;
+	start = HAL_GetTick();
+	while ((RTC->ISR & RTC_ISR_INITF) == 0 && HAL_GetTick() - start < 10)
+	{
+	}
+	/* synchronous first, then asynchronous, as two writes */
+	RTC->PRER = POWER_RTC_PREDIV_S;
+	RTC->PRER = (POWER_RTC_PREDIV_A << 16) | POWER_RTC_PREDIV_S;
+	RTC->TR = 0;
+	RTC->CR |= RTC_CR_BYPSHAD;
+	RTC->ISR &= ~RTC_ISR_INIT;
+	RTC->WPR = 0xFF;
+}
+
+static uint32_t rtc_read(void)
+{
+	uint32_t ssr, tr;
+
+	/* no shadow registers: read until a carry did not fall between SSR and TR */
+	do
+	{
+		ssr = RTC->SSR;
+		tr = RTC->TR;
+	} while (ssr != RTC->SSR || tr != RTC->TR);
+
+	uint32_t s = ((tr >> 20) & 0x3u) * 36000u + ((tr >> 16) & 0xFu) * 3600u + ((tr >> 12) & 0x7u) * 600u
+			+ ((tr >> 8) & 0xFu) * 60u + ((tr >> 4) & 0x7u) * 10u + (tr & 0xFu);
+
+	return s * POWER_RTC_HZ + (POWER_RTC_PREDIV_S - (ssr & 0xFFFFu));
+}
+
+void POWER_PortInit(void)
+{
+	GPIO_InitTypeDef GPIO_InitStruct;
+	uint32_t t0, t1, tick;
+
+	GPIO_InitStruct.Pin = POWER_INT_PIN;
+	GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING;
+	GPIO_InitStruct.Pull = GPIO_PULLDOWN;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+	HAL_GPIO_Init(POWER_INT_PORT, &GPIO_InitStruct);
+	HAL_NVIC_SetPriority(EXTI2_IRQn, 1, 0);
+	HAL_NVIC_DisableIRQ(EXTI2_IRQn);
+
+	rtc_init();
+
+	/* LSI against SysTick, from a tick edge */
+	tick = HAL_GetTick();
+	while (HAL_GetTick() == tick)
+	{
+	}
+	t0 = POWER_PortTicks();
+	HAL_Delay(POWER_CALIB_MS);
+	t1 = POWER_PortTicks();
+	if (t1 != t0)
+	{
+		tickUs = POWER_CALIB_MS * 1000.0f / (float)(t1 - t0);
+	}
+}
+
+uint32_t POWER_PortTicks(void)
+{
+	uint32_t t = rtc_read();
+
+	/* the time of day register wraps at midnight */
+	if (t < lastTicks)
+	{
+		dayTicks += POWER_TICKS_PER_DAY;
+	}
+	lastTicks = t;
+
+	return dayTicks + t;
+}
+
+float POWER_PortTickUs(void)
+{
+	return tickUs;
+}
+
+void POWER_PortSampling(uint8_t on)
+{
+	if (!on)
+	{
+		/* only restart what was running: sampling may be off for bench work */
+		sampling = (htim6.Instance->CR1 & TIM_CR1_CEN) && (htim6.Instance->DIER & TIM_DIER_UIE);
+		HAL_TIM_Base_Stop_IT(&htim6);
+		/* the last read and its processing still own SPI1 */
+		while (PIPE_Busy())
+		{
+		}
+		return;
+	}
+	if (sampling)
+	{
+		__HAL_TIM_SET_COUNTER(&htim6, 0);
+		HAL_TIM_Base_Start_IT(&htim6);
+		/* update event now rather than a period later */
+		HAL_TIM_GenerateEvent(&htim6, TIM_EVENTSOURCE_UPDATE);
+	}
+}
+
+int32_t POWER_PortSensor(uint8_t lowPower, const power_config_t *cfg)
+{
+	return lowPower ? enableWakeOnMotion(cfg->womMg, cfg->lpOdr) : disableWakeOnMotion();
+}
+
+void POWER_PortWakeIrq(uint8_t on)
+{
+	__HAL_GPIO_EXTI_CLEAR_IT(POWER_INT_PIN);
+	HAL_NVIC_ClearPendingIRQ(EXTI2_IRQn);
+	if (on)
+	{
+		HAL_NVIC_EnableIRQ(EXTI2_IRQn);
+	}
+	else
+	{
+		HAL_NVIC_DisableIRQ(EXTI2_IRQn);
+	}
+}
+
+uint32_t POWER_PortSleep(uint8_t stop, volatile const uint8_t *wake)
+{
+	uint32_t woke;
+
+	/* WFI still wakes on an interrupt that is pending while masked */
+	__disable_irq();
+	if (*wake)
+	{
+		__enable_irq();
+		return POWER_PortTicks();
+	}
+
+	HAL_SuspendTick();
+	if (stop)
+	{
+		HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+	}
+	else
+	{
+		HAL_PWR_EnterSLEEPMode(PWR_MAINREGULATOR_ON, PWR_SLEEPENTRY_WFI);
+	}
+	woke = POWER_PortTicks();
+	if (stop)
+	{
+		/* Stop leaves the core on HSI, HSE and the PLL off */
+		SystemClock_Config();
+	}
+	HAL_ResumeTick();
+	__enable_irq();
+
+	return woke;
+}
@@ -6,6 +6,7 @@
  */
 
 #include <stdbool.h>
+#include <string.h>
 #include "stm32f4xx_hal.h"
 #include "usart.h"
 
@@ -46,3 +47,8 @@ void print_motion7(uint32_t tick, float ax, float ay, float az, float gx, float
 
 	print_float(t, true, true);
 }
+
+void print_str(const char *str)
+{
+	HAL_UART_Transmit(&huart6, (uint8_t*)str, strlen(str), 100);
+}
@@ -0,0 +1,179 @@
+/*
+ * prof.c
+ *
+ *  Created on: 18 Oct 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stm32f4xx_hal.h"
+#include "print.h"
+#include "prof.h"
+
+/* DWT lock access, not in the CMSIS DWT_Type of the M4; a no-op where there is no lock */
+#define PROF_DWT_LAR (*(volatile uint32_t*)0xE0001FB0)
+#define PROF_DWT_UNLOCK 0xC5ACCE55
+
+static const char *names[PROF_PROBES] = { "tim6", "spi dma", "systick", "uart", "rf irq", "pendsv", "thermal",
+		"ahrs", "eskf", "pdr", "beacon", "ins", "spec", "power", "tasks" };
+
+static prof_stats_t probes[PROF_PROBES];
+static uint32_t windowStart;
+static uint32_t reportMs = PROF_REPORT_MS;
+
+void PROF_Init(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	PROF_DWT_LAR = PROF_DWT_UNLOCK;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	PROF_Reset();
+}
+
+void PROF_Record(prof_probe p, uint32_t cycles)
+{
+	prof_stats_t *s = &probes[p];
+	uint32_t primask = __get_PRIMASK(), bin = 0;
+
+	/* bin i holds up to PROF_HIST_MIN << i cycles */
+	if (cycles > PROF_HIST_MIN)
+	{
+		bin = 32 - __builtin_clz((cycles - 1) / PROF_HIST_MIN);
+		if (bin >= PROF_HIST_BINS)
+		{
+			bin = PROF_HIST_BINS - 1;
+		}
+	}
+
+	__disable_irq();
+	if (s->count == 0 || cycles < s->min)
+	{
+		s->min = cycles;
+	}
+	if (cycles > s->max)
+	{
+		s->max = cycles;
+	}
+	s->count++;
+	s->sum += cycles;
+	s->hist[bin]++;
+	__set_PRIMASK(primask);
+}
+
+void PROF_Reset(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	memset(probes, 0, sizeof(probes));
+	windowStart = HAL_GetTick();
+	__set_PRIMASK(primask);
+}
+
+void PROF_Get(prof_probe p, prof_stats_t *out)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	*out = probes[p];
+	__set_PRIMASK(primask);
+}
+
+static void print_probe(uint32_t i, const prof_stats_t *s, uint32_t ms)
+{
+	const float us = 1e6f / (float)SystemCoreClock;
+	float window = (float)ms * (SystemCoreClock / 1000u);
+	char line[200];
+	uint32_t j;
+	int32_t n;
+
+	n = snprintf(line, sizeof(line), "PROF %-8s n=%lu us min=%.1f mean=%.1f max=%.1f load=%.2f%% hist=", names[i],
+			(unsigned long)s->count, s->min * us, (float)s->sum / s->count * us, s->max * us,
+			window > 0.0f ? (float)s->sum * 100.0f / window : 0.0f);
+	for (j = 0; j < PROF_HIST_BINS && n < (int32_t)sizeof(line) - 12; j++)
+	{
+		n += snprintf(line + n, sizeof(line) - n, j ? ",%lu" : "%lu", (unsigned long)s->hist[j]);
+	}
+	snprintf(line + n, sizeof(line) - n, "\n");
+	print_str(line);
+}
+
+static void print_header(uint32_t ms)
+{
+	char line[40];
+
+	snprintf(line, sizeof(line), "PROF window=%lu ms\n", (unsigned long)ms);
+	print_str(line);
+}
+
+/* the periodic report goes out a line per call from a snapshot, a whole one would hold the UART for tens of ms */
+void PROF_Poll(void)
+{
+	static prof_stats_t snap[PROF_PROBES];
+	static uint32_t snapMs;
+	static int32_t line = -1;
+	uint32_t primask;
+
+	if (line < 0)
+	{
+		if (reportMs == 0 || HAL_GetTick() - windowStart < reportMs)
+		{
+			return;
+		}
+		primask = __get_PRIMASK();
+		__disable_irq();
+		memcpy(snap, probes, sizeof(snap));
+		snapMs = HAL_GetTick() - windowStart;
+		PROF_Reset();
+		__set_PRIMASK(primask);
+
+		print_header(snapMs);
+		line = 0;
+		return;
+	}
+
+	while (line < PROF_PROBES && snap[line].count == 0)
+	{
+		line++;
+	}
+	if (line < PROF_PROBES)
+	{
+		print_probe(line, &snap[line], snapMs);
+		line++;
+	}
+	if (line >= PROF_PROBES)
+	{
+		line = -1;
+	}
+}
+
+void PROF_Command(const char *args)
+{
+	if (strncmp(args, "reset", 5) == 0)
+	{
+		PROF_Reset();
+	}
+	else if (strncmp(args, "every", 5) == 0)
+	{
+		reportMs = strtoul(args + 5, NULL, 10);
+		PROF_Reset();
+	}
+	else
+	{
+		prof_stats_t s;
+		uint32_t i, ms = HAL_GetTick() - windowStart;
+
+		print_header(ms);
+		for (i = 0; i < PROF_PROBES; i++)
+		{
+			PROF_Get((prof_probe)i, &s);
+			if (s.count)
+			{
+				print_probe(i, &s, ms);
+			}
+		}
+	}
+}
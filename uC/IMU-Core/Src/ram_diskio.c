@@ -0,0 +1,118 @@
+/*
+ * ram_diskio.c
+ *
+ *  Created on: 18 Oct 2026
+ */
+
+#include <string.h>
+
+#include "ram_diskio.h"
+
+static uint8_t *ramMem = NULL;
+static uint32_t ramSectors = 0;
+static volatile DSTATUS Stat = STA_NOINIT;
+
+DSTATUS RAMDISK_initialize (BYTE pdrv);
+DSTATUS RAMDISK_status (BYTE pdrv);
+DRESULT RAMDISK_read (BYTE pdrv, BYTE *buff, DWORD sector, UINT count);
+#if _USE_WRITE == 1
+DRESULT RAMDISK_write (BYTE pdrv, const BYTE *buff, DWORD sector, UINT count);
+#endif /* _USE_WRITE == 1 */
+#if _USE_IOCTL == 1
+DRESULT RAMDISK_ioctl (BYTE pdrv, BYTE cmd, void *buff);
+#endif /* _USE_IOCTL == 1 */
+
+Diskio_drvTypeDef RAMDISK_Driver =
+{
+	RAMDISK_initialize,
+	RAMDISK_status,
+	RAMDISK_read,
+#if _USE_WRITE == 1
+	RAMDISK_write,
+#endif /* _USE_WRITE == 1 */
+#if _USE_IOCTL == 1
+	RAMDISK_ioctl,
+#endif /* _USE_IOCTL == 1 */
+};
+
+/* attaches the memory backing the disk, call before the volume is mounted */
+void RAMDISK_Setup(uint8_t *mem, uint32_t sectors)
+{
+	ramMem = mem;
+	ramSectors = sectors;
+	Stat = STA_NOINIT;
+}
+
+DSTATUS RAMDISK_initialize (BYTE pdrv)
+{
+	Stat = (ramMem && ramSectors) ? 0 : STA_NOINIT;
+	return Stat;
+}
+
+DSTATUS RAMDISK_status (BYTE pdrv)
+{
+	return Stat;
+}
+
+DRESULT RAMDISK_read (BYTE pdrv, BYTE *buff, DWORD sector, UINT count)
+{
+	if (Stat & STA_NOINIT)
+	{
+		return RES_NOTRDY;
+	}
+	if (sector + count > ramSectors)
+	{
+		return RES_PARERR;
+	}
+
+	memcpy(buff, &ramMem[sector * RAMDISK_SECTOR_SIZE], count * RAMDISK_SECTOR_SIZE);
+	return RES_OK;
+}
+
+#if _USE_WRITE == 1
+DRESULT RAMDISK_write (BYTE pdrv, const BYTE *buff, DWORD sector, UINT count)
+{
+	if (Stat & STA_NOINIT)
+	{
+		return RES_NOTRDY;
+	}
+	if (sector + count > ramSectors)
+	{
+		return RES_PARERR;
+	}
+
+	memcpy(&ramMem[sector * RAMDISK_SECTOR_SIZE], buff, count * RAMDISK_SECTOR_SIZE);
+	return RES_OK;
+}
+#endif /* _USE_WRITE == 1 */
+
+#if _USE_IOCTL == 1
+DRESULT RAMDISK_ioctl (BYTE pdrv, BYTE cmd, void *buff)
+{
+	if (Stat & STA_NOINIT)
+	{
+		return RES_NOTRDY;
+	}
+
+	switch (cmd)
+	{
+		case CTRL_SYNC:
+			return RES_OK;
+
+		case GET_SECTOR_COUNT:
+			*(DWORD*)buff = ramSectors;
+			return RES_OK;
+
+		case GET_SECTOR_SIZE:
+			*(WORD*)buff = RAMDISK_SECTOR_SIZE;
+			return RES_OK;
+
+		case GET_BLOCK_SIZE:
+			*(DWORD*)buff = 1;
+			return RES_OK;
+
+		default:
+			return RES_PARERR;
+	}
+}
+#endif /* _USE_IOCTL == 1 */
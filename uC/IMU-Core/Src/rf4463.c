@@ -0,0 +1,278 @@
+/*
+ * rf4463.c
+ *
+ *  Created on: 18 Oct 2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "stm32f4xx_hal.h"
+#include "rf4463.h"
+#include "radio_config_Si4463.h"
+#include "dwt_delay.h"
+#include "print.h"
+
+static const uint8_t radioConfig[] = RADIO_CONFIGURATION_DATA_ARRAY;
+
+static rf_rx_callback rxCallback = NULL;
+static rf_stats_t stats;
+
+/* written by the nIRQ handler, consumed by RF4463_Poll() */
+static volatile uint8_t irqPending = 0;
+static volatile rf_stamp_t irqStamp;
+
+static uint8_t txActive = 0;
+
+/* waits for CTS and reads len response bytes */
+static int32_t read_response(uint8_t *resp, uint8_t len)
+{
+	uint8_t cmd[2] = { RF4463_CMD_READ_CMD_BUFF, 0xFF }, rx[2];
+	uint32_t i;
+
+	for (i = 0; i < RF4463_CTS_TRIES; i++)
+	{
+		RF4463_PortSelect(1);
+		RF4463_PortTransfer(cmd, rx, 2);
+		if (rx[1] == 0xFF)
+		{
+			if (len)
+			{
+				RF4463_PortTransfer(NULL, resp, len);
+			}
+			RF4463_PortSelect(0);
+			return 0;
+		}
+		RF4463_PortSelect(0);
+	}
+
+	stats.ctsTimeouts++;
+	return -1;
+}
+
+static int32_t command(const uint8_t *cmd, uint8_t len, uint8_t *resp, uint8_t respLen)
+{
+	RF4463_PortSelect(1);
+	RF4463_PortTransfer(cmd, NULL, len);
+	RF4463_PortSelect(0);
+
+	return read_response(resp, respLen);
+}
+
+static int32_t set_property(uint8_t group, uint8_t start, const uint8_t *values, uint8_t count)
+{
+	uint8_t cmd[16] = { RF4463_CMD_SET_PROPERTY, group, count, start };
+
+	memcpy(&cmd[4], values, count);
+
+	return command(cmd, 4 + count, NULL, 0);
+}
+
+static int32_t start_rx(void)
+{
+	/* fixed length from the packet handler; stay in READY after a packet so FIFO and RSSI can be read */
+	uint8_t cmd[8] = { RF4463_CMD_START_RX, RF4463_CHANNEL, 0x00, 0x00, 0x00,
+			RF4463_STATE_RX, RF4463_STATE_READY, RF4463_STATE_READY };
+
+	return command(cmd, sizeof(cmd), NULL, 0);
+}
+
+static int32_t fifo_reset(void)
+{
+	uint8_t cmd[2] = { RF4463_CMD_FIFO_INFO, 0x03 };
+	uint8_t resp[2];
+
+	return command(cmd, sizeof(cmd), resp, sizeof(resp));
+}
+
+/* returns PH_PEND, clears everything */
+static int32_t int_status(uint8_t *phPend)
+{
+	uint8_t cmd[4] = { RF4463_CMD_GET_INT_STATUS, 0, 0, 0 };
+	uint8_t resp[8];
+
+	if (command(cmd, sizeof(cmd), resp, sizeof(resp)) != 0)
+	{
+		return -1;
+	}
+	*phPend = resp[2];
+
+	return 0;
+}
+
+int32_t RF4463_Init(void)
+{
+	static const uint8_t pktLen[2] = { 0x00, RF4463_PACKET_LEN };	/* PKT_FIELD_1_LENGTH */
+	static const uint8_t intEnable[3] = { 0x01, RF4463_PH_PACKET_SENT | RF4463_PH_PACKET_RX | RF4463_PH_CRC_ERROR, 0x00 };
+	static const uint8_t gpio[8] = { 0x13, 0x14, 0x02, 0x21, 0x20, 0x27, 0x0B, 0x00 };	/* as the NiceRF reference */
+	uint8_t cmd[2] = { RF4463_CMD_PART_INFO, 0 };
+	uint8_t resp[8], ph;
+	const uint8_t *p;
+
+	memset(&stats, 0, sizeof(stats));
+	irqPending = 0;
+	txActive = 0;
+
+	RF4463_PortInit();
+	RF4463_PortShutdown(1);
+	RF4463_PortDelayMs(1);
+	RF4463_PortShutdown(0);
+	RF4463_PortDelayMs(10);
+
+	/* length prefixed WDS command list, POWER_UP first */
+	for (p = radioConfig; *p; p += *p + 1)
+	{
+		if (command(p + 1, *p, NULL, 0) != 0)
+		{
+			return -1;
+		}
+	}
+
+	if (command(cmd, 1, resp, sizeof(resp)) != 0 || ((resp[1] << 8) | resp[2]) != RF4463_PART)
+	{
+		return -2;
+	}
+
+	if (command(gpio, sizeof(gpio), NULL, 0) != 0 ||
+		set_property(0x12, 0x0D, pktLen, sizeof(pktLen)) != 0 ||
+		set_property(0x01, 0x00, intEnable, sizeof(intEnable)) != 0)
+	{
+		return -3;
+	}
+
+	if (fifo_reset() != 0 || int_status(&ph) != 0 || start_rx() != 0)
+	{
+		return -4;
+	}
+
+	return 0;
+}
+
+void RF4463_SetRxCallback(rf_rx_callback cb)
+{
+	rxCallback = cb;
+}
+
+void RF4463_IrqHandler(void)
+{
+	stats.irqs++;
+	if (irqPending)
+	{
+		stats.missedIrqs++;
+	}
+
+	irqStamp.cycles = DWT_Get();
+	irqStamp.tick = HAL_GetTick();
+	irqPending = 1;
+}
+
+void RF4463_Poll(void)
+{
+	uint8_t modemCmd[2] = { RF4463_CMD_GET_MODEM_STATUS, 0xFF };
+	uint8_t fifoCmd = RF4463_CMD_READ_RX_FIFO;
+	uint8_t modem[8], data[RF4463_PACKET_LEN], ph;
+	uint32_t start, cycles;
+	rf_stamp_t stamp;
+
+	if (!irqPending)
+	{
+		return;
+	}
+
+	start = DWT_Get();
+	stamp.cycles = irqStamp.cycles;
+	stamp.tick = irqStamp.tick;
+	irqPending = 0;
+
+	if (int_status(&ph) != 0)
+	{
+		return;
+	}
+
+	if (ph & RF4463_PH_PACKET_SENT)
+	{
+		stats.sent++;
+		txActive = 0;
+	}
+
+	if (ph & RF4463_PH_CRC_ERROR)
+	{
+		stats.crcErrors++;
+		fifo_reset();
+	}
+	else if (ph & RF4463_PH_PACKET_RX)
+	{
+		/* RSSI latched at sync detect, 0.5 dB steps with RSSI_COMP = 0x40 */
+		if (command(modemCmd, sizeof(modemCmd), modem, sizeof(modem)) == 0)
+		{
+			stats.lastRssi = modem[3] * 0.5f - 134.0f;
+		}
+
+		RF4463_PortSelect(1);
+		RF4463_PortTransfer(&fifoCmd, NULL, 1);
+		RF4463_PortTransfer(NULL, data, sizeof(data));
+		RF4463_PortSelect(0);
+
+		stats.packets++;
+		if (rxCallback)
+		{
+			rxCallback(data, sizeof(data), stats.lastRssi, &stamp);
+		}
+	}
+
+	if (!txActive)
+	{
+		start_rx();
+	}
+
+	cycles = DWT_Get() - start;
+	if (cycles > stats.maxPollCycles)
+	{
+		stats.maxPollCycles = cycles;
+	}
+}
+
+int32_t RF4463_Send(const uint8_t *data, uint8_t len)
+{
+	uint8_t buf[1 + RF4463_PACKET_LEN] = { RF4463_CMD_WRITE_TX_FIFO };
+	uint8_t cmd[5] = { RF4463_CMD_START_TX, RF4463_CHANNEL, RF4463_STATE_RX << 4, 0x00, 0x00 };
+
+	if (len > RF4463_PACKET_LEN || txActive)
+	{
+		return -1;
+	}
+
+	memcpy(&buf[1], data, len);
+
+	RF4463_PortSelect(1);
+	RF4463_PortTransfer(buf, NULL, sizeof(buf));
+	RF4463_PortSelect(0);
+
+	txActive = 1;
+	if (command(cmd, sizeof(cmd), NULL, 0) != 0)
+	{
+		txActive = 0;
+		return -2;
+	}
+
+	return 0;
+}
+
+const rf_stats_t* RF4463_Stats(void)
+{
+	return &stats;
+}
+
+/* "rf" prints the radio counters */
+void RF4463_Command(const char *args)
+{
+	char line[160];
+
+	(void)args;
+
+	snprintf(line, sizeof(line), "RF irq=%lu rx=%lu crc=%lu tx=%lu cts=%lu missed=%lu rssi=%.1f cyc poll=%lu\n",
+			(unsigned long)stats.irqs, (unsigned long)stats.packets, (unsigned long)stats.crcErrors,
+			(unsigned long)stats.sent, (unsigned long)stats.ctsTimeouts, (unsigned long)stats.missedIrqs,
+			stats.lastRssi, (unsigned long)stats.maxPollCycles);
+	print_str(line);
+}
@@ -0,0 +1,81 @@
+/*
+ * rf4463_port.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  RF4463PRO on SPI3 (PC10 SCK, PC11 MISO, PC12 MOSI, 656 kHz at /64),
+ *  nSEL on PD3, SDN on PD1, nIRQ on PD0 / EXTI0.
+ */
+
+#include "stm32f4xx_hal.h"
+#include "spi.h"
+#include "rf4463.h"
+
+#define RF_NSEL_PORT GPIOD
+#define RF_NSEL_PIN GPIO_PIN_3
+#define RF_SDN_PORT GPIOD
+#define RF_SDN_PIN GPIO_PIN_1
+#define RF_NIRQ_PORT GPIOD
+#define RF_NIRQ_PIN GPIO_PIN_0
+
+void RF4463_PortInit(void)
+{
+	GPIO_InitTypeDef GPIO_InitStruct;
+
+	HAL_GPIO_WritePin(RF_NSEL_PORT, RF_NSEL_PIN, GPIO_PIN_SET);
+	HAL_GPIO_WritePin(RF_SDN_PORT, RF_SDN_PIN, GPIO_PIN_SET);
+
+	GPIO_InitStruct.Pin = RF_NSEL_PIN | RF_SDN_PIN;
+	GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+	GPIO_InitStruct.Pull = GPIO_NOPULL;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+	HAL_GPIO_Init(GPIOD, &GPIO_InitStruct);
+
+	GPIO_InitStruct.Pin = RF_NIRQ_PIN;
+	GPIO_InitStruct.Mode = GPIO_MODE_IT_FALLING;
+	GPIO_InitStruct.Pull = GPIO_PULLUP;
+	HAL_GPIO_Init(RF_NIRQ_PORT, &GPIO_InitStruct);
+
+	/* below the IMU sample interrupt, the handler only takes a timestamp */
+	HAL_NVIC_SetPriority(EXTI0_IRQn, 1, 0);
+	HAL_NVIC_EnableIRQ(EXTI0_IRQn);
+}
+
+void RF4463_PortShutdown(uint8_t on)
+{
+	HAL_GPIO_WritePin(RF_SDN_PORT, RF_SDN_PIN, on ? GPIO_PIN_SET : GPIO_PIN_RESET);
+}
+
+void RF4463_PortSelect(uint8_t on)
+{
+	HAL_GPIO_WritePin(RF_NSEL_PORT, RF_NSEL_PIN, on ? GPIO_PIN_RESET : GPIO_PIN_SET);
+}
+
+void RF4463_PortTransfer(const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+	uint8_t out, in;
+
+	/* byte by byte, the radio transfers are short and tx or rx may be absent */
+	while (len--)
+	{
+		out = tx ? *tx++ : 0xFF;
+		HAL_SPI_TransmitReceive(&hspi3, &out, &in, 1, 10);
+		if (rx)
+		{
+			*rx++ = in;
+		}
+	}
+}
+
+void RF4463_PortDelayMs(uint32_t ms)
+{
+	HAL_Delay(ms);
+}
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+	if (GPIO_Pin == RF_NIRQ_PIN)
+	{
+		RF4463_IrqHandler();
+	}
+}
@@ -0,0 +1,228 @@
+/*
+ * scheduler.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Tick and release times are in SysTick counts and compared by signed
+ *  difference, so they wrap cleanly.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "stm32f4xx_hal.h"
+#include "dwt_delay.h"
+#include "print.h"
+#include "scheduler.h"
+#include "prof.h"
+
+static sched_task_t tasks[SCHED_MAX_TASKS];
+static uint32_t tasksNum = 0;
+static sched_fn idle = NULL;
+
+/* written by SysTick only */
+static volatile uint32_t ticks;
+static volatile uint32_t tickStamp;
+
+static uint32_t statTicks;		/* tick at the last reset */
+static uint64_t busyCycles;
+
+void SCHED_Init(void)
+{
+	tasksNum = 0;
+	idle = NULL;
+	busyCycles = 0;
+	statTicks = ticks;
+}
+
+int32_t SCHED_Add(const char *name, sched_fn fn, uint32_t periodMs, uint32_t offsetMs, uint32_t budgetUs)
+{
+	sched_task_t *t;
+
+	if (tasksNum >= SCHED_MAX_TASKS || periodMs == 0 || fn == NULL)
+	{
+		return -1;
+	}
+
+	t = &tasks[tasksNum];
+	memset(t, 0, sizeof(*t));
+	t->name = name;
+	t->fn = fn;
+	t->period = periodMs;
+	t->offset = offsetMs % periodMs;
+	t->budget = budgetUs * (SystemCoreClock / 1000000u);
+	/* first release at the next tick that is offset into a period */
+	t->next = ticks + 1;
+	t->next += (t->offset + t->period - t->next % t->period) % t->period;
+
+	return (int32_t)tasksNum++;
+}
+
+void SCHED_SetIdle(sched_fn fn)
+{
+	idle = fn;
+}
+
+void SCHED_Tick(void)
+{
+	tickStamp = DWT_Get();
+	ticks++;
+}
+
+/* tick count and the DWT stamp of that tick, consistent */
+static uint32_t now(uint32_t *stamp)
+{
+	uint32_t t;
+
+	do
+	{
+		t = ticks;
+		*stamp = tickStamp;
+	} while (t != ticks);
+
+	return t;
+}
+
+/* moves a late release up to the last one due, returns the releases passed over */
+static uint32_t realign(sched_task_t *t, uint32_t tick)
+{
+	uint32_t missed;
+
+	if ((int32_t)(tick - t->next) < (int32_t)t->period)
+	{
+		return 0;
+	}
+	missed = (tick - t->next) / t->period;
+	t->next += missed * t->period;
+
+	return missed;
+}
+
+static void run(sched_task_t *t, uint32_t tick, uint32_t stamp)
+{
+	uint32_t start, cycles, jitter;
+
+	start = DWT_Get();
+	jitter = (tick - t->next) * (SystemCoreClock / 1000u) + (start - stamp);
+	t->fn();
+	cycles = DWT_Get() - start;
+
+	t->runs++;
+	t->lastCycles = cycles;
+	t->sumCycles += cycles;
+	if (cycles > t->wcet)
+	{
+		t->wcet = cycles;
+	}
+	if (t->budget && cycles > t->budget)
+	{
+		t->overruns++;
+	}
+	t->sumJitter += jitter;
+	if (jitter > t->maxJitter)
+	{
+		t->maxJitter = jitter;
+	}
+	busyCycles += cycles;
+#if PROF_ENABLE
+	PROF_Record(PROF_TASKS, cycles);
+#endif
+
+	t->next += t->period;
+}
+
+void SCHED_Run(void)
+{
+	uint32_t tick, stamp, i;
+	uint8_t ran = 0;
+	sched_task_t *t;
+
+	for (i = 0; i < tasksNum; i++)
+	{
+		t = &tasks[i];
+		tick = now(&stamp);
+		if ((int32_t)(tick - t->next) < 0)
+		{
+			continue;
+		}
+		/* a late task runs once for its latest release, not once per release */
+		t->skips += realign(t, tick);
+		run(t, tick, stamp);
+		ran = 1;
+	}
+	if (ran)
+	{
+		return;
+	}
+
+	tick = ticks;
+	if (idle)
+	{
+		idle();
+	}
+	if (ticks - tick > 1)
+	{
+		/* the idle hook ran long, not the tasks: start from the current releases */
+		tick = ticks;
+		for (i = 0; i < tasksNum; i++)
+		{
+			realign(&tasks[i], tick);
+		}
+		return;
+	}
+
+	/* until SysTick or the sample path; masked so a tick just now is not slept through */
+	__disable_irq();
+	if (ticks == tick)
+	{
+		__WFI();
+	}
+	__enable_irq();
+}
+
+const sched_task_t* SCHED_Task(uint32_t i)
+{
+	return i < tasksNum ? &tasks[i] : NULL;
+}
+
+/* "sched" prints per task times in us (last, mean, WCET, budget) and jitter, "sched reset" */
+void SCHED_Command(const char *args)
+{
+	const float us = 1e6f / (float)SystemCoreClock;
+	uint32_t elapsed = ticks - statTicks;
+	/* a task row: 77 characters of text, an 8 character name, 5 counters of 10 and 6 times of up to 12 */
+	char line[208];
+	uint32_t i;
+
+	if (strncmp(args, "reset", 5) == 0)
+	{
+		for (i = 0; i < tasksNum; i++)
+		{
+			sched_task_t *t = &tasks[i];
+
+			t->runs = t->overruns = t->skips = 0;
+			t->lastCycles = t->wcet = t->maxJitter = 0;
+			t->sumCycles = t->sumJitter = 0;
+		}
+		busyCycles = 0;
+		statTicks = ticks;
+		return;
+	}
+
+	snprintf(line, sizeof(line), "SCHED tasks=%lu ms=%lu load=%.1f%%\n", (unsigned long)tasksNum,
+			(unsigned long)elapsed,
+			elapsed ? (float)busyCycles * 100.0f / ((float)elapsed * (SystemCoreClock / 1000u)) : 0.0f);
+	print_str(line);
+	for (i = 0; i < tasksNum; i++)
+	{
+		const sched_task_t *t = &tasks[i];
+
+		snprintf(line, sizeof(line),
+				"SCHED %-8s %lu+%lu ms runs=%lu over=%lu skip=%lu us last=%.1f mean=%.1f wcet=%.1f budget=%.1f jitter mean=%.1f max=%.1f\n",
+				t->name, (unsigned long)t->period, (unsigned long)t->offset, (unsigned long)t->runs,
+				(unsigned long)t->overruns, (unsigned long)t->skips, t->lastCycles * us,
+				t->runs ? (float)t->sumCycles / t->runs * us : 0.0f, t->wcet * us, t->budget * us,
+				t->runs ? (float)t->sumJitter / t->runs * us : 0.0f, t->maxJitter * us);
+		print_str(line);
+	}
+}
@@ -0,0 +1,505 @@
+/*
+ * spectrum.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  Three frame buffers: two are filled by the interrupt, half a frame
+ *  apart, and a full one is swapped for the spare when SPEC_Poll() has
+ *  given the spare back; otherwise the frame is dropped and refilled.
+ *
+ *  With w the Hann window, S2 = sum w^2 and X the FFT of the windowed
+ *  frame, bin k holds the mean square P = 2 |X[k]|^2 / (N S2), so the
+ *  bins add up to the mean square of the frame.
+ *
+ *  The real FFT is done here rather than with arm_rfft_fast_f32, which
+ *  cannot be stopped part way: the even and odd samples are the real and
+ *  imaginary parts of an N/2 point complex FFT, computed by radix 2
+ *  butterflies SPEC_POLL_BUTTERFLIES at a time and then split into the
+ *  N/2 bins of the real one.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "spectrum.h"
+#include "ccm.h"
+#include "dsp_port.h"
+#include "dwt_delay.h"
+#include "print.h"
+
+#if SPEC_USE_CCM
+#define SPEC_STORAGE CCM_BSS
+#else
+#define SPEC_STORAGE
+#endif
+
+enum { IDLE, STAGES, SPLIT, BINS, FINISH };
+
+static spec_config_t config;
+static float s1, s2;
+static uint32_t stageShift;		/* log2 of the butterflies per stage */
+static uint32_t butterflyCount;
+
+static SPEC_STORAGE float32_t frames[3][SPEC_MAX_POINTS];
+static SPEC_STORAGE float32_t window[SPEC_MAX_POINTS];
+/* e^(-j 2 pi k / N), k < N/2, re and im */
+static SPEC_STORAGE float32_t twiddle[SPEC_MAX_POINTS];
+/* the complex FFT in place, then the bins */
+static SPEC_STORAGE float32_t power[SPEC_MAX_POINTS];
+
+/* interrupt side */
+static volatile uint8_t running = 0;
+static uint8_t fill[2];
+static int32_t pos[2];
+static float wsum[2];
+static uint32_t samples;
+
+/* frame owned by SPEC_Poll(), -1 when it is idle */
+static volatile int8_t handed = -1;
+static volatile uint8_t spare;
+static float handedSum;
+static uint32_t handedEnd;
+
+/* SPEC_Poll() progress on the handed frame */
+static uint8_t phase = IDLE;
+static uint32_t butterfly, bin;
+static float total, peakP;
+static uint32_t peakBin;
+static float levelSum[SPEC_MSG_BINS];
+static spec_result_t work, last;
+static uint8_t haveLast = 0;
+
+static spec_stats_t stats;
+
+static inline void account(uint32_t start, uint32_t *max)
+{
+	uint32_t cycles = DWT_Get() - start;
+
+	if (cycles > *max)
+	{
+		*max = cycles;
+	}
+}
+
+static void restart(void)
+{
+	fill[0] = 0;
+	fill[1] = 1;
+	spare = 2;
+	pos[0] = 0;
+	pos[1] = -(int32_t)(config.points / 2);
+	wsum[0] = 0.0f;
+	wsum[1] = 0.0f;
+	handed = -1;
+	phase = IDLE;
+}
+
+int32_t SPEC_SetPoints(uint16_t points)
+{
+	uint32_t k;
+
+	if ((points != 256 && points != 512 && points != 1024) || points > SPEC_MAX_POINTS)
+	{
+		return -1;
+	}
+
+	/* the interrupt cannot be half way through a sample while the main loop runs */
+	running = 0;
+	config.points = points;
+
+	s1 = 0.0f;
+	s2 = 0.0f;
+	for (k = 0; k < points; k++)
+	{
+		window[k] = 0.5f - 0.5f * cosf(6.28318531f * k / points);
+		s1 += window[k];
+		s2 += window[k] * window[k];
+	}
+	for (k = 0; k < points / 2; k++)
+	{
+		twiddle[2 * k] = cosf(6.28318531f * k / points);
+		twiddle[2 * k + 1] = -sinf(6.28318531f * k / points);
+	}
+	/* points / 4 butterflies in each of log2(points / 2) stages */
+	for (stageShift = 0; (1u << stageShift) < points / 4; stageShift++)
+	{
+	}
+	butterflyCount = (stageShift + 1) * (points / 4);
+	restart();
+	running = 1;
+
+	return 0;
+}
+
+int32_t SPEC_Init(const spec_config_t *cfg)
+{
+	if (cfg->bands > SPEC_MAX_BANDS)
+	{
+		return -1;
+	}
+	running = 0;
+	config = *cfg;
+	samples = 0;
+	haveLast = 0;
+	memset(&stats, 0, sizeof(stats));
+
+	return SPEC_SetPoints(cfg->points);
+}
+
+void SPEC_SetReport(uint8_t on)
+{
+	config.report = on;
+}
+
+void SPEC_AddSample(float ax, float ay, float az)
+{
+	uint32_t start = DWT_Get(), f;
+	float m;
+
+	if (!running)
+	{
+		return;
+	}
+
+	m = sqrtf(ax * ax + ay * ay + az * az);
+	samples++;
+	stats.samples++;
+
+	for (f = 0; f < 2; f++)
+	{
+		if (pos[f] >= 0)
+		{
+			float x = window[pos[f]] * m;
+
+			frames[fill[f]][pos[f]] = x;
+			wsum[f] += x;
+		}
+		if (++pos[f] == config.points)
+		{
+			if (handed < 0)
+			{
+				handedSum = wsum[f];
+				handedEnd = samples;
+				handed = fill[f];
+				fill[f] = spare;
+			}
+			else
+			{
+				stats.overruns++;
+			}
+			pos[f] = 0;
+			wsum[f] = 0.0f;
+		}
+	}
+
+	account(start, &stats.maxSampleCycles);
+}
+
+/* detrend into the FFT buffer in bit reversed order and give the frame buffer back */
+static void prepare(void)
+{
+	const float32_t *x = frames[handed];
+	float mean = handedSum / s1;
+	uint32_t n = config.points / 2, i, j, k;
+
+	for (i = 0, j = 0; i < n; i++)
+	{
+		power[2 * j] = x[2 * i] - mean * window[2 * i];
+		power[2 * j + 1] = x[2 * i + 1] - mean * window[2 * i + 1];
+
+		/* reversed increment, j becomes the reverse of i + 1 */
+		for (k = n >> 1; j & k; k >>= 1)
+		{
+			j ^= k;
+		}
+		j |= k;
+	}
+
+	work.endSample = handedEnd;
+	spare = handed;
+	handed = -1;
+
+	memset(work.band, 0, sizeof(work.band));
+	memset(levelSum, 0, sizeof(levelSum));
+	total = 0.0f;
+	peakP = 0.0f;
+	peakBin = 0;
+	butterfly = 0;
+	bin = 0;
+}
+
+/* butterflies [butterfly, end) of the N/2 point complex FFT, stage after stage */
+static void butterflies(uint32_t end)
+{
+	const uint32_t n = config.points / 2, mask = (1u << stageShift) - 1;
+	uint32_t s, b, half, i, j;
+	float32_t *u, *v, vr, vi;
+	const float32_t *w;
+
+	for (; butterfly < end; butterfly++)
+	{
+		s = butterfly >> stageShift;
+		b = butterfly & mask;
+		half = 1u << s;
+		j = b & (half - 1);
+		i = ((b >> s) << (s + 1)) + j;
+
+		/* e^(-j 2 pi j / (2 half)) */
+		w = &twiddle[2 * ((j * n) >> s)];
+		u = &power[2 * i];
+		v = &power[2 * (i + half)];
+		vr = v[0] * w[0] - v[1] * w[1];
+		vi = v[0] * w[1] + v[1] * w[0];
+
+		v[0] = u[0] - vr;
+		v[1] = u[1] - vi;
+		u[0] += vr;
+		u[1] += vi;
+	}
+}
+
+/* X[k] and X[N/2 - k] for k in [bin, end) from the complex FFT Z, in place */
+static void split(uint32_t end)
+{
+	const uint32_t n = config.points / 2;
+	float32_t *zk, *zn, er, ei, dr, di, tr, ti;
+	const float32_t *w;
+
+	for (; bin < end; bin++)
+	{
+		if (bin == 0)
+		{
+			/* X[0], and X[N/2] where the layout keeps it */
+			er = power[0];
+			power[0] = er + power[1];
+			power[1] = er - power[1];
+			continue;
+		}
+
+		/* X[k] = E + e^(-j pi k / n) D, X[n - k] = (E - e^(-j pi k / n) D)* */
+		zk = &power[2 * bin];
+		zn = &power[2 * (n - bin)];
+		w = &twiddle[2 * bin];
+		er = 0.5f * (zk[0] + zn[0]);
+		ei = 0.5f * (zk[1] - zn[1]);
+		dr = 0.5f * (zk[1] + zn[1]);
+		di = -0.5f * (zk[0] - zn[0]);
+		tr = dr * w[0] - di * w[1];
+		ti = dr * w[1] + di * w[0];
+
+		zn[0] = er - tr;
+		zn[1] = ti - ei;
+		zk[0] = er + tr;
+		zk[1] = ei + ti;
+	}
+}
+
+/* bins [bin, end) from X to mean square, in place */
+static void bins(uint32_t end)
+{
+	const float norm = 2.0f / ((float)config.points * s2);
+	const float hz = config.sampleHz / config.points;
+	const uint32_t perLevel = config.points / 2 / SPEC_MSG_BINS;
+	uint32_t b;
+	float p, f;
+
+	for (; bin < end; bin++)
+	{
+		if (bin == 0)
+		{
+			/* DC, the Nyquist bin in power[1] is left out */
+			p = 0.5f * norm * power[0] * power[0];
+		}
+		else
+		{
+			p = norm * (power[2 * bin] * power[2 * bin] + power[2 * bin + 1] * power[2 * bin + 1]);
+		}
+		power[bin] = p;
+		total += p;
+
+		f = bin * hz;
+		for (b = 0; b < config.bands; b++)
+		{
+			if (f >= config.edges[b] && f < config.edges[b + 1])
+			{
+				work.band[b] += p;
+			}
+		}
+		if (f >= config.minHz && f <= config.maxHz && bin > 0 && p > peakP)
+		{
+			peakP = p;
+			peakBin = bin;
+		}
+		levelSum[bin / perLevel] += p;
+	}
+}
+
+static void finish(void)
+{
+	const float hz = config.sampleHz / config.points;
+	uint32_t i;
+	float d = 0.0f;
+
+	if (peakBin > 0 && peakBin + 1 < config.points / 2)
+	{
+		/* Hann peaks are close to Gaussian, parabola through the log power */
+		float a = logf(power[peakBin - 1] + 1e-20f), b = logf(power[peakBin] + 1e-20f), c = logf(power[peakBin + 1] + 1e-20f);
+		float den = a - 2.0f * b + c;
+
+		if (den < 0.0f)
+		{
+			d = 0.5f * (a - c) / den;
+		}
+		/* the main lobe is three bins wide */
+		work.peakRms = sqrtf(power[peakBin - 1] + power[peakBin] + power[peakBin + 1]);
+	}
+	else
+	{
+		work.peakRms = sqrtf(peakP);
+	}
+	work.peakHz = peakBin ? (peakBin + d) * hz : 0.0f;
+	work.rms = sqrtf(total);
+	work.points = config.points;
+	work.index = stats.frames++;
+
+	for (i = 0; i < SPEC_MSG_BINS; i++)
+	{
+		float level = levelSum[i] > 0.0f ? 2.0f * (10.0f * log10f(levelSum[i]) + 80.0f) : 0.0f;
+
+		work.level[i] = level < 0.0f ? 0 : (level > 255.0f ? 255 : (uint8_t)(level + 0.5f));
+	}
+
+	last = work;
+	haveLast = 1;
+}
+
+static void report(const spec_result_t *r)
+{
+	char line[200];
+	int32_t n;
+	uint32_t i;
+
+	n = snprintf(line, sizeof(line), "SPEC %lu n=%u f=%.2f a=%.3f rms=%.3f b=", (unsigned long)r->index, r->points,
+			r->peakHz, r->peakRms, r->rms);
+	for (i = 0; i < config.bands; i++)
+	{
+		n += snprintf(line + n, sizeof(line) - n, i ? ",%.3g" : "%.3g", r->band[i]);
+	}
+	n += snprintf(line + n, sizeof(line) - n, " l=");
+	for (i = 0; i < SPEC_MSG_BINS && n < (int32_t)sizeof(line) - 3; i++)
+	{
+		n += snprintf(line + n, sizeof(line) - n, "%02X", r->level[i]);
+	}
+	snprintf(line + n, sizeof(line) - n, "\n");
+	print_str(line);
+}
+
+void SPEC_Poll(void)
+{
+	uint32_t start = DWT_Get(), end;
+
+	switch (phase)
+	{
+	case IDLE:
+		if (handed < 0)
+		{
+			return;
+		}
+		prepare();
+		phase = STAGES;
+		account(start, &stats.maxFftCycles);
+		return;
+
+	case STAGES:
+		end = butterfly + SPEC_POLL_BUTTERFLIES;
+		if (end >= butterflyCount)
+		{
+			end = butterflyCount;
+			phase = SPLIT;
+		}
+		butterflies(end);
+		account(start, &stats.maxFftCycles);
+		return;
+
+	case SPLIT:
+		/* pairs k, N/2 - k: the first half and the middle bin */
+		end = bin + SPEC_POLL_BINS;
+		if (end > config.points / 4)
+		{
+			end = config.points / 4 + 1;
+			phase = BINS;
+		}
+		split(end);
+		if (phase == BINS)
+		{
+			bin = 0;
+		}
+		account(start, &stats.maxFftCycles);
+		return;
+
+	case BINS:
+		end = bin + SPEC_POLL_BINS;
+		if (end >= config.points / 2)
+		{
+			end = config.points / 2;
+			phase = FINISH;
+		}
+		bins(end);
+		break;
+
+	default:
+		finish();
+		phase = IDLE;
+		if (config.report)
+		{
+			report(&last);
+		}
+		break;
+	}
+
+	account(start, &stats.maxPollCycles);
+}
+
+int32_t SPEC_Result(spec_result_t *r)
+{
+	if (!haveLast)
+	{
+		return -1;
+	}
+	*r = last;
+
+	return 0;
+}
+
+const spec_stats_t* SPEC_Stats(void)
+{
+	return &stats;
+}
+
+/* "spec" prints the last frame and counters, "spec size <n>", "spec on|off" the per frame message */
+void SPEC_Command(const char *args)
+{
+	char line[160];
+
+	if (strncmp(args, "size", 4) == 0)
+	{
+		print_str(SPEC_SetPoints((uint16_t)strtoul(args + 4, NULL, 10)) == 0 ? "SPEC size set\n" : "SPEC size is 256, 512 or 1024\n");
+		return;
+	}
+	if (strncmp(args, "on", 2) == 0 || strncmp(args, "off", 3) == 0)
+	{
+		SPEC_SetReport(args[1] == 'n');
+		return;
+	}
+
+	if (haveLast)
+	{
+		report(&last);
+	}
+	snprintf(line, sizeof(line), "SPEC n=%u fs=%.0f Hz frames=%lu ovr=%lu cyc max sample=%lu fft=%lu step=%lu\n",
+			config.points, config.sampleHz, (unsigned long)stats.frames, (unsigned long)stats.overruns,
+			(unsigned long)stats.maxSampleCycles, (unsigned long)stats.maxFftCycles, (unsigned long)stats.maxPollCycles);
+	print_str(line);
+}
@@ -36,9 +36,11 @@
 #include "stm32f4xx_it.h"
 
 /* USER CODE BEGIN 0 */
-#include "dwt_delay.h"
-#include "mpu9250.h"
-#include "print.h"
+#include "pipeline.h"
+#include "power.h"
+#include "scheduler.h"
+#include "prof.h"
+#include "cmd.h"
 /* USER CODE END 0 */
 
 /* External variables --------------------------------------------------------*/
@@ -51,6 +53,8 @@ extern SPI_HandleTypeDef hspi3;
 extern TIM_HandleTypeDef htim6;
 extern UART_HandleTypeDef huart1;
 extern UART_HandleTypeDef huart6;
+extern DMA_HandleTypeDef hdma_spi1_rx;
+extern DMA_HandleTypeDef hdma_spi1_tx;
 
 /******************************************************************************/
 /*            Cortex-M4 Processor Interruption and Exception Handlers         */ 
@@ -152,6 +156,9 @@ void SVC_Handler(void)
 void PendSV_Handler(void)
 {
   /* USER CODE BEGIN PendSV_IRQn 0 */
+  PROF_BEGIN(PROF_PENDSV);
+  PIPE_Process();
+  PROF_END(PROF_PENDSV);
 
   /* USER CODE END PendSV_IRQn 0 */
   /* USER CODE BEGIN PendSV_IRQn 1 */
@@ -165,12 +172,14 @@ void PendSV_Handler(void)
 void SysTick_Handler(void)
 {
   /* USER CODE BEGIN SysTick_IRQn 0 */
+  PROF_BEGIN(PROF_SYSTICK);
 
   /* USER CODE END SysTick_IRQn 0 */
   HAL_IncTick();
   HAL_SYSTICK_IRQHandler();
   /* USER CODE BEGIN SysTick_IRQn 1 */
-
+  SCHED_Tick();
+  PROF_END(PROF_SYSTICK);
   /* USER CODE END SysTick_IRQn 1 */
 }
 
@@ -299,26 +308,15 @@ void SPI3_IRQHandler(void)
 void TIM6_DAC_IRQHandler(void)
 {
   /* USER CODE BEGIN TIM6_DAC_IRQn 0 */
-  uint32_t tick1 = HAL_GetTick();
-  float ax, ay, az, gx, gy, gz, t = 0.0;
+  PROF_BEGIN(PROF_TIM6);
 
   /* USER CODE END TIM6_DAC_IRQn 0 */
   HAL_TIM_IRQHandler(&htim6);
   /* USER CODE BEGIN TIM6_DAC_IRQn 1 */
 
-  uint32_t tp1 = DWT_Get();
-
-  getMotion7(&ax,&ay,&az,&gx,&gy,&gz,&t);
-
-  uint32_t tp2 = DWT_Get();
-
-  print_motion7(tick1,ax,ay,az,gx,gy,gz,t);
-
-  uint32_t tp3 = DWT_Get();
-
-  float dt_meas = (tp2 - tp1)/((float)SystemCoreClock), dt_print = (tp3 - tp2)/((float)SystemCoreClock), dt_ttl = (tp3-tp1)/((float)SystemCoreClock);
-
-  dt_ttl = dt_meas + dt_print;
+  /* stamp and start the DMA read, the rest is in pipeline.c */
+  PIPE_Tick();
+  PROF_END(PROF_TIM6);
   /* USER CODE END TIM6_DAC_IRQn 1 */
 }
 
@@ -328,10 +326,13 @@ void TIM6_DAC_IRQHandler(void)
 void USART6_IRQHandler(void)
 {
   /* USER CODE BEGIN USART6_IRQn 0 */
+  PROF_BEGIN(PROF_UART);
+  CMD_RxIrq();
 
   /* USER CODE END USART6_IRQn 0 */
   HAL_UART_IRQHandler(&huart6);
   /* USER CODE BEGIN USART6_IRQn 1 */
+  PROF_END(PROF_UART);
 
   /* USER CODE END USART6_IRQn 1 */
 }
@@ -379,5 +380,42 @@ void FPU_IRQHandler(void)
 
 /* USER CODE BEGIN 1 */
 
+/**
+* @brief This function handles EXTI line 0 interrupt, RF4463 nIRQ on PD0.
+*/
+void EXTI0_IRQHandler(void)
+{
+  PROF_BEGIN(PROF_RF_IRQ);
+  HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_0);
+  PROF_END(PROF_RF_IRQ);
+}
+
+/**
+* @brief This function handles DMA2 stream0 global interrupt, SPI1_RX.
+*/
+void DMA2_Stream0_IRQHandler(void)
+{
+  PROF_BEGIN(PROF_SPI_DMA);
+  HAL_DMA_IRQHandler(&hdma_spi1_rx);
+  PROF_END(PROF_SPI_DMA);
+}
+
+/**
+* @brief This function handles DMA2 stream3 global interrupt, SPI1_TX.
+*/
+void DMA2_Stream3_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_spi1_tx);
+}
+
+/**
+* @brief This function handles EXTI line 2 interrupt, MPU9250 INT on PD2 in wake on motion.
+*/
+void EXTI2_IRQHandler(void)
+{
+  __HAL_GPIO_EXTI_CLEAR_IT(GPIO_PIN_2);
+  POWER_MotionIrq();
+}
+
 /* USER CODE END 1 */
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,489 @@
+/*
+ * thermal.c
+ *
+ *  Created on: 18 Oct 2026
+ *
+ *  The interrupt reads the coefficients through a pointer; a new set is
+ *  written to the other buffer and published by swapping the pointer, so
+ *  a fit in the main loop never exposes a half written table.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "thermal.h"
+#include "calib.h"
+#include "dsp_port.h"
+#include "dwt_delay.h"
+#include "print.h"
+
+#define O THERMAL_ORDER
+#if O < 2
+#error "THERMAL_ORDER must be at least 2, the scale command sets two terms"
+#endif
+/* temperature low pass, s */
+#define TEMP_TAU 1.0f
+
+static thermal_coeffs_t buffers[2];
+static const thermal_coeffs_t *volatile active = NULL;
+static uint8_t spare = 0;
+static volatile uint8_t enabled = 0, reevaluate = 1;
+
+/* evaluated at tEval */
+static float bias[6], gain[6] = { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+static float tEval;
+static float tAlpha = 0.01f, tFilt;
+static uint8_t haveTemp = 0;
+
+/* warm-up learning */
+static volatile uint8_t learning = 0, fitPending = 0;
+static volatile uint32_t learnLeft;
+static float binBase;
+static uint8_t haveBase = 0;
+static uint32_t binCount[THERMAL_BINS];
+static float binSum[THERMAL_BINS][6];
+
+static float sampleHz = 100.0f;
+static thermal_stats_t stats;
+
+void THERMAL_Init(float hz)
+{
+	sampleHz = hz;
+	tAlpha = 1.0f / (TEMP_TAU * hz);
+	haveTemp = 0;
+	reevaluate = 1;
+
+	learning = 0;
+	fitPending = 0;
+	haveBase = 0;
+	memset(binCount, 0, sizeof(binCount));
+	memset(binSum, 0, sizeof(binSum));
+
+	memset(&stats, 0, sizeof(stats));
+	stats.fitStatus = 1;
+	/* saved with the calibration, CALIB_Init() has run */
+	THERMAL_SetCoeffs(CALIB_Thermal());
+}
+
+void THERMAL_SetCoeffs(const thermal_coeffs_t *c)
+{
+	if (c)
+	{
+		buffers[spare] = *c;
+		active = &buffers[spare];
+		spare ^= 1;
+	}
+	enabled = (c != NULL);
+	reevaluate = 1;
+}
+
+const thermal_coeffs_t* THERMAL_Coeffs(void)
+{
+	return enabled ? active : NULL;
+}
+
+int32_t THERMAL_Save(void)
+{
+	CALIB_SetThermal(active);
+	return CALIB_Save();
+}
+
+void THERMAL_GyroDrift(float drift[3])
+{
+	const thermal_coeffs_t *c = active;
+	int i;
+
+	for (i = 0; i < 3; i++)
+	{
+		drift[i] = (enabled && c && haveTemp) ? bias[THERMAL_GX + i] - c->bias[THERMAL_GX + i][0] : 0.0f;
+	}
+}
+
+static void evaluate(const thermal_coeffs_t *c, float t)
+{
+	float dT = t - c->tref, b, s;
+	int i, k;
+
+	for (i = 0; i < 6; i++)
+	{
+		b = c->bias[i][O];
+		s = c->scale[i][O];
+		for (k = O - 1; k >= 0; k--)
+		{
+			b = b * dT + c->bias[i][k];
+			s = (k > 0) ? s * dT + c->scale[i][k] : s * dT + 1.0f;
+		}
+		bias[i] = b;
+		gain[i] = 1.0f / s;
+	}
+
+	tEval = t;
+	stats.evaluations++;
+}
+
+static void learn(const float v[6])
+{
+	int32_t bin;
+	int i;
+
+	if (v[0] * v[0] + v[1] * v[1] + v[2] * v[2] > THERMAL_STILL_GYRO * THERMAL_STILL_GYRO)
+	{
+		stats.rejected++;
+	}
+	else
+	{
+		if (!haveBase)
+		{
+			/* room for a small drop, most of the range for warming up */
+			binBase = floorf(tFilt) - 4.0f;
+			haveBase = 1;
+		}
+		bin = (int32_t)floorf((tFilt - binBase) * (1.0f / THERMAL_BIN_WIDTH));
+		if (bin < 0 || bin >= THERMAL_BINS)
+		{
+			stats.rejected++;
+		}
+		else
+		{
+			binCount[bin]++;
+			for (i = 0; i < 6; i++)
+			{
+				binSum[bin][i] += v[i];
+			}
+			stats.learned++;
+		}
+	}
+
+	if (--learnLeft == 0)
+	{
+		learning = 0;
+		fitPending = 1;
+	}
+}
+
+void THERMAL_Apply(float *ax, float *ay, float *az, float *gx, float *gy, float *gz, float t)
+{
+	uint32_t start = DWT_Get(), cycles;
+	const thermal_coeffs_t *c = active;
+	float v[6] = { *gx, *gy, *gz, *ax, *ay, *az };
+	int i;
+
+	stats.samples++;
+	if (haveTemp)
+	{
+		tFilt += tAlpha * (t - tFilt);
+	}
+	else
+	{
+		tFilt = t;
+		haveTemp = 1;
+	}
+	stats.temperature = tFilt;
+
+	if (learning)
+	{
+		learn(v);
+	}
+
+	if (enabled && c)
+	{
+		if (reevaluate || fabsf(tFilt - tEval) >= THERMAL_HYSTERESIS)
+		{
+			reevaluate = 0;
+			evaluate(c, tFilt);
+		}
+
+		for (i = 0; i < 6; i++)
+		{
+			v[i] = (v[i] - bias[i]) * gain[i];
+		}
+		*gx = v[0]; *gy = v[1]; *gz = v[2];
+		*ax = v[3]; *ay = v[4]; *az = v[5];
+	}
+
+	cycles = DWT_Get() - start;
+	if (cycles > stats.maxCycles)
+	{
+		stats.maxCycles = cycles;
+	}
+}
+
+void THERMAL_StartLearning(uint32_t samples)
+{
+	learning = 0;
+	haveBase = 0;
+	memset(binCount, 0, sizeof(binCount));
+	memset(binSum, 0, sizeof(binSum));
+	stats.learned = 0;
+	stats.rejected = 0;
+	fitPending = 0;
+
+	learnLeft = samples ? samples : 1;
+	learning = 1;
+}
+
+/* coefficients of p(T) around tref re-expanded around tref + delta */
+static void shift(float c[O + 1], float delta)
+{
+	int j, k;
+
+	/* repeated synthetic division by (x - delta) */
+	for (k = 0; k < O; k++)
+	{
+		for (j = O - 1; j >= k; j--)
+		{
+			c[j] += delta * c[j + 1];
+		}
+	}
+}
+
+int32_t THERMAL_Fit(void)
+{
+	float A[(O + 1) * (O + 1)], Ai[(O + 1) * (O + 1)], b[O + 1][6], u[THERMAL_BINS], x[THERMAL_BINS];
+	arm_matrix_instance_f32 mA, mAi;
+	thermal_coeffs_t next;
+	float b0[3], tref = 0.0f, span = 0.0f, lo = 1e9f, hi = -1e9f, p, e;
+	uint32_t n = 0, j, k, l;
+	int i;
+
+	/* bin temperatures and the normalised abscissa */
+	for (j = 0; j < THERMAL_BINS; j++)
+	{
+		if (binCount[j] >= THERMAL_MIN_BIN)
+		{
+			x[n] = binBase + (j + 0.5f) * THERMAL_BIN_WIDTH;
+			tref += x[n];
+			lo = fminf(lo, x[n]);
+			hi = fmaxf(hi, x[n]);
+			n++;
+		}
+	}
+	stats.binsUsed = n;
+
+	if (n < O + 2)
+	{
+		return stats.fitStatus = -1;
+	}
+	if (hi - lo < 1.0f)
+	{
+		return stats.fitStatus = -2;
+	}
+	tref /= n;
+	span = fmaxf(hi - tref, tref - lo);
+
+	memset(A, 0, sizeof(A));
+	memset(b, 0, sizeof(b));
+	for (j = 0, n = 0; j < THERMAL_BINS; j++)
+	{
+		if (binCount[j] < THERMAL_MIN_BIN)
+		{
+			continue;
+		}
+		u[n] = (x[n] - tref) / span;
+
+		for (k = 0, p = 1.0f; k <= O; k++, p *= u[n])
+		{
+			float q = p;
+
+			for (l = 0; l <= O; l++, q *= u[n])
+			{
+				A[k * (O + 1) + l] += q;
+			}
+			for (i = 0; i < 6; i++)
+			{
+				b[k][i] += p * binSum[j][i] / binCount[j];
+			}
+		}
+		n++;
+	}
+
+	arm_mat_init_f32(&mA, O + 1, O + 1, A);
+	arm_mat_init_f32(&mAi, O + 1, O + 1, Ai);
+	if (arm_mat_inverse_f32(&mA, &mAi) != ARM_MATH_SUCCESS)
+	{
+		return stats.fitStatus = -3;
+	}
+
+	/* keep the scale terms, moved to the new reference */
+	if (enabled && active)
+	{
+		next = *active;
+		for (i = 0; i < 6; i++)
+		{
+			next.scale[i][0] = 1.0f;
+			shift(next.scale[i], tref - next.tref);
+			next.scale[i][0] = 0.0f;
+		}
+	}
+	else
+	{
+		memset(&next, 0, sizeof(next));
+	}
+	next.tref = tref;
+
+	for (i = 0; i < 6; i++)
+	{
+		for (k = 0; k <= O; k++)
+		{
+			next.bias[i][k] = 0.0f;
+			for (l = 0; l <= O; l++)
+			{
+				next.bias[i][k] += Ai[k * (O + 1) + l] * b[l][i];
+			}
+		}
+
+		/* residual over the bins, in normalised form */
+		stats.fitRms[i] = 0.0f;
+		for (j = 0, n = 0; j < THERMAL_BINS; j++)
+		{
+			if (binCount[j] < THERMAL_MIN_BIN)
+			{
+				continue;
+			}
+			for (k = O + 1, p = 0.0f; k-- > 0;)
+			{
+				p = p * u[n] + next.bias[i][k];
+			}
+			e = binSum[j][i] / binCount[j] - p;
+			stats.fitRms[i] += e * e;
+			n++;
+		}
+		stats.fitRms[i] = sqrtf(stats.fitRms[i] / n);
+
+		/* back to degC */
+		for (k = 1, p = 1.0f / span; k <= O; k++, p /= span)
+		{
+			next.bias[i][k] *= p;
+		}
+	}
+
+	/* drift only, the static offsets belong to the calibration; the gyro
+	 * reads its full bias at rest, the part at tref goes over there */
+	for (i = 0; i < 3; i++)
+	{
+		b0[i] = next.bias[THERMAL_GX + i][0];
+	}
+	CALIB_ShiftGyroBias(b0);
+	for (i = 0; i < 6; i++)
+	{
+		next.bias[i][0] = 0.0f;
+	}
+
+	THERMAL_SetCoeffs(&next);
+
+	return stats.fitStatus = 0;
+}
+
+void THERMAL_Poll(void)
+{
+	char line[96];
+	int32_t fit, saved = 0;
+
+	if (!fitPending)
+	{
+		return;
+	}
+	fitPending = 0;
+
+	/* the fit moved the gyro bias too, both go to flash together */
+	fit = THERMAL_Fit();
+	if (fit == 0)
+	{
+		saved = THERMAL_Save();
+	}
+	snprintf(line, sizeof(line), "THERMAL fit %ld, %lu bins, save %ld\n", (long)fit, (unsigned long)stats.binsUsed,
+			(long)saved);
+	print_str(line);
+}
+
+const thermal_stats_t* THERMAL_Stats(void)
+{
+	return &stats;
+}
+
+/*
+ * "thermal" prints the state, "thermal learn <s>" starts a warm-up run,
+ * "thermal coef" prints the coefficients, "thermal scale <axis> <s1> <s2>"
+ * sets the scale terms of an axis (0..5 = gx gy gz ax ay az),
+ * "thermal on" / "thermal off" switch the compensation, "thermal save"
+ * stores the coefficients with the calibration.
+ */
+void THERMAL_Command(const char *args)
+{
+	const thermal_coeffs_t *c = active;
+	thermal_coeffs_t next;
+	char line[160];
+	float s, s1, s2;
+	unsigned axis;
+	int i;
+
+	if (sscanf(args, "learn %f", &s) == 1)
+	{
+		THERMAL_StartLearning((uint32_t)(s * sampleHz));
+		print_str("THERMAL learning\n");
+		return;
+	}
+	if (sscanf(args, "scale %u %f %f", &axis, &s1, &s2) == 3 && axis < 6)
+	{
+		if (c)
+		{
+			next = *c;
+		}
+		else
+		{
+			memset(&next, 0, sizeof(next));
+			next.tref = stats.temperature;
+		}
+		next.scale[axis][1] = s1;
+		next.scale[axis][2] = s2;
+		THERMAL_SetCoeffs(&next);
+		print_str("THERMAL scale set\n");
+		return;
+	}
+	if (strncmp(args, "save", 4) == 0)
+	{
+		snprintf(line, sizeof(line), "THERMAL save %ld\n", (long)THERMAL_Save());
+		print_str(line);
+		return;
+	}
+	if (strncmp(args, "off", 3) == 0)
+	{
+		enabled = 0;
+		print_str("THERMAL off\n");
+		return;
+	}
+	if (strncmp(args, "on", 2) == 0)
+	{
+		enabled = (c != NULL);
+		reevaluate = 1;
+		print_str(enabled ? "THERMAL on\n" : "THERMAL no coefficients\n");
+		return;
+	}
+	if (strncmp(args, "coef", 4) == 0)
+	{
+		if (!c)
+		{
+			print_str("THERMAL no coefficients\n");
+			return;
+		}
+		for (i = 0; i < 6; i++)
+		{
+			snprintf(line, sizeof(line), "THERMAL %d tref=%.2f b=%.4e %.4e %.4e s=%.4e %.4e\n", i, c->tref,
+					c->bias[i][0], c->bias[i][1], c->bias[i][2], c->scale[i][1], c->scale[i][2]);
+			print_str(line);
+		}
+		return;
+	}
+
+	snprintf(line, sizeof(line), "THERMAL %s T=%.2f n=%lu evals=%lu learn=%s%lu left learned=%lu rejected=%lu cyc=%lu\n",
+			enabled ? "on" : "off", stats.temperature, (unsigned long)stats.samples, (unsigned long)stats.evaluations,
+			learning ? "" : "done ", (unsigned long)(learning ? learnLeft : 0), (unsigned long)stats.learned,
+			(unsigned long)stats.rejected, (unsigned long)stats.maxCycles);
+	print_str(line);
+
+	snprintf(line, sizeof(line), "THERMAL fit=%ld bins=%lu rms g=%.2e %.2e %.2e a=%.2e %.2e %.2e\n",
+			(long)stats.fitStatus, (unsigned long)stats.binsUsed, stats.fitRms[0], stats.fitRms[1], stats.fitRms[2],
+			stats.fitRms[3], stats.fitRms[4], stats.fitRms[5]);
+	print_str(line);
+}